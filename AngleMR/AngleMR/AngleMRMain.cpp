@@ -301,7 +301,7 @@ bool AngleMRMain::Render(Windows::Graphics::Holographic::HolographicFrame^ holog
             if (cameraActive)
             {
                 // Draw the sample hologram.
-                m_renderer->UpdateProjections(pCameraResources->getCameraProjections());
+                m_renderer->UpdateProjections(pCameraResources->GetViewProjections());
                 auto size = pCameraResources->GetRenderTargetSize();
                 m_renderer->UpdateWindowSize(static_cast<GLsizei>(size.Width), static_cast<GLsizei>(size.Height));
                 m_angleResources->UpdateWindowSize(size.Width, size.Height);
@@ -2,7 +2,7 @@
 #pragma once
 
 
-#include "DeviceResources.h"
+#include "Common\DeviceResources.h"
 
 namespace ANGLE
 {
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "pch.h"
-#include "..\Common\StepTimer.h"
+#include "Common\StepTimer.h"
 #include "..\Common\AngleResources.h"
 
 namespace AngleMR
@@ -169,24 +169,41 @@ void SpinningCubeRenderer::CreateDeviceDependentResources()
     // incurred by setting the geometry shader stage.
     std::wstring vertexShaderFileName = m_usingVprtShaders ? L"ms-appx:///VprtVertexShader.cso" : L"ms-appx:///VertexShader.cso";
 
-    // Load shaders asynchronously.
-    task<std::vector<byte>> loadVSTask = DX::ReadDataAsync(vertexShaderFileName);
-    task<std::vector<byte>> loadPSTask = DX::ReadDataAsync(L"ms-appx:///PixelShader.cso");
+    // Resources are created as a graph on the shared pool: each shader as soon as its file
+    // is loaded, and the mesh alongside the shaders, since it doesn't use them.
+    DX::TaskGraph graph;
+    auto vertexShaderFile = std::make_shared<DX::AssetBlobPtr>();
+    auto pixelShaderFile = std::make_shared<DX::AssetBlobPtr>();
+    auto geometryShaderFile = std::make_shared<DX::AssetBlobPtr>();
+
+    DX::TaskGraph::NodeId loadVS = graph.Add("load vertex shader", [vertexShaderFile, vertexShaderFileName] ()
+    {
+        *vertexShaderFile = DX::ReadAsset(vertexShaderFileName);
+    });
+    DX::TaskGraph::NodeId loadPS = graph.Add("load pixel shader", [pixelShaderFile] ()
+    {
+        *pixelShaderFile = DX::ReadAsset(L"ms-appx:///PixelShader.cso");
+    });
 
-    task<std::vector<byte>> loadGSTask;
+    DX::TaskGraph::NodeId loadGS = 0;
     if (!m_usingVprtShaders)
     {
         // Load the pass-through geometry shader.
-        loadGSTask = DX::ReadDataAsync(L"ms-appx:///GeometryShader.cso");
+        loadGS = graph.Add("load geometry shader", [geometryShaderFile] ()
+        {
+            *geometryShaderFile = DX::ReadAsset(L"ms-appx:///GeometryShader.cso");
+        });
     }
 
     // After the vertex shader file is loaded, create the shader and input layout.
-    task<void> createVSTask = loadVSTask.then([this] (const std::vector<byte>& fileData)
+    graph.Add("create vertex shader", [this, vertexShaderFile] ()
     {
+        const DX::AssetBlobPtr& fileData = *vertexShaderFile;
+
         DX::ThrowIfFailed(
             m_deviceResources->GetD3DDevice()->CreateVertexShader(
-                fileData.data(),
-                fileData.size(),
+                fileData->GetData(),
+                fileData->GetSize(),
                 nullptr,
                 &m_vertexShader
                 )
@@ -202,20 +219,22 @@ void SpinningCubeRenderer::CreateDeviceDependentResources()
             m_deviceResources->GetD3DDevice()->CreateInputLayout(
                 vertexDesc.data(),
                 static_cast<UINT>(vertexDesc.size()),
-                fileData.data(),
-                static_cast<UINT>(fileData.size()),
+                fileData->GetData(),
+                static_cast<UINT>(fileData->GetSize()),
                 &m_inputLayout
                 )
             );
-    });
+    }, { loadVS });
 
     // After the pixel shader file is loaded, create the shader and constant buffer.
-    task<void> createPSTask = loadPSTask.then([this] (const std::vector<byte>& fileData)
+    graph.Add("create pixel shader", [this, pixelShaderFile] ()
     {
+        const DX::AssetBlobPtr& fileData = *pixelShaderFile;
+
         DX::ThrowIfFailed(
             m_deviceResources->GetD3DDevice()->CreatePixelShader(
-                fileData.data(),
-                fileData.size(),
+                fileData->GetData(),
+                fileData->GetSize(),
                 nullptr,
                 &m_pixelShader
                 )
@@ -229,28 +248,27 @@ void SpinningCubeRenderer::CreateDeviceDependentResources()
                 &m_modelConstantBuffer
                 )
             );
-    });
+    }, { loadPS });
 
-    task<void> createGSTask;
     if (!m_usingVprtShaders)
     {
         // After the pass-through geometry shader file is loaded, create the shader.
-        createGSTask = loadGSTask.then([this] (const std::vector<byte>& fileData)
+        graph.Add("create geometry shader", [this, geometryShaderFile] ()
         {
+            const DX::AssetBlobPtr& fileData = *geometryShaderFile;
+
             DX::ThrowIfFailed(
                 m_deviceResources->GetD3DDevice()->CreateGeometryShader(
-                    fileData.data(),
-                    fileData.size(),
+                    fileData->GetData(),
+                    fileData->GetSize(),
                     nullptr,
                     &m_geometryShader
                     )
                 );
-        });
+        }, { loadGS });
     }
 
-    // Once all shaders are loaded, create the mesh.
-    task<void> shaderTaskGroup = m_usingVprtShaders ? (createPSTask && createVSTask) : (createPSTask && createVSTask && createGSTask);
-    task<void> createCubeTask  = shaderTaskGroup.then([this] ()
+    graph.Add("create mesh", [this] ()
     {
         // Load mesh vertices. Each vertex has a position and a color.
         // Note that the cube size has changed from the default DirectX app
@@ -324,10 +342,10 @@ void SpinningCubeRenderer::CreateDeviceDependentResources()
             );
     });
 
-    // Once the cube is loaded, the object is ready to be rendered.
-    createCubeTask.then([this] ()
+    // Once everything is created, the cube is ready to be rendered.
+    graph.Run(DX::GetSharedWorkStealingPool(), [this] (const DX::TaskGraph::Result& result)
     {
-        m_loadingComplete = true;
+        m_loadingComplete = DX::ReportResourceCreation("SpinningCubeRenderer", result);
     });
 }
 
@@ -1,7 +1,7 @@
 #pragma once
 
-#include "..\Common\DeviceResources.h"
-#include "..\Common\StepTimer.h"
+#include "Common\DeviceResources.h"
+#include "Common\StepTimer.h"
 #include "ShaderStructures.h"
 
 namespace AngleMR
@@ -1,7 +1,7 @@
 #include "pch.h"
 
 #include "CameraResources.h"
-#include "Common\DirectXHelper.h"
+#include "DirectXHelper.h"
 #include "DeviceResources.h"
 #include <windows.graphics.directx.direct3d11.interop.h>
 
@@ -194,14 +194,12 @@ void DX::CameraResources::UpdateViewProjectionBuffer(
         // Update the view matrices. Holographic cameras (such as Microsoft HoloLens) are
         // constantly moving relative to the world. The view matrices need to be updated
         // every frame.
-        XMStoreFloat4x4(
-            &viewProjectionConstantBufferData.viewProjection[0],
-            XMMatrixTranspose(XMLoadFloat4x4(&viewCoordinateSystemTransform.Left) * XMLoadFloat4x4(&cameraProjectionTransform.Left))
-            );
-        XMStoreFloat4x4(
-            &viewProjectionConstantBufferData.viewProjection[1],
-            XMMatrixTranspose(XMLoadFloat4x4(&viewCoordinateSystemTransform.Right) * XMLoadFloat4x4(&cameraProjectionTransform.Right))
-            );
+        const XMMATRIX leftViewProjection  = XMLoadFloat4x4(&viewCoordinateSystemTransform.Left) * XMLoadFloat4x4(&cameraProjectionTransform.Left);
+        const XMMATRIX rightViewProjection = XMLoadFloat4x4(&viewCoordinateSystemTransform.Right) * XMLoadFloat4x4(&cameraProjectionTransform.Right);
+        XMStoreFloat4x4(&viewProjectionConstantBufferData.viewProjection[0], XMMatrixTranspose(leftViewProjection));
+        XMStoreFloat4x4(&viewProjectionConstantBufferData.viewProjection[1], XMMatrixTranspose(rightViewProjection));
+        XMStoreFloat4x4(&m_viewProjection[0], leftViewProjection);
+        XMStoreFloat4x4(&m_viewProjection[1], rightViewProjection);
     }
 
     // Use the D3D device context to update Direct3D device-based resources.
@@ -1,7 +1,5 @@
 #pragma once
 
-#include <map>
-
 namespace DX
 {
     class DeviceResources;
@@ -49,13 +47,14 @@ namespace DX
         Windows::Foundation::Size GetRenderTargetSize()             const { return m_d3dRenderTargetSize;           }
         bool                    IsRenderingStereoscopic()           const { return m_isStereo;                      }
 
+        // The view-projection matrices of the last UpdateViewProjectionBuffer that had a view
+        // transform, left eye first and not transposed, for renderers that don't read them from
+        // the constant buffer, such as AngleMR's OpenGL ES one.
+        const DirectX::XMFLOAT4X4* GetViewProjections()            const { return m_viewProjection;                }
+
         // The holographic camera these resources are for.
         Windows::Graphics::Holographic::HolographicCamera^ GetHolographicCamera() const { return m_holographicCamera; }
 
-        const DirectX::XMFLOAT4X4* getCameraProjections() {
-            return &m_viewProj[0];
-        };
-
     private:
         // Direct3D rendering objects. Required for 3D.
         Microsoft::WRL::ComPtr<ID3D11RenderTargetView>      m_d3dRenderTargetView;
@@ -64,6 +63,7 @@ namespace DX
 
         // Device resource to store view and projection matrices.
         Microsoft::WRL::ComPtr<ID3D11Buffer>                m_viewProjectionConstantBuffer;
+        DirectX::XMFLOAT4X4                                 m_viewProjection[2] = {};
 
         // Direct3D rendering properties.
         DXGI_FORMAT                                         m_dxgiFormat;
@@ -78,11 +78,5 @@ namespace DX
 
         // Pointer to the holographic camera these resources are for.
         Windows::Graphics::Holographic::HolographicCamera^  m_holographicCamera = nullptr;
-
-        std::map<Microsoft::WRL::ComPtr<ID3D11Texture2D>, HANDLE> m_backBuffers;
-
-        DirectX::XMFLOAT4X4 m_viewProj[2];
-
-
     };
 }
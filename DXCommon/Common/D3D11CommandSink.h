@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Core/CommandRecorder.h"
+
+namespace DX
+{
+    // Replays a CommandRecorder onto a Direct3D 11 device context. Handles recorded from
+    // ID3D11* pointers are cast back to their interfaces here.
+    class D3D11CommandSink
+    {
+    public:
+        explicit D3D11CommandSink(ID3D11DeviceContext* context) : m_context(context) {}
+
+        void SetInputLayout(DeviceHandle layout)
+        {
+            m_context->IASetInputLayout(As<ID3D11InputLayout>(layout));
+        }
+
+        void SetPrimitiveTopology(uint32_t topology)
+        {
+            m_context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(topology));
+        }
+
+        void SetVertexBuffer(DeviceHandle buffer, uint32_t stride, uint32_t offset)
+        {
+            ID3D11Buffer* const buffers[1] = { As<ID3D11Buffer>(buffer) };
+            const UINT strides[1] = { stride };
+            const UINT offsets[1] = { offset };
+            m_context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
+        }
+
+        void SetIndexBuffer(DeviceHandle buffer, uint32_t format)
+        {
+            m_context->IASetIndexBuffer(As<ID3D11Buffer>(buffer), static_cast<DXGI_FORMAT>(format), 0);
+        }
+
+        void SetVertexShader(DeviceHandle shader)
+        {
+            m_context->VSSetShader(As<ID3D11VertexShader>(shader), nullptr, 0);
+        }
+
+        void SetGeometryShader(DeviceHandle shader)
+        {
+            m_context->GSSetShader(As<ID3D11GeometryShader>(shader), nullptr, 0);
+        }
+
+        void SetPixelShader(DeviceHandle shader)
+        {
+            m_context->PSSetShader(As<ID3D11PixelShader>(shader), nullptr, 0);
+        }
+
+        void SetVSConstantBuffer(uint32_t slot, DeviceHandle buffer)
+        {
+            ID3D11Buffer* const buffers[1] = { As<ID3D11Buffer>(buffer) };
+            m_context->VSSetConstantBuffers(slot, 1, buffers);
+        }
+
+        void SetPSShaderResource(uint32_t slot, DeviceHandle view)
+        {
+            ID3D11ShaderResourceView* const views[1] = { As<ID3D11ShaderResourceView>(view) };
+            m_context->PSSetShaderResources(slot, 1, views);
+        }
+
+        void SetPSSampler(uint32_t slot, DeviceHandle sampler)
+        {
+            ID3D11SamplerState* const samplers[1] = { As<ID3D11SamplerState>(sampler) };
+            m_context->PSSetSamplers(slot, 1, samplers);
+        }
+
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+        {
+            m_context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+        }
+
+    private:
+        template<typename T>
+        static T* As(DeviceHandle handle)
+        {
+            return static_cast<T*>(const_cast<void*>(handle));
+        }
+
+        ID3D11DeviceContext* m_context;
+    };
+}
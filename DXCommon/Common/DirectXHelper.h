@@ -0,0 +1,145 @@
+﻿#pragma once
+
+#include <ppltasks.h>    // For create_task
+
+#include "Core\AssetCache.h"
+#include "Core\ShaderBundle.h"
+#include "Core\TaskGraph.h"
+
+namespace DX
+{
+    inline void ThrowIfFailed(HRESULT hr)
+    {
+        if (FAILED(hr))
+        {
+            // Set a breakpoint on this line to catch Win32 API errors.
+            throw Platform::Exception::CreateException(hr);
+        }
+    }
+
+    // Maps an ms-appx:/// URI to the file in the package install folder. Other paths are
+    // returned unchanged.
+    inline std::wstring ResolveAssetPath(const std::wstring& filename)
+    {
+        const std::wstring scheme = L"ms-appx:///";
+        if (filename.compare(0, scheme.size(), scheme) != 0)
+        {
+            return filename;
+        }
+
+        std::wstring path = Windows::ApplicationModel::Package::Current->InstalledLocation->Path->Data();
+        path += L'\\';
+        for (size_t i = scheme.size(); i < filename.size(); ++i)
+        {
+            path += filename[i] == L'/' ? L'\\' : filename[i];
+        }
+        return path;
+    }
+
+    // Reads a binary file such as a compiled shader through the shared asset cache, so a file
+    // that was prefetched or loaded before (by another renderer, or before the device was lost)
+    // is not read again. Blocks until the file is loaded; renderers call it from TaskGraph nodes.
+    inline AssetBlobPtr ReadAsset(const std::wstring& filename)
+    {
+        AssetBlobPtr blob = GetSharedAssetCache().Get(ResolveAssetPath(filename));
+        if (blob == nullptr)
+        {
+            throw Platform::Exception::CreateException(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+        }
+        return blob;
+    }
+
+    // Makes ReadAsset serve the files packed into a bundle by Tools\ShaderPacker.cpp from
+    // the bundle, as if they were next to it. Returns false, and leaves the files to be read one
+    // by one, if the bundle is missing or invalid.
+    inline bool MountAssetBundle(const std::wstring& filename)
+    {
+        std::wstring path = ResolveAssetPath(filename);
+        ShaderBundlePtr bundle = ShaderBundle::Open(LoadAssetFile(path));
+        if (bundle == nullptr)
+        {
+            return false;
+        }
+
+        GetSharedAssetCache().Mount(path.substr(0, path.find_last_of(L"\\/") + 1), bundle);
+        return true;
+    }
+
+    // Starts loading files that ReadAsset will be asked for, so that the reads overlap
+    // with device creation instead of following it.
+    inline void PrefetchAssets(std::initializer_list<std::wstring> filenames)
+    {
+        std::vector<std::wstring> paths;
+        for (const auto& filename : filenames)
+        {
+            paths.push_back(ResolveAssetPath(filename));
+        }
+        GetSharedAssetCache().Prefetch(paths);
+    }
+
+    // Writes how long a renderer took to create its device resources, and the chain of work
+    // that decided it, to the debugger output. Returns false, after writing the error, if
+    // creating them failed.
+    inline bool ReportResourceCreation(const char* renderer, const TaskGraph::Result& result)
+    {
+        std::string message = std::string(renderer) + ": ";
+        if (result.error != nullptr)
+        {
+            try
+            {
+                std::rethrow_exception(result.error);
+            }
+            catch (Platform::Exception^ exception)
+            {
+                char text[64];
+                snprintf(text, sizeof(text), "creating device resources failed, HRESULT 0x%08X", static_cast<unsigned int>(exception->HResult));
+                message += text;
+            }
+            catch (const std::exception& exception)
+            {
+                message += std::string("creating device resources failed: ") + exception.what();
+            }
+            catch (...)
+            {
+                message += "creating device resources failed";
+            }
+        }
+        else
+        {
+            char text[96];
+            snprintf(text, sizeof(text), "device resources created in %.2f ms (%.2f ms of work), critical path ", result.elapsed * 1000.0, result.totalWork * 1000.0);
+            message += text + result.DescribeCriticalPath();
+        }
+
+        OutputDebugStringA((message + "\n").c_str());
+        return result.error == nullptr;
+    }
+
+    // Converts a length in device-independent pixels (DIPs) to a length in physical pixels.
+    inline float ConvertDipsToPixels(float dips, float dpi)
+    {
+        constexpr float dipsPerInch = 96.0f;
+        return floorf(dips * dpi / dipsPerInch + 0.5f); // Round to nearest integer.
+    }
+
+#if defined(_DEBUG)
+    // Check for SDK Layer support.
+    inline bool SdkLayersAvailable()
+    {
+        HRESULT hr = D3D11CreateDevice(
+            nullptr,
+            D3D_DRIVER_TYPE_NULL,       // There is no need to create a real hardware device.
+            0,
+            D3D11_CREATE_DEVICE_DEBUG,  // Check for the SDK layers.
+            nullptr,                    // Any feature level will do.
+            0,
+            D3D11_SDK_VERSION,          // Always set this to D3D11_SDK_VERSION for Windows Store apps.
+            nullptr,                    // No need to keep the D3D device reference.
+            nullptr,                    // No need to know the feature level.
+            nullptr                     // No need to keep the D3D device context reference.
+            );
+
+        return SUCCEEDED(hr);
+    }
+#endif
+}
@@ -0,0 +1,356 @@
+#include "AssetCache.h"
+#include "ShaderBundle.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    class HeapAssetBlob : public DX::AssetBlob
+    {
+    public:
+        explicit HeapAssetBlob(std::vector<uint8_t>&& bytes) :
+            m_bytes(std::move(bytes))
+        {
+            m_data = m_bytes.data();
+            m_size = m_bytes.size();
+        }
+
+    private:
+        std::vector<uint8_t> m_bytes;
+    };
+
+    // A read-only view of a whole file. The file and mapping handles are closed once the view
+    // exists; the view keeps the file open until it is unmapped.
+    class MappedAssetBlob : public DX::AssetBlob
+    {
+    public:
+        MappedAssetBlob(const void* view, size_t size)
+        {
+            m_data = static_cast<const uint8_t*>(view);
+            m_size = size;
+        }
+
+        ~MappedAssetBlob()
+        {
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+        }
+    };
+
+#if defined(_WIN32)
+    struct FileHandle
+    {
+        explicit FileHandle(HANDLE handle) : handle(handle) {}
+        ~FileHandle()
+        {
+            if (handle != nullptr && handle != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(handle);
+            }
+        }
+
+        HANDLE handle;
+    };
+#else
+    struct FileHandle
+    {
+        explicit FileHandle(int handle) : handle(handle) {}
+        ~FileHandle()
+        {
+            if (handle >= 0)
+            {
+                close(handle);
+            }
+        }
+
+        int handle;
+    };
+#endif
+
+    // wchar_t is UTF-16 on Windows and UTF-32 elsewhere.
+    std::string ToUtf8(const std::wstring& text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            uint32_t code = static_cast<uint32_t>(text[i]);
+            if (code >= 0xD800 && code < 0xDC00 && i + 1 < text.size() &&
+                text[i + 1] >= 0xDC00 && text[i + 1] < 0xE000)
+            {
+                code = 0x10000 + ((code - 0xD800) << 10) + (static_cast<uint32_t>(text[++i]) - 0xDC00);
+            }
+            if (code < 0x80)
+            {
+                result += static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+                result += static_cast<char>(0xC0 | (code >> 6));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                result += static_cast<char>(0xE0 | (code >> 12));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                result += static_cast<char>(0xF0 | (code >> 18));
+                result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+        return result;
+    }
+}
+
+DX::AssetBlobPtr DX::MakeAssetBlob(std::vector<uint8_t>&& bytes)
+{
+    return std::make_shared<HeapAssetBlob>(std::move(bytes));
+}
+
+DX::AssetBlobPtr DX::LoadAssetFile(const std::wstring& path)
+{
+#if defined(_WIN32)
+    FileHandle file(CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr));
+    if (file.handle == INVALID_HANDLE_VALUE)
+    {
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file.handle, &fileSize))
+    {
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(fileSize.QuadPart);
+
+    // Empty files can't be mapped.
+    if (size > 0)
+    {
+        FileHandle mapping(CreateFileMappingFromApp(file.handle, nullptr, PAGE_READONLY, 0, nullptr));
+        if (mapping.handle != nullptr)
+        {
+            void* view = MapViewOfFileFromApp(mapping.handle, FILE_MAP_READ, 0, 0);
+            if (view != nullptr)
+            {
+                return std::make_shared<MappedAssetBlob>(view, size);
+            }
+        }
+    }
+
+    std::vector<uint8_t> bytes(size);
+    size_t read = 0;
+    while (read < size)
+    {
+        DWORD chunk = 0;
+        DWORD request = static_cast<DWORD>(std::min<size_t>(size - read, 1u << 30));
+        if (!ReadFile(file.handle, bytes.data() + read, request, &chunk, nullptr) || chunk == 0)
+        {
+            return nullptr;
+        }
+        read += chunk;
+    }
+    return MakeAssetBlob(std::move(bytes));
+#else
+    FileHandle file(open(ToUtf8(path).c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.handle < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat status;
+    if (fstat(file.handle, &status) != 0)
+    {
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(status.st_size);
+
+    // Empty files can't be mapped.
+    if (size > 0)
+    {
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file.handle, 0);
+        if (view != MAP_FAILED)
+        {
+            return std::make_shared<MappedAssetBlob>(view, size);
+        }
+    }
+
+    std::vector<uint8_t> bytes(size);
+    size_t read = 0;
+    while (read < size)
+    {
+        ssize_t chunk = ::read(file.handle, bytes.data() + read, size - read);
+        if (chunk <= 0)
+        {
+            return nullptr;
+        }
+        read += static_cast<size_t>(chunk);
+    }
+    return MakeAssetBlob(std::move(bytes));
+#endif
+}
+
+DX::AssetCache::AssetCache(Loader loader) :
+    m_loader(std::move(loader)),
+    m_statistics()
+{
+}
+
+DX::AssetCache::~AssetCache()
+{
+    for (auto& thread : m_prefetchThreads)
+    {
+        thread.join();
+    }
+}
+
+DX::AssetBlobPtr DX::AssetCache::Get(const std::wstring& path)
+{
+    std::shared_future<AssetBlobPtr> asset;
+    std::promise<AssetBlobPtr> promise;
+    bool load = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_assets.find(path);
+        if (found != m_assets.end())
+        {
+            asset = found->second;
+            m_statistics.hits++;
+        }
+        else
+        {
+            asset = promise.get_future().share();
+            m_assets.emplace(path, asset);
+            load = true;
+        }
+    }
+
+    if (load)
+    {
+        Load(path, promise);
+    }
+    return asset.get();
+}
+
+void DX::AssetCache::Prefetch(const std::vector<std::wstring>& paths)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& path : paths)
+    {
+        if (m_assets.find(path) != m_assets.end())
+        {
+            continue;
+        }
+
+        std::promise<AssetBlobPtr> promise;
+        m_assets.emplace(path, promise.get_future().share());
+        m_prefetchThreads.emplace_back([this, path](std::promise<AssetBlobPtr> promise)
+        {
+            Load(path, promise);
+        }, std::move(promise));
+    }
+}
+
+void DX::AssetCache::Mount(const std::wstring& directory, std::shared_ptr<const ShaderBundle> bundle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mountPoints.push_back({ directory, std::move(bundle) });
+}
+
+void DX::AssetCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_assets.clear();
+}
+
+DX::AssetCache::Statistics DX::AssetCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+// Runs the loader and hands the result to everyone waiting for path. A failed load is removed
+// from the cache before the waiters see it, so the next request retries.
+void DX::AssetCache::Load(const std::wstring& path, std::promise<AssetBlobPtr>& promise)
+{
+    AssetBlobPtr blob;
+    try
+    {
+        blob = FindInBundles(path);
+        if (blob == nullptr)
+        {
+            blob = m_loader(path);
+        }
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_assets.erase(path);
+        }
+        promise.set_exception(std::current_exception());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_statistics.loads++;
+        if (blob == nullptr)
+        {
+            m_assets.erase(path);
+        }
+        else
+        {
+            m_statistics.bytesLoaded += blob->GetSize();
+        }
+    }
+    promise.set_value(blob);
+}
+
+DX::AssetBlobPtr DX::AssetCache::FindInBundles(const std::wstring& path) const
+{
+    std::vector<MountPoint> mountPoints;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        mountPoints = m_mountPoints;
+    }
+
+    for (const auto& mountPoint : mountPoints)
+    {
+        if (path.compare(0, mountPoint.directory.size(), mountPoint.directory) != 0)
+        {
+            continue;
+        }
+
+        std::string name = ToUtf8(path.substr(mountPoint.directory.size()));
+        std::replace(name.begin(), name.end(), '\\', '/');
+        AssetBlobPtr blob = mountPoint.bundle->Find(name);
+        if (blob != nullptr)
+        {
+            return blob;
+        }
+    }
+    return nullptr;
+}
+
+DX::AssetCache& DX::GetSharedAssetCache()
+{
+    static AssetCache cache;
+    return cache;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Loads read-only assets such as compiled shaders once and keeps them in memory, shared by
+// every renderer that uses them. Has no Direct3D or WinRT dependencies so it can be built and
+// measured on any platform.
+namespace DX
+{
+    class ShaderBundle;
+
+    // The bytes of a loaded asset. Immutable; memory-mapped where the platform allows it.
+    class AssetBlob
+    {
+    public:
+        virtual ~AssetBlob() {}
+
+        const uint8_t*  GetData() const { return m_data; }
+        size_t          GetSize() const { return m_size; }
+
+        AssetBlob(const AssetBlob&) = delete;
+        AssetBlob& operator=(const AssetBlob&) = delete;
+
+    protected:
+        AssetBlob() : m_data(nullptr), m_size(0) {}
+
+        const uint8_t*  m_data;
+        size_t          m_size;
+    };
+
+    typedef std::shared_ptr<const AssetBlob> AssetBlobPtr;
+
+    // Wraps bytes that are already in memory.
+    AssetBlobPtr MakeAssetBlob(std::vector<uint8_t>&& bytes);
+
+    // Maps a file read-only, or reads it into memory if it can't be mapped. Returns null if the
+    // file can't be opened.
+    AssetBlobPtr LoadAssetFile(const std::wstring& path);
+
+    // Assets by path. Each asset is loaded once, however many renderers ask for it and whether
+    // or not they ask at the same time, and stays loaded until Clear so that recreating device
+    // resources doesn't read it again. Thread safe.
+    class AssetCache
+    {
+    public:
+        typedef std::function<AssetBlobPtr(const std::wstring&)> Loader;
+
+        struct Statistics
+        {
+            uint64_t    hits;           // Requests served by an asset loaded or being loaded.
+            uint64_t    loads;
+            uint64_t    bytesLoaded;
+        };
+
+        explicit AssetCache(Loader loader = LoadAssetFile);
+
+        // Waits for prefetches still in progress.
+        ~AssetCache();
+
+        // Returns the asset, loading it on the calling thread if nobody has started to, or
+        // waiting for the load in progress. Returns null if it can't be loaded; failures are not
+        // cached, so a later request tries again.
+        AssetBlobPtr Get(const std::wstring& path);
+
+        // Starts loading each asset that isn't loaded or loading yet, all in parallel, and
+        // returns without waiting.
+        void Prefetch(const std::vector<std::wstring>& paths);
+
+        // Serves assets whose paths start with directory, which ends in a path separator, from
+        // bundle when it has them; the rest of the path, with '/' separators, is the name in the
+        // bundle. Assets the bundle doesn't have still go to the loader. Assets already cached
+        // are not affected.
+        void Mount(const std::wstring& directory, std::shared_ptr<const ShaderBundle> bundle);
+
+        // Drops the cache's references, but not the mounted bundles. Blobs that are still in use
+        // stay valid.
+        void Clear();
+
+        Statistics GetStatistics() const;
+
+        AssetCache(const AssetCache&) = delete;
+        AssetCache& operator=(const AssetCache&) = delete;
+
+    private:
+        void Load(const std::wstring& path, std::promise<AssetBlobPtr>& promise);
+        AssetBlobPtr FindInBundles(const std::wstring& path) const;
+
+        struct MountPoint
+        {
+            std::wstring                        directory;
+            std::shared_ptr<const ShaderBundle> bundle;
+        };
+
+        Loader                                                          m_loader;
+        mutable std::mutex                                              m_mutex;
+        std::unordered_map<std::wstring, std::shared_future<AssetBlobPtr>> m_assets;
+        std::vector<std::thread>                                        m_prefetchThreads;
+        std::vector<MountPoint>                                         m_mountPoints;
+        Statistics                                                      m_statistics;
+    };
+
+    // The cache shared by all renderers in the process.
+    AssetCache& GetSharedAssetCache();
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DX
+{
+    // Opaque handle to a device object. On Direct3D 11 this is the ID3D11* pointer; the
+    // recorder only compares handles, so tests can use any distinct addresses.
+    typedef const void* DeviceHandle;
+
+    // Counts for one frame of recorded draws. A state change is one Set* call that a renderer
+    // asked for at draw time; it is applied only if the device does not already have that value.
+    struct CommandStats
+    {
+        uint32_t draws;
+        uint32_t stateChangesRequested;
+        uint32_t stateChangesApplied;
+
+        uint32_t StateChangesSaved() const { return stateChangesRequested - stateChangesApplied; }
+    };
+
+    // Records draws with the state they need, sorts them by pipeline state and replays them with
+    // redundant state changes filtered out against a shadow copy of the device state.
+    //
+    // State set on the recorder is sticky, as on a device context: each draw captures whatever
+    // was set before it. Only the state a renderer actually sets is tracked, so slots bound by
+    // other code (for example the view-projection constant buffer attached by CameraResources)
+    // are never touched.
+    //
+    // Replay is a template over the sink that receives the surviving calls; see
+    // D3D11CommandSink.h for Direct3D 11. A sink provides:
+    //
+    //   void SetInputLayout(DeviceHandle);
+    //   void SetPrimitiveTopology(uint32_t);
+    //   void SetVertexBuffer(DeviceHandle, uint32_t stride, uint32_t offset);
+    //   void SetIndexBuffer(DeviceHandle, uint32_t format);
+    //   void SetVertexShader(DeviceHandle);
+    //   void SetGeometryShader(DeviceHandle);
+    //   void SetPixelShader(DeviceHandle);
+    //   void SetVSConstantBuffer(uint32_t slot, DeviceHandle);
+    //   void SetPSShaderResource(uint32_t slot, DeviceHandle);
+    //   void SetPSSampler(uint32_t slot, DeviceHandle);
+    //   void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount,
+    //       uint32_t startIndex, int32_t baseVertex, uint32_t startInstance);
+    //
+    // Not thread safe; each renderer owns one recorder and uses it on the render thread.
+    class CommandRecorder
+    {
+    public:
+        static const uint32_t ConstantBufferSlots = 4;
+        static const uint32_t ShaderResourceSlots = 4;
+        static const uint32_t SamplerSlots = 2;
+
+        CommandRecorder()
+        {
+            m_current = Bindings();
+            m_device = Bindings();
+            m_stats = CommandStats();
+            m_lastFrameStats = CommandStats();
+            m_frameCount = 0;
+            m_known = 0;
+            m_pipelines.reserve(4);
+            m_draws.reserve(8);
+            m_order.reserve(8);
+        }
+
+        // Starts a new frame: the device state is treated as unknown again, since code outside
+        // the recorder may have changed it, and the counters for the previous frame are kept
+        // for GetLastFrameStats.
+        void BeginFrame()
+        {
+            m_known = 0;
+            m_lastFrameStats = m_stats;
+            m_stats = CommandStats();
+            ++m_frameCount;
+        }
+
+        // Forgets the shadow device state without ending the frame, e.g. after a device reset.
+        void InvalidateDeviceState()            { m_known = 0; }
+
+        const CommandStats& GetLastFrameStats() const { return m_lastFrameStats; }
+        uint32_t GetFrameCount() const          { return m_frameCount; }
+
+        void SetInputLayout(DeviceHandle layout)            { m_current.pipeline.inputLayout = layout;       m_current.mask |= InputLayoutBit; }
+        void SetPrimitiveTopology(uint32_t topology)        { m_current.pipeline.topology = topology;        m_current.mask |= TopologyBit; }
+        void SetVertexShader(DeviceHandle shader)           { m_current.pipeline.vertexShader = shader;      m_current.mask |= VertexShaderBit; }
+        void SetGeometryShader(DeviceHandle shader)         { m_current.pipeline.geometryShader = shader;    m_current.mask |= GeometryShaderBit; }
+        void SetPixelShader(DeviceHandle shader)            { m_current.pipeline.pixelShader = shader;       m_current.mask |= PixelShaderBit; }
+
+        void SetVertexBuffer(DeviceHandle buffer, uint32_t stride, uint32_t offset)
+        {
+            m_current.vertexBuffer = buffer;
+            m_current.vertexStride = stride;
+            m_current.vertexOffset = offset;
+            m_current.mask |= VertexBufferBit;
+        }
+
+        void SetIndexBuffer(DeviceHandle buffer, uint32_t format)
+        {
+            m_current.indexBuffer = buffer;
+            m_current.indexFormat = format;
+            m_current.mask |= IndexBufferBit;
+        }
+
+        void SetVSConstantBuffer(uint32_t slot, DeviceHandle buffer)
+        {
+            m_current.constantBuffers[slot] = buffer;
+            m_current.mask |= ConstantBufferBit << slot;
+        }
+
+        void SetPSShaderResource(uint32_t slot, DeviceHandle view)
+        {
+            m_current.shaderResources[slot] = view;
+            m_current.mask |= ShaderResourceBit << slot;
+        }
+
+        void SetPSSampler(uint32_t slot, DeviceHandle sampler)
+        {
+            m_current.samplers[slot] = sampler;
+            m_current.mask |= SamplerBit << slot;
+        }
+
+        // Captures the current state with the draw arguments.
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+        {
+            Draw draw;
+            draw.pipelineIndex = FindOrAddPipeline(m_current.pipeline);
+            draw.bindings = m_current;
+            draw.indexCount = indexCount;
+            draw.instanceCount = instanceCount;
+            draw.startIndex = startIndex;
+            draw.baseVertex = baseVertex;
+            draw.startInstance = startInstance;
+            m_draws.push_back(draw);
+        }
+
+        // Issues the recorded draws to sink, grouped by pipeline state and in recording order
+        // within a group, then clears them. State set on the recorder stays set for later draws.
+        template<typename TSink>
+        void Replay(TSink& sink)
+        {
+            m_order.resize(m_draws.size());
+            for (size_t i = 0; i < m_draws.size(); ++i)
+            {
+                m_order[i] = static_cast<uint32_t>(i);
+            }
+
+            // Pipelines are numbered in first-use order, so a stable sort on the index groups
+            // draws that share shaders and input layout without reordering anything else.
+            std::stable_sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b)
+            {
+                return m_draws[a].pipelineIndex < m_draws[b].pipelineIndex;
+            });
+
+            for (uint32_t index : m_order)
+            {
+                const Draw& draw = m_draws[index];
+                Apply(sink, draw.bindings);
+                sink.DrawIndexedInstanced(draw.indexCount, draw.instanceCount, draw.startIndex, draw.baseVertex, draw.startInstance);
+                ++m_stats.draws;
+            }
+
+            m_draws.clear();
+            m_order.clear();
+            m_pipelines.clear();
+        }
+
+    private:
+        enum : uint32_t
+        {
+            InputLayoutBit      = 1u << 0,
+            TopologyBit         = 1u << 1,
+            VertexShaderBit     = 1u << 2,
+            GeometryShaderBit   = 1u << 3,
+            PixelShaderBit      = 1u << 4,
+            VertexBufferBit     = 1u << 5,
+            IndexBufferBit      = 1u << 6,
+            ConstantBufferBit   = 1u << 7,
+            ShaderResourceBit   = ConstantBufferBit << ConstantBufferSlots,
+            SamplerBit          = ShaderResourceBit << ShaderResourceSlots,
+        };
+
+        struct PipelineState
+        {
+            DeviceHandle    inputLayout;
+            DeviceHandle    vertexShader;
+            DeviceHandle    geometryShader;
+            DeviceHandle    pixelShader;
+            uint32_t        topology;
+
+            bool operator==(const PipelineState& other) const
+            {
+                return inputLayout == other.inputLayout && vertexShader == other.vertexShader &&
+                    geometryShader == other.geometryShader && pixelShader == other.pixelShader &&
+                    topology == other.topology;
+            }
+        };
+
+        struct Bindings
+        {
+            PipelineState   pipeline;
+            DeviceHandle    vertexBuffer;
+            uint32_t        vertexStride;
+            uint32_t        vertexOffset;
+            DeviceHandle    indexBuffer;
+            uint32_t        indexFormat;
+            DeviceHandle    constantBuffers[ConstantBufferSlots];
+            DeviceHandle    shaderResources[ShaderResourceSlots];
+            DeviceHandle    samplers[SamplerSlots];
+
+            // Which of the above have been set; the rest are left alone on the device.
+            uint32_t        mask;
+        };
+
+        struct Draw
+        {
+            uint32_t        pipelineIndex;
+            Bindings        bindings;
+            uint32_t        indexCount;
+            uint32_t        instanceCount;
+            uint32_t        startIndex;
+            int32_t         baseVertex;
+            uint32_t        startInstance;
+        };
+
+        uint32_t FindOrAddPipeline(const PipelineState& pipeline)
+        {
+            for (size_t i = 0; i < m_pipelines.size(); ++i)
+            {
+                if (m_pipelines[i] == pipeline)
+                {
+                    return static_cast<uint32_t>(i);
+                }
+            }
+            m_pipelines.push_back(pipeline);
+            return static_cast<uint32_t>(m_pipelines.size() - 1);
+        }
+
+        // True if the state behind bit must be sent to the device. Updates the counters and
+        // marks the state as known; the caller stores the new value in m_device.
+        bool NeedsUpdate(const Bindings& wanted, uint32_t bit, bool same)
+        {
+            if ((wanted.mask & bit) == 0)
+            {
+                return false;
+            }
+            ++m_stats.stateChangesRequested;
+            if ((m_known & bit) != 0 && same)
+            {
+                return false;
+            }
+            ++m_stats.stateChangesApplied;
+            m_known |= bit;
+            return true;
+        }
+
+        template<typename TSink>
+        void Apply(TSink& sink, const Bindings& wanted)
+        {
+            const PipelineState& p = wanted.pipeline;
+            PipelineState& d = m_device.pipeline;
+
+            if (NeedsUpdate(wanted, InputLayoutBit, d.inputLayout == p.inputLayout))
+            {
+                d.inputLayout = p.inputLayout;
+                sink.SetInputLayout(p.inputLayout);
+            }
+            if (NeedsUpdate(wanted, TopologyBit, d.topology == p.topology))
+            {
+                d.topology = p.topology;
+                sink.SetPrimitiveTopology(p.topology);
+            }
+            if (NeedsUpdate(wanted, VertexShaderBit, d.vertexShader == p.vertexShader))
+            {
+                d.vertexShader = p.vertexShader;
+                sink.SetVertexShader(p.vertexShader);
+            }
+            if (NeedsUpdate(wanted, GeometryShaderBit, d.geometryShader == p.geometryShader))
+            {
+                d.geometryShader = p.geometryShader;
+                sink.SetGeometryShader(p.geometryShader);
+            }
+            if (NeedsUpdate(wanted, PixelShaderBit, d.pixelShader == p.pixelShader))
+            {
+                d.pixelShader = p.pixelShader;
+                sink.SetPixelShader(p.pixelShader);
+            }
+            if (NeedsUpdate(wanted, VertexBufferBit,
+                m_device.vertexBuffer == wanted.vertexBuffer && m_device.vertexStride == wanted.vertexStride && m_device.vertexOffset == wanted.vertexOffset))
+            {
+                m_device.vertexBuffer = wanted.vertexBuffer;
+                m_device.vertexStride = wanted.vertexStride;
+                m_device.vertexOffset = wanted.vertexOffset;
+                sink.SetVertexBuffer(wanted.vertexBuffer, wanted.vertexStride, wanted.vertexOffset);
+            }
+            if (NeedsUpdate(wanted, IndexBufferBit, m_device.indexBuffer == wanted.indexBuffer && m_device.indexFormat == wanted.indexFormat))
+            {
+                m_device.indexBuffer = wanted.indexBuffer;
+                m_device.indexFormat = wanted.indexFormat;
+                sink.SetIndexBuffer(wanted.indexBuffer, wanted.indexFormat);
+            }
+            for (uint32_t slot = 0; slot < ConstantBufferSlots; ++slot)
+            {
+                if (NeedsUpdate(wanted, ConstantBufferBit << slot, m_device.constantBuffers[slot] == wanted.constantBuffers[slot]))
+                {
+                    m_device.constantBuffers[slot] = wanted.constantBuffers[slot];
+                    sink.SetVSConstantBuffer(slot, wanted.constantBuffers[slot]);
+                }
+            }
+            for (uint32_t slot = 0; slot < ShaderResourceSlots; ++slot)
+            {
+                if (NeedsUpdate(wanted, ShaderResourceBit << slot, m_device.shaderResources[slot] == wanted.shaderResources[slot]))
+                {
+                    m_device.shaderResources[slot] = wanted.shaderResources[slot];
+                    sink.SetPSShaderResource(slot, wanted.shaderResources[slot]);
+                }
+            }
+            for (uint32_t slot = 0; slot < SamplerSlots; ++slot)
+            {
+                if (NeedsUpdate(wanted, SamplerBit << slot, m_device.samplers[slot] == wanted.samplers[slot]))
+                {
+                    m_device.samplers[slot] = wanted.samplers[slot];
+                    sink.SetPSSampler(slot, wanted.samplers[slot]);
+                }
+            }
+        }
+
+        Bindings                    m_current;
+        Bindings                    m_device;
+        uint32_t                    m_known;
+
+        std::vector<PipelineState>  m_pipelines;
+        std::vector<Draw>           m_draws;
+        std::vector<uint32_t>       m_order;
+
+        CommandStats                m_stats;
+        CommandStats                m_lastFrameStats;
+        uint32_t                    m_frameCount;
+    };
+}
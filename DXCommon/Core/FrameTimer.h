@@ -0,0 +1,392 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+
+namespace DX
+{
+    // Clock backends for BasicFrameTimer. A clock reports a fixed frequency and a monotonic
+    // counter in units of that frequency. Tests can supply their own clock with the same shape.
+
+#if defined(_WIN32)
+    // QueryPerformanceCounter. Both calls always succeed on Windows XP and later.
+    struct QpcClock
+    {
+        uint64_t Frequency() const
+        {
+            LARGE_INTEGER freq;
+            QueryPerformanceFrequency(&freq);
+            return static_cast<uint64_t>(freq.QuadPart);
+        }
+
+        uint64_t Now() const
+        {
+            LARGE_INTEGER ticks;
+            QueryPerformanceCounter(&ticks);
+            return static_cast<uint64_t>(ticks.QuadPart);
+        }
+    };
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    // clock_gettime(CLOCK_MONOTONIC) in nanoseconds.
+    struct MonotonicClock
+    {
+        uint64_t Frequency() const
+        {
+            return 1'000'000'000;
+        }
+
+        uint64_t Now() const
+        {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    };
+#endif
+
+    // std::chrono::steady_clock, for platforms without one of the above.
+    struct SteadyClock
+    {
+        uint64_t Frequency() const
+        {
+            using period = std::chrono::steady_clock::period;
+            return static_cast<uint64_t>(period::den / period::num);
+        }
+
+        uint64_t Now() const
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+    };
+
+#if defined(_WIN32)
+    using DefaultClock = QpcClock;
+#elif defined(__unix__) || defined(__APPLE__)
+    using DefaultClock = MonotonicClock;
+#else
+    using DefaultClock = SteadyClock;
+#endif
+
+    // Frame time percentiles over the timer's history window, in seconds.
+    struct FrameTimePercentiles
+    {
+        double p50;
+        double p95;
+        double p99;
+        double max;
+        uint32_t frameCount;
+    };
+
+    // StepTimer with frame time statistics.
+    //
+    // Behaves like StepTimer (same Tick/fixed timestep semantics and accessors) and also keeps the
+    // last HistorySize frame deltas in a fixed ring, counts hitches against a frame budget and
+    // answers percentile and histogram queries. Nothing allocates after construction.
+    //
+    // Tick must be called from a single thread. The statistics queries may be called from any
+    // thread without locking; a query that races with Tick may see one frame from the next
+    // window, which is fine for diagnostics.
+    template<typename TClock = DefaultClock, size_t HistorySize = 256>
+    class BasicFrameTimer
+    {
+        static_assert(HistorySize > 0 && (HistorySize & (HistorySize - 1)) == 0, "HistorySize must be a power of two.");
+
+    public:
+        explicit BasicFrameTimer(const TClock& clock = TClock()) :
+            m_clock(clock),
+            m_elapsedTicks(0),
+            m_totalTicks(0),
+            m_leftOverTicks(0),
+            m_frameCount(0),
+            m_framesPerSecond(0),
+            m_framesThisSecond(0),
+            m_qpcSecondCounter(0),
+            m_isFixedTimeStep(false),
+            m_targetElapsedTicks(TicksPerSecond / 60),
+            m_frameBudgetTicks(TicksPerSecond / 60),
+            m_hitchThresholdTicks(TicksPerSecond / 60 * 3 / 2),
+            m_historyCount(0),
+            m_hitchCount(0),
+            m_lastFrameWasHitch(false)
+        {
+            for (auto& delta : m_history)
+            {
+                delta.store(0, std::memory_order_relaxed);
+            }
+
+            m_qpcFrequency = m_clock.Frequency();
+            m_qpcLastTime = m_clock.Now();
+
+            // Initialize max delta to 1/10 of a second.
+            m_qpcMaxDelta = m_qpcFrequency / 10;
+        }
+
+        // Get elapsed time since the previous Update call.
+        uint64_t GetElapsedTicks() const                      { return m_elapsedTicks;                  }
+        double GetElapsedSeconds() const                      { return TicksToSeconds(m_elapsedTicks);  }
+
+        // Get total time since the start of the program.
+        uint64_t GetTotalTicks() const                        { return m_totalTicks;                    }
+        double GetTotalSeconds() const                        { return TicksToSeconds(m_totalTicks);    }
+
+        // Get total number of updates since start of the program.
+        uint32_t GetFrameCount() const                        { return m_frameCount;                    }
+
+        // Get the current framerate.
+        uint32_t GetFramesPerSecond() const                   { return m_framesPerSecond;               }
+
+        // Set whether to use fixed or variable timestep mode.
+        void SetFixedTimeStep(bool isFixedTimestep)           { m_isFixedTimeStep = isFixedTimestep;    }
+
+        // Set how often to call Update when in fixed timestep mode.
+        void SetTargetElapsedTicks(uint64_t targetElapsed)    { m_targetElapsedTicks = targetElapsed;   }
+        void SetTargetElapsedSeconds(double targetElapsed)    { m_targetElapsedTicks = SecondsToTicks(targetElapsed);   }
+
+        // Set the frame budget used for hitch detection; a frame is a hitch when its delta exceeds
+        // the budget by the given factor. Defaults to 1/60 s and 1.5.
+        void SetFrameBudgetSeconds(double budget, double hitchFactor = 1.5)
+        {
+            m_frameBudgetTicks = SecondsToTicks(budget);
+            m_hitchThresholdTicks = SecondsToTicks(budget * hitchFactor);
+        }
+        double GetFrameBudgetSeconds() const                  { return TicksToSeconds(m_frameBudgetTicks); }
+
+        // Number of hitches since construction, and whether the most recent frame was one.
+        uint32_t GetHitchCount() const                        { return m_hitchCount.load(std::memory_order_relaxed);       }
+        bool WasLastFrameHitch() const                        { return m_lastFrameWasHitch.load(std::memory_order_relaxed); }
+
+        // Integer format represents time using 10,000,000 ticks per second.
+        static const uint64_t TicksPerSecond = 10'000'000;
+
+        static double TicksToSeconds(uint64_t ticks)          { return static_cast<double>(ticks) / TicksPerSecond;     }
+        static uint64_t SecondsToTicks(double seconds)        { return static_cast<uint64_t>(seconds * TicksPerSecond); }
+
+        // The clock backing this timer, e.g. so a test can advance a fake clock.
+        TClock& GetClock()                                    { return m_clock; }
+
+        // After an intentional timing discontinuity (for instance a blocking IO operation)
+        // call this to avoid having the fixed timestep logic attempt a set of catch-up
+        // Update calls. The frame history is kept.
+        void ResetElapsedTime()
+        {
+            m_qpcLastTime = m_clock.Now();
+
+            m_leftOverTicks    = 0;
+            m_framesPerSecond  = 0;
+            m_framesThisSecond = 0;
+            m_qpcSecondCounter = 0;
+        }
+
+        // Update timer state, calling the specified Update function the appropriate number of times.
+        template<typename TUpdate>
+        void Tick(const TUpdate& update)
+        {
+            // Query the current time.
+            uint64_t currentTime = m_clock.Now();
+            uint64_t timeDelta   = currentTime - m_qpcLastTime;
+
+            m_qpcLastTime      = currentTime;
+            m_qpcSecondCounter += timeDelta;
+
+            // Record the real delta before clamping so long stalls show up in the statistics.
+            RecordFrame(ToTicks(timeDelta));
+
+            // Clamp excessively large time deltas (e.g. after paused in the debugger).
+            if (timeDelta > m_qpcMaxDelta)
+            {
+                timeDelta = m_qpcMaxDelta;
+            }
+
+            // Convert clock units into a canonical tick format. This cannot overflow due to the previous clamp.
+            timeDelta *= TicksPerSecond;
+            timeDelta /= m_qpcFrequency;
+
+            uint32_t lastFrameCount = m_frameCount;
+
+            if (m_isFixedTimeStep)
+            {
+                // Fixed timestep update logic; see StepTimer for the rationale behind the clamp.
+                if (std::llabs(static_cast<long long>(timeDelta - m_targetElapsedTicks)) < static_cast<long long>(TicksPerSecond / 4000))
+                {
+                    timeDelta = m_targetElapsedTicks;
+                }
+
+                m_leftOverTicks += timeDelta;
+
+                while (m_leftOverTicks >= m_targetElapsedTicks)
+                {
+                    m_elapsedTicks   = m_targetElapsedTicks;
+                    m_totalTicks    += m_targetElapsedTicks;
+                    m_leftOverTicks -= m_targetElapsedTicks;
+                    m_frameCount++;
+
+                    update();
+                }
+            }
+            else
+            {
+                // Variable timestep update logic.
+                m_elapsedTicks  = timeDelta;
+                m_totalTicks   += timeDelta;
+                m_leftOverTicks = 0;
+                m_frameCount++;
+
+                update();
+            }
+
+            // Track the current framerate.
+            if (m_frameCount != lastFrameCount)
+            {
+                m_framesThisSecond++;
+            }
+
+            if (m_qpcSecondCounter >= m_qpcFrequency)
+            {
+                m_framesPerSecond   = m_framesThisSecond;
+                m_framesThisSecond  = 0;
+                m_qpcSecondCounter %= m_qpcFrequency;
+            }
+        }
+
+        // Frame time percentiles over the last HistorySize frames. Returns zeros before the
+        // first frame. Uses a copy of the history on the stack, so it does not allocate.
+        FrameTimePercentiles GetPercentiles() const
+        {
+            uint32_t sorted[HistorySize];
+            const size_t count = CopyHistory(sorted);
+
+            FrameTimePercentiles result = {};
+            result.frameCount = static_cast<uint32_t>(count);
+            if (count == 0)
+            {
+                return result;
+            }
+
+            std::sort(sorted, sorted + count);
+            result.p50 = TicksToSeconds(sorted[NearestRank(50, count)]);
+            result.p95 = TicksToSeconds(sorted[NearestRank(95, count)]);
+            result.p99 = TicksToSeconds(sorted[NearestRank(99, count)]);
+            result.max = TicksToSeconds(sorted[count - 1]);
+            return result;
+        }
+
+        // A single percentile (0-100] in seconds over the last HistorySize frames.
+        double GetPercentileSeconds(double percentile) const
+        {
+            uint32_t values[HistorySize];
+            const size_t count = CopyHistory(values);
+            if (count == 0)
+            {
+                return 0.0;
+            }
+
+            const size_t rank = NearestRank(percentile, count);
+            std::nth_element(values, values + rank, values + count);
+            return TicksToSeconds(values[rank]);
+        }
+
+        // Fills buckets with the number of recent frames whose delta falls into each
+        // bucketSeconds-wide bin; the last bucket also counts everything longer.
+        template<size_t BucketCount>
+        void GetHistogram(uint32_t (&buckets)[BucketCount], double bucketSeconds) const
+        {
+            static_assert(BucketCount > 0, "The histogram needs at least one bucket.");
+
+            uint32_t values[HistorySize];
+            const size_t count = CopyHistory(values);
+            const uint64_t bucketTicks = (std::max)(SecondsToTicks(bucketSeconds), uint64_t(1));
+
+            std::fill(buckets, buckets + BucketCount, 0u);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint64_t bucket = values[i] / bucketTicks;
+                buckets[bucket < BucketCount ? bucket : BucketCount - 1]++;
+            }
+        }
+
+    private:
+        // Converts clock units to canonical ticks without overflowing on long stalls.
+        uint64_t ToTicks(uint64_t delta) const
+        {
+            return (delta / m_qpcFrequency) * TicksPerSecond + (delta % m_qpcFrequency) * TicksPerSecond / m_qpcFrequency;
+        }
+
+        void RecordFrame(uint64_t deltaTicks)
+        {
+            const uint32_t stored = static_cast<uint32_t>((std::min)(deltaTicks, uint64_t(UINT32_MAX)));
+            const uint32_t index = m_historyCount.load(std::memory_order_relaxed);
+
+            m_history[index & (HistorySize - 1)].store(stored, std::memory_order_relaxed);
+            m_historyCount.store(index + 1, std::memory_order_release);
+
+            const bool hitch = deltaTicks > m_hitchThresholdTicks;
+            m_lastFrameWasHitch.store(hitch, std::memory_order_relaxed);
+            if (hitch)
+            {
+                m_hitchCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        size_t CopyHistory(uint32_t (&values)[HistorySize]) const
+        {
+            const uint32_t written = m_historyCount.load(std::memory_order_acquire);
+            const size_t count = (std::min)(static_cast<size_t>(written), HistorySize);
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = m_history[i].load(std::memory_order_relaxed);
+            }
+            return count;
+        }
+
+        static size_t NearestRank(double percentile, size_t count)
+        {
+            const double rank = percentile / 100.0 * static_cast<double>(count);
+            const size_t index = static_cast<size_t>(rank + 0.999999);
+            return index == 0 ? 0 : (std::min)(index, count) - 1;
+        }
+
+        TClock m_clock;
+
+        // Source timing data uses clock units.
+        uint64_t m_qpcFrequency;
+        uint64_t m_qpcLastTime;
+        uint64_t m_qpcMaxDelta;
+
+        // Derived timing data uses a canonical tick format.
+        uint64_t m_elapsedTicks;
+        uint64_t m_totalTicks;
+        uint64_t m_leftOverTicks;
+
+        // Members for tracking the framerate.
+        uint32_t m_frameCount;
+        uint32_t m_framesPerSecond;
+        uint32_t m_framesThisSecond;
+        uint64_t m_qpcSecondCounter;
+
+        // Members for configuring fixed timestep mode.
+        bool     m_isFixedTimeStep;
+        uint64_t m_targetElapsedTicks;
+
+        // Members for frame statistics. m_history holds canonical ticks per frame.
+        uint64_t                m_frameBudgetTicks;
+        uint64_t                m_hitchThresholdTicks;
+        std::atomic<uint32_t>   m_history[HistorySize];
+        std::atomic<uint32_t>   m_historyCount;
+        std::atomic<uint32_t>   m_hitchCount;
+        std::atomic<bool>       m_lastFrameWasHitch;
+    };
+
+    using FrameTimer = BasicFrameTimer<>;
+}
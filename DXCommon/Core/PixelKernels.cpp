@@ -0,0 +1,29 @@
+#include "PixelKernels.h"
+
+#include <cstdint>
+#include <cstring>
+
+void DX::CopyPixelRows(
+    void* destination,
+    size_t destinationPitch,
+    const void* source,
+    size_t sourcePitch,
+    size_t rowBytes,
+    size_t rows)
+{
+    auto dst = static_cast<uint8_t*>(destination);
+    auto src = static_cast<const uint8_t*>(source);
+
+    if (destinationPitch == rowBytes && sourcePitch == rowBytes)
+    {
+        memcpy(dst, src, rowBytes * rows);
+        return;
+    }
+
+    for (size_t row = 0; row < rows; ++row)
+    {
+        memcpy(dst, src, rowBytes);
+        dst += destinationPitch;
+        src += sourcePitch;
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+// Platform-neutral pixel helpers shared by the texture upload paths. These have no
+// Direct3D or WinRT dependencies so they can be built and measured on any platform.
+namespace DX
+{
+    // Copies rows pixel rows of rowBytes each between buffers with different pitches, e.g. from a
+    // tightly packed BGRA8 image into a mapped texture whose RowPitch is padded by the driver.
+    // When both pitches equal rowBytes the copy collapses into a single memcpy.
+    void CopyPixelRows(
+        void* destination,
+        size_t destinationPitch,
+        const void* source,
+        size_t sourcePitch,
+        size_t rowBytes,
+        size_t rows);
+}
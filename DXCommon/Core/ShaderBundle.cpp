@@ -0,0 +1,385 @@
+#include "ShaderBundle.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DX::ShaderBundleFormat;
+
+namespace
+{
+    // LZ4 block format limits: a match is at least 4 bytes, the last 5 bytes of a block are
+    // always literals, and the last match starts at least 12 bytes before the end.
+    const size_t Lz4MinMatch = 4;
+    const size_t Lz4LastLiterals = 5;
+    const size_t Lz4MatchStartLimit = 12;
+    const size_t Lz4MaxOffset = 65535;
+    const int Lz4HashBits = 12;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    void WriteLength(std::vector<uint8_t>& out, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            out.push_back(255);
+        }
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    // One sequence: literals followed by a match, or only literals if it is the last one.
+    void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        size_t matchCode = matchLength >= Lz4MinMatch ? matchLength - Lz4MinMatch : 0;
+        out.push_back(static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+        if (literalLength >= 15)
+        {
+            WriteLength(out, literalLength - 15);
+        }
+        out.insert(out.end(), literals, literals + literalLength);
+
+        if (matchLength >= Lz4MinMatch)
+        {
+            out.push_back(static_cast<uint8_t>(offset));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+            if (matchCode >= 15)
+            {
+                WriteLength(out, matchCode - 15);
+            }
+        }
+    }
+
+    bool ReadLength(const uint8_t* data, size_t size, size_t& position, size_t& length)
+    {
+        uint8_t byte;
+        do
+        {
+            if (position >= size)
+            {
+                return false;
+            }
+            byte = data[position++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // A view of part of a bundle. Holds the bundle's blob so the bytes stay mapped.
+    class BundleAssetBlob : public DX::AssetBlob
+    {
+    public:
+        BundleAssetBlob(DX::AssetBlobPtr bundle, const uint8_t* data, size_t size) :
+            m_bundle(std::move(bundle))
+        {
+            m_data = data;
+            m_size = size;
+        }
+
+    private:
+        DX::AssetBlobPtr m_bundle;
+    };
+
+    size_t AlignPayload(size_t offset)
+    {
+        return (offset + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment;
+    }
+}
+
+void DX::Lz4Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& compressed)
+{
+    compressed.clear();
+    compressed.reserve(size + size / 255 + 16);
+
+    // Position + 1 of the last occurrence of each hashed 4-byte sequence; 0 means none.
+    std::vector<size_t> table(size_t(1) << Lz4HashBits, 0);
+
+    size_t anchor = 0;
+    size_t position = 0;
+    if (size > Lz4MatchStartLimit)
+    {
+        const size_t matchEndLimit = size - Lz4LastLiterals;
+        while (position + Lz4MatchStartLimit < size)
+        {
+            uint32_t sequence = Read32(data + position);
+            size_t& slot = table[(sequence * 2654435761u) >> (32 - Lz4HashBits)];
+            size_t candidate = slot;
+            slot = position + 1;
+
+            if (candidate == 0 || position - (candidate - 1) > Lz4MaxOffset || Read32(data + candidate - 1) != sequence)
+            {
+                ++position;
+                continue;
+            }
+
+            size_t match = candidate - 1;
+            while (position > anchor && match > 0 && data[position - 1] == data[match - 1])
+            {
+                --position;
+                --match;
+            }
+
+            size_t length = Lz4MinMatch;
+            while (position + length < matchEndLimit && data[position + length] == data[match + length])
+            {
+                ++length;
+            }
+
+            WriteSequence(compressed, data + anchor, position - anchor, position - match, length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    WriteSequence(compressed, data + anchor, size - anchor, 0, 0);
+}
+
+bool DX::Lz4Decompress(const uint8_t* compressed, size_t compressedSize, uint8_t* data, size_t size)
+{
+    size_t in = 0;
+    size_t out = 0;
+    while (in < compressedSize)
+    {
+        uint8_t token = compressed[in++];
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(compressed, compressedSize, in, literalLength))
+        {
+            return false;
+        }
+        if (literalLength > compressedSize - in || literalLength > size - out)
+        {
+            return false;
+        }
+        if (literalLength > 0)
+        {
+            memcpy(data + out, compressed + in, literalLength);
+        }
+        in += literalLength;
+        out += literalLength;
+
+        // The last sequence has no match.
+        if (in == compressedSize)
+        {
+            break;
+        }
+
+        if (compressedSize - in < 2)
+        {
+            return false;
+        }
+        size_t offset = compressed[in] | (compressed[in + 1] << 8);
+        in += 2;
+        if (offset == 0 || offset > out)
+        {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(compressed, compressedSize, in, matchLength))
+        {
+            return false;
+        }
+        matchLength += Lz4MinMatch;
+        if (matchLength > size - out)
+        {
+            return false;
+        }
+
+        // Byte by byte, since a match may overlap the bytes it produces.
+        const uint8_t* source = data + out - offset;
+        for (size_t i = 0; i < matchLength; ++i)
+        {
+            data[out + i] = source[i];
+        }
+        out += matchLength;
+    }
+    return out == size;
+}
+
+void DX::ShaderBundleWriter::Add(const std::string& name, std::vector<uint8_t> data, bool compress)
+{
+    Item item;
+    item.name = name;
+    item.size = data.size();
+    item.compressed = false;
+    if (compress && !data.empty())
+    {
+        std::vector<uint8_t> compressed;
+        Lz4Compress(data.data(), data.size(), compressed);
+        if (compressed.size() < data.size())
+        {
+            item.compressed = true;
+            data = std::move(compressed);
+        }
+    }
+    item.data = std::move(data);
+
+    auto existing = std::find_if(m_items.begin(), m_items.end(), [&name](const Item& other) { return other.name == name; });
+    if (existing != m_items.end())
+    {
+        *existing = std::move(item);
+    }
+    else
+    {
+        m_items.push_back(std::move(item));
+    }
+}
+
+std::vector<uint8_t> DX::ShaderBundleWriter::Write() const
+{
+    std::vector<const Item*> items;
+    for (const auto& item : m_items)
+    {
+        items.push_back(&item);
+    }
+    std::sort(items.begin(), items.end(), [](const Item* a, const Item* b) { return a->name < b->name; });
+
+    BundleHeader header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.entryCount = static_cast<uint32_t>(items.size());
+
+    std::vector<BundleEntry> entries(items.size());
+    std::string names;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(items[i]->name.size());
+        names += items[i]->name;
+    }
+    header.nameTableSize = static_cast<uint32_t>(names.size());
+
+    size_t offset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry) + names.size();
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        offset = AlignPayload(offset);
+        entries[i].offset = offset;
+        entries[i].storedSize = items[i]->data.size();
+        entries[i].size = items[i]->size;
+        entries[i].flags = items[i]->compressed ? CompressedFlag : 0;
+        offset += items[i]->data.size();
+    }
+
+    std::vector<uint8_t> bundle(offset, 0);
+    memcpy(bundle.data(), &header, sizeof(header));
+    if (!entries.empty())
+    {
+        memcpy(bundle.data() + sizeof(header), entries.data(), entries.size() * sizeof(BundleEntry));
+    }
+    memcpy(bundle.data() + sizeof(header) + entries.size() * sizeof(BundleEntry), names.data(), names.size());
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        std::copy(items[i]->data.begin(), items[i]->data.end(), bundle.begin() + static_cast<ptrdiff_t>(entries[i].offset));
+    }
+    return bundle;
+}
+
+DX::ShaderBundle::ShaderBundle(AssetBlobPtr blob, size_t entryCount) :
+    m_blob(std::move(blob)),
+    m_entryCount(entryCount)
+{
+}
+
+DX::ShaderBundlePtr DX::ShaderBundle::Open(AssetBlobPtr blob)
+{
+    if (blob == nullptr || blob->GetSize() < sizeof(BundleHeader) ||
+        reinterpret_cast<uintptr_t>(blob->GetData()) % alignof(BundleEntry) != 0)
+    {
+        return nullptr;
+    }
+
+    const uint8_t* data = blob->GetData();
+    const uint64_t size = blob->GetSize();
+
+    BundleHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != Magic || header.version != Version)
+    {
+        return nullptr;
+    }
+
+    const uint64_t namesOffset = sizeof(BundleHeader) + uint64_t(header.entryCount) * sizeof(BundleEntry);
+    if (namesOffset + header.nameTableSize > size)
+    {
+        return nullptr;
+    }
+
+    const auto* entries = reinterpret_cast<const BundleEntry*>(data + sizeof(BundleHeader));
+    const char* names = reinterpret_cast<const char*>(data + namesOffset);
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        const BundleEntry& entry = entries[i];
+        if (uint64_t(entry.nameOffset) + entry.nameLength > header.nameTableSize ||
+            entry.offset > size || entry.storedSize > size - entry.offset)
+        {
+            return nullptr;
+        }
+        // LZ4 expands by at most 255 times, so a larger size is corrupt and shouldn't be allocated.
+        if ((entry.flags & CompressedFlag) == 0 ? entry.storedSize != entry.size : (entry.size == 0 || entry.size / 255 > entry.storedSize))
+        {
+            return nullptr;
+        }
+
+        // Find relies on the names being sorted.
+        if (i > 0)
+        {
+            const BundleEntry& previous = entries[i - 1];
+            std::string a(names + previous.nameOffset, previous.nameLength);
+            std::string b(names + entry.nameOffset, entry.nameLength);
+            if (!(a < b))
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    return ShaderBundlePtr(new ShaderBundle(std::move(blob), header.entryCount));
+}
+
+const BundleEntry* DX::ShaderBundle::GetEntries() const
+{
+    return reinterpret_cast<const BundleEntry*>(m_blob->GetData() + sizeof(BundleHeader));
+}
+
+const char* DX::ShaderBundle::GetNameTable() const
+{
+    return reinterpret_cast<const char*>(m_blob->GetData() + sizeof(BundleHeader) + m_entryCount * sizeof(BundleEntry));
+}
+
+std::string DX::ShaderBundle::GetName(size_t index) const
+{
+    const BundleEntry& entry = GetEntries()[index];
+    return std::string(GetNameTable() + entry.nameOffset, entry.nameLength);
+}
+
+DX::AssetBlobPtr DX::ShaderBundle::Find(const std::string& name) const
+{
+    const BundleEntry* entries = GetEntries();
+    const char* names = GetNameTable();
+
+    auto found = std::lower_bound(entries, entries + m_entryCount, name, [names](const BundleEntry& entry, const std::string& key)
+    {
+        return key.compare(0, std::string::npos, names + entry.nameOffset, entry.nameLength) > 0;
+    });
+    if (found == entries + m_entryCount || name.compare(0, std::string::npos, names + found->nameOffset, found->nameLength) != 0)
+    {
+        return nullptr;
+    }
+
+    const uint8_t* payload = m_blob->GetData() + found->offset;
+    if ((found->flags & CompressedFlag) == 0)
+    {
+        return std::make_shared<BundleAssetBlob>(m_blob, payload, static_cast<size_t>(found->size));
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(found->size));
+    if (!Lz4Decompress(payload, static_cast<size_t>(found->storedSize), data.data(), data.size()))
+    {
+        return nullptr;
+    }
+    return MakeAssetBlob(std::move(data));
+}
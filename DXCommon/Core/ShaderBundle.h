@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AssetCache.h"
+
+// One file holding many small assets, compiled shaders mostly, so that an app opens and maps a
+// single file at startup instead of one per shader.
+//
+// Layout, all integers little-endian:
+//
+//     BundleHeader
+//     BundleEntry[entryCount]     sorted by name
+//     name table                  UTF-8 names, not terminated
+//     payloads                    each starting on a PayloadAlignment boundary
+//
+// A payload is either the asset's bytes or, if the entry is flagged compressed, one LZ4 block
+// that decompresses to them.
+namespace DX
+{
+    namespace ShaderBundleFormat
+    {
+        const uint32_t Magic = 0x42535844;      // "DXSB"
+        const uint32_t Version = 1;
+        const uint32_t PayloadAlignment = 64;
+        const uint32_t CompressedFlag = 1;
+
+        struct BundleHeader
+        {
+            uint32_t    magic;
+            uint32_t    version;
+            uint32_t    entryCount;
+            uint32_t    nameTableSize;
+        };
+
+        struct BundleEntry
+        {
+            uint32_t    nameOffset;             // Into the name table.
+            uint32_t    nameLength;
+            uint64_t    offset;                 // From the start of the bundle.
+            uint64_t    storedSize;
+            uint64_t    size;                   // After decompression.
+            uint32_t    flags;
+            uint32_t    reserved;
+        };
+
+        static_assert(sizeof(BundleHeader) == 16, "BundleHeader must match the file layout.");
+        static_assert(sizeof(BundleEntry) == 40, "BundleEntry must match the file layout.");
+    }
+
+    // Builds a bundle in memory.
+    class ShaderBundleWriter
+    {
+    public:
+        // Adds an asset under name, which is a relative path using '/'. If compress is set the
+        // asset is stored LZ4 compressed, unless that wouldn't make it smaller. Adding a name
+        // twice keeps the last one.
+        void Add(const std::string& name, std::vector<uint8_t> data, bool compress);
+
+        std::vector<uint8_t> Write() const;
+
+    private:
+        struct Item
+        {
+            std::string             name;
+            std::vector<uint8_t>    data;
+            size_t                  size;
+            bool                    compressed;
+        };
+
+        std::vector<Item> m_items;
+    };
+
+    // Read access to a bundle loaded with LoadAssetFile or held in memory.
+    class ShaderBundle
+    {
+    public:
+        // Returns null if blob is not a well-formed bundle. Every offset and size in the index
+        // is checked here, so lookups don't need to.
+        static std::shared_ptr<const ShaderBundle> Open(AssetBlobPtr blob);
+
+        size_t GetEntryCount() const { return m_entryCount; }
+        std::string GetName(size_t index) const;
+
+        // Returns the asset, or null if the bundle has no asset by that name or its payload
+        // doesn't decompress. Uncompressed assets point into the bundle, which they keep alive;
+        // compressed ones are decompressed into a new blob on every call.
+        AssetBlobPtr Find(const std::string& name) const;
+
+    private:
+        ShaderBundle(AssetBlobPtr blob, size_t entryCount);
+
+        const ShaderBundleFormat::BundleEntry* GetEntries() const;
+        const char* GetNameTable() const;
+
+        AssetBlobPtr    m_blob;
+        size_t          m_entryCount;
+    };
+
+    typedef std::shared_ptr<const ShaderBundle> ShaderBundlePtr;
+
+    // LZ4 block format, as produced by LZ4_compress_default and read by LZ4_decompress_safe.
+    void Lz4Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& compressed);
+
+    // Returns false unless compressed decodes to exactly size bytes.
+    bool Lz4Decompress(const uint8_t* compressed, size_t compressedSize, uint8_t* data, size_t size);
+}
@@ -0,0 +1,226 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+#include "FrameTimer.h"
+
+namespace
+{
+    struct NodeState
+    {
+        const char*             name;
+        std::function<void()>   work;
+        std::vector<size_t>     dependencies;
+        std::vector<size_t>     successors;
+        std::atomic<size_t>     waitingFor;
+        uint64_t                begin;
+        uint64_t                end;
+    };
+
+    // Everything a run needs, shared by the nodes in flight so the TaskGraph itself can go away.
+    struct RunState
+    {
+        DX::WorkStealingPool*                           pool;
+        std::function<void(const DX::TaskGraph::Result&)> completion;
+        std::unique_ptr<NodeState[]>                    nodes;
+        size_t                                          nodeCount;
+        std::atomic<size_t>                             unfinished;
+        std::atomic<bool>                               failed;
+        std::mutex                                      errorMutex;
+        std::exception_ptr                              error;
+        DX::DefaultClock                                clock;
+        uint64_t                                        frequency;
+        uint64_t                                        start;
+    };
+
+    DX::TaskGraph::Result Summarize(RunState& state)
+    {
+        DX::TaskGraph::Result result;
+        result.error = state.error;
+        result.totalWork = 0.0;
+
+        const double toSeconds = 1.0 / static_cast<double>(state.frequency);
+        uint64_t last = state.start;
+
+        // Nodes only depend on earlier nodes, so index order is a topological order.
+        std::vector<double> finish(state.nodeCount);
+        std::vector<size_t> previous(state.nodeCount, SIZE_MAX);
+        size_t criticalEnd = SIZE_MAX;
+        result.criticalPath = 0.0;
+        for (size_t i = 0; i < state.nodeCount; ++i)
+        {
+            const NodeState& node = state.nodes[i];
+            double duration = static_cast<double>(node.end - node.begin) * toSeconds;
+            result.nodes.push_back({ node.name, static_cast<double>(node.begin - state.start) * toSeconds, duration });
+            result.totalWork += duration;
+            last = std::max(last, node.end);
+
+            finish[i] = duration;
+            for (size_t dependency : node.dependencies)
+            {
+                if (finish[dependency] + duration > finish[i])
+                {
+                    finish[i] = finish[dependency] + duration;
+                    previous[i] = dependency;
+                }
+            }
+            if (criticalEnd == SIZE_MAX || finish[i] > result.criticalPath)
+            {
+                result.criticalPath = finish[i];
+                criticalEnd = i;
+            }
+        }
+
+        for (size_t i = criticalEnd; i != SIZE_MAX; i = previous[i])
+        {
+            result.criticalPathNodes.insert(result.criticalPathNodes.begin(), i);
+        }
+        result.elapsed = static_cast<double>(last - state.start) * toSeconds;
+        return result;
+    }
+
+    void RunNode(const std::shared_ptr<RunState>& state, size_t index)
+    {
+        NodeState& node = state->nodes[index];
+        node.begin = state->clock.Now();
+        if (!state->failed.load(std::memory_order_acquire))
+        {
+            try
+            {
+                node.work();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->errorMutex);
+                if (state->error == nullptr)
+                {
+                    state->error = std::current_exception();
+                }
+                state->failed.store(true, std::memory_order_release);
+            }
+        }
+        node.work = nullptr;
+        node.end = state->clock.Now();
+
+        for (size_t successor : node.successors)
+        {
+            if (state->nodes[successor].waitingFor.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                state->pool->Submit([state, successor] { RunNode(state, successor); });
+            }
+        }
+
+        if (state->unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            state->completion(Summarize(*state));
+        }
+    }
+}
+
+std::string DX::TaskGraph::Result::DescribeCriticalPath() const
+{
+    std::string description;
+    for (NodeId id : criticalPathNodes)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), " %.2f ms", nodes[id].duration * 1000.0);
+        description += description.empty() ? "" : " > ";
+        description += nodes[id].name;
+        description += text;
+    }
+    return description;
+}
+
+DX::TaskGraph::NodeId DX::TaskGraph::Add(const char* name, std::function<void()> work, std::initializer_list<NodeId> dependencies)
+{
+    NodeId id = m_nodes.size();
+    for (NodeId dependency : dependencies)
+    {
+        if (dependency >= id)
+        {
+            throw std::invalid_argument("TaskGraph dependencies must be added before the nodes that depend on them.");
+        }
+    }
+
+    Node node;
+    node.name = name;
+    node.work = std::move(work);
+    node.dependencies.assign(dependencies.begin(), dependencies.end());
+    for (NodeId dependency : node.dependencies)
+    {
+        m_nodes[dependency].successors.push_back(id);
+    }
+    m_nodes.push_back(std::move(node));
+    return id;
+}
+
+void DX::TaskGraph::Run(WorkStealingPool& pool, std::function<void(const Result&)> completion)
+{
+    auto state = std::make_shared<RunState>();
+    state->pool = &pool;
+    state->completion = std::move(completion);
+    state->nodeCount = m_nodes.size();
+    state->nodes.reset(new NodeState[m_nodes.size()]);
+    state->unfinished.store(m_nodes.size(), std::memory_order_relaxed);
+    state->failed.store(false, std::memory_order_relaxed);
+    state->frequency = state->clock.Frequency();
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        NodeState& node = state->nodes[i];
+        node.name = m_nodes[i].name;
+        node.work = std::move(m_nodes[i].work);
+        node.dependencies = std::move(m_nodes[i].dependencies);
+        node.successors = std::move(m_nodes[i].successors);
+        node.waitingFor.store(node.dependencies.size(), std::memory_order_relaxed);
+        node.begin = node.end = 0;
+    }
+    m_nodes.clear();
+
+    state->start = state->clock.Now();
+    if (state->nodeCount == 0)
+    {
+        state->completion(Summarize(*state));
+        return;
+    }
+
+    // Collected first: once a node is submitted it may finish and release its successors
+    // while this loop is still looking at them.
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < state->nodeCount; ++i)
+    {
+        if (state->nodes[i].dependencies.empty())
+        {
+            roots.push_back(i);
+        }
+    }
+    for (size_t root : roots)
+    {
+        pool.Submit([state, root] { RunNode(state, root); });
+    }
+}
+
+DX::TaskGraph::Result DX::TaskGraph::RunAndWait(WorkStealingPool& pool)
+{
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+    Result result;
+
+    Run(pool, [&](const Result& runResult)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = runResult;
+        finished = true;
+        done.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return finished; });
+    return result;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "WorkStealingPool.h"
+
+namespace DX
+{
+    // A set of work items and the items each one has to wait for, run on a WorkStealingPool
+    // with every item starting as soon as its dependencies are done. Used to create device
+    // resources, where loading a shader, creating it and creating unrelated buffers would
+    // otherwise be chained one after another.
+    class TaskGraph
+    {
+    public:
+        typedef size_t NodeId;
+
+        struct NodeTiming
+        {
+            const char* name;
+            double      start;          // Seconds from the start of Run.
+            double      duration;       // Seconds.
+        };
+
+        struct Result
+        {
+            // The first exception thrown by a node, or null. Once a node throws, nodes that
+            // haven't started yet are skipped.
+            std::exception_ptr      error;
+
+            double                  elapsed;        // Run to completion, in seconds.
+            double                  totalWork;      // Sum of node durations.
+
+            // Longest chain of dependent nodes by measured duration. Run can't finish sooner
+            // than criticalPath however many threads it has.
+            double                  criticalPath;
+            std::vector<NodeId>     criticalPathNodes;
+
+            std::vector<NodeTiming> nodes;          // Indexed by NodeId.
+
+            // e.g. "load VS 1.20 ms > create VS 0.31 ms"
+            std::string DescribeCriticalPath() const;
+        };
+
+        // Adds a node. Dependencies must be nodes added earlier, so the graph can't have
+        // cycles. name must outlive the graph run; a string literal is expected.
+        NodeId Add(const char* name, std::function<void()> work, std::initializer_list<NodeId> dependencies = {});
+
+        size_t GetNodeCount() const { return m_nodes.size(); }
+
+        // Starts the nodes without dependencies and returns. completion is called once, on the
+        // thread that finished the last node, and must not throw. The graph is emptied and can
+        // be reused.
+        void Run(WorkStealingPool& pool, std::function<void(const Result&)> completion);
+
+        // Runs the graph and waits for it. Not from a task on the same pool, which could be
+        // left with no thread to run the graph on.
+        Result RunAndWait(WorkStealingPool& pool);
+
+    private:
+        struct Node
+        {
+            const char*             name;
+            std::function<void()>   work;
+            std::vector<NodeId>     dependencies;
+            std::vector<NodeId>     successors;
+        };
+
+        std::vector<Node> m_nodes;
+    };
+}
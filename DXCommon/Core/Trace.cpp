@@ -0,0 +1,234 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    static_assert((DX::Trace::EventsPerThread & (DX::Trace::EventsPerThread - 1)) == 0, "EventsPerThread must be a power of two.");
+
+    using DX::Trace::Detail::ThreadBuffer;
+
+    // A copy of a ring slot.
+    struct Event
+    {
+        const char* name;
+        uint64_t    begin;
+        uint64_t    end;
+        int64_t     value;
+        bool        hasValue;
+    };
+
+    // Buffers live until exit so events from finished threads still appear in the output.
+    std::mutex                                  g_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>>  g_registry;
+    uint32_t                                    g_nextThreadId = 1;
+
+    // Trace clock and DefaultClock readings taken at startup, used to measure the trace clock
+    // frequency when it is not known up front.
+    const uint64_t g_startTicks = DX::Trace::Now();
+    const uint64_t g_startClock = DX::DefaultClock().Now();
+
+    uint64_t TraceClockFrequency()
+    {
+#if DX_TRACE_USE_TSC
+        DX::DefaultClock clock;
+        uint64_t ticks = DX::Trace::Now() - g_startTicks;
+        uint64_t elapsed = clock.Now() - g_startClock;
+        if (elapsed == 0)
+        {
+            return 1'000'000'000;
+        }
+        return static_cast<uint64_t>(static_cast<double>(ticks) * clock.Frequency() / elapsed);
+#else
+        return DX::DefaultClock().Frequency();
+#endif
+    }
+
+    // Converts clock ticks to nanoseconds without overflowing for large tick counts.
+    uint64_t TicksToNanoseconds(uint64_t ticks, uint64_t frequency)
+    {
+        return ticks / frequency * 1'000'000'000 + ticks % frequency * 1'000'000'000 / frequency;
+    }
+
+    // Microseconds with three decimals, i.e. nanosecond resolution, as the format expects.
+    void WriteMicroseconds(std::ostream& stream, uint64_t nanoseconds)
+    {
+        char text[32];
+        char* end = text + sizeof(text);
+        char* p = end;
+
+        uint64_t fraction = nanoseconds % 1000;
+        for (int i = 0; i < 3; ++i)
+        {
+            *--p = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        *--p = '.';
+
+        uint64_t whole = nanoseconds / 1000;
+        do
+        {
+            *--p = static_cast<char>('0' + whole % 10);
+            whole /= 10;
+        } while (whole != 0);
+
+        stream.write(p, end - p);
+    }
+
+    void WriteString(std::ostream& stream, const char* text)
+    {
+        stream << '"';
+        for (const char* c = text; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                stream << '\\' << *c;
+            }
+            else if (static_cast<unsigned char>(*c) >= 0x20)
+            {
+                stream << *c;
+            }
+        }
+        stream << '"';
+    }
+}
+
+std::atomic<bool> DX::Trace::g_enabled(true);
+
+void DX::Trace::SetEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool DX::Trace::IsEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+DX::Trace::Detail::ThreadBuffer* DX::Trace::Detail::RegisterThread()
+{
+    ThreadBuffer*& current = CurrentThreadBuffer();
+    if (current == nullptr)
+    {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->name.store(nullptr, std::memory_order_relaxed);
+        buffer->written.store(0, std::memory_order_relaxed);
+        buffer->clearedAt.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffer->threadId = g_nextThreadId++;
+        current = buffer.get();
+        g_registry.push_back(std::move(buffer));
+    }
+    return current;
+}
+
+void DX::Trace::SetThreadName(const char* name)
+{
+    Detail::RegisterThread()->name.store(name, std::memory_order_relaxed);
+}
+
+void DX::Trace::Clear()
+{
+    // Only the owning thread writes a ring's counter, so clearing just remembers where each
+    // ring currently ends and WriteChromeJson starts from there.
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (auto& buffer : g_registry)
+    {
+        buffer->clearedAt.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void DX::Trace::WriteChromeJson(std::ostream& stream)
+{
+    struct Snapshot
+    {
+        uint32_t            threadId;
+        const char*         name;
+        std::vector<Event>  events;
+    };
+
+    std::vector<Snapshot> snapshots;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        snapshots.reserve(g_registry.size());
+        for (auto& buffer : g_registry)
+        {
+            Snapshot snapshot;
+            snapshot.threadId = buffer->threadId;
+            snapshot.name = buffer->name.load(std::memory_order_relaxed);
+
+            uint64_t written = buffer->written.load(std::memory_order_acquire);
+            uint64_t first = std::max(written > EventsPerThread ? written - EventsPerThread : 0, buffer->clearedAt.load(std::memory_order_relaxed));
+            snapshot.events.reserve(static_cast<size_t>(written - first));
+            for (uint64_t i = first; i < written; ++i)
+            {
+                // The owning thread may be rewriting the slot for a later event; then the
+                // sequence has changed and the copy is skipped.
+                const DX::Trace::Detail::Event& slot = buffer->events[i & (EventsPerThread - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != i + 1)
+                {
+                    continue;
+                }
+                Event event;
+                event.name = slot.name.load(std::memory_order_relaxed);
+                event.begin = slot.begin.load(std::memory_order_relaxed);
+                event.end = slot.end.load(std::memory_order_relaxed);
+                event.value = slot.value.load(std::memory_order_relaxed);
+                event.hasValue = slot.hasValue.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == i + 1)
+                {
+                    snapshot.events.push_back(event);
+                }
+            }
+
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+
+    // Timestamps are written relative to the earliest event to keep the numbers short.
+    uint64_t origin = UINT64_MAX;
+    for (const auto& snapshot : snapshots)
+    {
+        for (const auto& event : snapshot.events)
+        {
+            origin = std::min(origin, event.begin);
+        }
+    }
+
+    const uint64_t frequency = TraceClockFrequency();
+    bool first = true;
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const auto& snapshot : snapshots)
+    {
+        if (snapshot.name != nullptr)
+        {
+            stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << snapshot.threadId << ",\"args\":{\"name\":";
+            WriteString(stream, snapshot.name);
+            stream << "}}";
+            first = false;
+        }
+
+        for (const auto& event : snapshot.events)
+        {
+            stream << (first ? "" : ",") << "\n{\"name\":";
+            WriteString(stream, event.name);
+            stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << snapshot.threadId << ",\"ts\":";
+            WriteMicroseconds(stream, TicksToNanoseconds(event.begin - origin, frequency));
+            stream << ",\"dur\":";
+            WriteMicroseconds(stream, TicksToNanoseconds(event.end - event.begin, frequency));
+            if (event.hasValue)
+            {
+                stream << ",\"args\":{\"value\":" << event.value << "}";
+            }
+            stream << "}";
+            first = false;
+        }
+    }
+    stream << "\n]}\n";
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "FrameTimer.h"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define DX_TRACE_USE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define DX_TRACE_USE_TSC 1
+#else
+#define DX_TRACE_USE_TSC 0
+#endif
+
+// Scoped CPU tracing for the frame loop.
+//
+// Each thread that records a scope gets its own fixed-size ring of events, so recording takes
+// no locks, no atomic read-modify-write and does not allocate after the first event on a
+// thread. Timestamps are raw clock ticks (the TSC on x86 and x64, DefaultClock elsewhere) and
+// are converted to nanoseconds only when the trace is written out as Chrome trace-event JSON,
+// which can be opened in chrome://tracing or https://ui.perfetto.dev. An enabled scope costs its
+// two clock reads plus a few nanoseconds (Tests/TraceBenchmark.cpp).
+//
+// Build with DX_TRACE_ENABLED defined to 0 to compile every DX_TRACE_* macro out.
+#ifndef DX_TRACE_ENABLED
+#define DX_TRACE_ENABLED 1
+#endif
+
+namespace DX
+{
+    namespace Trace
+    {
+        // Events kept per thread. Older events are overwritten once a thread's ring is full;
+        // at two cameras and a handful of scopes per frame this is roughly a minute of frames.
+        const size_t EventsPerThread = 16384;
+
+        // Current time in trace clock ticks. QueryPerformanceCounter and clock_gettime cost
+        // about twice as much as the TSC read they wrap, so x86 and x64 read the TSC directly;
+        // its frequency is measured against DefaultClock when the trace is written.
+        inline uint64_t Now()
+        {
+#if DX_TRACE_USE_TSC
+            return __rdtsc();
+#else
+            return DefaultClock().Now();
+#endif
+        }
+
+        // Recording can also be switched off at run time; a disabled scope costs one relaxed load.
+        void SetEnabled(bool enabled);
+        bool IsEnabled();
+
+        // Names the calling thread in the trace output. name must outlive the trace.
+        void SetThreadName(const char* name);
+
+        namespace Detail
+        {
+            // A slot of a ring, written as a sequence lock: sequence is the event's index plus
+            // one once it is complete and 0 while it is being rewritten, and a reader keeps its
+            // copy only if sequence is the same before and after. The fields are atomics so the
+            // reader's copy isn't a data race; relaxed, they compile to plain moves.
+            struct Event
+            {
+                std::atomic<uint64_t>       sequence;
+                std::atomic<const char*>    name;
+                std::atomic<uint64_t>       begin;
+                std::atomic<uint64_t>       end;
+                std::atomic<int64_t>        value;
+                std::atomic<bool>           hasValue;
+            };
+
+            // One thread's ring. Only the owning thread writes; written is published with
+            // release ordering after each event so a reader knows which slots to look at.
+            struct ThreadBuffer
+            {
+                uint32_t                    threadId;
+                std::atomic<const char*>    name;
+                std::atomic<uint64_t>       written;
+                std::atomic<uint64_t>       clearedAt;
+                Event                       events[EventsPerThread];
+            };
+
+            // The calling thread's ring, or null before its first event. A function-local
+            // thread_local with a constant initializer, so reading it needs no guard.
+            inline ThreadBuffer*& CurrentThreadBuffer()
+            {
+                static thread_local ThreadBuffer* buffer = nullptr;
+                return buffer;
+            }
+
+            // Creates and registers the calling thread's ring.
+            ThreadBuffer* RegisterThread();
+        }
+
+        // Appends one completed scope to the calling thread's ring. name must be a string
+        // literal or otherwise outlive the trace; only the pointer is stored. Inline, so that a
+        // scope costs its two clock reads and seven stores, which on x86 are all plain moves.
+        inline void Record(const char* name, uint64_t begin, uint64_t end, int64_t value, bool hasValue)
+        {
+            Detail::ThreadBuffer* buffer = Detail::CurrentThreadBuffer();
+            if (buffer == nullptr)
+            {
+                buffer = Detail::RegisterThread();
+            }
+
+            const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+            Detail::Event& event = buffer->events[index & (EventsPerThread - 1)];
+            event.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            event.name.store(name, std::memory_order_relaxed);
+            event.begin.store(begin, std::memory_order_relaxed);
+            event.end.store(end, std::memory_order_relaxed);
+            event.value.store(value, std::memory_order_relaxed);
+            event.hasValue.store(hasValue, std::memory_order_relaxed);
+            event.sequence.store(index + 1, std::memory_order_release);
+            buffer->written.store(index + 1, std::memory_order_release);
+        }
+
+        // Drops all events recorded so far. Thread names are kept.
+        void Clear();
+
+        // Writes every thread's events as a Chrome trace-event JSON object. Safe to call while
+        // other threads are recording; events overwritten during the copy are skipped.
+        void WriteChromeJson(std::ostream& stream);
+
+        // Internal; read by Scope so that the disabled check can be inlined.
+        extern std::atomic<bool> g_enabled;
+
+        // Records the time between construction and destruction under name.
+        class Scope
+        {
+        public:
+            explicit Scope(const char* name) :
+                m_name(name),
+                m_value(0),
+                m_hasValue(false),
+                m_begin(g_enabled.load(std::memory_order_relaxed) ? Now() : 0)
+            {
+            }
+
+            // value is shown as an argument of the event, e.g. a camera id.
+            Scope(const char* name, int64_t value) :
+                m_name(name),
+                m_value(value),
+                m_hasValue(true),
+                m_begin(g_enabled.load(std::memory_order_relaxed) ? Now() : 0)
+            {
+            }
+
+            ~Scope()
+            {
+                if (m_begin != 0)
+                {
+                    Record(m_name, m_begin, Now(), m_value, m_hasValue);
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            const char* m_name;
+            int64_t     m_value;
+            bool        m_hasValue;
+            uint64_t    m_begin;
+        };
+    }
+}
+
+#define DX_TRACE_CONCAT_INNER(a, b) a##b
+#define DX_TRACE_CONCAT(a, b) DX_TRACE_CONCAT_INNER(a, b)
+
+#if DX_TRACE_ENABLED
+// Traces the rest of the enclosing block.
+#define DX_TRACE_SCOPE(name) ::DX::Trace::Scope DX_TRACE_CONCAT(dxTraceScope, __LINE__)(name)
+// Traces the rest of the enclosing block, tagging the event with an integer argument.
+#define DX_TRACE_SCOPE_VALUE(name, value) ::DX::Trace::Scope DX_TRACE_CONCAT(dxTraceScope, __LINE__)(name, static_cast<int64_t>(value))
+#define DX_TRACE_THREAD_NAME(name) ::DX::Trace::SetThreadName(name)
+#else
+#define DX_TRACE_SCOPE(name) ((void)0)
+#define DX_TRACE_SCOPE_VALUE(name, value) ((void)0)
+#define DX_TRACE_THREAD_NAME(name) ((void)0)
+#endif
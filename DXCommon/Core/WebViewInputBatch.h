@@ -0,0 +1,205 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace DX
+{
+    // Collects the clicks, scrolls and key presses destined for a WebView between frames and
+    // serializes them into the single argument of one InvokeScriptAsync call per frame.
+    //
+    // The WebView side is a handler function installed once per navigation (see HandlerScript),
+    // so the page parses one short command string per frame instead of an eval'd script per event.
+    // The batch itself has no WinRT dependencies and may be filled from any thread.
+    //
+    // Wire format: commands separated by ';', fields separated by ','.
+    //   c,x,y          click the element at (x, y)
+    //   s,dx,dy        window.scrollBy(dx, dy)
+    //   k,code,...     append each character code to the focused element (8 deletes one character)
+    class WebViewInputBatch
+    {
+    public:
+        WebViewInputBatch()
+        {
+            m_pending.reserve(64);
+            m_flushing.reserve(64);
+        }
+
+        // Name of the script function installed by HandlerScript.
+        static const wchar_t* HandlerFunction()
+        {
+            return L"__uwpInjectInput";
+        }
+
+        // Script to eval once after each navigation completes.
+        static const wchar_t* HandlerScript()
+        {
+            return
+                L"window.__uwpInjectInput = function (batch) {"
+                L"  var ops = batch.split(';');"
+                L"  for (var i = 0; i < ops.length; i++) {"
+                L"    var a = ops[i].split(',');"
+                L"    if (a[0] === 'c') {"
+                L"      var target = document.elementFromPoint(+a[1], +a[2]);"
+                L"      if (target) { target.click(); }"
+                L"    } else if (a[0] === 's') {"
+                L"      window.scrollBy(+a[1], +a[2]);"
+                L"    } else if (a[0] === 'k') {"
+                L"      var e = document.activeElement;"
+                L"      if (!e || e.value === undefined) { continue; }"
+                L"      var v = e.value;"
+                L"      for (var j = 1; j < a.length; j++) {"
+                L"        var code = +a[j];"
+                L"        v = (code === 8) ? v.slice(0, -1) : v + String.fromCharCode(code);"
+                L"      }"
+                L"      e.value = v;"
+                L"    }"
+                L"  }"
+                L"  return '';"
+                L"};";
+        }
+
+        void Click(int x, int y)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.push_back({ CommandType::Click, x, y });
+        }
+
+        // Consecutive scrolls are merged, so a burst of pointer moves costs one scrollBy per frame.
+        void Scroll(int dx, int dy)
+        {
+            if (dx == 0 && dy == 0)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pending.empty() && m_pending.back().type == CommandType::Scroll)
+            {
+                m_pending.back().a += dx;
+                m_pending.back().b += dy;
+            }
+            else
+            {
+                m_pending.push_back({ CommandType::Scroll, dx, dy });
+            }
+        }
+
+        void Key(unsigned int code)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.push_back({ CommandType::Key, static_cast<int>(code), 0 });
+        }
+
+        // Drops any pending input, e.g. when the WebView starts a new navigation.
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.clear();
+        }
+
+        // Moves the pending input into argument and returns true, or returns false if nothing
+        // is pending. Only the swap happens under the lock; serialization reuses the capacity
+        // of argument and of the internal buffers, so steady-state frames do not allocate.
+        bool Flush(std::wstring& argument)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_pending.empty())
+                {
+                    return false;
+                }
+                m_flushing.swap(m_pending);
+            }
+
+            argument.clear();
+            CommandType previous = CommandType::None;
+            for (const auto& command : m_flushing)
+            {
+                if (command.type == CommandType::Key && previous == CommandType::Key)
+                {
+                    // Runs of keys share one 'k' command.
+                    argument += L',';
+                    AppendInt(argument, command.a);
+                    continue;
+                }
+
+                if (!argument.empty())
+                {
+                    argument += L';';
+                }
+
+                switch (command.type)
+                {
+                case CommandType::Click:
+                    argument += L"c,";
+                    AppendInt(argument, command.a);
+                    argument += L',';
+                    AppendInt(argument, command.b);
+                    break;
+
+                case CommandType::Scroll:
+                    argument += L"s,";
+                    AppendInt(argument, command.a);
+                    argument += L',';
+                    AppendInt(argument, command.b);
+                    break;
+
+                case CommandType::Key:
+                    argument += L"k,";
+                    AppendInt(argument, command.a);
+                    break;
+
+                default:
+                    break;
+                }
+                previous = command.type;
+            }
+
+            m_flushing.clear();
+            return true;
+        }
+
+    private:
+        enum class CommandType : unsigned char
+        {
+            None,
+            Click,
+            Scroll,
+            Key
+        };
+
+        struct Command
+        {
+            CommandType type;
+            int a;
+            int b;
+        };
+
+        static void AppendInt(std::wstring& s, int value)
+        {
+            wchar_t digits[12];
+            unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+            int count = 0;
+            do
+            {
+                digits[count++] = static_cast<wchar_t>(L'0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude != 0);
+
+            if (value < 0)
+            {
+                s += L'-';
+            }
+            while (count > 0)
+            {
+                s += digits[--count];
+            }
+        }
+
+        std::mutex              m_mutex;
+        std::vector<Command>    m_pending;
+        std::vector<Command>    m_flushing;
+    };
+}
@@ -0,0 +1,126 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // The pool and queue the current thread works for, so Submit can tell a worker's own
+    // tasks from tasks submitted by other threads.
+    thread_local const DX::WorkStealingPool* t_pool = nullptr;
+    thread_local size_t t_queue = 0;
+}
+
+DX::WorkStealingPool::WorkStealingPool(unsigned int threadCount) :
+    m_nextQueue(0),
+    m_stealCount(0),
+    m_pending(0),
+    m_stopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i]->thread = std::thread([this, i] { Run(i); });
+    }
+}
+
+DX::WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker->thread.join();
+    }
+}
+
+void DX::WorkStealingPool::Submit(std::function<void()> task)
+{
+    // Counted before the task is queued so the count never drops below zero, and under the
+    // sleep lock so a worker can't check it and then sleep through the notification. A worker
+    // woken before the task is queued looks again.
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t queue = t_pool == this ? t_queue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+    {
+        std::lock_guard<std::mutex> lock(m_workers[queue]->mutex);
+        m_workers[queue]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+void DX::WorkStealingPool::Run(size_t index)
+{
+    t_pool = this;
+    t_queue = index;
+
+    std::function<void()> task;
+    for (;;)
+    {
+        if (TryTake(index, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_pending.load(std::memory_order_relaxed) > 0 || m_stopping; });
+        if (m_stopping && m_pending.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+    }
+}
+
+bool DX::WorkStealingPool::TryTake(size_t index, std::function<void()>& task)
+{
+    // Own queue first, newest task first.
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then the oldest task of the next worker that has one.
+    for (size_t i = 1; i < m_workers.size(); ++i)
+    {
+        Worker& victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            m_stealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+DX::WorkStealingPool& DX::GetSharedWorkStealingPool()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DX
+{
+    // Fixed set of worker threads, each with its own task queue. A task submitted from a
+    // worker goes to that worker's queue and is run newest first, which keeps a chain of
+    // dependent tasks on one thread and its caches; idle workers steal the oldest task from
+    // the other queues. Tasks submitted from other threads are spread over the queues.
+    class WorkStealingPool
+    {
+    public:
+        // threadCount 0 means one per hardware thread.
+        explicit WorkStealingPool(unsigned int threadCount = 0);
+
+        // Runs every task already submitted, then joins the workers.
+        ~WorkStealingPool();
+
+        // Tasks must not throw.
+        void Submit(std::function<void()> task);
+
+        unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+        // Tasks taken from another worker's queue since construction.
+        uint64_t GetStealCount() const { return m_stealCount.load(std::memory_order_relaxed); }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    private:
+        struct Worker
+        {
+            std::mutex                          mutex;
+            std::deque<std::function<void()>>   tasks;
+            std::thread                         thread;
+        };
+
+        void Run(size_t index);
+        bool TryTake(size_t index, std::function<void()>& task);
+
+        std::vector<std::unique_ptr<Worker>>    m_workers;
+        std::atomic<size_t>                     m_nextQueue;
+        std::atomic<uint64_t>                   m_stealCount;
+
+        // Tasks queued and not yet taken. Workers sleep on m_wake while it is zero.
+        std::mutex                              m_sleepMutex;
+        std::condition_variable                 m_wake;
+        std::atomic<size_t>                     m_pending;
+        bool                                    m_stopping;
+    };
+
+    // The pool shared by the renderers in the process.
+    WorkStealingPool& GetSharedWorkStealingPool();
+}
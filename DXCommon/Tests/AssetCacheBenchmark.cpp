@@ -0,0 +1,74 @@
+#include "Core/AssetCache.h"
+
+#include "Benchmark.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DX;
+
+BENCHMARK(AssetCacheRequests)
+{
+    // Twelve shaders of 4 KB each, as a holographic renderer set loads when device resources
+    // are recreated.
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "AssetCacheBenchmark";
+    std::filesystem::create_directories(directory);
+    std::vector<std::wstring> paths;
+    for (int i = 0; i < 12; i++)
+    {
+        std::filesystem::path path = directory / ("Shader" + std::to_string(i) + ".cso");
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(4096, static_cast<char>('a' + i));
+        paths.push_back(path.wstring());
+    }
+
+    double uncached = TestSupport::MeasureNanoseconds(static_cast<double>(paths.size()), [&]
+    {
+        for (const auto& path : paths)
+        {
+            TestSupport::DoNotOptimize(LoadAssetFile(path));
+        }
+    });
+
+    AssetCache cache;
+    cache.Prefetch(paths);
+    double hit = TestSupport::MeasureNanoseconds(static_cast<double>(paths.size()), [&]
+    {
+        for (const auto& path : paths)
+        {
+            TestSupport::DoNotOptimize(cache.Get(path));
+        }
+    });
+
+    // Four threads asking for the same shaders at once, as the renderers do on device creation.
+    double contended = TestSupport::MeasureNanoseconds(4.0 * paths.size() * 100, [&]
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&]
+            {
+                for (int round = 0; round < 100; round++)
+                {
+                    for (const auto& path : paths)
+                    {
+                        TestSupport::DoNotOptimize(cache.Get(path));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+
+    std::filesystem::remove_all(directory);
+
+    TestSupport::Report("LoadAssetFile, 4 KB shader", uncached, "ns/asset");
+    TestSupport::Report("AssetCache::Get, cached", hit, "ns/asset");
+    TestSupport::Report("AssetCache::Get, cached, 4 threads", contended, "ns/asset");
+}
@@ -0,0 +1,178 @@
+#include "Core/AssetCache.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    // A loader that makes blobs of the path's length, counting calls and taking a while so
+    // that concurrent requests overlap.
+    struct CountingLoader
+    {
+        std::atomic<int>    calls;
+        int                 failuresLeft;
+
+        CountingLoader() : calls(0), failuresLeft(0) {}
+
+        AssetBlobPtr Load(const std::wstring& path)
+        {
+            calls++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            if (failuresLeft > 0)
+            {
+                failuresLeft--;
+                return nullptr;
+            }
+            return MakeAssetBlob(std::vector<uint8_t>(path.size(), static_cast<uint8_t>(path[0])));
+        }
+    };
+
+    std::filesystem::path WriteTemporaryFile(const char* name, size_t size)
+    {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        for (size_t i = 0; i < size; i++)
+        {
+            file.put(static_cast<char>(i * 7));
+        }
+        return path;
+    }
+}
+
+TEST_CASE(AssetCacheLoadsEachAssetOnceForConcurrentRequests)
+{
+    CountingLoader loader;
+    AssetCache cache([&loader](const std::wstring& path) { return loader.Load(path); });
+
+    // Eight renderers asking for the same shader at once share a single load.
+    std::vector<AssetBlobPtr> blobs(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        threads.emplace_back([&cache, &blobs, i] { blobs[i] = cache.Get(L"VertexShader.cso"); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK_EQUAL(1, loader.calls.load());
+    for (const AssetBlobPtr& blob : blobs)
+    {
+        CHECK(blob != nullptr && blob == blobs[0]);
+    }
+    CHECK_EQUAL(16u, blobs[0]->GetSize());
+    CHECK_EQUAL(static_cast<uint8_t>('V'), blobs[0]->GetData()[0]);
+
+    AssetCache::Statistics statistics = cache.GetStatistics();
+    CHECK_EQUAL(1u, statistics.loads);
+    CHECK_EQUAL(7u, statistics.hits);
+    CHECK_EQUAL(16u, statistics.bytesLoaded);
+
+    // Another asset is a separate load; the first is served from memory.
+    CHECK(cache.Get(L"PixelShader.cso") != blobs[0]);
+    CHECK(cache.Get(L"VertexShader.cso") == blobs[0]);
+    CHECK_EQUAL(2, loader.calls.load());
+}
+
+TEST_CASE(AssetCacheRetriesFailedLoads)
+{
+    CountingLoader loader;
+    loader.failuresLeft = 1;
+    AssetCache cache([&loader](const std::wstring& path) { return loader.Load(path); });
+
+    CHECK(cache.Get(L"Missing.cso") == nullptr);
+    AssetBlobPtr blob = cache.Get(L"Missing.cso");
+    CHECK(blob != nullptr);
+    CHECK_EQUAL(2, loader.calls.load());
+    CHECK_EQUAL(0u, cache.GetStatistics().hits);
+
+    // A loader that throws passes the exception to the caller, and isn't cached either.
+    int thrown = 0;
+    AssetCache throwing([&thrown](const std::wstring&) -> AssetBlobPtr
+    {
+        if (thrown++ == 0)
+        {
+            throw std::runtime_error("device removed");
+        }
+        return MakeAssetBlob(std::vector<uint8_t>(4));
+    });
+
+    bool caught = false;
+    try
+    {
+        throwing.Get(L"Shader.cso");
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(throwing.Get(L"Shader.cso") != nullptr);
+}
+
+TEST_CASE(AssetCachePrefetchesInParallelAndClearKeepsBlobsAlive)
+{
+    CountingLoader loader;
+    AssetCache cache([&loader](const std::wstring& path) { return loader.Load(path); });
+
+    // Four 20 ms loads in parallel take about one load's time, not four.
+    std::vector<std::wstring> paths = { L"a.cso", L"b.cso", L"c.cso", L"d.cso" };
+    auto start = std::chrono::steady_clock::now();
+    cache.Prefetch(paths);
+    cache.Prefetch(paths);
+    for (const auto& path : paths)
+    {
+        CHECK(cache.Get(path) != nullptr);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed < std::chrono::milliseconds(70));
+    CHECK_EQUAL(4, loader.calls.load());
+    CHECK_EQUAL(4u, cache.GetStatistics().hits);
+
+    // Clearing drops the cache's reference only; the next request loads again.
+    AssetBlobPtr blob = cache.Get(L"a.cso");
+    cache.Clear();
+    CHECK_EQUAL(5u, blob->GetSize());
+    CHECK_EQUAL(static_cast<uint8_t>('a'), blob->GetData()[0]);
+    CHECK(cache.Get(L"a.cso") != blob);
+    CHECK_EQUAL(5, loader.calls.load());
+}
+
+TEST_CASE(AssetCacheLoadsFilesFromDisk)
+{
+    std::filesystem::path full = WriteTemporaryFile("AssetCacheTests.bin", 5000);
+    std::filesystem::path empty = WriteTemporaryFile("AssetCacheTestsEmpty.bin", 0);
+
+    AssetBlobPtr blob = LoadAssetFile(full.wstring());
+    CHECK(blob != nullptr);
+    CHECK_EQUAL(5000u, blob->GetSize());
+    bool matches = blob != nullptr;
+    for (size_t i = 0; matches && i < blob->GetSize(); i++)
+    {
+        matches = blob->GetData()[i] == static_cast<uint8_t>(i * 7);
+    }
+    CHECK(matches);
+
+    // Empty files can't be mapped but still load; missing files don't.
+    AssetBlobPtr nothing = LoadAssetFile(empty.wstring());
+    CHECK(nothing != nullptr && nothing->GetSize() == 0);
+    CHECK(LoadAssetFile((std::filesystem::temp_directory_path() / "AssetCacheTestsMissing.bin").wstring()) == nullptr);
+
+    // The mapping outlives the file's directory entry.
+    AssetCache cache;
+    AssetBlobPtr cached = cache.Get(full.wstring());
+    std::filesystem::remove(full);
+    std::filesystem::remove(empty);
+    CHECK(cached != nullptr && cached->GetSize() == 5000 && cached->GetData()[4999] == static_cast<uint8_t>(4999 * 7));
+}
@@ -0,0 +1,196 @@
+#include "MockD3D11.h"
+
+#include "Common/D3D11CommandSink.h"
+
+#include "Check.h"
+
+using namespace DX;
+
+namespace
+{
+    typedef ID3D11DeviceContext::Call Call;
+
+    ID3D11InputLayout           g_layout;
+    ID3D11Buffer                g_vertices;
+    ID3D11Buffer                g_otherVertices;
+    ID3D11Buffer                g_indices;
+    ID3D11Buffer                g_model;
+    ID3D11Buffer                g_material;
+    ID3D11VertexShader          g_vertexShader;
+    ID3D11GeometryShader        g_geometryShader;
+    ID3D11PixelShader           g_pixelShader;
+    ID3D11PixelShader           g_otherPixelShader;
+    ID3D11ShaderResourceView    g_texture;
+    ID3D11SamplerState          g_sampler;
+
+    // What the spinning cube renderer sets for its one draw.
+    void SetCubeState(CommandRecorder& commands, ID3D11PixelShader* pixelShader = &g_pixelShader)
+    {
+        commands.SetVertexBuffer(&g_vertices, 24, 0);
+        commands.SetIndexBuffer(&g_indices, DXGI_FORMAT_R16_UINT);
+        commands.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commands.SetInputLayout(&g_layout);
+        commands.SetVertexShader(&g_vertexShader);
+        commands.SetVSConstantBuffer(0, &g_model);
+        commands.SetGeometryShader(&g_geometryShader);
+        commands.SetPixelShader(pixelShader);
+    }
+
+    void Replay(CommandRecorder& commands, ID3D11DeviceContext& context)
+    {
+        D3D11CommandSink sink(&context);
+        commands.Replay(sink);
+    }
+}
+
+TEST_CASE(CommandRecorderSinkForwardsEachStateToItsContextMethod)
+{
+    CommandRecorder commands;
+    SetCubeState(commands);
+    commands.SetPSShaderResource(0, &g_texture);
+    commands.SetPSSampler(1, &g_sampler);
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+
+    ID3D11DeviceContext context;
+    Replay(commands, context);
+
+    const std::vector<Call> expected =
+    {
+        { "IASetInputLayout", &g_layout, 0, 0 },
+        { "IASetPrimitiveTopology", nullptr, 0, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST },
+        { "VSSetShader", &g_vertexShader, 0, 0 },
+        { "GSSetShader", &g_geometryShader, 0, 0 },
+        { "PSSetShader", &g_pixelShader, 0, 0 },
+        { "IASetVertexBuffers", &g_vertices, 0, 24000 },
+        { "IASetIndexBuffer", &g_indices, 0, DXGI_FORMAT_R16_UINT },
+        { "VSSetConstantBuffers", &g_model, 0, 0 },
+        { "PSSetShaderResources", &g_texture, 0, 0 },
+        { "PSSetSamplers", &g_sampler, 1, 0 },
+        { "DrawIndexedInstanced", nullptr, 2, 36 },
+    };
+    CHECK(context.calls == expected);
+}
+
+TEST_CASE(CommandRecorderFiltersRedundantStateWithinAFrame)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+
+    commands.BeginFrame();
+    SetCubeState(commands);
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+    Replay(commands, context);
+
+    // The second camera of the frame sets the same state again.
+    const size_t firstCameraCalls = context.calls.size();
+    SetCubeState(commands);
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+    Replay(commands, context);
+    CHECK_EQUAL(firstCameraCalls + 1, context.calls.size());
+    CHECK(context.calls.back().method == "DrawIndexedInstanced");
+
+    commands.BeginFrame();
+    const CommandStats& stats = commands.GetLastFrameStats();
+    CHECK_EQUAL(2u, stats.draws);
+    CHECK_EQUAL(16u, stats.stateChangesRequested);
+    CHECK_EQUAL(8u, stats.stateChangesApplied);
+    CHECK_EQUAL(8u, stats.StateChangesSaved());
+    CHECK_EQUAL(2u, commands.GetFrameCount());
+}
+
+TEST_CASE(CommandRecorderForgetsDeviceStateOnBeginFrameAndInvalidate)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+
+    SetCubeState(commands);
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+    Replay(commands, context);
+    CHECK_EQUAL(9u, context.calls.size());
+
+    // Other code may have changed the context since the last frame, so everything is sent again.
+    commands.BeginFrame();
+    SetCubeState(commands);
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+    Replay(commands, context);
+    CHECK_EQUAL(18u, context.calls.size());
+
+    commands.InvalidateDeviceState();
+    commands.DrawIndexedInstanced(36, 2, 0, 0, 0);
+    Replay(commands, context);
+    CHECK_EQUAL(27u, context.calls.size());
+}
+
+TEST_CASE(CommandRecorderStateIsStickyAcrossDraws)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+
+    SetCubeState(commands);
+    commands.DrawIndexedInstanced(36, 1, 0, 0, 0);
+    commands.SetVertexBuffer(&g_otherVertices, 24, 96);
+    commands.DrawIndexedInstanced(12, 1, 0, 0, 0);
+    Replay(commands, context);
+
+    // Only the vertex buffer changes between the two draws.
+    CHECK_EQUAL(2u, context.draws);
+    CHECK_EQUAL(size_t(2), context.Count("IASetVertexBuffers"));
+    CHECK_EQUAL(size_t(1), context.Count("VSSetShader"));
+    CHECK(context.calls[context.calls.size() - 2] == (Call{ "IASetVertexBuffers", &g_otherVertices, 0, 24096 }));
+}
+
+TEST_CASE(CommandRecorderGroupsDrawsByPipelineInRecordingOrder)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+
+    SetCubeState(commands, &g_pixelShader);
+    commands.DrawIndexedInstanced(1, 1, 0, 0, 0);
+    SetCubeState(commands, &g_otherPixelShader);
+    commands.DrawIndexedInstanced(2, 1, 0, 0, 0);
+    SetCubeState(commands, &g_pixelShader);
+    commands.DrawIndexedInstanced(3, 1, 0, 0, 0);
+    SetCubeState(commands, &g_otherPixelShader);
+    commands.DrawIndexedInstanced(4, 1, 0, 0, 0);
+    Replay(commands, context);
+
+    std::vector<uint32_t> order;
+    for (const Call& call : context.calls)
+    {
+        if (call.method == "DrawIndexedInstanced")
+        {
+            order.push_back(call.value);
+        }
+    }
+    CHECK(order == (std::vector<uint32_t>{ 1, 3, 2, 4 }));
+    CHECK_EQUAL(size_t(2), context.Count("PSSetShader"));
+}
+
+TEST_CASE(CommandRecorderLeavesUnsetSlotsAlone)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+
+    // Slot 0 belongs to another renderer's constant buffer here, and no geometry shader is set.
+    commands.SetVSConstantBuffer(1, &g_material);
+    commands.SetVertexShader(&g_vertexShader);
+    commands.DrawIndexedInstanced(6, 1, 0, 0, 0);
+    Replay(commands, context);
+
+    const std::vector<Call> expected =
+    {
+        { "VSSetShader", &g_vertexShader, 0, 0 },
+        { "VSSetConstantBuffers", &g_material, 1, 0 },
+        { "DrawIndexedInstanced", nullptr, 1, 6 },
+    };
+    CHECK(context.calls == expected);
+}
+
+TEST_CASE(CommandRecorderReplayWithNoDrawsDoesNothing)
+{
+    CommandRecorder commands;
+    ID3D11DeviceContext context;
+    SetCubeState(commands);
+    Replay(commands, context);
+    CHECK(context.calls.empty());
+}
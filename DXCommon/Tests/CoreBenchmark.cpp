@@ -0,0 +1,33 @@
+#include "Core/PixelKernels.h"
+
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace DX;
+
+BENCHMARK(PixelKernelsTextureUpload)
+{
+    // A 1280x720 BGRA8 frame into a mapped texture, packed and with a padded row pitch.
+    const size_t width = 1280;
+    const size_t height = 720;
+    const size_t rowBytes = width * 4;
+    const size_t paddedPitch = rowBytes + 256;
+    std::vector<uint8_t> source(rowBytes * height, 1);
+    std::vector<uint8_t> destination(paddedPitch * height);
+
+    double packed = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        CopyPixelRows(destination.data(), rowBytes, source.data(), rowBytes, rowBytes, height);
+        TestSupport::DoNotOptimize(destination[0]);
+    });
+    double padded = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        CopyPixelRows(destination.data(), paddedPitch, source.data(), rowBytes, rowBytes, height);
+        TestSupport::DoNotOptimize(destination[0]);
+    });
+    TestSupport::Report("1280x720 BGRA8, packed pitch", packed / 1000, "us/frame");
+    TestSupport::Report("1280x720 BGRA8, padded pitch", padded / 1000, "us/frame");
+    TestSupport::Report("1280x720 BGRA8, padded pitch", rowBytes * height / padded, "GB/s");
+}
@@ -0,0 +1,183 @@
+#include "Core/FrameTimer.h"
+
+#include "Check.h"
+
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // A clock in microseconds that only moves when the test advances it.
+    struct FakeClock
+    {
+        uint64_t now = 0;
+
+        uint64_t Frequency() const  { return 1'000'000; }
+        uint64_t Now() const        { return now; }
+    };
+
+    typedef BasicFrameTimer<FakeClock, 16> TestTimer;
+
+    void TickAfter(TestTimer& timer, uint64_t microseconds, int* updates = nullptr)
+    {
+        timer.GetClock().now += microseconds;
+        timer.Tick([updates] { if (updates != nullptr) { ++*updates; } });
+    }
+
+    bool Near(double expected, double actual)
+    {
+        return std::fabs(expected - actual) < 1e-9;
+    }
+}
+
+TEST_CASE(FrameTimerPercentilesAreZeroBeforeTheFirstFrame)
+{
+    TestTimer timer;
+    FrameTimePercentiles percentiles = timer.GetPercentiles();
+    CHECK_EQUAL(0u, percentiles.frameCount);
+    CHECK(percentiles.p50 == 0.0 && percentiles.p95 == 0.0 && percentiles.p99 == 0.0 && percentiles.max == 0.0);
+    CHECK(timer.GetPercentileSeconds(50) == 0.0);
+}
+
+TEST_CASE(FrameTimerPercentilesOverPartlyFilledRing)
+{
+    TestTimer timer;
+    TickAfter(timer, 3000);
+    TickAfter(timer, 1000);
+    TickAfter(timer, 4000);
+    TickAfter(timer, 2000);
+
+    FrameTimePercentiles percentiles = timer.GetPercentiles();
+    CHECK_EQUAL(4u, percentiles.frameCount);
+    CHECK(Near(0.002, percentiles.p50));
+    CHECK(Near(0.004, percentiles.p95));
+    CHECK(Near(0.004, percentiles.p99));
+    CHECK(Near(0.004, percentiles.max));
+    CHECK(Near(0.001, timer.GetPercentileSeconds(25)));
+    CHECK(Near(0.003, timer.GetPercentileSeconds(75)));
+}
+
+TEST_CASE(FrameTimerPercentilesOverFullRingKeepOnlyTheLatestFrames)
+{
+    TestTimer timer;
+
+    // Sixteen slow frames that the next sixteen push out of the ring.
+    for (int i = 0; i < 16; ++i)
+    {
+        TickAfter(timer, 90'000);
+    }
+    for (uint64_t milliseconds = 16; milliseconds >= 1; --milliseconds)
+    {
+        TickAfter(timer, milliseconds * 1000);
+    }
+
+    FrameTimePercentiles percentiles = timer.GetPercentiles();
+    CHECK_EQUAL(16u, percentiles.frameCount);
+    CHECK(Near(0.008, percentiles.p50));
+    CHECK(Near(0.016, percentiles.p95));
+    CHECK(Near(0.016, percentiles.p99));
+    CHECK(Near(0.016, percentiles.max));
+    CHECK(Near(0.001, timer.GetPercentileSeconds(1)));
+    CHECK(Near(0.012, timer.GetPercentileSeconds(75)));
+
+    uint32_t buckets[4];
+    timer.GetHistogram(buckets, 0.005);
+    CHECK_EQUAL(4u, buckets[0]);
+    CHECK_EQUAL(5u, buckets[1]);
+    CHECK_EQUAL(5u, buckets[2]);
+    CHECK_EQUAL(2u, buckets[3]);
+}
+
+TEST_CASE(FrameTimerCountsHitchesAgainstTheBudget)
+{
+    TestTimer timer;
+
+    // The default budget is 1/60 s with a factor of 1.5, so anything over 25 ms is a hitch.
+    TickAfter(timer, 16'000);
+    CHECK(!timer.WasLastFrameHitch());
+    TickAfter(timer, 30'000);
+    CHECK(timer.WasLastFrameHitch());
+    TickAfter(timer, 24'000);
+    CHECK(!timer.WasLastFrameHitch());
+    TickAfter(timer, 500'000);
+    CHECK(timer.WasLastFrameHitch());
+    CHECK_EQUAL(2u, timer.GetHitchCount());
+
+    timer.SetFrameBudgetSeconds(0.010, 2.0);
+    CHECK(Near(0.010, timer.GetFrameBudgetSeconds()));
+    TickAfter(timer, 19'000);
+    CHECK(!timer.WasLastFrameHitch());
+    TickAfter(timer, 21'000);
+    CHECK(timer.WasLastFrameHitch());
+    CHECK_EQUAL(3u, timer.GetHitchCount());
+}
+
+TEST_CASE(FrameTimerFixedStepSnapsDeltasCloseToTheTarget)
+{
+    TestTimer timer;
+    timer.SetFixedTimeStep(true);
+    timer.SetTargetElapsedTicks(TestTimer::TicksPerSecond / 60);
+
+    // 16.7 ms is within 1/4000 s of 1/60 s, so it counts as exactly one step with nothing left over.
+    int updates = 0;
+    for (int i = 0; i < 60; ++i)
+    {
+        TickAfter(timer, 16'700, &updates);
+    }
+    CHECK_EQUAL(60, updates);
+    CHECK_EQUAL(60u, timer.GetFrameCount());
+    CHECK_EQUAL(TestTimer::TicksPerSecond / 60, timer.GetElapsedTicks());
+    CHECK_EQUAL(60 * (TestTimer::TicksPerSecond / 60), timer.GetTotalTicks());
+
+    // 10 ms is well short of a step, so it only accumulates.
+    updates = 0;
+    TickAfter(timer, 10'000, &updates);
+    CHECK_EQUAL(0, updates);
+    TickAfter(timer, 10'000, &updates);
+    CHECK_EQUAL(1, updates);
+}
+
+TEST_CASE(FrameTimerClampsLongStallsButRecordsThem)
+{
+    TestTimer timer;
+    timer.SetFixedTimeStep(true);
+    timer.SetTargetElapsedTicks(TestTimer::TicksPerSecond / 60);
+
+    // A 2 s stall catches up at most 1/10 s, which is six steps of 1/60 s.
+    int updates = 0;
+    TickAfter(timer, 2'000'000, &updates);
+    CHECK_EQUAL(6, updates);
+    CHECK(Near(2.0, timer.GetPercentiles().max));
+    CHECK_EQUAL(1u, timer.GetHitchCount());
+
+    // In variable step mode the clamped delta becomes the elapsed time.
+    TestTimer variable;
+    TickAfter(variable, 2'000'000);
+    CHECK_EQUAL(TestTimer::TicksPerSecond / 10, variable.GetElapsedTicks());
+    CHECK(Near(2.0, variable.GetPercentileSeconds(100)));
+}
+
+TEST_CASE(FrameTimerResetElapsedTimeSkipsTheGapAndKeepsHistory)
+{
+    TestTimer timer;
+    TickAfter(timer, 16'000);
+
+    timer.GetClock().now += 5'000'000;
+    timer.ResetElapsedTime();
+    TickAfter(timer, 16'000);
+
+    CHECK_EQUAL(160'000u, timer.GetElapsedTicks());
+    CHECK_EQUAL(2u, timer.GetPercentiles().frameCount);
+    CHECK_EQUAL(0u, timer.GetHitchCount());
+}
+
+TEST_CASE(FrameTimerCountsFramesPerSecond)
+{
+    TestTimer timer;
+    for (int i = 0; i < 100; ++i)
+    {
+        TickAfter(timer, 10'000);
+    }
+    CHECK_EQUAL(100u, timer.GetFramesPerSecond());
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Just enough of d3d11.h for Common/D3D11CommandSink.h to compile against a context that logs
+// each call instead of sending it to a driver.
+typedef unsigned int UINT;
+typedef int INT;
+
+enum D3D11_PRIMITIVE_TOPOLOGY : uint32_t
+{
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+    D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5,
+};
+
+enum DXGI_FORMAT : uint32_t
+{
+    DXGI_FORMAT_R32_UINT = 42,
+    DXGI_FORMAT_R16_UINT = 57,
+};
+
+struct ID3D11InputLayout {};
+struct ID3D11Buffer {};
+struct ID3D11VertexShader {};
+struct ID3D11GeometryShader {};
+struct ID3D11PixelShader {};
+struct ID3D11ShaderResourceView {};
+struct ID3D11SamplerState {};
+struct ID3D11ClassInstance {};
+
+struct ID3D11DeviceContext
+{
+    struct Call
+    {
+        std::string     method;
+        const void*     object;
+        uint32_t        slot;
+        uint32_t        value;
+
+        bool operator==(const Call& other) const
+        {
+            return method == other.method && object == other.object && slot == other.slot && value == other.value;
+        }
+    };
+
+    std::vector<Call>   calls;
+    uint32_t            draws = 0;
+
+    void IASetInputLayout(ID3D11InputLayout* layout)                    { Log("IASetInputLayout", layout); }
+    void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology)      { Log("IASetPrimitiveTopology", nullptr, 0, topology); }
+    void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const*, UINT)     { Log("VSSetShader", shader); }
+    void GSSetShader(ID3D11GeometryShader* shader, ID3D11ClassInstance* const*, UINT)   { Log("GSSetShader", shader); }
+    void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const*, UINT)      { Log("PSSetShader", shader); }
+
+    void IASetVertexBuffers(UINT slot, UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets)
+    {
+        Log("IASetVertexBuffers", count == 1 ? buffers[0] : nullptr, slot, strides[0] * 1000 + offsets[0]);
+    }
+
+    void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset)
+    {
+        Log("IASetIndexBuffer", buffer, offset, format);
+    }
+
+    void VSSetConstantBuffers(UINT slot, UINT count, ID3D11Buffer* const* buffers)
+    {
+        Log("VSSetConstantBuffers", count == 1 ? buffers[0] : nullptr, slot);
+    }
+
+    void PSSetShaderResources(UINT slot, UINT count, ID3D11ShaderResourceView* const* views)
+    {
+        Log("PSSetShaderResources", count == 1 ? views[0] : nullptr, slot);
+    }
+
+    void PSSetSamplers(UINT slot, UINT count, ID3D11SamplerState* const* samplers)
+    {
+        Log("PSSetSamplers", count == 1 ? samplers[0] : nullptr, slot);
+    }
+
+    void DrawIndexedInstanced(UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+    {
+        Log("DrawIndexedInstanced", nullptr, instanceCount, indexCount);
+        (void)startIndex;
+        (void)baseVertex;
+        (void)startInstance;
+        ++draws;
+    }
+
+    void Log(const char* method, const void* object, uint32_t slot = 0, uint32_t value = 0)
+    {
+        calls.push_back(Call{ method, object, slot, value });
+    }
+
+    size_t Count(const std::string& method) const
+    {
+        size_t count = 0;
+        for (const Call& call : calls)
+        {
+            count += call.method == method ? 1 : 0;
+        }
+        return count;
+    }
+};
@@ -0,0 +1,73 @@
+#include "Core/PixelKernels.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    std::vector<uint8_t> Pattern(size_t size)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(i * 7 + 1);
+        }
+        return bytes;
+    }
+}
+
+TEST_CASE(PixelKernelsCopiesPackedRows)
+{
+    const std::vector<uint8_t> source = Pattern(16 * 4 * 8);
+    std::vector<uint8_t> destination(source.size());
+
+    CopyPixelRows(destination.data(), 64, source.data(), 64, 64, 8);
+    CHECK(destination == source);
+}
+
+TEST_CASE(PixelKernelsCopiesIntoAPaddedPitch)
+{
+    const size_t rowBytes = 10 * 4;
+    const size_t pitch = 64;
+    const std::vector<uint8_t> source = Pattern(rowBytes * 5);
+    std::vector<uint8_t> destination(pitch * 5, 0xCD);
+
+    CopyPixelRows(destination.data(), pitch, source.data(), rowBytes, rowBytes, 5);
+    for (size_t row = 0; row < 5; ++row)
+    {
+        for (size_t column = 0; column < pitch; ++column)
+        {
+            const uint8_t expected = column < rowBytes ? source[row * rowBytes + column] : 0xCD;
+            CHECK_EQUAL(static_cast<int>(expected), static_cast<int>(destination[row * pitch + column]));
+        }
+    }
+}
+
+TEST_CASE(PixelKernelsCopiesOutOfAPaddedPitch)
+{
+    const size_t rowBytes = 12;
+    const size_t pitch = 32;
+    const std::vector<uint8_t> source = Pattern(pitch * 3);
+    std::vector<uint8_t> destination(rowBytes * 3);
+
+    CopyPixelRows(destination.data(), rowBytes, source.data(), pitch, rowBytes, 3);
+    for (size_t row = 0; row < 3; ++row)
+    {
+        for (size_t column = 0; column < rowBytes; ++column)
+        {
+            CHECK(destination[row * rowBytes + column] == source[row * pitch + column]);
+        }
+    }
+}
+
+TEST_CASE(PixelKernelsZeroRowsWritesNothing)
+{
+    std::vector<uint8_t> destination(16, 0xAB);
+    const std::vector<uint8_t> source = Pattern(16);
+    CopyPixelRows(destination.data(), 16, source.data(), 16, 16, 0);
+    CHECK(destination == std::vector<uint8_t>(16, 0xAB));
+}
@@ -0,0 +1,83 @@
+#include "Core/ShaderBundle.h"
+
+#include "Benchmark.h"
+
+#include <string>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    // Mostly repetitive, like compiled shader bytecode.
+    std::vector<uint8_t> ShaderLike(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            data[i] = (i % 16 < 12) ? static_cast<uint8_t>(i % 16) : static_cast<uint8_t>(seed >> 24);
+        }
+        return data;
+    }
+}
+
+BENCHMARK(ShaderBundleLz4)
+{
+    std::vector<uint8_t> shader = ShaderLike(64 * 1024, 1);
+    std::vector<uint8_t> compressed;
+    double compress = TestSupport::MeasureNanoseconds(static_cast<double>(shader.size()), [&]
+    {
+        Lz4Compress(shader.data(), shader.size(), compressed);
+        TestSupport::DoNotOptimize(compressed.data());
+    });
+
+    std::vector<uint8_t> decompressed(shader.size());
+    double decompress = TestSupport::MeasureNanoseconds(static_cast<double>(shader.size()), [&]
+    {
+        Lz4Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+        TestSupport::DoNotOptimize(decompressed.data());
+    });
+
+    TestSupport::Report("Lz4Compress, 64 KB of shader-like bytes", 1.0 / compress, "GB/s");
+    TestSupport::Report("Lz4Decompress", 1.0 / decompress, "GB/s");
+    TestSupport::Report("compressed size", 100.0 * compressed.size() / shader.size(), "%");
+}
+
+BENCHMARK(ShaderBundleFind)
+{
+    // 64 shaders of 4 KB, as a bundle of every sample's shaders would hold.
+    ShaderBundleWriter plain;
+    ShaderBundleWriter packed;
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        names.push_back("Shaders/Shader" + std::to_string(i) + ".cso");
+        plain.Add(names.back(), ShaderLike(4096, i), false);
+        packed.Add(names.back(), ShaderLike(4096, i), true);
+    }
+    ShaderBundlePtr plainBundle = ShaderBundle::Open(MakeAssetBlob(plain.Write()));
+    ShaderBundlePtr packedBundle = ShaderBundle::Open(MakeAssetBlob(packed.Write()));
+
+    size_t next = 0;
+    double inPlace = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(plainBundle->Find(names[next++ % names.size()]));
+    });
+    double decompressed = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(packedBundle->Find(names[next++ % names.size()]));
+    });
+    double open = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(ShaderBundle::Open(MakeAssetBlob(plain.Write())));
+    });
+    double write = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(plain.Write());
+    });
+
+    TestSupport::Report("Find among 64, uncompressed", inPlace, "ns/asset");
+    TestSupport::Report("Find among 64, LZ4 compressed 4 KB", decompressed, "ns/asset");
+    TestSupport::Report("Open, 64 entries (less the write below)", (open - write) / 1000, "us");
+}
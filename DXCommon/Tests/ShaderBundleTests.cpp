@@ -0,0 +1,275 @@
+#include "Core/ShaderBundle.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace DX;
+using namespace DX::ShaderBundleFormat;
+
+namespace
+{
+    std::vector<uint8_t> Bytes(const std::string& text)
+    {
+        return std::vector<uint8_t>(text.begin(), text.end());
+    }
+
+    std::string Text(const AssetBlobPtr& blob)
+    {
+        return blob == nullptr ? std::string("<null>") : std::string(reinterpret_cast<const char*>(blob->GetData()), blob->GetSize());
+    }
+
+    // Mostly repetitive, like compiled shader bytecode: runs of instruction tokens with a few
+    // varying operands.
+    std::vector<uint8_t> ShaderLike(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            data[i] = (i % 16 < 12) ? static_cast<uint8_t>(i % 16) : static_cast<uint8_t>(seed >> 24);
+        }
+        return data;
+    }
+
+    std::vector<uint8_t> Random(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(seed >> 24);
+        }
+        return data;
+    }
+
+    bool RoundTrips(const std::vector<uint8_t>& data, size_t* compressedSize = nullptr)
+    {
+        std::vector<uint8_t> compressed;
+        Lz4Compress(data.data(), data.size(), compressed);
+        if (compressedSize != nullptr)
+        {
+            *compressedSize = compressed.size();
+        }
+        std::vector<uint8_t> decompressed(data.size());
+        return Lz4Decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size()) && decompressed == data;
+    }
+
+    ShaderBundlePtr OpenBytes(std::vector<uint8_t> bytes)
+    {
+        return ShaderBundle::Open(MakeAssetBlob(std::move(bytes)));
+    }
+}
+
+TEST_CASE(Lz4DecodesTheReferenceBlockFormat)
+{
+    // Twenty 'a's as the reference encoder writes them: one literal with a 14 byte match at
+    // offset 1, then the five literals every block ends with.
+    const uint8_t block[] = { 0x1A, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    uint8_t output[20];
+    CHECK(Lz4Decompress(block, sizeof(block), output, sizeof(output)));
+    CHECK(std::string(reinterpret_cast<char*>(output), sizeof(output)) == std::string(20, 'a'));
+
+    // Sizes that don't match, and offsets before the start of the output, are rejected.
+    uint8_t longer[21];
+    CHECK(!Lz4Decompress(block, sizeof(block), longer, sizeof(longer)));
+    CHECK(!Lz4Decompress(block, sizeof(block), output, 19));
+    const uint8_t badOffset[] = { 0x1A, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    CHECK(!Lz4Decompress(badOffset, sizeof(badOffset), output, sizeof(output)));
+    CHECK(!Lz4Decompress(block, 3, output, sizeof(output)));
+}
+
+TEST_CASE(Lz4RoundTripsEveryKindOfInput)
+{
+    CHECK(RoundTrips({}));
+    CHECK(RoundTrips(Bytes("x")));
+    CHECK(RoundTrips(Bytes("abcdabcdabcd")));
+    CHECK(RoundTrips(Bytes("abcdabcdabcda")));
+
+    // Long literal runs and long matches use the extra length bytes.
+    size_t compressedSize = 0;
+    CHECK(RoundTrips(Random(1000, 1)));
+    CHECK(RoundTrips(std::vector<uint8_t>(100000, 7), &compressedSize));
+    CHECK(compressedSize < 500);
+
+    // Repeats further apart than the 64 KB window can't be matched, but still round trip.
+    std::vector<uint8_t> far = Random(70000, 2);
+    std::vector<uint8_t> repeated = far;
+    repeated.resize(far.size() + 5000);
+    std::copy(far.begin(), far.begin() + 5000, repeated.begin() + far.size());
+    CHECK(RoundTrips(repeated));
+
+    std::vector<uint8_t> shader = ShaderLike(20000, 3);
+    CHECK(RoundTrips(shader, &compressedSize));
+    CHECK(compressedSize < shader.size() * 3 / 4);
+
+    for (size_t size = 0; size < 64; size++)
+    {
+        CHECK(RoundTrips(ShaderLike(size, static_cast<uint32_t>(size))));
+    }
+}
+
+TEST_CASE(ShaderBundleWritesAndFindsAssets)
+{
+    ShaderBundleWriter writer;
+    writer.Add("Shaders/VertexShader.cso", Bytes("vertex"), false);
+    writer.Add("PixelShader.cso", ShaderLike(4000, 9), true);
+    writer.Add("Random.bin", Random(300, 4), true);
+    writer.Add("Empty.bin", {}, true);
+    writer.Add("Shaders/VertexShader.cso", Bytes("vertex v2"), false);
+
+    std::vector<uint8_t> bytes = writer.Write();
+    ShaderBundlePtr bundle = OpenBytes(bytes);
+    CHECK(bundle != nullptr);
+    if (bundle == nullptr)
+    {
+        return;
+    }
+
+    // Names are sorted, and adding a name again replaced it.
+    CHECK_EQUAL(4u, bundle->GetEntryCount());
+    CHECK_EQUAL(std::string("Empty.bin"), bundle->GetName(0));
+    CHECK_EQUAL(std::string("PixelShader.cso"), bundle->GetName(1));
+    CHECK_EQUAL(std::string("Random.bin"), bundle->GetName(2));
+    CHECK_EQUAL(std::string("Shaders/VertexShader.cso"), bundle->GetName(3));
+    CHECK_EQUAL(std::string("vertex v2"), Text(bundle->Find("Shaders/VertexShader.cso")));
+    CHECK(bundle->Find("Shaders/Vertex") == nullptr);
+    CHECK(bundle->Find("Zzz") == nullptr);
+    CHECK(bundle->Find("") == nullptr);
+
+    // Compression is kept only where it helps, and payloads start on 64 byte boundaries.
+    const BundleEntry* entries = reinterpret_cast<const BundleEntry*>(bytes.data() + sizeof(BundleHeader));
+    CHECK_EQUAL(0u, entries[0].flags);
+    CHECK_EQUAL(CompressedFlag, entries[1].flags);
+    CHECK_EQUAL(0u, entries[2].flags);
+    for (int i = 0; i < 4; i++)
+    {
+        CHECK_EQUAL(0u, entries[i].offset % PayloadAlignment);
+    }
+
+    AssetBlobPtr pixel = bundle->Find("PixelShader.cso");
+    std::vector<uint8_t> expected = ShaderLike(4000, 9);
+    CHECK(pixel != nullptr && pixel->GetSize() == 4000 && memcmp(pixel->GetData(), expected.data(), 4000) == 0);
+    AssetBlobPtr empty = bundle->Find("Empty.bin");
+    CHECK(empty != nullptr && empty->GetSize() == 0);
+
+    // Uncompressed assets point into the bundle and keep it alive.
+    AssetBlobPtr random = bundle->Find("Random.bin");
+    bundle.reset();
+    expected = Random(300, 4);
+    CHECK(random != nullptr && random->GetSize() == 300 && memcmp(random->GetData(), expected.data(), 300) == 0);
+}
+
+TEST_CASE(ShaderBundleRejectsMalformedBundles)
+{
+    ShaderBundleWriter writer;
+    writer.Add("a.cso", Bytes("first"), false);
+    writer.Add("b.cso", ShaderLike(1000, 1), true);
+    const std::vector<uint8_t> good = writer.Write();
+    CHECK(OpenBytes(good) != nullptr);
+    CHECK(ShaderBundle::Open(nullptr) == nullptr);
+    CHECK(OpenBytes(std::vector<uint8_t>(good.begin(), good.begin() + 8)) == nullptr);
+
+    auto corrupt = [&good](size_t offset, uint32_t value)
+    {
+        std::vector<uint8_t> bytes = good;
+        memcpy(bytes.data() + offset, &value, sizeof(value));
+        return OpenBytes(std::move(bytes));
+    };
+    const size_t firstEntry = sizeof(BundleHeader);
+    const size_t secondEntry = firstEntry + sizeof(BundleEntry);
+
+    CHECK(corrupt(offsetof(BundleHeader, magic), 0x12345678) == nullptr);
+    CHECK(corrupt(offsetof(BundleHeader, version), Version + 1) == nullptr);
+    CHECK(corrupt(offsetof(BundleHeader, entryCount), 1000000) == nullptr);
+    CHECK(corrupt(offsetof(BundleHeader, nameTableSize), 1000000) == nullptr);
+    CHECK(corrupt(firstEntry + offsetof(BundleEntry, nameLength), 100) == nullptr);
+    CHECK(corrupt(firstEntry + offsetof(BundleEntry, offset), static_cast<uint32_t>(good.size() + 1)) == nullptr);
+    CHECK(corrupt(firstEntry + offsetof(BundleEntry, storedSize), static_cast<uint32_t>(good.size())) == nullptr);
+    CHECK(corrupt(firstEntry + offsetof(BundleEntry, size), 6) == nullptr);
+    CHECK(corrupt(secondEntry + offsetof(BundleEntry, size), 0x7FFFFFFF) == nullptr);
+
+    // Names out of order would break the binary search.
+    CHECK(corrupt(secondEntry + offsetof(BundleEntry, nameOffset), 0) == nullptr);
+
+    // A truncated file fails to open rather than reading past its end.
+    CHECK(OpenBytes(std::vector<uint8_t>(good.begin(), good.end() - 1)) == nullptr);
+
+    // A corrupt compressed payload opens, but the asset isn't returned.
+    std::vector<uint8_t> bytes = good;
+    BundleEntry second;
+    memcpy(&second, bytes.data() + secondEntry, sizeof(second));
+    bytes[static_cast<size_t>(second.offset)] = 0xFF;
+    ShaderBundlePtr bundle = OpenBytes(std::move(bytes));
+    CHECK(bundle != nullptr && bundle->Find("b.cso") == nullptr && Text(bundle->Find("a.cso")) == "first");
+}
+
+TEST_CASE(ShaderBundleMountedInTheAssetCache)
+{
+    ShaderBundleWriter writer;
+    writer.Add("VertexShader.cso", Bytes("from bundle"), false);
+    writer.Add("Shaders/PixelShader.cso", Bytes("pixel from bundle"), true);
+    ShaderBundlePtr bundle = OpenBytes(writer.Write());
+
+    int loads = 0;
+    AssetCache cache([&loads](const std::wstring& path)
+    {
+        loads++;
+        return MakeAssetBlob(std::vector<uint8_t>(path.begin(), path.end()));
+    });
+    CHECK_EQUAL(std::string("ms-appx:///VertexShader.cso"), Text(cache.Get(L"ms-appx:///VertexShader.cso")));
+    cache.Mount(L"ms-appx:///", bundle);
+
+    // Cached assets are not affected; new ones come from the bundle, with '\' read as '/',
+    // and the ones it doesn't have still go to the loader.
+    CHECK_EQUAL(std::string("ms-appx:///VertexShader.cso"), Text(cache.Get(L"ms-appx:///VertexShader.cso")));
+    cache.Clear();
+    CHECK_EQUAL(std::string("from bundle"), Text(cache.Get(L"ms-appx:///VertexShader.cso")));
+    CHECK_EQUAL(std::string("pixel from bundle"), Text(cache.Get(L"ms-appx:///Shaders\\PixelShader.cso")));
+    CHECK_EQUAL(std::string("ms-appx:///Other.cso"), Text(cache.Get(L"ms-appx:///Other.cso")));
+    CHECK_EQUAL(std::string("other:///VertexShader.cso"), Text(cache.Get(L"other:///VertexShader.cso")));
+    CHECK_EQUAL(3, loads);
+}
+
+TEST_CASE(ShaderPackerPacksFilesByName)
+{
+    namespace fs = std::filesystem;
+    fs::path directory = fs::temp_directory_path() / "ShaderPackerTest";
+    fs::create_directories(directory / "x64");
+    std::vector<uint8_t> vertex = ShaderLike(3000, 5);
+    std::vector<uint8_t> pixel = Random(700, 6);
+    std::ofstream(directory / "x64" / "VertexShader.cso", std::ios::binary).write(reinterpret_cast<const char*>(vertex.data()), vertex.size());
+    std::ofstream(directory / "PixelShader.cso", std::ios::binary).write(reinterpret_cast<const char*>(pixel.data()), pixel.size());
+
+    fs::path output = directory / "Shaders.bundle";
+    std::string command = std::string("\"") + SHADER_PACKER_PATH + "\" --compress \"" + output.string() + "\" \"" +
+        (directory / "x64" / "VertexShader.cso").string() + "\" \"" + (directory / "PixelShader.cso").string() + "\" > /dev/null";
+    CHECK_EQUAL(0, std::system(command.c_str()));
+
+    // Each input is found by its file name, whichever directory it came from.
+    ShaderBundlePtr bundle = ShaderBundle::Open(LoadAssetFile(output.wstring()));
+    CHECK(bundle != nullptr);
+    if (bundle != nullptr)
+    {
+        CHECK_EQUAL(2u, bundle->GetEntryCount());
+        AssetBlobPtr foundVertex = bundle->Find("VertexShader.cso");
+        AssetBlobPtr foundPixel = bundle->Find("PixelShader.cso");
+        CHECK(foundVertex != nullptr && std::vector<uint8_t>(foundVertex->GetData(), foundVertex->GetData() + foundVertex->GetSize()) == vertex);
+        CHECK(foundPixel != nullptr && std::vector<uint8_t>(foundPixel->GetData(), foundPixel->GetData() + foundPixel->GetSize()) == pixel);
+    }
+
+    // A missing input is an error and writes nothing.
+    fs::remove(output);
+    command = std::string("\"") + SHADER_PACKER_PATH + "\" \"" + output.string() + "\" \"" + (directory / "Missing.cso").string() + "\" 2> /dev/null";
+    CHECK(std::system(command.c_str()) != 0);
+    CHECK(!fs::exists(output));
+
+    fs::remove_all(directory);
+}
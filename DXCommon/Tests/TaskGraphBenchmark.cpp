@@ -0,0 +1,95 @@
+#include "Core/TaskGraph.h"
+
+#include "Benchmark.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace DX;
+
+BENCHMARK(WorkStealingPoolTaskOverhead)
+{
+    WorkStealingPool pool(4);
+    const int Tasks = 10000;
+
+    // Tasks submitted from outside the pool, spread over the queues.
+    double external = TestSupport::MeasureNanoseconds(Tasks, [&]
+    {
+        std::atomic<int> done(0);
+        for (int i = 0; i < Tasks; i++)
+        {
+            pool.Submit([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+        }
+        while (done.load(std::memory_order_relaxed) < Tasks)
+        {
+            std::this_thread::yield();
+        }
+    });
+
+    // Tasks submitted by a worker to its own queue.
+    double internal = TestSupport::MeasureNanoseconds(Tasks, [&]
+    {
+        std::atomic<int> done(0);
+        pool.Submit([&]
+        {
+            for (int i = 0; i < Tasks; i++)
+            {
+                pool.Submit([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+        while (done.load(std::memory_order_relaxed) < Tasks)
+        {
+            std::this_thread::yield();
+        }
+    });
+
+    TestSupport::Report("Submit and run, from outside the pool", external, "ns/task");
+    TestSupport::Report("Submit and run, from a worker", internal, "ns/task");
+    TestSupport::Report("steals", static_cast<double>(pool.GetStealCount()), "tasks");
+}
+
+BENCHMARK(TaskGraphNodeOverhead)
+{
+    WorkStealingPool pool(4);
+
+    // The device resources graph of a holographic renderer: four shaders loaded and created,
+    // and a mesh, with empty work so only the graph's own cost is measured.
+    double renderer = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TaskGraph graph;
+        TaskGraph::NodeId created[4];
+        for (int i = 0; i < 4; i++)
+        {
+            TaskGraph::NodeId load = graph.Add("load", [] {});
+            created[i] = graph.Add("create", [] {}, { load });
+        }
+        TaskGraph::NodeId mesh = graph.Add("mesh", [] {});
+        graph.Add("ready", [] {}, { created[0], created[1], created[2], created[3], mesh });
+        TestSupport::DoNotOptimize(graph.RunAndWait(pool));
+    });
+
+    // A wide graph and a chain of 1000 nodes.
+    double wide = TestSupport::MeasureNanoseconds(1000, [&]
+    {
+        TaskGraph graph;
+        for (int i = 0; i < 1000; i++)
+        {
+            graph.Add("node", [] {});
+        }
+        TestSupport::DoNotOptimize(graph.RunAndWait(pool));
+    });
+    double chain = TestSupport::MeasureNanoseconds(1000, [&]
+    {
+        TaskGraph graph;
+        TaskGraph::NodeId previous = graph.Add("node", [] {});
+        for (int i = 1; i < 1000; i++)
+        {
+            previous = graph.Add("node", [] {}, { previous });
+        }
+        TestSupport::DoNotOptimize(graph.RunAndWait(pool));
+    });
+
+    TestSupport::Report("renderer graph, 10 nodes, build and run", renderer / 1000, "us");
+    TestSupport::Report("1000 independent nodes", wide, "ns/node");
+    TestSupport::Report("chain of 1000 nodes", chain, "ns/node");
+}
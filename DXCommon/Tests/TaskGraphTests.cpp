@@ -0,0 +1,210 @@
+#include "Core/TaskGraph.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    void SleepMilliseconds(int milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    }
+}
+
+TEST_CASE(WorkStealingPoolRunsEveryTaskBeforeItIsDestroyed)
+{
+    std::atomic<int> count(0);
+    {
+        WorkStealingPool pool(4);
+        CHECK_EQUAL(4u, pool.GetThreadCount());
+        for (int i = 0; i < 10000; i++)
+        {
+            pool.Submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    CHECK_EQUAL(10000, count.load());
+
+    WorkStealingPool defaultPool;
+    CHECK(defaultPool.GetThreadCount() >= 1);
+}
+
+TEST_CASE(WorkStealingPoolRunsAWorkersOwnTasksNewestFirst)
+{
+    // With one worker nothing is stolen, so the order is exactly the queue's.
+    std::mutex mutex;
+    std::vector<int> order;
+    {
+        WorkStealingPool pool(1);
+        pool.Submit([&]
+        {
+            for (int i = 0; i < 5; i++)
+            {
+                pool.Submit([&, i] { std::lock_guard<std::mutex> lock(mutex); order.push_back(i); });
+            }
+        });
+    }
+    CHECK(order == std::vector<int>({ 4, 3, 2, 1, 0 }));
+}
+
+TEST_CASE(WorkStealingPoolIdleWorkersStealQueuedTasks)
+{
+    // Every task is queued by one worker, so the others only get work by stealing it.
+    std::atomic<int> count(0);
+    std::mutex mutex;
+    std::vector<std::thread::id> threads;
+    uint64_t steals = 0;
+    {
+        WorkStealingPool pool(4);
+        pool.Submit([&]
+        {
+            for (int i = 0; i < 40; i++)
+            {
+                pool.Submit([&]
+                {
+                    SleepMilliseconds(1);
+                    count.fetch_add(1);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (std::find(threads.begin(), threads.end(), std::this_thread::get_id()) == threads.end())
+                    {
+                        threads.push_back(std::this_thread::get_id());
+                    }
+                });
+            }
+        });
+        while (count.load() < 40)
+        {
+            SleepMilliseconds(1);
+        }
+        steals = pool.GetStealCount();
+    }
+    CHECK_EQUAL(40, count.load());
+    CHECK(steals > 0);
+    CHECK(threads.size() > 1);
+}
+
+TEST_CASE(TaskGraphRunsNodesAfterTheirDependencies)
+{
+    WorkStealingPool pool(4);
+
+    // Layers of nodes, each depending on two nodes of the layer before, with every node
+    // recording when it finished.
+    for (int repeat = 0; repeat < 20; repeat++)
+    {
+        TaskGraph graph;
+        std::atomic<int> clock(0);
+        std::vector<int> finished(64, -1);
+        std::vector<std::pair<size_t, size_t>> dependencies(64);
+        for (size_t i = 0; i < 64; i++)
+        {
+            if (i < 8)
+            {
+                graph.Add("root", [&, i] { finished[i] = clock.fetch_add(1); });
+                continue;
+            }
+            size_t a = i - 8;
+            size_t b = (i / 8 - 1) * 8 + (i + 3) % 8;
+            dependencies[i] = { a, b };
+            graph.Add("node", [&, i] { finished[i] = clock.fetch_add(1); }, { a, b });
+        }
+        CHECK_EQUAL(64u, graph.GetNodeCount());
+
+        TaskGraph::Result result = graph.RunAndWait(pool);
+        CHECK(result.error == nullptr);
+        CHECK_EQUAL(0u, graph.GetNodeCount());
+        CHECK_EQUAL(64, clock.load());
+        bool ordered = true;
+        for (size_t i = 8; i < 64; i++)
+        {
+            ordered = ordered && finished[i] > finished[dependencies[i].first] && finished[i] > finished[dependencies[i].second];
+        }
+        CHECK(ordered);
+    }
+}
+
+TEST_CASE(TaskGraphRejectsForwardDependenciesAndRunsEmptyGraphs)
+{
+    TaskGraph graph;
+    TaskGraph::NodeId first = graph.Add("first", [] {});
+    bool threw = false;
+    try
+    {
+        graph.Add("second", [] {}, { first + 1 });
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(1u, graph.GetNodeCount());
+
+    WorkStealingPool pool(2);
+    TaskGraph empty;
+    int completions = 0;
+    empty.Run(pool, [&completions](const TaskGraph::Result& result)
+    {
+        completions++;
+        CHECK(result.nodes.empty() && result.criticalPathNodes.empty());
+    });
+    CHECK_EQUAL(1, completions);
+}
+
+TEST_CASE(TaskGraphStopsAfterTheFirstError)
+{
+    WorkStealingPool pool(2);
+    TaskGraph graph;
+    std::atomic<bool> ranAfter(false);
+    TaskGraph::NodeId load = graph.Add("load", [] { throw std::runtime_error("missing shader"); });
+    graph.Add("create", [&ranAfter] { ranAfter = true; }, { load });
+
+    TaskGraph::Result result = graph.RunAndWait(pool);
+    CHECK(result.error != nullptr);
+    CHECK(!ranAfter.load());
+    CHECK_EQUAL(2u, result.nodes.size());
+
+    std::string message;
+    try
+    {
+        std::rethrow_exception(result.error);
+    }
+    catch (const std::runtime_error& error)
+    {
+        message = error.what();
+    }
+    CHECK_EQUAL(std::string("missing shader"), message);
+}
+
+TEST_CASE(TaskGraphReportsTheCriticalPath)
+{
+    // load VS > create VS is the longest chain; the mesh runs alongside it.
+    WorkStealingPool pool(4);
+    TaskGraph graph;
+    TaskGraph::NodeId loadVs = graph.Add("load VS", [] { SleepMilliseconds(30); });
+    TaskGraph::NodeId createVs = graph.Add("create VS", [] { SleepMilliseconds(20); }, { loadVs });
+    TaskGraph::NodeId mesh = graph.Add("mesh", [] { SleepMilliseconds(25); });
+    graph.Add("ready", [] {}, { createVs, mesh });
+
+    TaskGraph::Result result = graph.RunAndWait(pool);
+    CHECK(result.criticalPathNodes == std::vector<TaskGraph::NodeId>({ 0, 1, 3 }));
+    CHECK(result.criticalPath >= 0.050);
+    CHECK(result.totalWork >= 0.075);
+    CHECK(result.elapsed >= result.criticalPath);
+
+    // Running in parallel, the graph takes about as long as its critical path, not its total work.
+    CHECK(result.elapsed < result.totalWork);
+    CHECK(result.nodes[2].start < result.nodes[1].start);
+
+    std::string description = result.DescribeCriticalPath();
+    CHECK(description.find("load VS ") == 0);
+    CHECK(description.find(" ms > create VS ") != std::string::npos);
+    CHECK(description.find(" ms > ready ") != std::string::npos);
+}
@@ -0,0 +1,52 @@
+#include "Core/Trace.h"
+
+#include "Benchmark.h"
+
+BENCHMARK(TraceScope)
+{
+    // The budget for an enabled scope is its two clock reads plus 5 ns. It was 30 ns in all,
+    // but a TSC read alone is 20-25 ns on some machines and VMs, and no scope can avoid reading
+    // the clock at both ends, so the budget is now on what the trace adds to those reads.
+    const int ScopesPerCall = 1000;
+    DX::Trace::SetEnabled(true);
+    double enabled = TestSupport::MeasureNanoseconds(ScopesPerCall, []
+    {
+        for (int i = 0; i < ScopesPerCall; ++i)
+        {
+            DX_TRACE_SCOPE("Frame");
+        }
+    });
+    double withValue = TestSupport::MeasureNanoseconds(ScopesPerCall, []
+    {
+        for (int i = 0; i < ScopesPerCall; ++i)
+        {
+            DX_TRACE_SCOPE_VALUE("Camera", i);
+        }
+    });
+
+    DX::Trace::SetEnabled(false);
+    double disabled = TestSupport::MeasureNanoseconds(ScopesPerCall, []
+    {
+        for (int i = 0; i < ScopesPerCall; ++i)
+        {
+            DX_TRACE_SCOPE("Frame");
+        }
+    });
+    DX::Trace::SetEnabled(true);
+    DX::Trace::Clear();
+
+    double clock = TestSupport::MeasureNanoseconds(ScopesPerCall, []
+    {
+        for (int i = 0; i < ScopesPerCall; ++i)
+        {
+            TestSupport::DoNotOptimize(DX::Trace::Now());
+        }
+    });
+
+    TestSupport::Report("enabled scope", enabled, "ns/scope");
+    TestSupport::Report("enabled scope with a value", withValue, "ns/scope");
+    TestSupport::Report("disabled scope", disabled, "ns/scope");
+    TestSupport::Report("trace clock read", clock, "ns/read");
+    TestSupport::Report("enabled scope, in trace clock reads", enabled / clock, "reads/scope");
+    TestSupport::Report("enabled scope, beyond its two clock reads", enabled - 2 * clock, "ns/scope");
+}
@@ -0,0 +1,139 @@
+#include "Core/Trace.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace
+{
+    std::string WriteTrace()
+    {
+        std::ostringstream stream;
+        DX::Trace::WriteChromeJson(stream);
+        return stream.str();
+    }
+
+    size_t Count(const std::string& text, const std::string& pattern)
+    {
+        size_t count = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+}
+
+TEST_CASE(TraceScopesAreWrittenAsCompleteEvents)
+{
+    DX::Trace::Clear();
+    {
+        DX_TRACE_SCOPE("TraceTestOuter");
+        DX_TRACE_SCOPE_VALUE("TraceTestInner", 42);
+    }
+
+    const std::string json = WriteTrace();
+    CHECK(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0);
+    CHECK_EQUAL(size_t(1), Count(json, "\"name\":\"TraceTestOuter\",\"ph\":\"X\""));
+    CHECK_EQUAL(size_t(1), Count(json, "\"name\":\"TraceTestInner\",\"ph\":\"X\""));
+    CHECK_EQUAL(size_t(1), Count(json, "\"args\":{\"value\":42}"));
+}
+
+TEST_CASE(TraceClearDropsEarlierEvents)
+{
+    {
+        DX_TRACE_SCOPE("TraceTestBeforeClear");
+    }
+    DX::Trace::Clear();
+    {
+        DX_TRACE_SCOPE("TraceTestAfterClear");
+    }
+
+    const std::string json = WriteTrace();
+    CHECK_EQUAL(size_t(0), Count(json, "TraceTestBeforeClear"));
+    CHECK_EQUAL(size_t(1), Count(json, "TraceTestAfterClear"));
+}
+
+TEST_CASE(TraceDisabledScopesRecordNothing)
+{
+    DX::Trace::Clear();
+    DX::Trace::SetEnabled(false);
+    {
+        DX_TRACE_SCOPE("TraceTestDisabled");
+    }
+    DX::Trace::SetEnabled(true);
+
+    CHECK(DX::Trace::IsEnabled());
+    CHECK_EQUAL(size_t(0), Count(WriteTrace(), "TraceTestDisabled"));
+}
+
+TEST_CASE(TraceKeepsTheLatestEventsOfAFullRing)
+{
+    DX::Trace::Clear();
+    std::thread writer([]
+    {
+        DX_TRACE_THREAD_NAME("TraceTestWriter");
+        for (size_t i = 0; i < DX::Trace::EventsPerThread + 100; ++i)
+        {
+            DX_TRACE_SCOPE_VALUE("TraceTestRing", i);
+        }
+    });
+    writer.join();
+
+    const std::string json = WriteTrace();
+    CHECK_EQUAL(DX::Trace::EventsPerThread, Count(json, "\"name\":\"TraceTestRing\""));
+    CHECK_EQUAL(size_t(0), Count(json, "\"args\":{\"value\":99}"));
+    CHECK_EQUAL(size_t(1), Count(json, "\"args\":{\"value\":100}"));
+    CHECK_EQUAL(size_t(1), Count(json, "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"));
+    CHECK(json.find("\"args\":{\"name\":\"TraceTestWriter\"}") != std::string::npos);
+}
+
+TEST_CASE(TraceCopiesOnlyWholeEventsWhileTheRingIsRewritten)
+{
+    // The writer names each event by whether its lap of the ring is even or odd, so a slot
+    // copied while it was being rewritten would pair one lap's name with another's value.
+    DX::Trace::Clear();
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> recorded(0);
+    std::thread writer([&stop, &recorded]
+    {
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+        {
+            recorded.store(i, std::memory_order_relaxed);
+            const uint64_t now = DX::Trace::Now();
+            DX::Trace::Record((i / DX::Trace::EventsPerThread) % 2 == 0 ? "TraceTestEvenLap" : "TraceTestOddLap", now, now, static_cast<int64_t>(i), true);
+        }
+    });
+
+    while (recorded.load(std::memory_order_relaxed) < 2 * DX::Trace::EventsPerThread)
+    {
+        std::this_thread::yield();
+    }
+
+    size_t events = 0;
+    bool whole = true;
+    for (int write = 0; write < 20; ++write)
+    {
+        const std::string json = WriteTrace();
+        for (size_t at = json.find("\"name\":\"TraceTest"); at != std::string::npos; at = json.find("\"name\":\"TraceTest", at + 1))
+        {
+            const bool even = json.compare(at, 24, "\"name\":\"TraceTestEvenLap") == 0;
+            if (!even && json.compare(at, 23, "\"name\":\"TraceTestOddLap") != 0)
+            {
+                continue;
+            }
+            const size_t value = json.find("\"value\":", at);
+            const uint64_t i = std::stoull(json.substr(value + 8, 20));
+            whole = whole && even == ((i / DX::Trace::EventsPerThread) % 2 == 0);
+            ++events;
+        }
+    }
+    stop.store(true);
+    writer.join();
+
+    CHECK(whole);
+    CHECK(events > 0);
+}
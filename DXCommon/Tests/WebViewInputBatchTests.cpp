@@ -0,0 +1,122 @@
+#include "Core/WebViewInputBatch.h"
+
+#include "Check.h"
+
+#include <thread>
+
+using namespace DX;
+
+TEST_CASE(WebViewInputBatchEmptyFlushReturnsFalse)
+{
+    WebViewInputBatch batch;
+    std::wstring argument = L"unchanged";
+    CHECK(!batch.Flush(argument));
+    CHECK(argument == L"unchanged");
+}
+
+TEST_CASE(WebViewInputBatchSerializesEachCommand)
+{
+    WebViewInputBatch batch;
+    batch.Click(10, 20);
+    batch.Scroll(-3, 4);
+    batch.Key(65);
+
+    std::wstring argument;
+    CHECK(batch.Flush(argument));
+    CHECK(argument == L"c,10,20;s,-3,4;k,65");
+    CHECK(!batch.Flush(argument));
+}
+
+TEST_CASE(WebViewInputBatchMergesConsecutiveScrolls)
+{
+    WebViewInputBatch batch;
+    batch.Scroll(1, 2);
+    batch.Scroll(3, 4);
+    batch.Scroll(0, 0);
+    batch.Click(5, 6);
+    batch.Scroll(-1, -1);
+
+    std::wstring argument;
+    CHECK(batch.Flush(argument));
+    CHECK(argument == L"s,4,6;c,5,6;s,-1,-1");
+}
+
+TEST_CASE(WebViewInputBatchRunsOfKeysShareOneCommand)
+{
+    WebViewInputBatch batch;
+    batch.Key(72);
+    batch.Key(105);
+    batch.Key(8);
+    batch.Click(0, 0);
+    batch.Key(33);
+
+    std::wstring argument;
+    CHECK(batch.Flush(argument));
+    CHECK(argument == L"k,72,105,8;c,0,0;k,33");
+}
+
+TEST_CASE(WebViewInputBatchFormatsExtremeCoordinates)
+{
+    WebViewInputBatch batch;
+    batch.Click(-2147483647 - 1, 2147483647);
+
+    std::wstring argument;
+    CHECK(batch.Flush(argument));
+    CHECK(argument == L"c,-2147483648,2147483647");
+}
+
+TEST_CASE(WebViewInputBatchClearDropsPendingInput)
+{
+    WebViewInputBatch batch;
+    batch.Click(1, 1);
+    batch.Clear();
+
+    std::wstring argument;
+    CHECK(!batch.Flush(argument));
+    batch.Key(49);
+    CHECK(batch.Flush(argument));
+    CHECK(argument == L"k,49");
+}
+
+TEST_CASE(WebViewInputBatchCollectsFromSeveralThreads)
+{
+    WebViewInputBatch batch;
+    const int ThreadCount = 4;
+    const int ClicksPerThread = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([&batch, t]
+        {
+            for (int i = 0; i < ClicksPerThread; ++i)
+            {
+                batch.Click(t, i);
+            }
+        });
+    }
+
+    // Flushing while the threads run must neither lose nor repeat a click.
+    const size_t Total = ThreadCount * ClicksPerThread;
+    size_t clicks = 0;
+    std::wstring argument;
+    while (clicks < Total)
+    {
+        if (batch.Flush(argument))
+        {
+            for (wchar_t c : argument)
+            {
+                clicks += c == L'c';
+            }
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(!batch.Flush(argument));
+    CHECK_EQUAL(Total, clicks);
+}
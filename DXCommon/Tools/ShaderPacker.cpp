@@ -0,0 +1,83 @@
+// Packs compiled shaders and other small assets into one bundle that apps mount with
+// DX::MountAssetBundle. Standard C++ only, so it builds wherever the content is built:
+//
+//     g++ -std=c++17 -O2 ShaderPacker.cpp ../Core/ShaderBundle.cpp ../Core/AssetCache.cpp -o ShaderPacker
+//     cl /std:c++17 /O2 /EHsc ShaderPacker.cpp ..\Core\ShaderBundle.cpp ..\Core\AssetCache.cpp
+//
+// Usage: ShaderPacker [--compress] <output bundle> <input file>...
+//
+// Each input is stored under its file name, so "x64\Release\VertexShader.cso" is found as
+// ms-appx:///VertexShader.cso once the bundle is mounted from the package root.
+
+#include "../Core/ShaderBundle.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    bool ReadFile(const char* path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !file.bad();
+    }
+
+    std::string FileName(const std::string& path)
+    {
+        size_t separator = path.find_last_of("/\\");
+        return separator == std::string::npos ? path : path.substr(separator + 1);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool compress = false;
+    int first = 1;
+    if (first < argc && strcmp(argv[first], "--compress") == 0)
+    {
+        compress = true;
+        ++first;
+    }
+    if (argc - first < 2)
+    {
+        fprintf(stderr, "Usage: ShaderPacker [--compress] <output bundle> <input file>...\n");
+        return 2;
+    }
+
+    const char* output = argv[first];
+    DX::ShaderBundleWriter writer;
+    size_t inputBytes = 0;
+    for (int i = first + 1; i < argc; ++i)
+    {
+        std::vector<uint8_t> data;
+        if (!ReadFile(argv[i], data))
+        {
+            fprintf(stderr, "ShaderPacker: can't read %s\n", argv[i]);
+            return 1;
+        }
+        inputBytes += data.size();
+        writer.Add(FileName(argv[i]), std::move(data), compress);
+    }
+
+    std::vector<uint8_t> bundle = writer.Write();
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bundle.data()), static_cast<std::streamsize>(bundle.size()));
+    file.close();
+    if (!file)
+    {
+        fprintf(stderr, "ShaderPacker: can't write %s\n", output);
+        return 1;
+    }
+
+    printf("%s: %d assets, %zu bytes in, %zu bytes out\n", output, argc - first - 1, inputBytes, bundle.size());
+    return 0;
+}
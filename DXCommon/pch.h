@@ -0,0 +1,15 @@
+#pragma once
+
+#include <agile.h>
+#include <array>
+#include <d2d1_2.h>
+#include <d3d11_4.h>
+#include <DirectXColors.h>
+#include <dwrite_2.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <wincodec.h>
+#include <WindowsNumerics.h>
+#include <wrl.h>
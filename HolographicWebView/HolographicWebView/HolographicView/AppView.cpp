@@ -1,5 +1,7 @@
 ﻿#include "pch.h"
 #include "AppView.h"
+#include "Common\DirectXHelper.h"
+#include "Core\Trace.h"
 
 #include <ppltasks.h>
 
@@ -42,6 +44,16 @@ void AppView::Initialize(CoreApplicationView^ applicationView)
     CoreApplication::Resuming +=
         ref new EventHandler<Platform::Object^>(this, &AppView::OnResuming);
 
+    // Start reading the shaders now so that the reads overlap with device creation; the
+    // renderers pick them up from the shared asset cache. Shaders.bundle is used when the
+    // package has one and the individual .cso files otherwise.
+    DX::MountAssetBundle(L"ms-appx:///Shaders.bundle");
+    DX::PrefetchAssets({
+        L"ms-appx:///VertexShader.cso",
+        L"ms-appx:///VprtVertexShader.cso",
+        L"ms-appx:///GeometryShader.cso",
+        L"ms-appx:///PixelShader.cso" });
+
     // At this point we have access to the device and we can create device-dependent
     // resources.
     m_deviceResources = std::make_shared<DX::DeviceResources>();
@@ -93,6 +105,8 @@ void AppView::Load(Platform::String^ entryPoint)
 // update, draw, and present loop, and it also oversees window message processing.
 void AppView::Run()
 {
+    DX_TRACE_THREAD_NAME("Frame loop");
+
     while (!m_windowClosed)
     {
         if (m_windowVisible && (m_holographicSpace != nullptr))
@@ -105,6 +119,7 @@ void AppView::Run()
             {
                 // The holographic frame has an API that presents the swap chain for each
                 // holographic camera.
+                DX_TRACE_SCOPE("Present");
                 m_deviceResources->Present(holographicFrame);
             }
         }
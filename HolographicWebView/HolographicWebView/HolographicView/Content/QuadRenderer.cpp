@@ -11,8 +11,12 @@
 
 #include "pch.h"
 #include "QuadRenderer.h"
+#include "Common\D3D11CommandSink.h"
 #include "Common\DirectXHelper.h"
+#include "Core\PixelKernels.h"
+#include "Core\Trace.h"
 #include <robuffer.h> // IBufferByteAccess
+#include <sstream>
 
 using namespace Concurrency;
 using namespace DirectX;
@@ -168,23 +172,15 @@ namespace HolographicWebView
 
         if (m_webViewImageInfo != nullptr)
         {
+            DX_TRACE_SCOPE("Texture upload");
+
             std::unique_lock<std::mutex> lock(m_mutex);
             D3D11_MAPPED_SUBRESOURCE mapped;
             const auto context = m_deviceResources->GetD3DDeviceContext();
 
             context->Map(m_quadTexture.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
-            unsigned int count = m_webViewImageInfo->PixelData->Length;
-            byte* data1 = (byte*)mapped.pData;
-            byte* data2 = m_webViewImageInfo->PixelData->Data;
-            auto r = mapped.RowPitch;
-            auto d = mapped.DepthPitch;
             unsigned int length = m_width * 4;
-            for(int i = 0; i < m_height; ++i)
-            {
-                memcpy((void*)data1, (void*)data2, length);
-                data1 += mapped.RowPitch;
-                data2 += length;
-            }
+            DX::CopyPixelRows(mapped.pData, mapped.RowPitch, m_webViewImageInfo->PixelData->Data, length, length, m_height);
 
             context->Unmap(m_quadTexture.Get(), 0);
 
@@ -192,74 +188,51 @@ namespace HolographicWebView
             m_webViewImageInfo = nullptr;
         }
 
-        // Each vertex is one instance of the VertexPositionColor struct.
-        const UINT stride = sizeof(VertexPositionColorTex);
-        const UINT offset = 0;
-        context->IASetVertexBuffers(
-            0,
-            1,
-            m_vertexBuffer.GetAddressOf(),
-            &stride,
-            &offset
-        );
-        context->IASetIndexBuffer(
-            m_indexBuffer.Get(),
-            DXGI_FORMAT_R16_UINT, // Each index is one 16-bit unsigned integer (short).
-            0
-        );
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        context->IASetInputLayout(m_inputLayout.Get());
+        // Record the draw with all the state it needs. The recorder only sends the state that
+        // differs from what the device already has, so the second camera in a frame usually
+        // costs just the draw call.
+        m_commands.SetVertexBuffer(m_vertexBuffer.Get(), sizeof(VertexPositionColorTex), 0);
+        m_commands.SetIndexBuffer(m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT); // Each index is one 16-bit unsigned integer (short).
+        m_commands.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_commands.SetInputLayout(m_inputLayout.Get());
 
-        // Attach the vertex shader.
-        context->VSSetShader(
-            m_vertexShader.Get(),
-            nullptr,
-            0
-        );
-        // Apply the model constant buffer to the vertex shader.
-        context->VSSetConstantBuffers(
-            0,
-            1,
-            m_modelConstantBuffer.GetAddressOf()
-        );
+        // Attach the vertex shader and the model constant buffer.
+        m_commands.SetVertexShader(m_vertexShader.Get());
+        m_commands.SetVSConstantBuffer(0, m_modelConstantBuffer.Get());
 
-        if (!m_usingVprtShaders)
-        {
-            // On devices that do not support the D3D11_FEATURE_D3D11_OPTIONS3::
-            // VPAndRTArrayIndexFromAnyShaderFeedingRasterizer optional feature,
-            // a pass-through geometry shader sets the render target ID.
-            context->GSSetShader(
-                m_geometryShader.Get(),
-                nullptr,
-                0
-            );
-        }
+        // On devices that do not support the D3D11_FEATURE_D3D11_OPTIONS3::
+        // VPAndRTArrayIndexFromAnyShaderFeedingRasterizer optional feature,
+        // a pass-through geometry shader sets the render target ID.
+        m_commands.SetGeometryShader(m_usingVprtShaders ? nullptr : m_geometryShader.Get());
 
         // Attach the pixel shader.
-        context->PSSetShader(
-            m_pixelShader.Get(),
-            nullptr,
-            0
-        );
-        context->PSSetShaderResources(
-            0,
-            1,
-            m_quadTextureView.GetAddressOf()
-        );
-        context->PSSetSamplers(
-            0,
-            1,
-            m_quadTextureSamplerState.GetAddressOf()
-        );
+        m_commands.SetPixelShader(m_pixelShader.Get());
+        m_commands.SetPSShaderResource(0, m_quadTextureView.Get());
+        m_commands.SetPSSampler(0, m_quadTextureSamplerState.Get());
 
-        // Draw the objects.
-        context->DrawIndexedInstanced(
-            m_indexCount,   // Index count per instance.
-            2,              // Instance count.
-            0,              // Start index location.
-            0,              // Base vertex location.
-            0               // Start instance location.
-        );
+        // Draw the objects: index count per instance, instance count, start index location,
+        // base vertex location and start instance location.
+        m_commands.DrawIndexedInstanced(m_indexCount, 2, 0, 0, 0);
+
+        DX::D3D11CommandSink sink(context);
+        m_commands.Replay(sink);
+    }
+
+    // Starts a new frame in the command recorder. Call once per frame, before the first camera.
+    void QuadRenderer::BeginFrame()
+    {
+        m_commands.BeginFrame();
+
+        // Every few seconds, report how much redundant state the recorder filtered out.
+        if (m_commands.GetFrameCount() % 300 == 0)
+        {
+            const auto& stats = m_commands.GetLastFrameStats();
+            std::wstringstream w;
+            w << L"QuadRenderer draws:" << stats.draws
+              << L" state changes applied:" << stats.stateChangesApplied
+              << L" saved per frame:" << stats.StateChangesSaved() << std::endl;
+            OutputDebugString(w.str().c_str());
+        }
     }
 
     void QuadRenderer::OnWebViewImage(MainPage^ sender, WebViewImageInfo^ imageInfo)
@@ -296,24 +269,41 @@ namespace HolographicWebView
         // can avoid using geometry shaders to set the render target array index.
         std::wstring vertexShaderFileName = m_usingVprtShaders ? L"ms-appx:///VprtVertexShader.cso" : L"ms-appx:///VertexShader.cso";
 
-        // Load shaders asynchronously.
-        task<std::vector<byte>> loadVSTask = DX::ReadDataAsync(vertexShaderFileName);
-        task<std::vector<byte>> loadPSTask = DX::ReadDataAsync(L"ms-appx:///PixelShader.cso");
+        // Resources are created as a graph on the shared pool: each shader as soon as its file
+        // is loaded, and the quad alongside the shaders, since it doesn't use them.
+        DX::TaskGraph graph;
+        auto vertexShaderFile = std::make_shared<DX::AssetBlobPtr>();
+        auto pixelShaderFile = std::make_shared<DX::AssetBlobPtr>();
+        auto geometryShaderFile = std::make_shared<DX::AssetBlobPtr>();
 
-        task<std::vector<byte>> loadGSTask;
+        DX::TaskGraph::NodeId loadVS = graph.Add("load vertex shader", [vertexShaderFile, vertexShaderFileName]()
+        {
+            *vertexShaderFile = DX::ReadAsset(vertexShaderFileName);
+        });
+        DX::TaskGraph::NodeId loadPS = graph.Add("load pixel shader", [pixelShaderFile]()
+        {
+            *pixelShaderFile = DX::ReadAsset(L"ms-appx:///PixelShader.cso");
+        });
+
+        DX::TaskGraph::NodeId loadGS = 0;
         if (!m_usingVprtShaders)
         {
             // Load the pass-through geometry shader.
-            loadGSTask = DX::ReadDataAsync(L"ms-appx:///GeometryShader.cso");
+            loadGS = graph.Add("load geometry shader", [geometryShaderFile]()
+            {
+                *geometryShaderFile = DX::ReadAsset(L"ms-appx:///GeometryShader.cso");
+            });
         }
 
         // After the vertex shader file is loaded, create the shader and input layout.
-        task<void> createVSTask = loadVSTask.then([this](const std::vector<byte>& fileData)
+        graph.Add("create vertex shader", [this, vertexShaderFile]()
         {
+            const DX::AssetBlobPtr& fileData = *vertexShaderFile;
+
             DX::ThrowIfFailed(
                 m_deviceResources->GetD3DDevice()->CreateVertexShader(
-                    fileData.data(),
-                    fileData.size(),
+                    fileData->GetData(),
+                    fileData->GetSize(),
                     nullptr,
                     &m_vertexShader
                 )
@@ -332,20 +322,22 @@ namespace HolographicWebView
                 m_deviceResources->GetD3DDevice()->CreateInputLayout(
                     vertexDesc.data(),
                     static_cast<UINT>(vertexDesc.size()),
-                    fileData.data(),
-                    static_cast<UINT>(fileData.size()),
+                    fileData->GetData(),
+                    static_cast<UINT>(fileData->GetSize()),
                     &m_inputLayout
                 )
             );
-        });
+        }, { loadVS });
 
         // After the pixel shader file is loaded, create the shader and constant buffer.
-        task<void> createPSTask = loadPSTask.then([this](const std::vector<byte>& fileData)
+        graph.Add("create pixel shader", [this, pixelShaderFile]()
         {
+            const DX::AssetBlobPtr& fileData = *pixelShaderFile;
+
             DX::ThrowIfFailed(
                 m_deviceResources->GetD3DDevice()->CreatePixelShader(
-                    fileData.data(),
-                    fileData.size(),
+                    fileData->GetData(),
+                    fileData->GetSize(),
                     nullptr,
                     &m_pixelShader
                 )
@@ -359,28 +351,27 @@ namespace HolographicWebView
                     &m_modelConstantBuffer
                 )
             );
-        });
+        }, { loadPS });
 
-        task<void> createGSTask;
         if (!m_usingVprtShaders)
         {
             // After the geometry shader file is loaded, create the shader.
-            createGSTask = loadGSTask.then([this](const std::vector<byte>& fileData)
+            graph.Add("create geometry shader", [this, geometryShaderFile]()
             {
+                const DX::AssetBlobPtr& fileData = *geometryShaderFile;
+
                 DX::ThrowIfFailed(
                     m_deviceResources->GetD3DDevice()->CreateGeometryShader(
-                        fileData.data(),
-                        fileData.size(),
+                        fileData->GetData(),
+                        fileData->GetSize(),
                         nullptr,
                         &m_geometryShader
                     )
                 );
-            });
+            }, { loadGS });
         }
 
-        // Once all shaders are loaded, create the mesh.
-        task<void> shaderTaskGroup = m_usingVprtShaders ? (createPSTask && createVSTask) : (createPSTask && createVSTask && createGSTask);
-        task<void> finishLoadingTask = shaderTaskGroup.then([this]()
+        graph.Add("create quad", [this]()
         {
             // Load mesh vertices. Each vertex has a position and a color.
             // Note that the quad size has changed from the default DirectX app
@@ -490,14 +481,18 @@ namespace HolographicWebView
                     &m_quadTextureSamplerState
                 )
             );
+        });
 
-            // After the assets are loaded, the quad is ready to be rendered.
-            m_loadingComplete = true;
+        // Once everything is created, the quad is ready to be rendered.
+        graph.Run(DX::GetSharedWorkStealingPool(), [this](const DX::TaskGraph::Result& result)
+        {
+            m_loadingComplete = DX::ReportResourceCreation("QuadRenderer", result);
         });
     }
 
     void QuadRenderer::ReleaseDeviceDependentResources()
     {
+        m_commands.InvalidateDeviceState();
         m_loadingComplete = false;
         m_usingVprtShaders = false;
 
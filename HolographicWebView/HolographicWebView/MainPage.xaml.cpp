@@ -151,9 +151,19 @@ task<void> MainPage::UpdateWebViewBitmap(unsigned int width, unsigned int height
     }).then([this]()
     {
         UpdateWebView();
-        std::wstringstream w;
-        w << L" FPS:" << m_timer.GetFramesPerSecond() << std::endl;
-        OutputDebugString(w.str().c_str());
+
+        // Report frame time percentiles about once a second; the FPS counter alone hides stutter.
+        if (m_timer.GetFrameCount() % 60 == 0)
+        {
+            auto stats = m_timer.GetPercentiles();
+            std::wstringstream w;
+            w << L" FPS:" << m_timer.GetFramesPerSecond()
+              << L" p50:" << stats.p50 * 1000.0 << L"ms"
+              << L" p95:" << stats.p95 * 1000.0 << L"ms"
+              << L" p99:" << stats.p99 * 1000.0 << L"ms"
+              << L" hitches:" << m_timer.GetHitchCount() << std::endl;
+            OutputDebugString(w.str().c_str());
+        }
     });
 }
 
@@ -6,7 +6,7 @@
 #pragma once
 
 #include "MainPage.g.h"
-#include "Common/StepTimer.h"
+#include "Core\FrameTimer.h"
 #include <vector>
 #include <ppltasks.h>
 #include <functional>
@@ -52,7 +52,7 @@ namespace HolographicWebView
         void OnWebContentLoaded(Windows::UI::Xaml::Controls::WebView ^ webview, Windows::UI::Xaml::Controls::WebViewNavigationCompletedEventArgs^ args);
 
         Platform::Agile<Windows::ApplicationModel::Core::CoreApplicationView> m_holographicView;
-        DX::StepTimer m_timer;
+        DX::FrameTimer m_timer;
         Windows::Graphics::Imaging::BitmapTransform^ m_transform;
 
         int m_requestedWebViewWidth;
@@ -279,6 +279,12 @@ bool MRAppServiceDemoMain::Render(Windows::Graphics::Holographic::HolographicFra
     // matrix, such as lighting maps.
     //
 
+#ifdef DRAW_SAMPLE_CONTENT
+    // The renderer replays its draws through a command recorder that skips state the
+    // device already has; state set by the previous frame can't be trusted.
+    m_spinningCubeRenderer->BeginFrame();
+#endif
+
     // Lock the set of holographic camera resources, then draw to each camera
     // in this frame.
     return m_deviceResources->UseHolographicCameraResources<bool>(
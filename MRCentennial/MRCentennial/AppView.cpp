@@ -1,5 +1,6 @@
 ﻿#include "pch.h"
 #include "AppView.h"
+#include "Common\DirectXHelper.h"
 
 #include <ppltasks.h>
 
@@ -49,6 +50,16 @@ void AppView::Initialize(CoreApplicationView^ applicationView)
     CoreApplication::Resuming +=
         ref new EventHandler<Platform::Object^>(this, &AppView::OnResuming);
 
+    // Start reading the shaders now so that the reads overlap with device creation; the
+    // renderers pick them up from the shared asset cache. Shaders.bundle is used when the
+    // package has one and the individual .cso files otherwise.
+    DX::MountAssetBundle(L"ms-appx:///Shaders.bundle");
+    DX::PrefetchAssets({
+        L"ms-appx:///VertexShader.cso",
+        L"ms-appx:///VprtVertexShader.cso",
+        L"ms-appx:///GeometryShader.cso",
+        L"ms-appx:///PixelShader.cso" });
+
     // At this point we have access to the device and we can create device-dependent
     // resources.
     m_deviceResources = std::make_shared<DX::DeviceResources>();
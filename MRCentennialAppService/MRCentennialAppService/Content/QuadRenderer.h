@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include "..\Common\DeviceResources.h"
-#include "..\Common\StepTimer.h"
+#include "Common\DeviceResources.h"
+#include "Common\StepTimer.h"
+#include "Core\CommandRecorder.h"
 #include "ShaderStructures.h"
 #include <mutex>
 
@@ -27,6 +28,11 @@ namespace MRCentennialAppService
     void ReleaseDeviceDependentResources();
     void Update(const DX::StepTimer& timer);
     void Render();
+
+    // Starts a new frame for the command recorder; see Render.
+    void BeginFrame();
+    const DX::CommandStats& GetCommandStats() const { return m_commands.GetLastFrameStats(); }
+
     void Resize(int width, int height);
     void StartFadeIn();
     void StartFadeOut();
@@ -53,6 +59,9 @@ namespace MRCentennialAppService
     // Cached pointer to device resources.
     std::shared_ptr<DX::DeviceResources>                m_deviceResources;
 
+    // Records the draw each frame and filters redundant state changes.
+    DX::CommandRecorder                                 m_commands;
+
     // Direct3D resources for quad geometry.
     Microsoft::WRL::ComPtr<ID3D11InputLayout>           m_inputLayout;
     Microsoft::WRL::ComPtr<ID3D11Buffer>                m_vertexBuffer;
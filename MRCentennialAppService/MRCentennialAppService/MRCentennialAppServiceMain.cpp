@@ -1,9 +1,11 @@
 #include "pch.h"
 #include "MRCentennialAppServiceMain.h"
 #include "Common\DirectXHelper.h"
+#include "Core\Trace.h"
 
 #include <windows.graphics.directx.direct3d11.interop.h>
 #include <Collection.h>
+#include <fstream>
 #include <D3D11.h>
 
 using namespace MRCentennialAppService;
@@ -170,6 +172,8 @@ MRCentennialAppServiceMain::~MRCentennialAppServiceMain()
 // Updates the application state once per frame.
 HolographicFrame^ MRCentennialAppServiceMain::Update()
 {
+    DX_TRACE_SCOPE("Update");
+
     // Before doing the timer update, there is some work to do per-frame
     // to maintain holographic rendering. First, we will get information
     // about the current frame.
@@ -190,6 +194,8 @@ HolographicFrame^ MRCentennialAppServiceMain::Update()
 #ifdef DRAW_SAMPLE_CONTENT
     if (m_stationaryReferenceFrame != nullptr)
     {
+        DX_TRACE_SCOPE("Input");
+
         // Check for new input state since the last frame.
         for (auto& gamepadWithButtonState : m_gamepads)
         {
@@ -229,6 +235,8 @@ HolographicFrame^ MRCentennialAppServiceMain::Update()
         // run as many times as needed to get to the current step.
         //
 
+        DX_TRACE_SCOPE("Update scene");
+
 #ifdef DRAW_SAMPLE_CONTENT
         m_renderer->Update(m_timer);
 #endif
@@ -272,6 +280,8 @@ HolographicFrame^ MRCentennialAppServiceMain::Update()
 // frame was rendered to at least one camera.
 bool MRCentennialAppServiceMain::Render(HolographicFrame^ holographicFrame)
 {
+    DX_TRACE_SCOPE("Render");
+
     // Don't try to render anything before the first Update.
     if (m_timer.GetFrameCount() == 0)
     {
@@ -286,6 +296,12 @@ bool MRCentennialAppServiceMain::Render(HolographicFrame^ holographicFrame)
     // matrix, such as lighting maps.
     //
 
+#ifdef DRAW_SAMPLE_CONTENT
+    // The renderer replays its draws through a command recorder that skips state the
+    // device already has; state set by the previous frame can't be trusted.
+    m_renderer->BeginFrame();
+#endif
+
     // Lock the set of holographic camera resources, then draw to each camera
     // in this frame.
     return m_deviceResources->UseHolographicCameraResources<bool>(
@@ -299,6 +315,8 @@ bool MRCentennialAppServiceMain::Render(HolographicFrame^ holographicFrame)
         bool atLeastOneCameraRendered = false;
         for (auto cameraPose : prediction->CameraPoses)
         {
+            DX_TRACE_SCOPE_VALUE("Render camera", cameraPose->HolographicCamera->Id);
+
             // This represents the device-based resources for a HolographicCamera.
             DX::CameraResources* pCameraResources = cameraResourceMap[cameraPose->HolographicCamera->Id].get();
 
@@ -368,6 +386,12 @@ void MRCentennialAppServiceMain::SaveAppState()
     //
     //       For example, store information in the SpatialAnchorStore.
     //
+
+#if DX_TRACE_ENABLED
+    // Write the frames traced so far to LocalState\trace.json for chrome://tracing.
+    std::ofstream traceFile(std::wstring(Windows::Storage::ApplicationData::Current->LocalFolder->Path->Data()) + L"\\trace.json");
+    DX::Trace::WriteChromeJson(traceFile);
+#endif
 }
 
 
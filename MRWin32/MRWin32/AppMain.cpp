@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "AppMain.h"
+#include "Common\DirectXHelper.h"
 
 #include <..\winrt\WinRTBase.h>
 #include <windows.graphics.holographic.h>
@@ -30,6 +31,21 @@ AppMain::AppMain() :
 
 void AppMain::Initialize()
 {
+    // Start reading the shaders now so that the reads overlap with device creation; the
+    // renderers pick them up from the shared asset cache. Shaders.bundle is used when it
+    // was deployed next to the executable and the individual .cso files otherwise.
+    WCHAR full_path[MAX_PATH + 1] = { 0 };
+    ::GetModuleFileName(nullptr, full_path, MAX_PATH + 1);
+
+    std::wstring path = full_path;
+    path = path.substr(0, path.rfind(L"\\") + 1);
+    DX::MountAssetBundle(path + L"Shaders.bundle");
+    DX::PrefetchAssets({
+        path + L"VertexShader.cso",
+        path + L"VprtVertexShader.cso",
+        path + L"GeometryShader.cso",
+        path + L"PixelShader.cso" });
+
     // At this point we have access to the device and we can create device-dependent
     // resources.
     m_deviceResources = std::make_shared<DX::DeviceResources>();
@@ -1,7 +1,8 @@
 #pragma once
 
-#include "..\Common\DeviceResources.h"
-#include "..\Common\StepTimer.h"
+#include "Common\DeviceResources.h"
+#include "Common\StepTimer.h"
+#include "Core\CommandRecorder.h"
 #include "ShaderStructures.h"
 
 namespace MRWin32
@@ -16,6 +17,10 @@ namespace MRWin32
         void Update(const DX::StepTimer& timer);
         void Render();
 
+        // Starts a new frame for the command recorder; see Render.
+        void BeginFrame();
+        const DX::CommandStats& GetCommandStats() const { return m_commands.GetLastFrameStats(); }
+
         // Repositions the sample hologram.
         void PositionHologram(Windows::UI::Input::Spatial::SpatialPointerPose^ pointerPose);
 
@@ -27,6 +32,9 @@ namespace MRWin32
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources>            m_deviceResources;
 
+        // Records the draw each frame and filters redundant state changes.
+        DX::CommandRecorder                             m_commands;
+
         // Direct3D resources for cube geometry.
         Microsoft::WRL::ComPtr<ID3D11InputLayout>       m_inputLayout;
         Microsoft::WRL::ComPtr<ID3D11Buffer>            m_vertexBuffer;
@@ -46,7 +46,11 @@ WebViewPage::WebViewPage()
 void WebViewPage::OnNavigatedStarting(WebView^ sender, WebViewNavigationStartingEventArgs^ args)
 {
     m_contentLoaded = false;
-    m_pointerTracking = false;
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        m_pointerTracking = false;
+    }
+    m_inputBatch.Clear();
 }
 
 void WebViewPage::OnNavigatedTo(Windows::UI::Xaml::Navigation::NavigationEventArgs^ args)
@@ -111,12 +115,14 @@ void WebViewPage::OnWebContentLoaded(Windows::UI::Xaml::Controls::WebView ^ webv
     auto width = m_webView->ActualWidth;
 
     auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
-    Platform::String^ hideScroll = L"function SetBodyOverFlowHidden(){document.body.style.overflow = 'hidden'; return 'Set Style to hidden';} SetBodyOverFlowHidden();";
-    scripts->Append(hideScroll);
+    std::wstring setup = L"function SetBodyOverFlowHidden(){document.body.style.overflow = 'hidden'; return 'Set Style to hidden';} SetBodyOverFlowHidden();";
+    setup += DX::WebViewInputBatch::HandlerScript();
+    scripts->Append(ref new Platform::String(setup.c_str()));
     m_webView->InvokeScriptAsync("eval", scripts);
 
     OutputDebugString(L"OnWebContentLoaded");
     CreateDirectxTextures();
+    UpdateWebViewBounds();
     m_contentLoaded = true;
     m_timer.ResetElapsedTime();
     UpdateWebView();
@@ -131,6 +137,9 @@ inline float ConvertDipsToPixels(float dips, float dpi)
 
 void WebViewPage::UpdateWebView()
 {
+    UpdateWebViewBounds();
+    FlushInput();
+
     m_timer.Tick([&]()
     {
         UpdateWebViewBitmap(m_width, m_height);
@@ -218,98 +227,96 @@ void WebViewPage::GetOffsets()
 
 void WebViewPage::OnClick(int x, int y)
 {
-    DisplayInformation^ displayInformation = DisplayInformation::GetForCurrentView();
-    auto dpi = displayInformation->LogicalDpi;
-
-    auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
-    std::wstringstream w;
-    w << L"document.elementFromPoint(" << x << "," << y  << L").click()";
-    scripts->Append(ref new Platform::String(w.str().c_str()));
-    m_webView->InvokeScriptAsync(ref new Platform::String(L"eval"), scripts);
+    m_inputBatch.Click(x, y);
 }
 
 void WebViewPage::OnScroll(int x, int y)
 {
-    auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
-    std::wstringstream w;
-    w << L"window.scrollBy(" << x << L"," << y << L");";
-    scripts->Append(ref new Platform::String(w.str().c_str()));
-    m_webView->InvokeScriptAsync("eval", scripts);
+    m_inputBatch.Scroll(x, y);
 }
 
-ValueSet^ WebViewPage::OnRequestReceived(AppServiceConnection^ sender, AppServiceRequestReceivedEventArgs^ args)
+// Caches the WebView's position in window coordinates so pointer messages can be
+// mapped to page coordinates without a dispatcher hop. Must be called on the UI thread.
+void WebViewPage::UpdateWebViewBounds()
 {
-    ValueSet^ request = args->Request->Message;
-    ValueSet^ message = safe_cast<ValueSet^>(request->Lookup(L"Data"));
+    auto ttv = m_webView->TransformToVisual(Window::Current->Content);
+    Point location = ttv->TransformPoint(Point(0, 0));
 
-    if (message->HasKey("PointerMessage") && m_contentLoaded)
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    m_webViewBounds = Rect(location.X, location.Y, (float)m_width, (float)m_height);
+}
+
+// Sends all input received since the previous frame to the page in one script call.
+// Must be called on the UI thread.
+void WebViewPage::FlushInput()
+{
+    if (!m_contentLoaded || !m_inputBatch.Flush(m_inputArgument))
     {
-        CoreApplication::MainView->Dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([this, message]()
-        {
-            Platform::String^ pointerEvent = safe_cast<Platform::String^>(message->Lookup(L"PointerMessage"));
-            float x = (float)(message->Lookup(L"x"));
-            float y = (float)(message->Lookup(L"y"));
+        return;
+    }
+
+    auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
+    scripts->Append(ref new Platform::String(m_inputArgument.c_str(), (unsigned int)m_inputArgument.size()));
+    m_webView->InvokeScriptAsync(Platform::StringReference(DX::WebViewInputBatch::HandlerFunction()), scripts);
+}
+
+void WebViewPage::OnPointerMessage(Platform::String^ pointerEvent, float x, float y)
+{
+    std::lock_guard<std::mutex> lock(m_inputMutex);
 
-            auto ttv = m_webView->TransformToVisual(Window::Current->Content);
-            Point location = ttv->TransformPoint(Point(0, 0));
+    if (m_webViewBounds.Contains(Point(x, y)))
+    {
+        Point point(x - m_webViewBounds.X, y - m_webViewBounds.Y);
 
-            if (x >= location.X && x <= location.X + m_width && y >= location.Y && y <= location.Y + m_height)
+        if (pointerEvent == L"OnPointerPressed")
+        {
+            m_pointerTracking = true;
+            m_currentPointerPosition.X = m_startPointerPosition.X = point.X;
+            m_currentPointerPosition.Y = m_startPointerPosition.Y = point.Y;
+        }
+        else if (pointerEvent == L"OnPointerReleased")
+        {
+            m_pointerTracking = false;
+            if (std::abs(point.X - m_startPointerPosition.X) < 10 && std::abs(point.Y - m_startPointerPosition.Y) < 10)
             {
-                auto relative = Window::Current->Content->TransformToVisual(m_webView);
-                auto point = relative->TransformPoint(Point(x, y));
-                
-                if (pointerEvent == L"OnPointerPressed")
-                {
-                    m_pointerTracking = true;
-                    m_currentPointerPosition.X = m_startPointerPosition.X = point.X;
-                    m_currentPointerPosition.Y = m_startPointerPosition.Y = point.Y;
-                }
-                else if (pointerEvent == L"OnPointerReleased")
-                {
-                    m_pointerTracking = false;
-                    if (std::abs(point.X - m_startPointerPosition.X) < 10 && std::abs(point.Y - m_startPointerPosition.Y) < 10)
-                    {
-                        OnClick((int)point.X, (int)point.Y);
-                    }
-                }
-                else if (pointerEvent == L"OnPointerMoved")
-                {
-                    if (m_pointerTracking)
-                    {
-                        float xoffset = m_currentPointerPosition.X - point.X;
-                        float yoffset = m_currentPointerPosition.Y - point.Y;
-                        m_currentPointerPosition = point;
-                        OnScroll((int)xoffset, (int)yoffset);
-                    }
-                }
+                OnClick((int)point.X, (int)point.Y);
             }
-            else
+        }
+        else if (pointerEvent == L"OnPointerMoved")
+        {
+            if (m_pointerTracking)
             {
-                m_pointerTracking = false;
+                float xoffset = m_currentPointerPosition.X - point.X;
+                float yoffset = m_currentPointerPosition.Y - point.Y;
+                m_currentPointerPosition = point;
+                OnScroll((int)xoffset, (int)yoffset);
             }
-        }));
+        }
+    }
+    else
+    {
+        m_pointerTracking = false;
+    }
+}
+
+ValueSet^ WebViewPage::OnRequestReceived(AppServiceConnection^ sender, AppServiceRequestReceivedEventArgs^ args)
+{
+    ValueSet^ request = args->Request->Message;
+    ValueSet^ message = safe_cast<ValueSet^>(request->Lookup(L"Data"));
+
+    // Input is queued here on the App Service thread and sent to the page once per frame by FlushInput.
+    if (message->HasKey("PointerMessage") && m_contentLoaded)
+    {
+        Platform::String^ pointerEvent = safe_cast<Platform::String^>(message->Lookup(L"PointerMessage"));
+        float x = (float)(message->Lookup(L"x"));
+        float y = (float)(message->Lookup(L"y"));
+        OnPointerMessage(pointerEvent, x, y);
     }
     if (message->HasKey("KeyboardMessage") && m_contentLoaded)
     {
-        Platform::String^ keyboardEvent = safe_cast<Platform::String^>(message->Lookup(L"KeyboardMessage"));
-        CoreApplication::MainView->Dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([this, message]()
-        {
-            Platform::String^ keyboardEvent = safe_cast<Platform::String^>(message->Lookup(L"KeyboardMessage"));
-            unsigned int key = (unsigned int)(message->Lookup(L"Key"));
-            wchar_t keyChar = (wchar_t)key;
-            auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
-            std::wstringstream w;
-            if (key == (unsigned int)VirtualKey::Back)
-            {
-                 w << L"document.activeElement.value=document.activeElement.value.slice(0, -1);";
-            }
-            else
-            {
-                w << L"document.activeElement.value=document.activeElement.value+'" << keyChar << "';";
-            }
-            scripts->Append(ref new Platform::String(w.str().c_str()));
-            m_webView->InvokeScriptAsync("eval", scripts);
-        }));
+        // The page handler treats VirtualKey::Back (8) as a backspace.
+        unsigned int key = (unsigned int)(message->Lookup(L"Key"));
+        m_inputBatch.Key(key);
     }
 
     auto response = ref new ValueSet();
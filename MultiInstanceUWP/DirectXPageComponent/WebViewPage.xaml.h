@@ -8,9 +8,11 @@
 #include "WebViewPage.g.h"
 #include "Common\StepTimer.h"
 #include "Common\DeviceResources.h"
+#include "..\..\DXCommon\Core\WebViewInputBatch.h"
 #include "AppServiceListener.h"
 #include "ProtocolArgs.h"
 #include <memory>
+#include <mutex>
 #include <ppltasks.h>
 
 namespace DirectXPageComponent
@@ -50,6 +52,9 @@ namespace DirectXPageComponent
         void UpdateDirectxTextures(const void *buffer, int width, int height);
         void OnClick(int x, int y);
         void OnScroll(int x, int y);
+        void OnPointerMessage(Platform::String^ pointerEvent, float x, float y);
+        void FlushInput();
+        void UpdateWebViewBounds();
         void GetOffsets();
 
         Windows::UI::Xaml::Controls::WebView^ m_webView;
@@ -69,5 +74,9 @@ namespace DirectXPageComponent
         bool m_pointerTracking;
         Windows::Foundation::Point m_startPointerPosition;
         Windows::Foundation::Point m_currentPointerPosition;
+        Windows::Foundation::Rect m_webViewBounds;
+        std::mutex m_inputMutex;    // Guards the pointer state and bounds above, which the App Service thread uses.
+        DX::WebViewInputBatch m_inputBatch;
+        std::wstring m_inputArgument;
     };
 }
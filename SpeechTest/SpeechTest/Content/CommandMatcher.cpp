@@ -0,0 +1,409 @@
+#include "CommandMatcher.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+#include <cwctype>
+#include <stdexcept>
+
+using namespace Speech;
+
+namespace
+{
+    // Similarity of a word heard to a command word with the same phonetic key, when the
+    // spelling alone doesn't make them closer.
+    const float SoundsAlikeSimilarity = 0.8f;
+
+    // Edits allowed between a word heard and a command word. Short words have to be spelled
+    // and sound right, or "red" would also be "rod", "bed" and "ref".
+    int MaxEdits(size_t length)
+    {
+        return length <= 3 ? 0 : length <= 7 ? 1 : 2;
+    }
+
+    uint32_t Letters(const std::wstring& word)
+    {
+        uint32_t letters = 0;
+        for (wchar_t c : word)
+        {
+            letters |= 1u << (c >= L'a' && c <= L'z' ? c - L'a' : 26 + c % 6);
+        }
+        return letters;
+    }
+
+    // Optimal string alignment distance, which counts swapping two neighbouring letters as one
+    // edit, or limit + 1 if it is more than limit. Only cells within limit of the diagonal are
+    // filled in, and it stops at the first row with none within limit.
+    int BoundedDistance(const std::wstring& a, const std::wstring& b, int limit, std::vector<int>& scratch)
+    {
+        const int m = static_cast<int>(a.size());
+        const int n = static_cast<int>(b.size());
+        const int outside = limit + 1;
+        if (std::abs(m - n) > limit)
+        {
+            return outside;
+        }
+
+        scratch.assign(3 * (n + 1), outside);
+        int* twoBack = scratch.data();
+        int* previous = twoBack + n + 1;
+        int* current = previous + n + 1;
+        for (int j = 0; j <= std::min(n, limit); ++j)
+        {
+            previous[j] = j;
+        }
+
+        for (int i = 1; i <= m; ++i)
+        {
+            const int first = std::max(1, i - limit);
+            const int last = std::min(n, i + limit);
+            current[0] = std::min(i, outside);
+            current[first - 1] = first == 1 ? current[0] : outside;
+            int rowMinimum = current[first - 1];
+
+            for (int j = first; j <= last; ++j)
+            {
+                int distance = std::min(previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1), std::min(previous[j], current[j - 1]) + 1);
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    distance = std::min(distance, twoBack[j - 2] + 1);
+                }
+                current[j] = std::min(distance, outside);
+                rowMinimum = std::min(rowMinimum, current[j]);
+            }
+            if (last < n)
+            {
+                current[last + 1] = outside;
+            }
+            if (rowMinimum > limit)
+            {
+                return outside;
+            }
+
+            std::swap(twoBack, previous);
+            std::swap(previous, current);
+        }
+        return previous[n];
+    }
+
+    // Soundex classes without the length limit. 'a' stands for any vowel and 0 for letters
+    // that are dropped.
+    wchar_t Sound(wchar_t c)
+    {
+        switch (c)
+        {
+        case L'b': case L'f': case L'p': case L'v':
+            return L'1';
+        case L'c': case L'g': case L'j': case L'k': case L'q': case L's': case L'x': case L'z':
+            return L'2';
+        case L'd': case L't':
+            return L'3';
+        case L'l':
+            return L'4';
+        case L'm': case L'n':
+            return L'5';
+        case L'r':
+            return L'6';
+        case L'a': case L'e': case L'i': case L'o': case L'u':
+            return L'a';
+        case L'h': case L'w': case L'y':
+            return 0;
+        default:
+            return c;
+        }
+    }
+}
+
+struct CommandMatcher::Search
+{
+    std::vector<std::wstring>           words;
+    std::vector<size_t>                 lengths;
+    size_t                              totalLength;
+
+    // Candidates for each word heard, and the command word each word joined with the next one
+    // spells, since the recognizer may split a command word in two. Joined words have to be
+    // exact, or a long enough pair of words is always close to some command.
+    std::vector<std::vector<Candidate>> candidates;
+    std::vector<std::vector<Candidate>> joinedCandidates;
+
+    Match                               best;
+};
+
+CommandMatcher::CommandMatcher() :
+    m_nodes(1),
+    m_commandCount(0)
+{
+    m_nodes[0].command = NoMatch;
+}
+
+size_t CommandMatcher::Add(const std::wstring& phrase)
+{
+    std::vector<std::wstring> words = Normalize(phrase);
+    if (words.empty())
+    {
+        throw std::invalid_argument("A voice command needs at least one letter or digit.");
+    }
+
+    size_t command = m_commandCount++;
+    std::vector<uint32_t> path;
+    std::wstring joined;
+    for (const std::wstring& word : words)
+    {
+        path.push_back(AddWord(word));
+        joined += word;
+    }
+    AddPath(path, command);
+
+    // "SpeechRecognizer" may also be heard as one word.
+    if (words.size() > 1)
+    {
+        AddPath({ AddWord(joined) }, command);
+    }
+    return command;
+}
+
+CommandMatcher::Match CommandMatcher::Find(const std::wstring& text) const
+{
+    Search search;
+    search.words = Normalize(text);
+    search.best.command = NoMatch;
+    search.best.score = 0.0f;
+
+    const size_t count = search.words.size();
+    search.totalLength = 0;
+    search.candidates.resize(count);
+    search.joinedCandidates.resize(count);
+
+    std::vector<int> scratch;
+    for (size_t i = 0; i < count; ++i)
+    {
+        search.lengths.push_back(search.words[i].size());
+        search.totalLength += search.words[i].size();
+        FindWords(search.words[i], search.candidates[i], scratch);
+        if (i + 1 < count)
+        {
+            auto joined = m_wordIds.find(search.words[i] + search.words[i + 1]);
+            if (joined != m_wordIds.end())
+            {
+                search.joinedCandidates[i].push_back({ joined->second, 1.0f });
+            }
+        }
+    }
+
+    for (size_t first = 0; first < count; ++first)
+    {
+        Walk(search, 0, first, 0.0f, 0);
+    }
+    return search.best;
+}
+
+std::vector<std::wstring> CommandMatcher::Normalize(const std::wstring& text)
+{
+    std::vector<std::wstring> words;
+    std::wstring word;
+    wchar_t previous = 0;
+    for (wchar_t c : text)
+    {
+        if (c == L'\'' || c == L'\x2019')
+        {
+            continue;
+        }
+
+        bool split = !std::iswalnum(c) || (std::iswupper(c) && std::iswlower(previous));
+        if (split && !word.empty())
+        {
+            words.push_back(word);
+            word.clear();
+        }
+        if (std::iswalnum(c))
+        {
+            word.push_back(static_cast<wchar_t>(std::towlower(c)));
+        }
+        previous = c;
+    }
+    if (!word.empty())
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+std::wstring CommandMatcher::PhoneticKey(const std::wstring& word)
+{
+    std::wstring key;
+    wchar_t last = 0;
+    for (size_t i = 0; i < word.size(); ++i)
+    {
+        wchar_t sound = Sound(word[i]);
+        if (sound == 0)
+        {
+            continue;
+        }
+
+        // Vowels only count at the start, but keep the consonants either side apart.
+        if (sound == L'a' && i > 0)
+        {
+            last = sound;
+            continue;
+        }
+        if (sound != last)
+        {
+            key.push_back(sound);
+        }
+        last = sound;
+    }
+    return key;
+}
+
+uint32_t CommandMatcher::AddWord(const std::wstring& text)
+{
+    auto existing = m_wordIds.find(text);
+    if (existing != m_wordIds.end())
+    {
+        return existing->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(m_words.size());
+    m_words.push_back({ text, Letters(text) });
+    m_wordIds.emplace(text, id);
+
+    if (m_wordsByLength.size() <= text.size())
+    {
+        m_wordsByLength.resize(text.size() + 1);
+    }
+    m_wordsByLength[text.size()].push_back(id);
+
+    std::wstring key = PhoneticKey(text);
+    if (key.size() >= 2)
+    {
+        m_wordsBySound[key].push_back(id);
+    }
+    return id;
+}
+
+void CommandMatcher::AddPath(const std::vector<uint32_t>& words, size_t command)
+{
+    uint32_t node = 0;
+    for (uint32_t word : words)
+    {
+        auto& children = m_nodes[node].children;
+        auto child = std::lower_bound(children.begin(), children.end(), std::make_pair(word, 0u));
+        if (child != children.end() && child->first == word)
+        {
+            node = child->second;
+            continue;
+        }
+
+        uint32_t added = static_cast<uint32_t>(m_nodes.size());
+        children.insert(child, std::make_pair(word, added));
+        m_nodes.emplace_back();
+        m_nodes.back().command = NoMatch;
+        node = added;
+    }
+
+    if (m_nodes[node].command == NoMatch)
+    {
+        m_nodes[node].command = command;
+    }
+}
+
+void CommandMatcher::FindWords(const std::wstring& heard, std::vector<Candidate>& candidates, std::vector<int>& scratch) const
+{
+    candidates.clear();
+
+    auto exact = m_wordIds.find(heard);
+    if (exact != m_wordIds.end())
+    {
+        candidates.push_back({ exact->second, 1.0f });
+        return;
+    }
+
+    const size_t length = heard.size();
+    const int limit = MaxEdits(length);
+    const uint32_t letters = Letters(heard);
+    const size_t shortest = length > static_cast<size_t>(limit) ? length - limit : 1;
+    const size_t longest = std::min(length + limit, m_wordsByLength.empty() ? 0 : m_wordsByLength.size() - 1);
+    for (size_t wordLength = shortest; wordLength <= longest; ++wordLength)
+    {
+        for (uint32_t id : m_wordsByLength[wordLength])
+        {
+            // An edit adds or removes at most two letters from the set of letters in a word.
+            const Word& word = m_words[id];
+            if ((std::bitset<32>(letters ^ word.letters).count() + 1) / 2 > static_cast<size_t>(limit))
+            {
+                continue;
+            }
+
+            int distance = BoundedDistance(heard, word.text, limit, scratch);
+            if (distance <= limit)
+            {
+                float similarity = 1.0f - static_cast<float>(distance) / static_cast<float>(std::max(length, wordLength));
+                candidates.push_back({ id, similarity });
+            }
+        }
+    }
+
+    if (limit == 0)
+    {
+        return;
+    }
+
+    std::wstring key = PhoneticKey(heard);
+    auto alike = key.size() >= 2 ? m_wordsBySound.find(key) : m_wordsBySound.end();
+    if (alike != m_wordsBySound.end())
+    {
+        for (uint32_t id : alike->second)
+        {
+            auto candidate = std::find_if(candidates.begin(), candidates.end(), [id](const Candidate& c) { return c.word == id; });
+            if (candidate == candidates.end())
+            {
+                candidates.push_back({ id, SoundsAlikeSimilarity });
+            }
+            else
+            {
+                candidate->similarity = std::max(candidate->similarity, SoundsAlikeSimilarity);
+            }
+        }
+    }
+}
+
+void CommandMatcher::Walk(Search& search, uint32_t node, size_t next, float matched, size_t spanLength) const
+{
+    const auto& children = m_nodes[node].children;
+    for (int joined = 0; joined < 2; ++joined)
+    {
+        const size_t used = joined ? 2 : 1;
+        if (next + used > search.words.size())
+        {
+            break;
+        }
+
+        const size_t length = search.lengths[next] + (joined ? search.lengths[next + 1] : 0);
+        for (const Candidate& candidate : (joined ? search.joinedCandidates : search.candidates)[next])
+        {
+            auto child = std::lower_bound(children.begin(), children.end(), std::make_pair(candidate.word, 0u));
+            if (child == children.end() || child->first != candidate.word)
+            {
+                continue;
+            }
+
+            const float childMatched = matched + candidate.similarity * static_cast<float>(length);
+            const size_t childSpan = spanLength + length;
+            const size_t command = m_nodes[child->second].command;
+            if (command != NoMatch)
+            {
+                // How well the words match, scaled down by up to half for the words heard
+                // around them.
+                float quality = childMatched / static_cast<float>(childSpan);
+                float coverage = static_cast<float>(childSpan) / static_cast<float>(search.totalLength);
+                float score = quality * (0.5f + 0.5f * coverage);
+                if (score > search.best.score || (score == search.best.score && command < search.best.command))
+                {
+                    search.best.command = command;
+                    search.best.score = score;
+                }
+            }
+            Walk(search, child->second, next + used, childMatched, childSpan);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Speech
+{
+    // Finds the voice command closest to what the recognizer heard, so "purple.", "Gray",
+    // "purpel" or "light blue" still select a command. Commands and transcriptions are
+    // normalized to lower case words and the commands kept in a trie of words. Each word heard
+    // is matched against the command words spelled within a few edits or sounding the same,
+    // and the trie is walked with those candidates from every word of the transcription, so a
+    // command can also be found inside a longer sentence. Standard C++, so it can be tested
+    // and measured off the device.
+    class CommandMatcher
+    {
+    public:
+        static const size_t NoMatch = SIZE_MAX;
+
+        struct Match
+        {
+            size_t  command;    // Index of the command in the order added, or NoMatch.
+
+            // 1 when the transcription is the command after normalization. Less for each
+            // misspelled word and for words of the transcription that aren't part of the
+            // command; 0 with NoMatch.
+            float   score;
+        };
+
+        CommandMatcher();
+
+        // Adds a command and returns its index. Throws std::invalid_argument if the phrase has
+        // no letters or digits. When two commands normalize to the same words, Find returns
+        // the first.
+        size_t Add(const std::wstring& phrase);
+
+        size_t GetCommandCount() const { return m_commandCount; }
+
+        // Thread safe with other calls to Find, not with Add.
+        Match Find(const std::wstring& text) const;
+
+        // Lower case words, split at spaces, punctuation and changes from lower to upper case,
+        // so "SpeechRecognizer" is "speech recognizer". Apostrophes are dropped.
+        static std::vector<std::wstring> Normalize(const std::wstring& text);
+
+        // Consonant classes in order, vowels dropped after the first letter, so words that
+        // sound alike such as "grey" and "gray" or "blue" and "blew" have the same key.
+        static std::wstring PhoneticKey(const std::wstring& word);
+
+    private:
+        struct Word
+        {
+            std::wstring    text;
+            uint32_t        letters;    // Bit per letter in the word, to skip most distances.
+        };
+
+        struct Node
+        {
+            // Sorted by word id.
+            std::vector<std::pair<uint32_t, uint32_t>>  children;
+            size_t                                      command;
+        };
+
+        // A command word that may be what the recognizer heard.
+        struct Candidate
+        {
+            uint32_t    word;
+            float       similarity;
+        };
+
+        struct Search;
+
+        uint32_t AddWord(const std::wstring& text);
+        void AddPath(const std::vector<uint32_t>& words, size_t command);
+        void FindWords(const std::wstring& heard, std::vector<Candidate>& candidates, std::vector<int>& scratch) const;
+        void Walk(Search& search, uint32_t node, size_t next, float matched, size_t spanLength) const;
+
+        std::vector<Word>                                       m_words;
+        std::unordered_map<std::wstring, uint32_t>              m_wordIds;
+        std::vector<std::vector<uint32_t>>                      m_wordsByLength;
+        std::unordered_map<std::wstring, std::vector<uint32_t>> m_wordsBySound;
+        std::vector<Node>                                       m_nodes;
+        size_t                                                  m_commandCount;
+    };
+}
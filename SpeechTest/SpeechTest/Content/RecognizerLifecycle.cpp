@@ -0,0 +1,399 @@
+#include "RecognizerLifecycle.h"
+
+#include <algorithm>
+
+using namespace Speech;
+
+const std::chrono::milliseconds RecognizerLifecycle::RetryDelay(500);
+const std::chrono::milliseconds RecognizerLifecycle::MaxRetryDelay(30000);
+
+RecognizerLifecycle::RecognizerLifecycle(std::shared_ptr<IRecognizer> recognizer, StateChangedCallback stateChanged) :
+    m_state(std::make_shared<State>())
+{
+    m_state->recognizer = std::move(recognizer);
+    m_state->stateChanged = std::move(stateChanged);
+    m_state->state = RecognizerState::Cold;
+    m_state->active = false;
+    m_state->gateOpen = true;
+    m_state->busy = false;
+    m_state->hasPermission = false;
+    m_state->sessionEnded = false;
+    m_state->sessionFailed = false;
+    m_state->waitingForReady = false;
+    m_state->statistics = Statistics();
+    m_state->failures = 0;
+    m_state->retryScheduled = false;
+    m_state->retryGeneration = 0;
+    m_state->notifying = false;
+}
+
+RecognizerLifecycle::~RecognizerLifecycle()
+{
+    Shutdown();
+}
+
+void RecognizerLifecycle::SetActive(bool active)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        State& state = *m_state;
+        if (state.state == RecognizerState::Stopped || active == state.active)
+        {
+            return;
+        }
+
+        state.active = active;
+        if (active)
+        {
+            ++state.statistics.activations;
+            state.activatedAt = Clock::now();
+            state.waitingForReady = true;
+
+            switch (state.state)
+            {
+            case RecognizerState::Idle:
+            case RecognizerState::Starting:
+            case RecognizerState::Listening:
+            case RecognizerState::Pausing:
+            case RecognizerState::Paused:
+            case RecognizerState::Resuming:
+                ++state.statistics.warmActivations;
+                break;
+
+            case RecognizerState::NoPermission:
+            case RecognizerState::Failed:
+                SetState(state, RecognizerState::Cold);
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+    Advance(m_state);
+}
+
+void RecognizerLifecycle::SetGateOpen(bool open)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        State& state = *m_state;
+        if (state.state == RecognizerState::Stopped || open == state.gateOpen)
+        {
+            return;
+        }
+
+        state.gateOpen = open;
+        if (open && state.active)
+        {
+            state.activatedAt = Clock::now();
+            state.waitingForReady = true;
+        }
+    }
+    Advance(m_state);
+}
+
+void RecognizerLifecycle::OnSessionEnded(bool recoverable)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        State& state = *m_state;
+        switch (state.state)
+        {
+        case RecognizerState::Listening:
+        case RecognizerState::Paused:
+            if (recoverable)
+            {
+                SetState(state, RecognizerState::Idle);
+            }
+            else
+            {
+                Fail(state);
+            }
+            break;
+
+        // Decided when the operation completes.
+        case RecognizerState::Pausing:
+        case RecognizerState::Resuming:
+            state.sessionEnded = true;
+            state.sessionFailed = state.sessionFailed || !recoverable;
+            break;
+
+        default:
+            break;
+        }
+    }
+    Advance(m_state);
+}
+
+void RecognizerLifecycle::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (m_state->state != RecognizerState::Stopped)
+        {
+            SetState(*m_state, RecognizerState::Stopped);
+            m_state->busy = false;
+            m_state->recognizer->Release();
+        }
+    }
+    Notify(*m_state);
+}
+
+RecognizerState RecognizerLifecycle::GetState() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->state;
+}
+
+RecognizerLifecycle::Statistics RecognizerLifecycle::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->statistics;
+}
+
+void RecognizerLifecycle::Advance(const std::shared_ptr<State>& state)
+{
+    RecognizerState operation;
+    bool start;
+    std::chrono::milliseconds retryDelay(0);
+    uint64_t retryGeneration = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        start = NextOperation(*state, operation);
+        if (start && operation == RecognizerState::Failed)
+        {
+            retryDelay = RetryDelay * (1ll << (std::min<uint32_t>(state->failures, 16) - 1));
+            retryDelay = std::min(retryDelay, MaxRetryDelay);
+            retryGeneration = state->retryGeneration;
+        }
+    }
+
+    // Outside the lock, like the operations.
+    Notify(*state);
+    if (!start)
+    {
+        return;
+    }
+
+    // Started without the lock, since done may be called before the operation returns.
+    IRecognizer::Completion done = [state, operation](bool succeeded) { Complete(state, operation, succeeded); };
+    switch (operation)
+    {
+    case RecognizerState::Failed:
+        state->recognizer->ScheduleRetry(retryDelay, [state, retryGeneration] { Retry(state, retryGeneration); });
+        break;
+    case RecognizerState::RequestingPermission:
+        state->recognizer->RequestPermission(done);
+        break;
+    case RecognizerState::Compiling:
+        state->recognizer->Compile(done);
+        break;
+    case RecognizerState::Starting:
+        state->recognizer->StartSession(done);
+        break;
+    case RecognizerState::Pausing:
+        state->recognizer->PauseSession(done);
+        break;
+    case RecognizerState::Resuming:
+        state->recognizer->ResumeSession(done);
+        break;
+    default:
+        break;
+    }
+}
+
+// Picks the operation that moves the recognizer towards what was asked for, and marks it as
+// running. Failed stands for scheduling a retry.
+bool RecognizerLifecycle::NextOperation(State& state, RecognizerState& operation)
+{
+    if (state.busy)
+    {
+        return false;
+    }
+
+    switch (state.state)
+    {
+    case RecognizerState::Cold:
+        // The recognizer is compiled whenever there is permission, so activating the
+        // app later only has to start it. Permission is only asked for while active.
+        if (state.hasPermission)
+        {
+            operation = RecognizerState::Compiling;
+            ++state.statistics.compilations;
+        }
+        else if (state.active)
+        {
+            operation = RecognizerState::RequestingPermission;
+        }
+        else
+        {
+            return false;
+        }
+        break;
+
+    case RecognizerState::Idle:
+        if (!state.active || !state.gateOpen)
+        {
+            return false;
+        }
+        operation = RecognizerState::Starting;
+        ++state.statistics.sessionStarts;
+        break;
+
+    case RecognizerState::Listening:
+        if (state.active && state.gateOpen)
+        {
+            return false;
+        }
+        operation = RecognizerState::Pausing;
+        break;
+
+    case RecognizerState::Paused:
+        if (!state.active || !state.gateOpen)
+        {
+            return false;
+        }
+        operation = RecognizerState::Resuming;
+        break;
+
+    // Once per failure, and only while active; otherwise the next activation retries.
+    case RecognizerState::Failed:
+        if (!state.active || state.retryScheduled)
+        {
+            return false;
+        }
+        state.retryScheduled = true;
+        operation = RecognizerState::Failed;
+        return true;
+
+    // Stopped, or waiting for the next activation.
+    default:
+        return false;
+    }
+
+    state.busy = true;
+    state.sessionEnded = false;
+    state.sessionFailed = false;
+    SetState(state, operation);
+    return true;
+}
+
+void RecognizerLifecycle::Complete(const std::shared_ptr<State>& state, RecognizerState operation, bool succeeded)
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+
+        // Shut down while the operation was running.
+        if (!state->busy || state->state != operation)
+        {
+            return;
+        }
+        state->busy = false;
+
+        if (operation == RecognizerState::RequestingPermission)
+        {
+            state->hasPermission = succeeded;
+            SetState(*state, succeeded ? RecognizerState::Cold : RecognizerState::NoPermission);
+        }
+        else if (!succeeded || state->sessionFailed)
+        {
+            Fail(*state);
+        }
+        else
+        {
+            switch (operation)
+            {
+            case RecognizerState::Compiling:
+                SetState(*state, RecognizerState::Idle);
+                break;
+            case RecognizerState::Starting:
+                SetState(*state, RecognizerState::Listening);
+                break;
+            case RecognizerState::Pausing:
+                SetState(*state, state->sessionEnded ? RecognizerState::Idle : RecognizerState::Paused);
+                break;
+            case RecognizerState::Resuming:
+                SetState(*state, state->sessionEnded ? RecognizerState::Idle : RecognizerState::Listening);
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (state->state == RecognizerState::Listening && state->active && state->gateOpen && state->waitingForReady)
+        {
+            state->waitingForReady = false;
+            state->statistics.lastActivationLatency = std::chrono::duration<double>(Clock::now() - state->activatedAt).count();
+        }
+        if (state->state == RecognizerState::Listening)
+        {
+            state->failures = 0;
+        }
+    }
+    Advance(state);
+}
+
+void RecognizerLifecycle::Retry(const std::shared_ptr<State>& state, uint64_t generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+
+        // Activated again, shut down or deactivated since the failure.
+        if (state->state != RecognizerState::Failed || !state->active || generation != state->retryGeneration)
+        {
+            return;
+        }
+        ++state->statistics.retries;
+        SetState(*state, RecognizerState::Cold);
+    }
+    Advance(state);
+}
+
+void RecognizerLifecycle::Fail(State& state)
+{
+    SetState(state, RecognizerState::Failed);
+    ++state.failures;
+    state.recognizer->Release();
+}
+
+void RecognizerLifecycle::SetState(State& state, RecognizerState value)
+{
+    // Leaving Failed by any route makes the retry scheduled for it a no-op.
+    if (state.state == RecognizerState::Failed && value != RecognizerState::Failed)
+    {
+        state.retryScheduled = false;
+        ++state.retryGeneration;
+    }
+
+    state.state = value;
+    if (state.stateChanged)
+    {
+        state.notifications.push_back(value);
+    }
+}
+
+// Passes on the queued states. A thread that finds another already doing so leaves its states
+// to that one, which keeps them in order even when stateChanged calls back into the lifecycle.
+void RecognizerLifecycle::Notify(State& state)
+{
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (state.notifying)
+    {
+        return;
+    }
+
+    state.notifying = true;
+    while (!state.notifications.empty())
+    {
+        std::vector<RecognizerState> notifications;
+        notifications.swap(state.notifications);
+        lock.unlock();
+        for (RecognizerState value : notifications)
+        {
+            state.stateChanged(value);
+        }
+        lock.lock();
+    }
+    state.notifying = false;
+}
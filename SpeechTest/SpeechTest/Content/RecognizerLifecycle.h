@@ -0,0 +1,160 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Speech
+{
+    // The platform operations RecognizerLifecycle drives. Each one starts an operation and
+    // calls done when it finishes, on any thread and possibly before returning. Only one
+    // operation runs at a time.
+    class IRecognizer
+    {
+    public:
+        typedef std::function<void(bool succeeded)> Completion;
+
+        virtual ~IRecognizer() {}
+
+        virtual void RequestPermission(Completion done) = 0;
+
+        // Creates the recognizer and compiles its constraints.
+        virtual void Compile(Completion done) = 0;
+
+        virtual void StartSession(Completion done) = 0;
+        virtual void PauseSession(Completion done) = 0;
+        virtual void ResumeSession(Completion done) = 0;
+
+        // Releases the recognizer and any session right away. An operation still running may
+        // complete afterwards; its result is ignored. Called with the lifecycle locked, so it
+        // must not call back into it.
+        virtual void Release() = 0;
+
+        // Calls retry once, on any thread, after delay. Used to create the recognizer again
+        // after it failed while the app is active.
+        virtual void ScheduleRetry(std::chrono::milliseconds delay, std::function<void()> retry) = 0;
+    };
+
+    enum class RecognizerState
+    {
+        Cold,                   // No recognizer.
+        RequestingPermission,
+        NoPermission,           // Asked again the next time the app is activated.
+        Compiling,
+        Idle,                   // Compiled, no session.
+        Starting,
+        Listening,
+        Pausing,
+        Paused,                 // Compiled with a paused session, ready to resume.
+        Resuming,
+        Failed,                 // Released; created again after a while if active, or the next time the app is activated.
+        Stopped                 // Shut down.
+    };
+
+    // Keeps one speech recognizer warm across activation changes. The recognizer is compiled
+    // once, as soon as there is permission to use the microphone, and its session is paused
+    // rather than released when the app is deactivated, so activating the app again only has
+    // to resume it. Every transition goes through one state machine that runs one operation at
+    // a time and then moves on towards whatever the latest SetActive asked for, so activation
+    // changes during an operation are never lost or run twice. A gate, such as a voice
+    // activity detector, can also pause the session while the app is active and nobody is
+    // speaking. When the recognizer fails while the app is active it is created again after a
+    // delay that doubles with each failure in a row. Standard C++, so it can be tested with a
+    // fake recognizer.
+    class RecognizerLifecycle
+    {
+    public:
+        typedef std::function<void(RecognizerState state)> StateChangedCallback;
+
+        struct Statistics
+        {
+            uint32_t    activations;
+            uint32_t    warmActivations;    // Activations that found the recognizer compiled.
+            uint32_t    compilations;
+            uint32_t    sessionStarts;
+            uint32_t    retries;            // Times the recognizer was created again after failing.
+
+            // From the last SetActive(true), or SetGateOpen(true) while active, to Listening, in
+            // seconds. 0 until the first.
+            double      lastActivationLatency;
+        };
+
+        // stateChanged is called with every state in order, one call at a time, without the
+        // lifecycle locked, so it may call back into it. Nothing happens until SetActive.
+        explicit RecognizerLifecycle(std::shared_ptr<IRecognizer> recognizer, StateChangedCallback stateChanged = nullptr);
+
+        // Shuts down.
+        ~RecognizerLifecycle();
+
+        void SetActive(bool active);
+
+        // Whether the session should listen while the app is active. Open until first closed.
+        // Closing it pauses the session and opening it resumes it, as for activation changes,
+        // but the recognizer is compiled and permission asked for whatever the gate.
+        void SetGateOpen(bool open);
+
+        // Called when the session ends by itself, e.g. after a timeout or because the
+        // microphone went away. A recoverable end starts a new session while the app is
+        // active; otherwise the recognizer is released until the next activation.
+        void OnSessionEnded(bool recoverable);
+
+        // Releases the recognizer. Operations still running are ignored when they complete.
+        void Shutdown();
+
+        RecognizerState GetState() const;
+        Statistics GetStatistics() const;
+
+        RecognizerLifecycle(const RecognizerLifecycle&) = delete;
+        RecognizerLifecycle& operator=(const RecognizerLifecycle&) = delete;
+
+        // The first retry after a failure waits RetryDelay, each further one twice as long as
+        // the last, up to MaxRetryDelay.
+        static const std::chrono::milliseconds RetryDelay;
+        static const std::chrono::milliseconds MaxRetryDelay;
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        // Shared with the operations in flight, which can outlive the lifecycle.
+        struct State
+        {
+            std::shared_ptr<IRecognizer>    recognizer;
+            StateChangedCallback            stateChanged;
+
+            mutable std::mutex              mutex;
+            RecognizerState                 state;
+            bool                            active;
+            bool                            gateOpen;
+            bool                            busy;           // An operation is running.
+            bool                            hasPermission;
+            bool                            sessionEnded;   // While pausing or resuming.
+            bool                            sessionFailed;
+            bool                            waitingForReady;
+            Clock::time_point               activatedAt;
+            Statistics                      statistics;
+
+            // Failures since the session last started listening, and the retry scheduled for
+            // the latest one; leaving Failed cancels it.
+            uint32_t                        failures;
+            bool                            retryScheduled;
+            uint64_t                        retryGeneration;
+
+            // States not yet passed to stateChanged, and whether a thread is passing them.
+            std::vector<RecognizerState>    notifications;
+            bool                            notifying;
+        };
+
+        static void Advance(const std::shared_ptr<State>& state);
+        static bool NextOperation(State& state, RecognizerState& operation);
+        static void Complete(const std::shared_ptr<State>& state, RecognizerState operation, bool succeeded);
+        static void Retry(const std::shared_ptr<State>& state, uint64_t generation);
+        static void Fail(State& state);
+        static void SetState(State& state, RecognizerState value);
+        static void Notify(State& state);
+
+        std::shared_ptr<State> m_state;
+    };
+}
@@ -13,6 +13,9 @@
 #include "SpeechInput.h"
 #include "AudioCapturePermissions.h"
 
+#include <MemoryBuffer.h>
+#include <wrl/client.h>
+
 
 using namespace Speech;
 using namespace Concurrency;
@@ -21,17 +24,149 @@ using namespace Platform::Collections;
 using namespace Windows::ApplicationModel::Resources::Core;
 using namespace Windows::Foundation;
 using namespace Windows::Foundation::Collections;
+using namespace Windows::Media;
+using namespace Windows::Media::Audio;
+using namespace Windows::Media::Capture;
+using namespace Windows::Media::Render;
 using namespace Windows::Media::SpeechRecognition;
+using namespace Windows::System::Threading;
+
+namespace
+{
+    // Lowest CommandMatcher score passed on as a command. A misspelled word or a command said
+    // inside a short sentence, such as "make it red", is still above it.
+    const float MinimumCommandScore = 0.6f;
+
+    // How long the voice activity detector keeps reporting speech after it stops, in 10 ms
+    // frames. Long enough for the recognizer to finish the phrase and for pauses between the
+    // words of a command.
+    const unsigned int VoiceActivityHangoverFrames = 150;
+
+    // Further seconds of silence before the gate pauses the session, so the hangover expires
+    // twice. A word said after a shorter pause reaches a session that is still listening; only
+    // the first word after a long silence waits for the session to resume.
+    const double VoiceActivityPauseDelay = VoiceActivityHangoverFrames / 100.0;
+
+    const wchar_t* StateNames[] =
+    {
+        L"Cold", L"Requesting permission", L"No permission", L"Compiling", L"Idle", L"Starting",
+        L"Listening", L"Pausing", L"Paused", L"Resuming", L"Failed", L"Stopped"
+    };
+
+    // Runs the lifecycle's operations on the UI thread, where the recognizer is created, and
+    // where the continuations of its operations run.
+    class DispatchedRecognizer : public IRecognizer
+    {
+    public:
+        DispatchedRecognizer(SpeechInput^ input, Windows::UI::Core::CoreDispatcher^ dispatcher) :
+            m_input(input),
+            m_dispatcher(dispatcher)
+        {
+        }
+
+        virtual void RequestPermission(Completion done) override
+        {
+            Run([](SpeechInput^) { return SpeechInput::Available(); }, done);
+        }
+
+        virtual void Compile(Completion done) override
+        {
+            Run([](SpeechInput^ input) { return input->CompileConstraints(); }, done);
+        }
+
+        virtual void StartSession(Completion done) override
+        {
+            Run([](SpeechInput^ input) { return input->StartSession(); }, done);
+        }
+
+        virtual void PauseSession(Completion done) override
+        {
+            Run([](SpeechInput^ input) { return input->PauseSession(); }, done);
+        }
+
+        virtual void ResumeSession(Completion done) override
+        {
+            Run([](SpeechInput^ input) { return input->ResumeSession(); }, done);
+        }
+
+        virtual void Release() override
+        {
+            Dispatch([](SpeechInput^ input) { input->StopSpeechRecognition(); });
+        }
+
+        // The lifecycle is thread safe, so the retry runs on the thread pool.
+        virtual void ScheduleRetry(std::chrono::milliseconds delay, std::function<void()> retry) override
+        {
+            TimeSpan period;
+            period.Duration = delay.count() * 10000;
+            ThreadPoolTimer::CreateTimer(ref new TimerElapsedHandler([retry](ThreadPoolTimer^) { retry(); }), period);
+        }
+
+    private:
+        void Run(std::function<task<bool>(SpeechInput^)> operation, Completion done)
+        {
+            Dispatch([operation, done](SpeechInput^ input)
+            {
+                operation(input).then([done](task<bool> previousTask)
+                {
+                    bool succeeded = false;
+                    try
+                    {
+                        succeeded = previousTask.get();
+                    }
+                    catch (...)
+                    {
+                    }
+                    done(succeeded);
+                });
+            });
+        }
+
+        // Runs work right away on the UI thread, later otherwise. The SpeechInput isn't kept
+        // alive for it; work is dropped once it has gone.
+        void Dispatch(std::function<void(SpeechInput^)> work)
+        {
+            Platform::WeakReference input = m_input;
+            auto run = [input, work]()
+            {
+                SpeechInput^ resolved = input.Resolve<SpeechInput>();
+                if (resolved != nullptr)
+                {
+                    work(resolved);
+                }
+            };
+
+            if (m_dispatcher->HasThreadAccess)
+            {
+                run();
+            }
+            else
+            {
+                m_dispatcher->RunAsync(Windows::UI::Core::CoreDispatcherPriority::Normal, ref new Windows::UI::Core::DispatchedHandler(run));
+            }
+        }
+
+        Platform::WeakReference                 m_input;
+        Windows::UI::Core::CoreDispatcher^      m_dispatcher;
+    };
+}
 
 SpeechInput::SpeechInput() 
-    : m_speechRecognizer(nullptr)
+    : m_speechRecognizer(nullptr),
+    m_activations(0)
 {
 
 }
 
 SpeechInput::~SpeechInput()
 {
-    Stop();
+    // The lifecycle can no longer reach this object to release the recognizer.
+    if (m_lifecycle)
+    {
+        m_lifecycle->Shutdown();
+    }
+    ReleaseVoiceActivityGate();
+    StopSpeechRecognition();
 }
 
 void SpeechInput::SetDelegate(IMRAppServiceListenerDelegate* delegate)
@@ -79,183 +214,368 @@ void SpeechInput::StopSpeechRecognition()
 	}
 }
 
-/// <summary>
-/// Upon leaving, clean up the speech recognizer. Ensure we aren't still listening, and disable the event 
-/// handlers to prevent leaks.
-/// </summary>
-/// <param name="e">Unused navigation parameters.</param>
-void SpeechInput::Stop()
+void SpeechInput::Start(IMRAppServiceListenerDelegate* delegate, Platform::Collections::Vector<Platform::String^>^ keys)
 {
-	auto cancelation = m_cancellationToken.get();
-	if (cancelation != nullptr)
+	m_delegate = delegate;
+
+	if (m_lifecycle)
 	{
-		cancelation->cancel();
+		throw ref new Platform::Exception(-1, L"Reentrant call to Start()");
 	}
-	else
+
+	m_commands = keys;
+	m_commandMatcher = CommandMatcher();
+	for each (String^ key in keys)
 	{
-		StopSpeechRecognition();
+		m_commandMatcher.Add(key->Data());
 	}
+
+	m_errorMessage = L"";
+	m_dispatcher = Windows::UI::Core::CoreWindow::GetForCurrentThread()->Dispatcher;
+	auto recognizer = std::make_shared<DispatchedRecognizer>(this, m_dispatcher);
+	m_lifecycle = std::make_unique<RecognizerLifecycle>(recognizer, [](RecognizerState state)
+	{
+		OutputDebugString((std::wstring(L"Speech recognizer: ") + StateNames[static_cast<int>(state)] + L"\n").c_str());
+	});
 }
 
-void SpeechInput::Start(IMRAppServiceListenerDelegate* delegate, Platform::Collections::Vector<Platform::String^>^ keys)
+void SpeechInput::SetActive(bool active)
 {
-	m_delegate = delegate;
+	m_active = active;
+	if (m_audioGraph != nullptr)
+	{
+		if (active)
+		{
+			// Listen right away, and until the gate sees a long silence from here on. Gate
+			// changes from before are ignored.
+			++m_activations;
+			m_lifecycle->SetGateOpen(true);
+			m_audioGraph->Start();
+		}
+		else
+		{
+			m_audioGraph->Stop();
+		}
+	}
 
-	if (m_cancellationToken.get() != nullptr || m_speechRecognizer != nullptr)
+	if (m_lifecycle)
 	{
-		throw ref new Platform::Exception(-1, L"Reentrant call to Start()");
+		m_lifecycle->SetActive(active);
 	}
+}
 
-	m_cancellationToken = std::make_shared<Concurrency::cancellation_token_source>(cancellation_token_source());
-	m_errorMessage = L"";
+void SpeechInput::CreateVoiceActivityGate()
+{
+	if (m_audioGraph != nullptr || m_creatingAudioGraph)
+	{
+		return;
+	}
+	m_creatingAudioGraph = true;
 
-	auto startTask = create_task(create_task(AudioCapturePermissions::RequestMicrophonePermissionAsync()));
-	startTask.then([this, keys](bool hasMicPermissions)
+	SpeechInput^ input = this;
+	AudioGraphSettings^ settings = ref new AudioGraphSettings(AudioRenderCategory::Speech);
+	create_task(AudioGraph::CreateAsync(settings), task_continuation_context::use_current())
+		.then([input](CreateAudioGraphResult^ result)
 	{
-		if (hasMicPermissions && !m_cancellationToken.get()->get_token().is_canceled())
+		if (result->Status != AudioGraphCreationStatus::Success)
 		{
-			return Initialize(keys);
+			throw ref new Platform::FailureException(L"The audio graph could not be created");
 		}
-		else
+		input->m_audioGraph = result->Graph;
+		return create_task(result->Graph->CreateDeviceInputNodeAsync(MediaCategory::Speech), task_continuation_context::use_current());
+	}, task_continuation_context::use_current())
+		.then([input](CreateAudioDeviceInputNodeResult^ result)
+	{
+		if (result->Status != AudioDeviceNodeCreationStatus::Success)
 		{
-			cancel_current_task();
+			throw ref new Platform::FailureException(L"The microphone could not be opened for voice activity detection");
 		}
-	}).then([this](bool success)
+
+		AudioGraph^ graph = input->m_audioGraph;
+		input->m_frameOutputNode = graph->CreateFrameOutputNode();
+		result->DeviceInputNode->AddOutgoingConnection(input->m_frameOutputNode);
+		input->m_channelCount = graph->EncodingProperties->ChannelCount;
+
+		VoiceActivityDetector::Settings detectorSettings;
+		detectorSettings.sampleRate = graph->EncodingProperties->SampleRate;
+		detectorSettings.stopFrames = VoiceActivityHangoverFrames;
+		input->m_voiceActivityDetector = std::make_unique<VoiceActivityDetector>(detectorSettings, nullptr);
+
+		// Gate changes are passed to the UI thread, where the lifecycle is used, with the
+		// activation they belong to. The gate starts open, as the lifecycle's does.
+		Platform::WeakReference weakInput(input);
+		Windows::UI::Core::CoreDispatcher^ dispatcher = input->m_dispatcher;
+		input->m_voiceActivityGate = std::make_unique<VoiceActivityGate>(VoiceActivityPauseDelay, [weakInput, dispatcher](bool open)
+		{
+			SpeechInput^ resolved = weakInput.Resolve<SpeechInput>();
+			if (resolved == nullptr)
+			{
+				return;
+			}
+			uint32_t activation = resolved->m_gateActivation;
+			dispatcher->RunAsync(Windows::UI::Core::CoreDispatcherPriority::Normal, ref new Windows::UI::Core::DispatchedHandler([weakInput, open, activation]()
+			{
+				SpeechInput^ resolved = weakInput.Resolve<SpeechInput>();
+				if (resolved != nullptr)
+				{
+					resolved->OnVoiceActivityGate(open, activation);
+				}
+			}));
+		});
+		input->m_gateActivation = input->m_activations;
+
+		input->m_quantumStartedToken = graph->QuantumStarted +=
+			ref new TypedEventHandler<AudioGraph^, Object^>(input, &SpeechInput::AudioGraph_QuantumStarted);
+
+		if (input->m_active)
+		{
+			graph->Start();
+		}
+	}, task_continuation_context::use_current())
+		.then([input](task<void> previousTask)
 	{
-		if (success && !m_cancellationToken.get()->get_token().is_canceled())
+		input->m_creatingAudioGraph = false;
+		try
 		{
-			return StartSpeechRecognition();
+			previousTask.get();
+		}
+		catch (Platform::Exception^ ex)
+		{
+			OutputDebugString((std::wstring(L"Voice activity detection unavailable: ") + ex->Message->Data() + L"\n").c_str());
+			input->ReleaseVoiceActivityGate();
+		}
+		catch (const std::exception&)
+		{
+			OutputDebugString(L"Voice activity detection unavailable for the audio format\n");
+			input->ReleaseVoiceActivityGate();
+		}
+	}, task_continuation_context::use_current());
+}
+
+void SpeechInput::ReleaseVoiceActivityGate()
+{
+	auto audioGraph = m_audioGraph;
+	m_audioGraph = nullptr;
+	m_frameOutputNode = nullptr;
+	if (audioGraph != nullptr)
+	{
+		audioGraph->QuantumStarted -= m_quantumStartedToken;
+		audioGraph->Stop();
+		delete audioGraph;
+	}
+
+	// Listen whenever the app is active, as without the gate.
+	if (m_lifecycle)
+	{
+		m_lifecycle->SetGateOpen(true);
+	}
+}
+
+void SpeechInput::OnVoiceActivityGate(bool open, uint32_t activation)
+{
+	OutputDebugString(open ? L"Voice activity gate opened\n" : L"Voice activity gate closed\n");
+
+	// Ignores changes from before the app was last activated.
+	if (m_active && m_audioGraph != nullptr && m_lifecycle && activation == m_activations)
+	{
+		m_lifecycle->SetGateOpen(open);
+	}
+}
+
+/// <summary>
+/// Runs the voice activity detector on the audio captured since the last quantum, on the audio
+/// graph's thread.
+/// </summary>
+void SpeechInput::AudioGraph_QuantumStarted(AudioGraph^ sender, Object^ args)
+{
+	AudioFrameOutputNode^ frameOutputNode = m_frameOutputNode;
+	if (frameOutputNode == nullptr)
+	{
+		return;
+	}
+	uint32_t activation = m_activations;
+	if (activation != m_gateActivation)
+	{
+		m_gateActivation = activation;
+		m_voiceActivityDetector->Reset();
+		m_voiceActivityGate->Reset(0.0);
+	}
+
+	AudioFrame^ frame = frameOutputNode->GetFrame();
+	AudioBuffer^ buffer = frame->LockBuffer(AudioBufferAccessMode::Read);
+	IMemoryBufferReference^ reference = buffer->CreateReference();
+
+	Microsoft::WRL::ComPtr<IMemoryBufferByteAccess> byteAccess;
+	BYTE* data = nullptr;
+	UINT32 capacity = 0;
+	if (SUCCEEDED(reinterpret_cast<IInspectable*>(reference)->QueryInterface(IID_PPV_ARGS(&byteAccess))) &&
+		SUCCEEDED(byteAccess->GetBuffer(&data, &capacity)))
+	{
+		// The graph's samples are 32 bit floats, interleaved.
+		const float* samples = reinterpret_cast<const float*>(data);
+		const size_t frames = buffer->Length / sizeof(float) / m_channelCount;
+		if (m_channelCount == 1)
+		{
+			m_voiceActivityDetector->Process(samples, frames);
 		}
 		else
 		{
-			cancel_current_task();
+			m_monoSamples.resize(frames);
+			const float scale = 1.0f / static_cast<float>(m_channelCount);
+			for (size_t i = 0; i < frames; ++i)
+			{
+				float sum = 0.0f;
+				for (unsigned int channel = 0; channel < m_channelCount; ++channel)
+				{
+					sum += samples[i * m_channelCount + channel];
+				}
+				m_monoSamples[i] = sum * scale;
+			}
+			m_voiceActivityDetector->Process(m_monoSamples.data(), frames);
 		}
-	}).then([this](task<void> t)
+		m_voiceActivityGate->Update(m_voiceActivityDetector->IsSpeech(), m_voiceActivityDetector->GetTime());
+	}
+
+	delete reference;
+	delete buffer;
+}
+
+void SpeechInput::ReportError(Platform::String^ message)
+{
+	m_errorMessage = message;
+	if (m_delegate)
+	{
+		m_delegate->OnSpeechRecognizerError(message);
+	}
+}
+
+Concurrency::task<bool> SpeechInput::Succeeded(Concurrency::task<void> operation)
+{
+	SpeechInput^ input = this;
+	return operation.then([input](task<void> previousTask)
 	{
 		try
 		{
-			t.get();
-
-			m_stateChangedToken = m_speechRecognizer->StateChanged +=
-				ref new TypedEventHandler<
-				SpeechRecognizer ^,
-				SpeechRecognizerStateChangedEventArgs ^>(
-					this,
-					&SpeechInput::SpeechRecognizer_StateChanged);
-
-			m_qualityDegradedToken = m_speechRecognizer->RecognitionQualityDegrading +=
-				ref new TypedEventHandler<
-				SpeechRecognizer ^,
-				SpeechRecognitionQualityDegradingEventArgs ^>(
-					this,
-					&SpeechInput::OnSpeechQualityDegraded);
-
-			// Handle continuous recognition events. Completed fires when various error states occur. ResultGenerated fires when
-			// some recognized phrases occur, or the garbage rule is hit.
-			m_completedToken = m_speechRecognizer->ContinuousRecognitionSession->Completed +=
-				ref new TypedEventHandler<
-				SpeechContinuousRecognitionSession ^,
-				SpeechContinuousRecognitionCompletedEventArgs ^>(
-					this,
-					&SpeechInput::ContinuousRecognitionSession_Completed);
-
-			m_resultEventToken = m_speechRecognizer->ContinuousRecognitionSession->ResultGenerated +=
-				ref new TypedEventHandler<
-				SpeechContinuousRecognitionSession ^,
-				SpeechContinuousRecognitionResultGeneratedEventArgs ^>(
-					this,
-					&SpeechInput::ContinuousRecognitionSession_ResultGenerated);
-
+			previousTask.get();
+			return true;
 		}
 		catch (Platform::Exception^ ex)
 		{
-			m_errorMessage = ex->Message;
-			StopSpeechRecognition();
-			m_delegate->OnSpeechRecognizerError(m_errorMessage);
+			input->ReportError(ex->Message);
 		}
 		catch (task_canceled)
 		{
-			StopSpeechRecognition();
-			m_errorMessage = L"Start cancelled";
-			m_delegate->OnSpeechRecognizerError(m_errorMessage);
+			input->ReportError(L"Speech recognition was cancelled");
 		}
+		return false;
+	});
+}
 
-		m_cancellationToken = nullptr;
+Concurrency::task<bool> SpeechInput::StartSession()
+{
+	return Succeeded(create_task(m_speechRecognizer->ContinuousRecognitionSession->StartAsync()));
+}
 
-	});
+Concurrency::task<bool> SpeechInput::PauseSession()
+{
+	// Keeps the recognizer and its compiled constraints, so resuming is immediate.
+	return Succeeded(create_task(m_speechRecognizer->ContinuousRecognitionSession->PauseAsync()));
 }
 
-Concurrency::task<void> SpeechInput::StartSpeechRecognition()
+Concurrency::task<bool> SpeechInput::ResumeSession()
 {
-    // The recognizer can only start listening in a continuous fashion if the recognizer is currently idle.
-    // This prevents an exception from occurring.
-    if (m_speechRecognizer->State == SpeechRecognizerState::Idle)
-    {
-		return create_task(m_speechRecognizer->ContinuousRecognitionSession->StartAsync());
-    }
-	else
+	try
+	{
+		m_speechRecognizer->ContinuousRecognitionSession->Resume();
+		return task_from_result(true);
+	}
+	catch (Platform::Exception^ ex)
 	{
-		// Cancelling recognition prevents any currently recognized speech from
-		// generating a ResultGenerated event. StopAsync() will allow the final session to 
-		// complete.
-		return create_task(m_speechRecognizer->ContinuousRecognitionSession->CancelAsync());
+		ReportError(ex->Message);
+		return task_from_result(false);
 	}
 }
 
-Concurrency::task<bool> SpeechInput::Initialize(Platform::Collections::Vector<Platform::String^>^ keys)
+/// <summary>
+/// Creates a SpeechRecognizer instance and compiles the grammar.
+/// </summary>
+Concurrency::task<bool> SpeechInput::CompileConstraints()
 {
     // Note: Language not fully implemented and code only tested for English
     Windows::Globalization::Language^ speechLanguage = SpeechRecognizer::SystemSpeechLanguage;
     m_speechContext = ResourceContext::GetForCurrentView();
     m_speechContext->Languages = ref new VectorView<String^>(1, speechLanguage->LanguageTag);
     m_speechResourceMap = ResourceManager::Current->MainResourceMap->GetSubtree(L"LocalizationSpeechResources");
-    return InitializeRecognizer(keys, SpeechRecognizer::SystemSpeechLanguage);
-}
 
-/// <summary>
-/// Creates a SpeechRecognizer instance and initializes the grammar.
-/// </summary>
-Concurrency::task<bool> SpeechInput::InitializeRecognizer(Platform::Collections::Vector<Platform::String^>^ keys, Windows::Globalization::Language^ recognizerLanguage)
-{
-    // If reinitializing the recognizer (ie, changing the speech language), clean up the old recognizer first.
-    // Avoid doing this while the recognizer is active by disabling the ability to change languages while listening.
-    if (m_speechRecognizer != nullptr)
+    if (m_constraint == nullptr)
     {
-        m_speechRecognizer->StateChanged -= m_stateChangedToken;
-        m_speechRecognizer->RecognitionQualityDegrading -= m_qualityDegradedToken;
-        m_speechRecognizer->ContinuousRecognitionSession->Completed -= m_completedToken;
-        m_speechRecognizer->ContinuousRecognitionSession->ResultGenerated -= m_resultEventToken;
-        delete m_speechRecognizer;
-        m_speechRecognizer = nullptr;
+        m_constraint = ref new SpeechRecognitionListConstraint(m_commands);
     }
 
-    return create_task([this, keys, recognizerLanguage]() 
+    SpeechInput^ input = this;
+    try
     {
-        m_speechRecognizer = ref new SpeechRecognizer(recognizerLanguage);
-
-
-
-        SpeechRecognitionListConstraint^ spConstraint = ref new SpeechRecognitionListConstraint(keys);
-        m_speechRecognizer->Constraints->Clear();
-        m_speechRecognizer->Constraints->Append(spConstraint);
+        m_speechRecognizer = ref new SpeechRecognizer(speechLanguage);
+        m_speechRecognizer->Constraints->Append(m_constraint);
+
+        m_stateChangedToken = m_speechRecognizer->StateChanged +=
+            ref new TypedEventHandler<
+            SpeechRecognizer ^,
+            SpeechRecognizerStateChangedEventArgs ^>(
+                this,
+                &SpeechInput::SpeechRecognizer_StateChanged);
+
+        m_qualityDegradedToken = m_speechRecognizer->RecognitionQualityDegrading +=
+            ref new TypedEventHandler<
+            SpeechRecognizer ^,
+            SpeechRecognitionQualityDegradingEventArgs ^>(
+                this,
+                &SpeechInput::OnSpeechQualityDegraded);
+
+        // Handle continuous recognition events. Completed fires when various error states occur. ResultGenerated fires when
+        // some recognized phrases occur, or the garbage rule is hit.
+        m_completedToken = m_speechRecognizer->ContinuousRecognitionSession->Completed +=
+            ref new TypedEventHandler<
+            SpeechContinuousRecognitionSession ^,
+            SpeechContinuousRecognitionCompletedEventArgs ^>(
+                this,
+                &SpeechInput::ContinuousRecognitionSession_Completed);
+
+        m_resultEventToken = m_speechRecognizer->ContinuousRecognitionSession->ResultGenerated +=
+            ref new TypedEventHandler<
+            SpeechContinuousRecognitionSession ^,
+            SpeechContinuousRecognitionResultGeneratedEventArgs ^>(
+                this,
+                &SpeechInput::ContinuousRecognitionSession_ResultGenerated);
 
         return create_task(m_speechRecognizer->CompileConstraintsAsync(), task_continuation_context::use_current())
-            .then([this](task<SpeechRecognitionCompilationResult^> previousTask)
+            .then([input](task<SpeechRecognitionCompilationResult^> previousTask)
         {
-            SpeechRecognitionCompilationResult^ compilationResult = previousTask.get();
-
-            if (compilationResult->Status != SpeechRecognitionResultStatus::Success)
+            try
             {
-
+                SpeechRecognitionCompilationResult^ compilationResult = previousTask.get();
+                if (compilationResult->Status != SpeechRecognitionResultStatus::Success)
+                {
+                    input->ReportError(L"The speech commands could not be compiled");
+                    return false;
+                }
+
+                // There is permission to use the microphone by now.
+                input->CreateVoiceActivityGate();
+                return true;
             }
-            else
+            catch (Platform::Exception^ ex)
             {
-
+                input->ReportError(ex->Message);
+                return false;
             }
-
-            return(compilationResult->Status == SpeechRecognitionResultStatus::Success);
         }, task_continuation_context::use_current());
-    });
+    }
+    catch (Platform::Exception^ ex)
+    {
+        ReportError(ex->Message);
+        return task_from_result(false);
+    }
 }
 
 /// <summary>
@@ -279,9 +599,14 @@ void SpeechInput::SpeechRecognizer_StateChanged(SpeechRecognizer ^sender, Speech
 /// <param name="args">The state of the recognizer</param>
 void SpeechInput::ContinuousRecognitionSession_Completed(SpeechContinuousRecognitionSession ^sender, SpeechContinuousRecognitionCompletedEventArgs ^args)
 {
-    if (m_delegate)
+    // A session that timed out or was cancelled is started again while the app is active.
+    // Anything else, such as the microphone going away, waits for the next activation.
+    bool recoverable = args->Status == SpeechRecognitionResultStatus::Success ||
+        args->Status == SpeechRecognitionResultStatus::TimeoutExceeded ||
+        args->Status == SpeechRecognitionResultStatus::UserCanceled;
+    if (m_lifecycle)
     {
-        //m_delegate->On(sender, args);
+        m_lifecycle->OnSessionEnded(recoverable);
     }
 }
 
@@ -297,6 +622,13 @@ void SpeechInput::ContinuousRecognitionSession_ResultGenerated(SpeechContinuousR
     if (m_delegate)
     {
         m_delegate->OnSpeechResultGenerated(sender, args);
+
+        // Transcriptions such as "purple." or "light blue" still select a command.
+        CommandMatcher::Match match = m_commandMatcher.Find(args->Result->Text->Data());
+        if (match.command != CommandMatcher::NoMatch && match.score >= MinimumCommandScore)
+        {
+            m_delegate->OnSpeechCommandRecognized(m_commands->GetAt(static_cast<unsigned int>(match.command)), match.score, args->Result);
+        }
     }
 }
 
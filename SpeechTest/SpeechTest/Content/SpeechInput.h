@@ -14,7 +14,13 @@
 #include <collection.h>
 #include <ppltasks.h>
 #include <pplcancellation_token.h>
+#include <atomic>
 #include <memory>
+#include <vector>
+
+#include "CommandMatcher.h"
+#include "RecognizerLifecycle.h"
+#include "VoiceActivityDetector.h"
 
 namespace Speech
 {
@@ -24,6 +30,11 @@ namespace Speech
         virtual void OnSpeechResultGenerated(Windows::Media::SpeechRecognition::SpeechContinuousRecognitionSession ^sender, Windows::Media::SpeechRecognition::SpeechContinuousRecognitionResultGeneratedEventArgs ^args) = 0;
 		virtual void OnRecognizerStateChanged(Windows::Media::SpeechRecognition::SpeechRecognizer^ recognizer, Windows::Media::SpeechRecognition::SpeechRecognizerStateChangedEventArgs^ args) = 0;
 		virtual void OnSpeechRecognizerError(Platform::String^ error) = 0;
+
+        // Called after OnSpeechResultGenerated when the text heard matches one of the commands
+        // passed to Start closely enough. command is the command as passed to Start, score is
+        // CommandMatcher's and is 1 when the text is the command.
+        virtual void OnSpeechCommandRecognized(Platform::String^ command, float score, Windows::Media::SpeechRecognition::SpeechRecognitionResult^ result) = 0;
 	};
 
 
@@ -34,16 +45,34 @@ namespace Speech
         virtual ~SpeechInput();
 
     internal:
+		// Must be called on the UI thread. Nothing is started until SetActive(true); the
+		// recognizer is then kept, paused, while the app isn't active, and while it is active
+		// but nobody is speaking.
 		void Start(IMRAppServiceListenerDelegate* delegate, Platform::Collections::Vector<Platform::String^>^ keys);
+		void SetActive(bool active);
 		static Concurrency::task<bool> Available();
 
-    private:
-		Concurrency::task<bool> Initialize(Platform::Collections::Vector<Platform::String^>^ keys);
-		Concurrency::task<void> StartSpeechRecognition();
-		void Stop();
+		// The operations RecognizerLifecycle drives, on the UI thread. Failures are reported to
+		// the delegate and return false.
+		Concurrency::task<bool> CompileConstraints();
+		Concurrency::task<bool> StartSession();
+		Concurrency::task<bool> PauseSession();
+		Concurrency::task<bool> ResumeSession();
 		void StopSpeechRecognition();
 
+    private:
 		void SetDelegate(IMRAppServiceListenerDelegate* delegate);
+		Concurrency::task<bool> Succeeded(Concurrency::task<void> operation);
+		void ReportError(Platform::String^ message);
+
+		// The voice activity gate: an audio graph that feeds the microphone to a
+		// VoiceActivityDetector and a VoiceActivityGate, which close the lifecycle's gate after
+		// a long silence and open it again when somebody speaks. Without it the session
+		// listens whenever the app is active.
+		void CreateVoiceActivityGate();
+		void ReleaseVoiceActivityGate();
+		void OnVoiceActivityGate(bool open, uint32_t activation);
+		void AudioGraph_QuantumStarted(Windows::Media::Audio::AudioGraph^ sender, Platform::Object^ args);
 
         static const unsigned int HResultPrivacyStatementDeclined = 0x80045509;
         static const unsigned int HResultRecognizerNotFound = 0x8004503a;
@@ -53,8 +82,8 @@ namespace Speech
         Windows::ApplicationModel::Resources::Core::ResourceMap^ m_speechResourceMap;
         bool isPopulatingLanguages = false;
 
-
-        Concurrency::task<bool> InitializeRecognizer(Platform::Collections::Vector<Platform::String^>^ keys, Windows::Globalization::Language^ recognizerLanguage);
+        // Built once from the commands and added to every recognizer created.
+        Windows::Media::SpeechRecognition::SpeechRecognitionListConstraint^ m_constraint;
 
         Windows::Foundation::EventRegistrationToken m_stateChangedToken;
         Windows::Foundation::EventRegistrationToken m_resultEventToken;
@@ -68,8 +97,29 @@ namespace Speech
 
         IMRAppServiceListenerDelegate* m_delegate;
 
-		std::shared_ptr<Concurrency::cancellation_token_source> m_cancellationToken;
+        // The commands passed to Start, and the matcher that finds them in the results.
+        Platform::Collections::Vector<Platform::String^>^ m_commands;
+        CommandMatcher m_commandMatcher;
+
+		std::unique_ptr<RecognizerLifecycle> m_lifecycle;
 		Platform::String^ m_errorMessage;
+		Windows::UI::Core::CoreDispatcher^ m_dispatcher;
+		bool m_active = false;
+
+		Windows::Media::Audio::AudioGraph^ m_audioGraph;
+		Windows::Media::Audio::AudioFrameOutputNode^ m_frameOutputNode;
+		Windows::Foundation::EventRegistrationToken m_quantumStartedToken;
+		bool m_creatingAudioGraph = false;
+
+		// Only used on the audio graph's thread once the graph has started.
+		std::unique_ptr<VoiceActivityDetector> m_voiceActivityDetector;
+		std::unique_ptr<VoiceActivityGate> m_voiceActivityGate;
+		std::vector<float> m_monoSamples;
+		unsigned int m_channelCount = 1;
+		uint32_t m_gateActivation = 0;      // The activation the detector and gate were last reset for.
+
+		// Counts activations of the app; the detector and gate start again with each.
+		std::atomic<uint32_t> m_activations;
 
     };
 }
@@ -1,7 +1,8 @@
 #pragma once
 
-#include "..\Common\DeviceResources.h"
-#include "..\Common\StepTimer.h"
+#include "Common\DeviceResources.h"
+#include "Common\StepTimer.h"
+#include "Core\CommandRecorder.h"
 #include "ShaderStructures.h"
 
 namespace SpeechTest
@@ -15,6 +16,11 @@ namespace SpeechTest
         void ReleaseDeviceDependentResources();
         void Update(const DX::StepTimer& timer);
         void Render();
+
+        // Starts a new frame for the command recorder; see Render.
+        void BeginFrame();
+        const DX::CommandStats& GetCommandStats() const { return m_commands.GetLastFrameStats(); }
+
         void SetColor(Windows::Foundation::Numerics::float4 color);
 
         // Repositions the sample hologram.
@@ -28,6 +34,9 @@ namespace SpeechTest
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources>            m_deviceResources;
 
+        // Records the draw each frame and filters redundant state changes.
+        DX::CommandRecorder                             m_commands;
+
         // Direct3D resources for cube geometry.
         Microsoft::WRL::ComPtr<ID3D11InputLayout>       m_inputLayout;
         Microsoft::WRL::ComPtr<ID3D11Buffer>            m_vertexBuffer;
@@ -0,0 +1,399 @@
+#include "VoiceActivityDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if !defined(VOICE_ACTIVITY_SCALAR) && (defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__))
+#define VOICE_ACTIVITY_SSE2 1
+#include <emmintrin.h>
+#else
+#define VOICE_ACTIVITY_SSE2 0
+#endif
+
+using namespace Speech;
+
+namespace
+{
+    const float Pi = 3.14159265358979f;
+
+    // Added to every power so silence has a flat spectrum rather than a log of zero.
+    const float PowerFloor = 1e-12f;
+
+    // How fast the noise floor follows the frame energy: quickly down, slowly up, and up
+    // more slowly still through frames that look like speech, so a steady tonal noise is
+    // eventually taken for background.
+    const float FloorFall = 0.2f;
+    const float FloorRise = 0.01f;
+    const float FloorRiseInSpeech = 0.0005f;
+
+    const float InverseLn2 = 1.44269504f;
+
+#if VOICE_ACTIVITY_SSE2
+    int BitCount4(int bits)
+    {
+        static const int counts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+        return counts[bits];
+    }
+
+    float HorizontalSum(__m128 v)
+    {
+        __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    }
+
+    // log2 of positive normal floats to about 1e-7: the exponent, plus the mantissa brought
+    // to [sqrt(1/2), sqrt(2)) through the series of atanh((m - 1) / (m + 1)).
+    __m128 Log2(__m128 x)
+    {
+        const __m128i bits = _mm_castps_si128(x);
+        __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+        const __m128 high = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+        mantissa = _mm_mul_ps(mantissa, _mm_or_ps(_mm_and_ps(high, _mm_set1_ps(0.5f)), _mm_andnot_ps(high, _mm_set1_ps(1.0f))));
+        exponent = _mm_add_ps(exponent, _mm_and_ps(high, _mm_set1_ps(1.0f)));
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 s = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+        const __m128 s2 = _mm_mul_ps(s, s);
+        __m128 series = _mm_add_ps(_mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(s2, _mm_set1_ps(1.0f / 7.0f)));
+        series = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(s2, series));
+        series = _mm_add_ps(one, _mm_mul_ps(s2, series));
+        return _mm_add_ps(exponent, _mm_mul_ps(_mm_mul_ps(s, series), _mm_set1_ps(2.0f * InverseLn2)));
+    }
+#endif
+
+    void SumSquaresAndCrossings(const float* samples, size_t count, float& sumSquares, unsigned int& crossings)
+    {
+        sumSquares = 0.0f;
+        crossings = 0;
+        size_t i = 0;
+#if VOICE_ACTIVITY_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (; i + 4 < count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(samples + i);
+            sum = _mm_add_ps(sum, _mm_mul_ps(x, x));
+            crossings += BitCount4(_mm_movemask_ps(x) ^ _mm_movemask_ps(_mm_loadu_ps(samples + i + 1)));
+        }
+        sumSquares = HorizontalSum(sum);
+#endif
+        for (; i < count; ++i)
+        {
+            sumSquares += samples[i] * samples[i];
+            if (i + 1 < count && std::signbit(samples[i]) != std::signbit(samples[i + 1]))
+            {
+                ++crossings;
+            }
+        }
+    }
+
+    // The windowed samples, even ones to even and odd ones to odd, pairs of them.
+    void WindowAndSplit(const float* samples, const float* window, float* even, float* odd, size_t pairs)
+    {
+        size_t i = 0;
+#if VOICE_ACTIVITY_SSE2
+        for (; i + 4 <= pairs; i += 4)
+        {
+            const __m128 low = _mm_mul_ps(_mm_loadu_ps(samples + 2 * i), _mm_loadu_ps(window + 2 * i));
+            const __m128 high = _mm_mul_ps(_mm_loadu_ps(samples + 2 * i + 4), _mm_loadu_ps(window + 2 * i + 4));
+            _mm_storeu_ps(even + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(odd + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#endif
+        for (; i < pairs; ++i)
+        {
+            even[i] = samples[2 * i] * window[2 * i];
+            odd[i] = samples[2 * i + 1] * window[2 * i + 1];
+        }
+    }
+
+    // Sum and sum of log2 of positive values.
+    void SumAndLogSum(const float* values, size_t count, float& sum, float& logSum)
+    {
+        sum = 0.0f;
+        logSum = 0.0f;
+        size_t i = 0;
+#if VOICE_ACTIVITY_SSE2
+        __m128 sums = _mm_setzero_ps();
+        __m128 logSums = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(values + i);
+            sums = _mm_add_ps(sums, x);
+            logSums = _mm_add_ps(logSums, Log2(x));
+        }
+        sum = HorizontalSum(sums);
+        logSum = HorizontalSum(logSums);
+#endif
+        for (; i < count; ++i)
+        {
+            sum += values[i];
+            logSum += std::log2(values[i]);
+        }
+    }
+}
+
+VoiceActivityDetector::VoiceActivityDetector(const Settings& settings, EventCallback callback) :
+    m_settings(settings),
+    m_callback(std::move(callback))
+{
+    if (settings.sampleRate < 8000 || settings.sampleRate > 192000)
+    {
+        throw std::invalid_argument("Voice activity detection needs a sample rate from 8 kHz to 192 kHz.");
+    }
+
+    m_frameLength = settings.sampleRate / 100;
+    const size_t analysisLength = 3 * m_frameLength;
+    m_fftLength = 2;
+    while (m_fftLength < analysisLength)
+    {
+        m_fftLength *= 2;
+    }
+    const size_t half = m_fftLength / 2;
+
+    // About an octave each, from 100 Hz to 4 kHz.
+    const float edges[] = { 100.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f };
+    const float binWidth = static_cast<float>(settings.sampleRate) / static_cast<float>(m_fftLength);
+    for (size_t i = 0; i + 1 < sizeof(edges) / sizeof(edges[0]); ++i)
+    {
+        size_t first = std::max<size_t>(1, static_cast<size_t>(std::ceil(edges[i] / binWidth)));
+        size_t last = std::min(half, static_cast<size_t>(edges[i + 1] / binWidth));
+        m_bands.push_back(std::make_pair(first, last));
+    }
+
+    m_history.assign(analysisLength, 0.0f);
+    m_window.resize(analysisLength);
+    for (size_t i = 0; i < analysisLength; ++i)
+    {
+        m_window[i] = 0.5f - 0.5f * std::cos(2.0f * Pi * static_cast<float>(i) / static_cast<float>(analysisLength - 1));
+    }
+
+    m_cosines.resize(half);
+    m_sines.resize(half);
+    for (size_t k = 0; k < half; ++k)
+    {
+        m_cosines[k] = std::cos(2.0f * Pi * static_cast<float>(k) / static_cast<float>(m_fftLength));
+        m_sines[k] = -std::sin(2.0f * Pi * static_cast<float>(k) / static_cast<float>(m_fftLength));
+    }
+
+    m_bitReversed.resize(half);
+    for (size_t i = 0; i < half; ++i)
+    {
+        uint32_t reversed = 0;
+        for (size_t bit = 1; bit < half; bit *= 2)
+        {
+            reversed = (reversed << 1) | ((i & bit) ? 1 : 0);
+        }
+        m_bitReversed[i] = reversed;
+    }
+
+    m_real.resize(half);
+    m_imaginary.resize(half);
+    m_power.resize(half + 1);
+    m_pending.reserve(m_frameLength);
+    Reset();
+}
+
+void VoiceActivityDetector::Process(const float* samples, size_t count)
+{
+    if (!m_pending.empty())
+    {
+        size_t taken = std::min(m_frameLength - m_pending.size(), count);
+        m_pending.insert(m_pending.end(), samples, samples + taken);
+        samples += taken;
+        count -= taken;
+        if (m_pending.size() < m_frameLength)
+        {
+            return;
+        }
+        ProcessFrame(m_pending.data());
+        m_pending.clear();
+    }
+
+    for (; count >= m_frameLength; samples += m_frameLength, count -= m_frameLength)
+    {
+        ProcessFrame(samples);
+    }
+    m_pending.assign(samples, samples + count);
+}
+
+void VoiceActivityDetector::Reset()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_pending.clear();
+    m_frames = 0;
+    m_noiseFloor = 0.0f;
+    m_speech = false;
+    m_run = 0;
+    m_runStart = 0;
+    m_features = VoiceActivityFeatures();
+}
+
+float VoiceActivityDetector::SpectralFlatness()
+{
+    // The real FFT of the windowed history, from a complex FFT of half the length with the
+    // even samples as real parts and the odd ones as imaginary parts.
+    const size_t half = m_fftLength / 2;
+    const size_t length = m_history.size();
+    const size_t pairs = length / 2;
+    WindowAndSplit(m_history.data(), m_window.data(), m_real.data(), m_imaginary.data(), pairs);
+    std::fill(m_real.begin() + pairs, m_real.end(), 0.0f);
+    std::fill(m_imaginary.begin() + pairs, m_imaginary.end(), 0.0f);
+    if (length % 2 != 0)
+    {
+        m_real[pairs] = m_history[length - 1] * m_window[length - 1];
+    }
+
+    for (size_t i = 0; i < half; ++i)
+    {
+        if (m_bitReversed[i] > i)
+        {
+            std::swap(m_real[i], m_real[m_bitReversed[i]]);
+            std::swap(m_imaginary[i], m_imaginary[m_bitReversed[i]]);
+        }
+    }
+    for (size_t size = 2; size <= half; size *= 2)
+    {
+        const size_t step = m_fftLength / size;
+        for (size_t start = 0; start < half; start += size)
+        {
+            for (size_t k = 0; k < size / 2; ++k)
+            {
+                const float c = m_cosines[k * step];
+                const float s = m_sines[k * step];
+                const size_t a = start + k;
+                const size_t b = a + size / 2;
+                const float re = c * m_real[b] - s * m_imaginary[b];
+                const float im = c * m_imaginary[b] + s * m_real[b];
+                m_real[b] = m_real[a] - re;
+                m_imaginary[b] = m_imaginary[a] - im;
+                m_real[a] += re;
+                m_imaginary[a] += im;
+            }
+        }
+    }
+
+    // Separate the spectra of the even and odd samples and combine them.
+    m_power[0] = (m_real[0] + m_imaginary[0]) * (m_real[0] + m_imaginary[0]) + PowerFloor;
+    m_power[half] = (m_real[0] - m_imaginary[0]) * (m_real[0] - m_imaginary[0]) + PowerFloor;
+    for (size_t k = 1; k < half; ++k)
+    {
+        const float evenReal = 0.5f * (m_real[k] + m_real[half - k]);
+        const float evenImaginary = 0.5f * (m_imaginary[k] - m_imaginary[half - k]);
+        const float oddReal = 0.5f * (m_imaginary[k] + m_imaginary[half - k]);
+        const float oddImaginary = -0.5f * (m_real[k] - m_real[half - k]);
+        const float re = evenReal + m_cosines[k] * oddReal - m_sines[k] * oddImaginary;
+        const float im = evenImaginary + m_cosines[k] * oddImaginary + m_sines[k] * oddReal;
+        m_power[k] = re * re + im * im + PowerFloor;
+    }
+
+    float weighted = 0.0f;
+    float total = 0.0f;
+    for (const auto& band : m_bands)
+    {
+        const size_t bins = band.second - band.first + 1;
+        float sum;
+        float logSum;
+        SumAndLogSum(m_power.data() + band.first, bins, sum, logSum);
+        weighted += sum * std::exp2(logSum / static_cast<float>(bins)) / (sum / static_cast<float>(bins));
+        total += sum;
+    }
+    return std::min(1.0f, weighted / total);
+}
+
+void VoiceActivityDetector::ProcessFrame(const float* frame)
+{
+    float sumSquares;
+    unsigned int crossings;
+    SumSquaresAndCrossings(frame, m_frameLength, sumSquares, crossings);
+    m_features.energy = 10.0f * std::log10(sumSquares / static_cast<float>(m_frameLength) + 1e-10f);
+    m_features.zeroCrossingRate = static_cast<float>(crossings) / static_cast<float>(m_frameLength - 1);
+
+    std::copy(m_history.begin() + m_frameLength, m_history.end(), m_history.begin());
+    std::copy(frame, frame + m_frameLength, m_history.end() - m_frameLength);
+    m_features.spectralFlatness = SpectralFlatness();
+
+    if (m_frames == 0)
+    {
+        m_noiseFloor = m_features.energy;
+    }
+    const bool speechFrame =
+        m_features.energy > std::max(m_noiseFloor + m_settings.margin, m_settings.minimumEnergy) &&
+        m_features.spectralFlatness < m_settings.maximumFlatness &&
+        m_features.zeroCrossingRate < m_settings.maximumZeroCrossingRate;
+
+    const float rate = m_features.energy < m_noiseFloor ? FloorFall : speechFrame || m_speech ? FloorRiseInSpeech : FloorRise;
+    m_noiseFloor += rate * (m_features.energy - m_noiseFloor);
+
+    if (speechFrame == m_speech)
+    {
+        m_run = 0;
+    }
+    else
+    {
+        if (m_run == 0)
+        {
+            m_runStart = m_frames;
+        }
+        if (++m_run >= (m_speech ? m_settings.stopFrames : m_settings.startFrames))
+        {
+            m_speech = speechFrame;
+            m_run = 0;
+            if (m_callback)
+            {
+                VoiceActivityEvent event;
+                event.speech = m_speech;
+                event.time = static_cast<double>(m_runStart * m_frameLength) / static_cast<double>(m_settings.sampleRate);
+                m_callback(event);
+            }
+        }
+    }
+    ++m_frames;
+}
+
+VoiceActivityGate::VoiceActivityGate(double closeDelay, ChangedCallback changed) :
+    m_closeDelay(closeDelay),
+    m_changed(std::move(changed)),
+    m_open(true),
+    m_lastSpeech(0.0)
+{
+}
+
+void VoiceActivityGate::Update(bool speech, double time)
+{
+    if (speech)
+    {
+        m_lastSpeech = time;
+        if (!m_open)
+        {
+            m_open = true;
+            if (m_changed)
+            {
+                m_changed(true);
+            }
+        }
+    }
+    else if (m_open && time - m_lastSpeech >= m_closeDelay)
+    {
+        m_open = false;
+        if (m_changed)
+        {
+            m_changed(false);
+        }
+    }
+}
+
+void VoiceActivityGate::Reset(double time)
+{
+    m_lastSpeech = time;
+    if (!m_open)
+    {
+        m_open = true;
+        if (m_changed)
+        {
+            m_changed(true);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Speech
+{
+    struct VoiceActivityFeatures
+    {
+        float   energy;             // Mean square of the frame, in dB relative to full scale.
+        float   zeroCrossingRate;   // Sign changes per sample, 0 to 1.
+        float   spectralFlatness;   // Geometric over arithmetic mean of the power spectrum, 0 to 1.
+    };
+
+    struct VoiceActivityEvent
+    {
+        bool    speech;             // Started rather than stopped.
+        double  time;               // Seconds of audio processed since construction or Reset.
+    };
+
+    // Tells speech from silence and steady background noise in 10 ms frames of mono audio. A
+    // frame counts as speech when its energy is well above the tracked noise floor, it has few
+    // enough zero crossings to be voiced, and its spectrum has the peaks of a voice's harmonics
+    // rather than being flat. Flatness is measured over the last 30 ms, which resolves the
+    // harmonics of low voices where 10 ms can't, in bands weighted by their power so the tilt
+    // of a noise spectrum doesn't count as peaks. Speech starts after a few such frames in a
+    // row and stops after a longer run without, so unvoiced sounds and short pauses inside a
+    // sentence don't end it. Standard C++, with SSE2 for the per-sample work where it is
+    // available.
+    class VoiceActivityDetector
+    {
+    public:
+        struct Settings
+        {
+            unsigned int    sampleRate = 16000;
+            float           margin = 9.0f;                  // dB above the noise floor.
+            float           minimumEnergy = -55.0f;         // dBFS, whatever the noise floor.
+            float           maximumFlatness = 0.45f;
+            float           maximumZeroCrossingRate = 0.4f;
+            unsigned int    startFrames = 3;                // Speech frames in a row to start.
+            unsigned int    stopFrames = 30;                // Other frames in a row to stop.
+        };
+
+        // Called from Process, with the time the first or last speech frame began or ended.
+        typedef std::function<void(const VoiceActivityEvent& event)> EventCallback;
+
+        // Throws std::invalid_argument for a sample rate under 8 kHz or over 192 kHz.
+        VoiceActivityDetector(const Settings& settings, EventCallback callback);
+
+        // Samples in [-1, 1], any number at a time. Frames left incomplete are kept for the
+        // next call.
+        void Process(const float* samples, size_t count);
+
+        // Forgets the audio so far, as for a new stream. The noise floor is learnt again.
+        void Reset();
+
+        bool IsSpeech() const { return m_speech; }
+
+        // Seconds of audio in the frames processed since construction or Reset.
+        double GetTime() const { return static_cast<double>(m_frames * m_frameLength) / static_cast<double>(m_settings.sampleRate); }
+
+        // Of the last complete frame.
+        const VoiceActivityFeatures& GetLastFeatures() const { return m_features; }
+
+        size_t GetFrameLength() const { return m_frameLength; }
+
+    private:
+        void ProcessFrame(const float* frame);
+        float SpectralFlatness();
+
+        Settings                            m_settings;
+        EventCallback                       m_callback;
+        size_t                              m_frameLength;
+        size_t                              m_fftLength;
+
+        // Power spectrum bins of the bands the flatness is measured in, first and last.
+        std::vector<std::pair<size_t, size_t>> m_bands;
+
+        std::vector<float>                  m_history;      // The last 30 ms, oldest first.
+        std::vector<float>                  m_window;
+        std::vector<float>                  m_cosines;      // Of 2 pi k / m_fftLength.
+        std::vector<float>                  m_sines;
+        std::vector<uint32_t>               m_bitReversed;  // For the half length FFT.
+        std::vector<float>                  m_real;
+        std::vector<float>                  m_imaginary;
+        std::vector<float>                  m_power;
+
+        std::vector<float>                  m_pending;      // Start of a frame from the last Process.
+        uint64_t                            m_frames;
+        float                               m_noiseFloor;
+        bool                                m_speech;
+        unsigned int                        m_run;          // Frames in a row disagreeing with m_speech.
+        uint64_t                            m_runStart;
+        VoiceActivityFeatures               m_features;
+    };
+
+    // Decides when a recognizer fed by the same microphone can stop listening. Pausing it
+    // whenever the detector reports silence would lose the first word after every pause, since
+    // resuming takes longer than the detector takes to notice speech. So the gate opens with
+    // speech, and on Reset, and only closes once the detector has reported no speech for
+    // closeDelay seconds, which on top of the detector's own stop frames is longer than the
+    // pauses inside and between the sentences of a conversation.
+    class VoiceActivityGate
+    {
+    public:
+        // Called from Update and Reset when the gate opens or closes.
+        typedef std::function<void(bool open)> ChangedCallback;
+
+        // Open until closeDelay seconds of silence.
+        VoiceActivityGate(double closeDelay, ChangedCallback changed);
+
+        // After the detector has processed audio up to time.
+        void Update(bool speech, double time);
+
+        // Opens the gate and starts counting silence again from time, e.g. after the detector
+        // was reset for a new stream.
+        void Reset(double time);
+
+        bool IsOpen() const { return m_open; }
+
+    private:
+        double          m_closeDelay;
+        ChangedCallback m_changed;
+        bool            m_open;
+        double          m_lastSpeech;
+    };
+}
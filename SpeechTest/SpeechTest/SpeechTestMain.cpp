@@ -1,9 +1,11 @@
 #include "pch.h"
 #include "SpeechTestMain.h"
 #include "Common\DirectXHelper.h"
+#include "Core\Trace.h"
 
 #include <windows.graphics.directx.direct3d11.interop.h>
 #include <Collection.h>
+#include <fstream>
 
 
 using namespace SpeechTest;
@@ -162,7 +164,7 @@ SpeechTestMain::~SpeechTestMain()
 // Updates the application state once per frame.
 HolographicFrame^ SpeechTestMain::Update()
 {
-    UpdateSpeechRecognizer(m_timer.GetTotalSeconds());
+    DX_TRACE_SCOPE("Update");
 
     // Before doing the timer update, there is some work to do per-frame
     // to maintain holographic rendering. First, we will get information
@@ -184,6 +186,8 @@ HolographicFrame^ SpeechTestMain::Update()
 #ifdef DRAW_SAMPLE_CONTENT
     if (m_stationaryReferenceFrame != nullptr)
     {
+        DX_TRACE_SCOPE("Input");
+
         // Check for new input state since the last frame.
         for (auto& gamepadWithButtonState : m_gamepads)
         {
@@ -223,6 +227,8 @@ HolographicFrame^ SpeechTestMain::Update()
         // run as many times as needed to get to the current step.
         //
 
+        DX_TRACE_SCOPE("Update scene");
+
 #ifdef DRAW_SAMPLE_CONTENT
         m_spinningCubeRenderer->Update(m_timer);
 #endif
@@ -266,6 +272,8 @@ HolographicFrame^ SpeechTestMain::Update()
 // frame was rendered to at least one camera.
 bool SpeechTestMain::Render(HolographicFrame^ holographicFrame)
 {
+    DX_TRACE_SCOPE("Render");
+
     // Don't try to render anything before the first Update.
     if (m_timer.GetFrameCount() == 0)
     {
@@ -280,6 +288,12 @@ bool SpeechTestMain::Render(HolographicFrame^ holographicFrame)
     // matrix, such as lighting maps.
     //
 
+#ifdef DRAW_SAMPLE_CONTENT
+    // The renderer replays its draws through a command recorder that skips state the
+    // device already has; state set by the previous frame can't be trusted.
+    m_spinningCubeRenderer->BeginFrame();
+#endif
+
     // Lock the set of holographic camera resources, then draw to each camera
     // in this frame.
     return m_deviceResources->UseHolographicCameraResources<bool>(
@@ -293,6 +307,8 @@ bool SpeechTestMain::Render(HolographicFrame^ holographicFrame)
         bool atLeastOneCameraRendered = false;
         for (auto cameraPose : prediction->CameraPoses)
         {
+            DX_TRACE_SCOPE_VALUE("Render camera", cameraPose->HolographicCamera->Id);
+
             // This represents the device-based resources for a HolographicCamera.
             DX::CameraResources* pCameraResources = cameraResourceMap[cameraPose->HolographicCamera->Id].get();
 
@@ -360,6 +376,12 @@ void SpeechTestMain::SaveAppState()
     //
     //       For example, store information in the SpatialAnchorStore.
     //
+
+#if DX_TRACE_ENABLED
+    // Write the frames traced so far to LocalState\trace.json for chrome://tracing.
+    std::ofstream traceFile(std::wstring(Windows::Storage::ApplicationData::Current->LocalFolder->Path->Data()) + L"\\trace.json");
+    DX::Trace::WriteChromeJson(traceFile);
+#endif
 }
 
 void SpeechTestMain::LoadAppState()
@@ -565,26 +587,8 @@ void SpeechTestMain::InitializeSpeechCommandList()
     m_speechCommandData->Insert(L"SpeechRecognizer", float4(0.5f, 0.1f, 1.f, 1.f));
 }
 
-void SpeechTestMain::InitializeMicrophone()
-{
-	Speech::SpeechInput::Available().then([this](bool hasMicPermission)
-    {
-        m_hasMicPermission = hasMicPermission;
-        if (m_hasMicPermission)
-        {
-            OutputDebugString(L"Microphone permission enabled\n");
-        }
-        else
-        {
-            OutputDebugString(L"Microphone permission disabled\n");
-        }
-    });
-}
-
 void SpeechTestMain::InitializeSpeech()
 {
-	m_speechInput = nullptr;
-
 	// Here, we compile the list of voice commands by reading them from the map.
 	Platform::Collections::Vector<String^>^ speechCommandList = ref new Platform::Collections::Vector<String^>();
 	for each (auto pair in m_speechCommandData)
@@ -596,58 +600,15 @@ void SpeechTestMain::InitializeSpeech()
 	m_speechInput->Start(this, speechCommandList);
 }
 
-void SpeechTestMain::InitializeSpeechWithDelay()
-{
-    Windows::Foundation::TimeSpan delay;
-    delay.Duration = 6 * 10000000; // 6 seconds
-
-    CoreDispatcher^ dispatcher = CoreWindow::GetForCurrentThread()->Dispatcher;
-
-    ThreadPoolTimer ^ PeriodicTimer = ThreadPoolTimer::CreateTimer(
-        ref new TimerElapsedHandler([this, dispatcher](ThreadPoolTimer^ source) {
-
-        // run this ThreadPoolTimer on the main UI thread
-        dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new Windows::UI::Core::DispatchedHandler([this, dispatcher]()
-        {
-            InitializeSpeech();
-        }));
-    }), delay);
-}
-
 void SpeechTestMain::OnActivated(bool activated)
 {
-	m_activated = activated;
-}
-
-void SpeechTestMain::UpdateSpeechRecognizer(double time)
-{
-    if (time > 6.0)
+    // The recognizer is created on the first activation and then only paused while the app
+    // isn't active, so it listens again as soon as the app is.
+    if (m_speechInput == nullptr)
     {
-        if (m_activated && !m_micInitialized)
-        {
-            m_micInitialized = true;
-            InitializeMicrophone();
-            OutputDebugString(L"Requesting mic permission\n");
-        }
-
-        if (m_hasMicPermission)
-        {
-            if (m_activated && !m_speechInitialized)
-            {
-                m_speechInitialized = true;
-                InitializeSpeech();
-                OutputDebugString(L"Starting speech recognition\n");
-            }
-            else if (!m_activated && m_speechInitialized)
-            {
-                m_speechInitialized = false;
-                m_micInitialized = false;
-                m_hasMicPermission = false;
-				m_speechInput = nullptr;
-                OutputDebugString(L"Stopping speech recognition\n");
-            }
-        }
+        InitializeSpeech();
     }
+    m_speechInput->SetActive(activated);
 }
 
 void SpeechTestMain::OnSpeechResultGenerated(SpeechContinuousRecognitionSession ^sender, SpeechContinuousRecognitionResultGeneratedEventArgs ^args)
@@ -659,12 +620,6 @@ void SpeechTestMain::OnSpeechResultGenerated(SpeechContinuousRecognitionSession
     if ((args->Result->Confidence == SpeechRecognitionConfidence::High) ||
         (args->Result->Confidence == SpeechRecognitionConfidence::Medium))
     {
-        if (m_speechCommandData->HasKey(args->Result->Text))
-        {
-            m_spinningCubeRenderer->SetColor(m_speechCommandData->Lookup(args->Result->Text));
-
-        }
-
         // When the debugger is attached, we can print information to the debug console.
         OutputDebugString(
             (std::wstring(L"Last command was: ") +
@@ -678,6 +633,22 @@ void SpeechTestMain::OnSpeechResultGenerated(SpeechContinuousRecognitionSession
     }
 }
 
+void SpeechTestMain::OnSpeechCommandRecognized(String^ command, float score, SpeechRecognitionResult^ result)
+{
+    // The same confidence is needed as for the text itself.
+    if ((result->Confidence == SpeechRecognitionConfidence::High) ||
+        (result->Confidence == SpeechRecognitionConfidence::Medium))
+    {
+        m_spinningCubeRenderer->SetColor(m_speechCommandData->Lookup(command));
+
+        OutputDebugString(
+            (std::wstring(L"Matched command: ") +
+                command->Data() +
+                L" (score " + std::to_wstring(score) + L")\n").c_str()
+        );
+    }
+}
+
 void SpeechTestMain::OnSpeechQualityDegraded(Windows::Media::SpeechRecognition::SpeechRecognizer^ recognizer, Windows::Media::SpeechRecognition::SpeechRecognitionQualityDegradingEventArgs^ args)
 {
     switch (args->Problem)
@@ -56,16 +56,12 @@ namespace SpeechTest
         // Initializes the speech command list.
         void InitializeSpeechCommandList();
 
-		void InitializeSpeechWithDelay();
         void InitializeSpeech();
 
         // Handle HMD activated event
         void OnActivated(bool activated);
 
     private:
-        void UpdateSpeechRecognizer(double time);
-        void InitializeMicrophone();
-
         // Asynchronously creates resources for new holographic cameras.
         void OnCameraAdded(
             Windows::Graphics::Holographic::HolographicSpace^ sender,
@@ -114,6 +110,13 @@ namespace SpeechTest
 
 		void OnSpeechRecognizerError(Platform::String^ error);
 
+        // Sets the cube to the color of a recognized command.
+        void OnSpeechCommandRecognized(
+            Platform::String^ command,
+            float score,
+            Windows::Media::SpeechRecognition::SpeechRecognitionResult^ result
+        );
+
  
 
 
@@ -171,9 +174,5 @@ namespace SpeechTest
         // Keep track of mouse input.
         bool                                                            m_pointerPressed = false;
         Speech::SpeechInput^                                             m_speechInput;
-        bool                                                             m_speechInitialized;
-        bool                                                             m_activated;
-        bool                                                             m_micInitialized;
-        bool                                                             m_hasMicPermission;
     };
 }
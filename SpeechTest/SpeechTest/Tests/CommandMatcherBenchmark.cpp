@@ -0,0 +1,116 @@
+#include "Content/CommandMatcher.h"
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Speech;
+
+namespace
+{
+    struct Lcg
+    {
+        uint32_t state = 7;
+
+        uint32_t Next(uint32_t limit)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) % limit;
+        }
+    };
+
+    std::wstring RandomWord(Lcg& random)
+    {
+        std::wstring word;
+        size_t length = 4 + random.Next(7);
+        for (size_t i = 0; i < length; ++i)
+        {
+            word.push_back(static_cast<wchar_t>(L'a' + random.Next(26)));
+        }
+        return word;
+    }
+
+    // A full optimal string alignment table, what a scan without the matcher's index would do.
+    int Distance(const std::wstring& a, const std::wstring& b)
+    {
+        std::vector<std::vector<int>> table(a.size() + 1, std::vector<int>(b.size() + 1));
+        for (size_t i = 0; i <= a.size(); ++i)
+        {
+            for (size_t j = 0; j <= b.size(); ++j)
+            {
+                if (i == 0 || j == 0)
+                {
+                    table[i][j] = static_cast<int>(i + j);
+                    continue;
+                }
+                table[i][j] = std::min({ table[i - 1][j] + 1, table[i][j - 1] + 1, table[i - 1][j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1) });
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    table[i][j] = std::min(table[i][j], table[i - 2][j - 2] + 1);
+                }
+            }
+        }
+        return table[a.size()][b.size()];
+    }
+}
+
+BENCHMARK(CommandMatcherFind)
+{
+    // 12,000 commands of one to three random words, and queries that are a command, a command
+    // with a letter changed, and a command inside a sentence.
+    Lcg random;
+    CommandMatcher matcher;
+    std::vector<std::wstring> commands;
+    for (int i = 0; i < 12000; ++i)
+    {
+        std::wstring command = RandomWord(random);
+        for (uint32_t words = random.Next(3); words > 0; --words)
+        {
+            command += L" " + RandomWord(random);
+        }
+        commands.push_back(command);
+        matcher.Add(command);
+    }
+
+    std::vector<std::wstring> exact;
+    std::vector<std::wstring> typos;
+    std::vector<std::wstring> sentences;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const std::wstring& command = commands[random.Next(static_cast<uint32_t>(commands.size()))];
+        exact.push_back(command);
+        std::wstring typo = command;
+        typo[random.Next(static_cast<uint32_t>(typo.size()))] = static_cast<wchar_t>(L'a' + random.Next(26));
+        typos.push_back(typo);
+        sentences.push_back(L"please set it to " + command + L" now");
+    }
+
+    auto measure = [&matcher](const std::vector<std::wstring>& queries)
+    {
+        size_t index = 0;
+        return TestSupport::MeasureNanoseconds(1, [&]
+        {
+            TestSupport::DoNotOptimize(matcher.Find(queries[index++ % queries.size()]).command);
+        });
+    };
+
+    TestSupport::Report("Find, exact command", measure(exact) / 1000.0, "us");
+    TestSupport::Report("Find, one letter changed", measure(typos) / 1000.0, "us");
+    TestSupport::Report("Find, command inside a sentence", measure(sentences) / 1000.0, "us");
+
+    size_t index = 0;
+    double scan = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        const std::wstring& query = typos[index++ % typos.size()];
+        int best = INT32_MAX;
+        for (const std::wstring& command : commands)
+        {
+            best = std::min(best, Distance(query, command));
+        }
+        TestSupport::DoNotOptimize(best);
+    });
+    TestSupport::Report("linear scan, one letter changed", scan / 1000.0, "us");
+}
@@ -0,0 +1,127 @@
+#include "Content/CommandMatcher.h"
+
+#include "Check.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Speech;
+
+namespace
+{
+    CommandMatcher Colors()
+    {
+        CommandMatcher matcher;
+        for (const wchar_t* phrase : { L"Red", L"Green", L"Blue", L"Light Blue", L"Purple", L"Grey", L"Yellow", L"Aquamarine", L"Blackboard" })
+        {
+            matcher.Add(phrase);
+        }
+        return matcher;
+    }
+
+    bool Near(float expected, float actual)
+    {
+        return std::fabs(expected - actual) < 1e-4f;
+    }
+}
+
+TEST_CASE(CommandMatcherNormalizesWords)
+{
+    CHECK(CommandMatcher::Normalize(L"  Light-Blue, please!") == std::vector<std::wstring>({ L"light", L"blue", L"please" }));
+    CHECK(CommandMatcher::Normalize(L"SpeechRecognizer") == std::vector<std::wstring>({ L"speech", L"recognizer" }));
+    CHECK(CommandMatcher::Normalize(L"don't stop HMD2") == std::vector<std::wstring>({ L"dont", L"stop", L"hmd2" }));
+    CHECK(CommandMatcher::Normalize(L"it\x2019s") == std::vector<std::wstring>({ L"its" }));
+    CHECK(CommandMatcher::Normalize(L"...").empty());
+}
+
+TEST_CASE(CommandMatcherPhoneticKeysGroupWordsThatSoundAlike)
+{
+    CHECK(CommandMatcher::PhoneticKey(L"grey") == CommandMatcher::PhoneticKey(L"gray"));
+    CHECK(CommandMatcher::PhoneticKey(L"blue") == CommandMatcher::PhoneticKey(L"blew"));
+    CHECK(CommandMatcher::PhoneticKey(L"red") != CommandMatcher::PhoneticKey(L"green"));
+    CHECK(CommandMatcher::PhoneticKey(L"apple") == L"a14");
+}
+
+TEST_CASE(CommandMatcherFindsExactCommands)
+{
+    CommandMatcher matcher = Colors();
+    CHECK_EQUAL(static_cast<size_t>(9), matcher.GetCommandCount());
+
+    CommandMatcher::Match match = matcher.Find(L"purple.");
+    CHECK_EQUAL(static_cast<size_t>(4), match.command);
+    CHECK(Near(1.0f, match.score));
+
+    // The longer command wins over the one inside it.
+    match = matcher.Find(L"Light blue");
+    CHECK_EQUAL(static_cast<size_t>(3), match.command);
+    CHECK(Near(1.0f, match.score));
+
+    // Words split or joined differently from the command.
+    CHECK_EQUAL(static_cast<size_t>(8), matcher.Find(L"black board").command);
+    CHECK(Near(1.0f, matcher.Find(L"black board").score));
+    CHECK_EQUAL(static_cast<size_t>(3), matcher.Find(L"lightblue").command);
+}
+
+TEST_CASE(CommandMatcherToleratesMisspellingsAndSoundAlikes)
+{
+    CommandMatcher matcher = Colors();
+
+    // A swap of two letters is one edit of six.
+    CommandMatcher::Match match = matcher.Find(L"purpel");
+    CHECK_EQUAL(static_cast<size_t>(4), match.command);
+    CHECK(Near(1.0f - 1.0f / 6.0f, match.score));
+
+    // Two edits are allowed in words of eight letters or more, but not three, unless the word
+    // still sounds the same.
+    CHECK_EQUAL(static_cast<size_t>(7), matcher.Find(L"akwamarine").command);
+    CHECK(matcher.Find(L"abuamabibe").command == CommandMatcher::NoMatch);
+
+    // Spelled two edits apart but sounding the same.
+    match = matcher.Find(L"blew");
+    CHECK_EQUAL(static_cast<size_t>(2), match.command);
+    CHECK(Near(0.8f, match.score));
+    CHECK_EQUAL(static_cast<size_t>(5), matcher.Find(L"gray").command);
+    CHECK(Near(0.8f, matcher.Find(L"gray").score));
+
+    // Words of three letters or fewer have to be exact.
+    CHECK(matcher.Find(L"rod").command == CommandMatcher::NoMatch);
+    CHECK(matcher.Find(L"bed").command == CommandMatcher::NoMatch);
+}
+
+TEST_CASE(CommandMatcherFindsCommandsInsideSentences)
+{
+    CommandMatcher matcher = Colors();
+
+    // The extra words scale the score down by up to half: nine of 21 letters are the command.
+    CommandMatcher::Match match = matcher.Find(L"make it light blue please");
+    CHECK_EQUAL(static_cast<size_t>(3), match.command);
+    CHECK(Near(0.5f + 0.5f * 9.0f / 21.0f, match.score));
+
+    match = matcher.Find(L"the weather is nice today");
+    CHECK(match.command == CommandMatcher::NoMatch);
+    CHECK(match.score == 0.0f);
+    CHECK(matcher.Find(L"").command == CommandMatcher::NoMatch);
+}
+
+TEST_CASE(CommandMatcherRejectsEmptyCommandsAndKeepsTheFirstDuplicate)
+{
+    CommandMatcher matcher;
+    bool threw = false;
+    try
+    {
+        matcher.Add(L" ?! ");
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK_EQUAL(static_cast<size_t>(0), matcher.GetCommandCount());
+
+    CHECK_EQUAL(static_cast<size_t>(0), matcher.Add(L"Speech Recognizer"));
+    CHECK_EQUAL(static_cast<size_t>(1), matcher.Add(L"SpeechRecognizer"));
+    CHECK_EQUAL(static_cast<size_t>(0), matcher.Find(L"speech recognizer").command);
+    CHECK_EQUAL(static_cast<size_t>(0), matcher.Find(L"speechrecognizer").command);
+}
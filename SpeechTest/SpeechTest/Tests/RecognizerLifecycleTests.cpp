@@ -0,0 +1,250 @@
+#include "Content/RecognizerLifecycle.h"
+
+#include "Check.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace Speech;
+
+namespace
+{
+    // Holds each operation until the test completes it, and each retry until the test fires it.
+    class FakeRecognizer : public IRecognizer
+    {
+    public:
+        struct Operation
+        {
+            std::string name;
+            Completion  done;
+        };
+
+        struct ScheduledRetry
+        {
+            std::chrono::milliseconds   delay;
+            std::function<void()>       retry;
+        };
+
+        std::deque<Operation>       operations;
+        std::deque<ScheduledRetry>  retries;
+        int                         releases = 0;
+
+        virtual void RequestPermission(Completion done) override  { operations.push_back({ "permission", done }); }
+        virtual void Compile(Completion done) override            { operations.push_back({ "compile", done }); }
+        virtual void StartSession(Completion done) override       { operations.push_back({ "start", done }); }
+        virtual void PauseSession(Completion done) override       { operations.push_back({ "pause", done }); }
+        virtual void ResumeSession(Completion done) override      { operations.push_back({ "resume", done }); }
+        virtual void Release() override                           { ++releases; }
+
+        virtual void ScheduleRetry(std::chrono::milliseconds delay, std::function<void()> retry) override
+        {
+            retries.push_back({ delay, retry });
+        }
+
+        // Completes the oldest operation, which has to be the one named.
+        bool Complete(const std::string& name, bool succeeded = true)
+        {
+            if (operations.empty() || operations.front().name != name)
+            {
+                return false;
+            }
+            Completion done = operations.front().done;
+            operations.pop_front();
+            done(succeeded);
+            return true;
+        }
+
+        std::chrono::milliseconds FireRetry()
+        {
+            ScheduledRetry scheduled = retries.front();
+            retries.pop_front();
+            scheduled.retry();
+            return scheduled.delay;
+        }
+    };
+
+    // Takes a lifecycle from nothing to listening.
+    bool Listen(RecognizerLifecycle& lifecycle, FakeRecognizer& recognizer)
+    {
+        lifecycle.SetActive(true);
+        return recognizer.Complete("permission") && recognizer.Complete("compile") && recognizer.Complete("start") &&
+            lifecycle.GetState() == RecognizerState::Listening;
+    }
+}
+
+TEST_CASE(RecognizerLifecycleStartsColdAndResumesWarm)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    std::vector<RecognizerState> states;
+    RecognizerLifecycle lifecycle(recognizer, [&states](RecognizerState state) { states.push_back(state); });
+    CHECK(lifecycle.GetState() == RecognizerState::Cold);
+    CHECK(recognizer->operations.empty());
+
+    CHECK(Listen(lifecycle, *recognizer));
+    CHECK(states == std::vector<RecognizerState>({ RecognizerState::RequestingPermission, RecognizerState::Cold, RecognizerState::Compiling,
+        RecognizerState::Idle, RecognizerState::Starting, RecognizerState::Listening }));
+
+    // Deactivating pauses the session rather than releasing it.
+    lifecycle.SetActive(false);
+    CHECK(recognizer->Complete("pause"));
+    CHECK(lifecycle.GetState() == RecognizerState::Paused);
+    lifecycle.SetActive(true);
+    CHECK(recognizer->Complete("resume"));
+    CHECK(lifecycle.GetState() == RecognizerState::Listening);
+
+    RecognizerLifecycle::Statistics statistics = lifecycle.GetStatistics();
+    CHECK_EQUAL(2u, statistics.activations);
+    CHECK_EQUAL(1u, statistics.warmActivations);
+    CHECK_EQUAL(1u, statistics.compilations);
+    CHECK_EQUAL(1u, statistics.sessionStarts);
+    CHECK_EQUAL(0, recognizer->releases);
+}
+
+TEST_CASE(RecognizerLifecycleActsOnTheLatestActivationOnly)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    RecognizerLifecycle lifecycle(recognizer);
+    CHECK(Listen(lifecycle, *recognizer));
+
+    // Activation flips while the pause runs end in one resume, not a pause and a resume each.
+    lifecycle.SetActive(false);
+    lifecycle.SetActive(true);
+    lifecycle.SetActive(false);
+    lifecycle.SetActive(true);
+    CHECK(recognizer->Complete("pause"));
+    CHECK(recognizer->Complete("resume"));
+    CHECK(recognizer->operations.empty());
+    CHECK(lifecycle.GetState() == RecognizerState::Listening);
+
+    // The gate pauses and resumes the session while active.
+    lifecycle.SetGateOpen(false);
+    CHECK(recognizer->Complete("pause"));
+    CHECK(lifecycle.GetState() == RecognizerState::Paused);
+    lifecycle.SetGateOpen(true);
+    CHECK(recognizer->Complete("resume"));
+    CHECK(lifecycle.GetState() == RecognizerState::Listening);
+}
+
+TEST_CASE(RecognizerLifecycleRetriesFailuresWithBackoffWhileActive)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    RecognizerLifecycle lifecycle(recognizer);
+    CHECK(Listen(lifecycle, *recognizer));
+
+    lifecycle.OnSessionEnded(false);
+    CHECK(lifecycle.GetState() == RecognizerState::Failed);
+    CHECK_EQUAL(1, recognizer->releases);
+    CHECK_EQUAL(static_cast<size_t>(1), recognizer->retries.size());
+
+    // Each failure in a row waits twice as long, and permission isn't asked for again.
+    CHECK(recognizer->FireRetry() == RecognizerLifecycle::RetryDelay);
+    CHECK(recognizer->Complete("compile", false));
+    CHECK(recognizer->FireRetry() == 2 * RecognizerLifecycle::RetryDelay);
+    CHECK(recognizer->Complete("compile"));
+    CHECK(recognizer->Complete("start", false));
+    CHECK(recognizer->FireRetry() == 4 * RecognizerLifecycle::RetryDelay);
+    CHECK(recognizer->Complete("compile"));
+    CHECK(recognizer->Complete("start"));
+    CHECK(lifecycle.GetState() == RecognizerState::Listening);
+    CHECK_EQUAL(3u, lifecycle.GetStatistics().retries);
+
+    // Listening again starts the backoff over.
+    lifecycle.OnSessionEnded(false);
+    CHECK(recognizer->FireRetry() == RecognizerLifecycle::RetryDelay);
+
+    // The delay stops growing.
+    for (int i = 0; i < 20; ++i)
+    {
+        CHECK(recognizer->Complete("compile", false));
+        CHECK(recognizer->FireRetry() <= RecognizerLifecycle::MaxRetryDelay);
+    }
+    CHECK(recognizer->Complete("compile", false));
+    CHECK(recognizer->retries.front().delay == RecognizerLifecycle::MaxRetryDelay);
+}
+
+TEST_CASE(RecognizerLifecycleOnlyRetriesWhileActive)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    RecognizerLifecycle lifecycle(recognizer);
+    CHECK(Listen(lifecycle, *recognizer));
+
+    // A retry that comes after deactivating does nothing, and failing while inactive schedules
+    // none.
+    lifecycle.OnSessionEnded(false);
+    lifecycle.SetActive(false);
+    recognizer->FireRetry();
+    CHECK(lifecycle.GetState() == RecognizerState::Failed);
+    CHECK(recognizer->operations.empty());
+    CHECK(recognizer->retries.empty());
+
+    // Activating retries at once, and makes the retry still pending from before a no-op.
+    lifecycle.SetActive(true);
+    CHECK(recognizer->Complete("compile", false));
+    CHECK_EQUAL(static_cast<size_t>(1), recognizer->retries.size());
+    lifecycle.SetActive(false);
+    lifecycle.SetActive(true);
+    CHECK(recognizer->Complete("compile"));
+    recognizer->FireRetry();
+    CHECK(recognizer->Complete("start"));
+    CHECK(recognizer->operations.empty());
+    CHECK(lifecycle.GetState() == RecognizerState::Listening);
+    CHECK_EQUAL(0u, lifecycle.GetStatistics().retries);
+
+    // No permission isn't a failure to retry.
+    auto denied = std::make_shared<FakeRecognizer>();
+    RecognizerLifecycle deniedLifecycle(denied);
+    deniedLifecycle.SetActive(true);
+    CHECK(denied->Complete("permission", false));
+    CHECK(deniedLifecycle.GetState() == RecognizerState::NoPermission);
+    CHECK(denied->retries.empty());
+}
+
+TEST_CASE(RecognizerLifecycleNotifiesInOrderWithoutTheLock)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    std::vector<RecognizerState> states;
+    RecognizerLifecycle* self = nullptr;
+    RecognizerLifecycle lifecycle(recognizer, [&states, &self](RecognizerState state)
+    {
+        // Calling back in would deadlock with the lifecycle locked.
+        self->GetStatistics();
+        states.push_back(state);
+        if (state == RecognizerState::Listening)
+        {
+            self->SetActive(false);
+        }
+    });
+    self = &lifecycle;
+
+    // Listening deactivates it again, from inside the callback.
+    lifecycle.SetActive(true);
+    CHECK(recognizer->Complete("permission") && recognizer->Complete("compile") && recognizer->Complete("start"));
+    CHECK(lifecycle.GetState() == RecognizerState::Pausing);
+    CHECK(states.back() == RecognizerState::Pausing);
+    CHECK(states[states.size() - 2] == RecognizerState::Listening);
+    CHECK(recognizer->Complete("pause"));
+
+    lifecycle.Shutdown();
+    CHECK(states.back() == RecognizerState::Stopped);
+    CHECK_EQUAL(1, recognizer->releases);
+}
+
+TEST_CASE(RecognizerLifecycleIgnoresOperationsAndRetriesAfterShutdown)
+{
+    auto recognizer = std::make_shared<FakeRecognizer>();
+    {
+        RecognizerLifecycle lifecycle(recognizer);
+        lifecycle.SetActive(true);
+        CHECK(recognizer->Complete("permission"));
+        CHECK(recognizer->Complete("compile", false));
+        CHECK_EQUAL(static_cast<size_t>(1), recognizer->retries.size());
+        lifecycle.SetActive(false);
+        lifecycle.SetActive(true);
+    }
+
+    // The compile started by the activation and the retry both outlive the lifecycle.
+    CHECK(recognizer->Complete("compile"));
+    recognizer->FireRetry();
+    CHECK(recognizer->operations.empty());
+}
@@ -0,0 +1,40 @@
+#include "Content/VoiceActivityDetector.h"
+
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace Speech;
+
+BENCHMARK(VoiceActivityCpuCost)
+{
+    // What the detector and gate cost the audio graph's thread per second of audio, fed in
+    // 10 ms quanta of noisy speech-level audio.
+    for (unsigned int sampleRate : { 16000u, 48000u })
+    {
+        std::vector<float> audio(sampleRate * 10);
+        uint32_t state = 1;
+        for (float& sample : audio)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = 0.1f * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+
+        VoiceActivityDetector::Settings settings;
+        settings.sampleRate = sampleRate;
+        VoiceActivityDetector detector(settings, nullptr);
+        VoiceActivityGate gate(1.5, nullptr);
+        const size_t quantum = sampleRate / 100;
+        double nanoseconds = TestSupport::MeasureNanoseconds(10, [&]
+        {
+            for (size_t i = 0; i < audio.size(); i += quantum)
+            {
+                detector.Process(audio.data() + i, quantum);
+                gate.Update(detector.IsSpeech(), detector.GetTime());
+            }
+        });
+
+        TestSupport::Report(sampleRate == 16000 ? "16 kHz, CPU per audio second" : "48 kHz, CPU per audio second", nanoseconds / 1000.0, "us");
+    }
+}
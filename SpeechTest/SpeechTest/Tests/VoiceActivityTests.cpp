@@ -0,0 +1,193 @@
+#include "Content/VoiceActivityDetector.h"
+
+#include "Check.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace Speech;
+
+namespace
+{
+    // 11.5 s of 16 kHz mono: words at 0.5-1.5 s and, after a 2.5 s pause, at 4.0-4.6 s, fan
+    // noise at 6.0-7.5 s, and a sentence at 10.0-11.2 s in white noise from 9.5 s at about
+    // 10 dB below it, over a -56 dBFS noise floor. The speech is synthetic: voiced harmonics
+    // through two formants with a syllable envelope, and a fricative burst in the middle.
+    const char* const FixturePath = SPEECH_TEST_FIXTURES "/VoiceActivity16k.wav";
+
+    // The 16 bit PCM samples of a WAV file as floats, and its sample rate.
+    std::vector<float> ReadWav(const std::string& path, unsigned int& sampleRate)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<float> samples;
+        sampleRate = 0;
+        for (size_t chunk = 12; chunk + 8 <= bytes.size();)
+        {
+            uint32_t length;
+            std::memcpy(&length, &bytes[chunk + 4], sizeof(length));
+            if (std::memcmp(&bytes[chunk], "fmt ", 4) == 0)
+            {
+                std::memcpy(&sampleRate, &bytes[chunk + 12], sizeof(sampleRate));
+            }
+            else if (std::memcmp(&bytes[chunk], "data", 4) == 0)
+            {
+                for (size_t i = 0; i + 1 < length && chunk + 9 + i < bytes.size(); i += 2)
+                {
+                    int16_t sample;
+                    std::memcpy(&sample, &bytes[chunk + 8 + i], sizeof(sample));
+                    samples.push_back(sample / 32768.0f);
+                }
+            }
+            chunk += 8 + length;
+        }
+        return samples;
+    }
+
+    struct GateChange
+    {
+        bool    open;
+        double  time;
+    };
+
+    // Runs the fixture through a detector and a gate in 10 ms quanta, as the audio graph
+    // delivers it.
+    void RunFixture(double closeDelay, std::vector<VoiceActivityEvent>& events, std::vector<GateChange>& changes)
+    {
+        unsigned int sampleRate;
+        std::vector<float> samples = ReadWav(FixturePath, sampleRate);
+        CHECK_EQUAL(16000u, sampleRate);
+        CHECK_EQUAL(static_cast<size_t>(184000), samples.size());
+
+        VoiceActivityDetector::Settings settings;
+        settings.sampleRate = sampleRate;
+        settings.stopFrames = 150;
+        VoiceActivityDetector detector(settings, [&events](const VoiceActivityEvent& event) { events.push_back(event); });
+        VoiceActivityGate gate(closeDelay, [&changes, &detector](bool open) { changes.push_back({ open, detector.GetTime() }); });
+        for (size_t i = 0; i < samples.size(); i += 160)
+        {
+            detector.Process(samples.data() + i, std::min<size_t>(160, samples.size() - i));
+            gate.Update(detector.IsSpeech(), detector.GetTime());
+        }
+    }
+
+    bool Near(double expected, double actual, double tolerance)
+    {
+        return std::fabs(expected - actual) <= tolerance;
+    }
+}
+
+TEST_CASE(VoiceActivityDetectorFindsTheSpeechInTheFixture)
+{
+    std::vector<VoiceActivityEvent> events;
+    std::vector<GateChange> changes;
+    RunFixture(1.5, events, changes);
+
+    // Three starts within a few frames of the words, none for the fan, and a stop 1.5 s after
+    // each of the first two.
+    CHECK_EQUAL(static_cast<size_t>(5), events.size());
+    if (events.size() == 5)
+    {
+        CHECK(events[0].speech && Near(0.5, events[0].time, 0.1));
+        CHECK(!events[1].speech && Near(1.5, events[1].time, 0.2));
+        CHECK(events[2].speech && Near(4.0, events[2].time, 0.1));
+        CHECK(!events[3].speech && Near(4.6, events[3].time, 0.2));
+        CHECK(events[4].speech && Near(10.0, events[4].time, 0.1));
+    }
+}
+
+TEST_CASE(VoiceActivityGateKeepsListeningThroughShortPauses)
+{
+    // The 2.5 s pause before the second word is shorter than the hangover twice over, so the
+    // session is still listening for it. It is paused once, during the long silence with the
+    // fan, and listening again within 100 ms of the last sentence starting.
+    std::vector<VoiceActivityEvent> events;
+    std::vector<GateChange> changes;
+    RunFixture(1.5, events, changes);
+    CHECK_EQUAL(static_cast<size_t>(2), changes.size());
+    if (changes.size() == 2)
+    {
+        CHECK(!changes[0].open && Near(4.6 + 3.0, changes[0].time, 0.2));
+        CHECK(changes[1].open && changes[1].time >= 10.0 && changes[1].time <= 10.1);
+    }
+
+    // Closing as soon as the detector stops would have paused the session before the second
+    // word, and resumed it only once the word had started.
+    events.clear();
+    changes.clear();
+    RunFixture(0.0, events, changes);
+    bool pausedBeforeTheWord = false;
+    for (size_t i = 0; i + 1 < changes.size(); ++i)
+    {
+        pausedBeforeTheWord = pausedBeforeTheWord ||
+            (!changes[i].open && changes[i].time > 2.0 && changes[i].time < 4.0 && changes[i + 1].open && changes[i + 1].time > 4.0);
+    }
+    CHECK(pausedBeforeTheWord);
+}
+
+TEST_CASE(VoiceActivityGateOpensWithSpeechAndClosesAfterTheDelay)
+{
+    std::vector<bool> changes;
+    VoiceActivityGate gate(2.0, [&changes](bool open) { changes.push_back(open); });
+    CHECK(gate.IsOpen());
+
+    // Open from the start, and closed 2 s after it without speech.
+    gate.Update(false, 1.99);
+    CHECK(gate.IsOpen());
+    gate.Update(false, 2.0);
+    CHECK(!gate.IsOpen());
+    gate.Update(false, 3.0);
+    CHECK(changes == std::vector<bool>({ false }));
+
+    // Speech opens it at once and keeps it open for 2 s after its end.
+    gate.Update(true, 3.5);
+    gate.Update(true, 4.0);
+    gate.Update(false, 5.9);
+    CHECK(gate.IsOpen());
+    gate.Update(false, 6.0);
+    CHECK(changes == std::vector<bool>({ false, true, false }));
+
+    // Reset opens it and counts the silence from then.
+    gate.Reset(0.0);
+    CHECK(gate.IsOpen());
+    gate.Reset(0.5);
+    gate.Update(false, 2.4);
+    CHECK(gate.IsOpen());
+    gate.Update(false, 2.5);
+    CHECK(changes == std::vector<bool>({ false, true, false, true, false }));
+}
+
+TEST_CASE(VoiceActivityDetectorRejectsUnsupportedSampleRates)
+{
+    VoiceActivityDetector::Settings settings;
+    for (unsigned int sampleRate : { 7999u, 192001u })
+    {
+        settings.sampleRate = sampleRate;
+        bool threw = false;
+        try
+        {
+            VoiceActivityDetector detector(settings, nullptr);
+        }
+        catch (const std::invalid_argument&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    // Any number of samples at a time, with the time in whole frames.
+    settings.sampleRate = 48000;
+    VoiceActivityDetector detector(settings, nullptr);
+    std::vector<float> silence(1000, 0.0f);
+    detector.Process(silence.data(), silence.size());
+    CHECK(Near(0.02, detector.GetTime(), 1e-9));
+    detector.Process(silence.data(), 440);
+    CHECK(Near(0.03, detector.GetTime(), 1e-9));
+    detector.Reset();
+    CHECK(detector.GetTime() == 0.0);
+}
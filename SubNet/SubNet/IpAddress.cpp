@@ -0,0 +1,458 @@
+#include "IpAddress.h"
+
+#include <cstring>
+
+using namespace SubNet;
+
+namespace
+{
+    const char HexDigits[] = "0123456789abcdef";
+
+    int HexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    // Four decimal numbers up to 255 separated by dots, without leading zeros, which some
+    // parsers read as octal.
+    bool ParseIPv4(const char* text, size_t length, uint8_t* bytes)
+    {
+        size_t position = 0;
+        for (int part = 0; part < 4; ++part)
+        {
+            if (part > 0)
+            {
+                if (position >= length || text[position] != '.')
+                {
+                    return false;
+                }
+                ++position;
+            }
+
+            size_t start = position;
+            unsigned value = 0;
+            while (position < length && text[position] >= '0' && text[position] <= '9' && position - start < 3)
+            {
+                value = value * 10 + static_cast<unsigned>(text[position] - '0');
+                ++position;
+            }
+            if (position == start || value > 255 || (position - start > 1 && text[start] == '0'))
+            {
+                return false;
+            }
+            bytes[part] = static_cast<uint8_t>(value);
+        }
+        return position == length;
+    }
+
+    bool ParseIPv6(const char* text, size_t length, uint8_t* bytes)
+    {
+        uint16_t groups[8];
+        int count = 0;
+        int gap = -1;           // Index of the group "::" stands before.
+        size_t position = 0;
+
+        if (length >= 2 && text[0] == ':' && text[1] == ':')
+        {
+            gap = 0;
+            position = 2;
+        }
+
+        while (position < length)
+        {
+            // A dotted IPv4 tail takes the last two groups.
+            if (memchr(text + position, ':', length - position) == nullptr &&
+                memchr(text + position, '.', length - position) != nullptr)
+            {
+                uint8_t tail[4];
+                if (count > 6 || !ParseIPv4(text + position, length - position, tail))
+                {
+                    return false;
+                }
+                groups[count++] = static_cast<uint16_t>(tail[0] << 8 | tail[1]);
+                groups[count++] = static_cast<uint16_t>(tail[2] << 8 | tail[3]);
+                position = length;
+                break;
+            }
+
+            size_t start = position;
+            unsigned value = 0;
+            int digit;
+            while (position < length && position - start < 4 && (digit = HexValue(text[position])) >= 0)
+            {
+                value = value << 4 | static_cast<unsigned>(digit);
+                ++position;
+            }
+            if (position == start || count == 8)
+            {
+                return false;
+            }
+            groups[count++] = static_cast<uint16_t>(value);
+
+            if (position == length)
+            {
+                break;
+            }
+            if (text[position] != ':')
+            {
+                return false;
+            }
+            ++position;
+            if (position < length && text[position] == ':')
+            {
+                if (gap >= 0)
+                {
+                    return false;
+                }
+                gap = count;
+                ++position;
+            }
+            else if (position == length)
+            {
+                return false;
+            }
+        }
+
+        if (gap < 0 ? count != 8 : count > 7)
+        {
+            return false;
+        }
+
+        // Groups after the "::" go at the end, with zeros between.
+        int before = gap < 0 ? count : gap;
+        for (int index = 0; index < 8; ++index)
+        {
+            int i = index < before ? index : index - (8 - count);
+            uint16_t group = index < before || i >= before ? groups[i] : 0;
+            bytes[2 * index] = static_cast<uint8_t>(group >> 8);
+            bytes[2 * index + 1] = static_cast<uint8_t>(group);
+        }
+        return true;
+    }
+
+    size_t FormatIPv4(const uint8_t* bytes, char* buffer)
+    {
+        char* out = buffer;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i > 0)
+            {
+                *out++ = '.';
+            }
+            unsigned value = bytes[i];
+            if (value >= 100)
+            {
+                *out++ = static_cast<char>('0' + value / 100);
+            }
+            if (value >= 10)
+            {
+                *out++ = static_cast<char>('0' + value / 10 % 10);
+            }
+            *out++ = static_cast<char>('0' + value % 10);
+        }
+        *out = '\0';
+        return static_cast<size_t>(out - buffer);
+    }
+
+    size_t FormatIPv6(const uint8_t* bytes, char* buffer)
+    {
+        uint16_t groups[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            groups[i] = static_cast<uint16_t>(bytes[2 * i] << 8 | bytes[2 * i + 1]);
+        }
+
+        // The first longest run of two or more zero groups becomes "::".
+        int gap = -1;
+        int gapLength = 1;
+        for (int i = 0; i < 8;)
+        {
+            int run = 0;
+            while (i + run < 8 && groups[i + run] == 0)
+            {
+                ++run;
+            }
+            if (run > gapLength)
+            {
+                gap = i;
+                gapLength = run;
+            }
+            i += run > 0 ? run : 1;
+        }
+
+        char* out = buffer;
+        for (int i = 0; i < 8; ++i)
+        {
+            if (i == gap)
+            {
+                *out++ = ':';
+                if (i == 0)
+                {
+                    *out++ = ':';
+                }
+                i += gapLength - 1;
+                continue;
+            }
+
+            // An IPv4-mapped address ends in dotted decimal.
+            if (i == 6 && gap == 0 && gapLength == 5 && groups[5] == 0xFFFF)
+            {
+                out += FormatIPv4(bytes + 12, out);
+                return static_cast<size_t>(out - buffer);
+            }
+
+            bool leading = true;
+            for (int shift = 12; shift >= 0; shift -= 4)
+            {
+                unsigned digit = groups[i] >> shift & 0xF;
+                if (leading && digit == 0 && shift > 0)
+                {
+                    continue;
+                }
+                leading = false;
+                *out++ = HexDigits[digit];
+            }
+            if (i < 7)
+            {
+                *out++ = ':';
+            }
+        }
+        *out = '\0';
+        return static_cast<size_t>(out - buffer);
+    }
+
+    // Keeps the first length bits of bytes and sets or clears the rest.
+    void SetHostBits(uint8_t* bytes, unsigned bits, unsigned length, bool ones)
+    {
+        for (unsigned i = 0; i < bits / 8; ++i)
+        {
+            unsigned kept = length > i * 8 ? length - i * 8 : 0;
+            uint8_t mask = kept >= 8 ? 0xFF : static_cast<uint8_t>(0xFF00 >> kept);
+            bytes[i] = ones ? static_cast<uint8_t>(bytes[i] | ~mask) : static_cast<uint8_t>(bytes[i] & mask);
+        }
+    }
+}
+
+IpAddress::IpAddress() :
+    family(AddressFamily::None),
+    bytes()
+{
+}
+
+IpAddress IpAddress::FromIPv4(uint32_t address)
+{
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(address >> 24),
+        static_cast<uint8_t>(address >> 16),
+        static_cast<uint8_t>(address >> 8),
+        static_cast<uint8_t>(address) };
+    return FromIPv4Bytes(bytes);
+}
+
+IpAddress IpAddress::FromIPv4Bytes(const uint8_t bytes[4])
+{
+    IpAddress address;
+    address.family = AddressFamily::IPv4;
+    memcpy(address.bytes, bytes, 4);
+    return address;
+}
+
+IpAddress IpAddress::FromIPv6Bytes(const uint8_t bytes[16])
+{
+    IpAddress address;
+    address.family = AddressFamily::IPv6;
+    memcpy(address.bytes, bytes, 16);
+    return address;
+}
+
+IpAddress IpAddress::Parse(const char* text, size_t length)
+{
+    IpAddress address;
+    if (memchr(text, ':', length) != nullptr)
+    {
+        if (ParseIPv6(text, length, address.bytes))
+        {
+            address.family = AddressFamily::IPv6;
+            return address;
+        }
+    }
+    else if (ParseIPv4(text, length, address.bytes))
+    {
+        address.family = AddressFamily::IPv4;
+        return address;
+    }
+    return IpAddress();
+}
+
+size_t IpAddress::Format(char* buffer) const
+{
+    switch (family)
+    {
+    case AddressFamily::IPv4:
+        return FormatIPv4(bytes, buffer);
+    case AddressFamily::IPv6:
+        return FormatIPv6(bytes, buffer);
+    default:
+        buffer[0] = '\0';
+        return 0;
+    }
+}
+
+bool IpAddress::operator==(const IpAddress& other) const
+{
+    return family == other.family && memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+}
+
+IpPrefix::IpPrefix() :
+    length(0)
+{
+}
+
+IpPrefix::IpPrefix(const IpAddress& address, unsigned length) :
+    address(address),
+    length(static_cast<uint8_t>(length < address.GetBits() ? length : address.GetBits()))
+{
+}
+
+IpPrefix IpPrefix::FromMask(const IpAddress& address, const IpAddress& mask)
+{
+    if (address.family == AddressFamily::None || mask.family != address.family)
+    {
+        return IpPrefix();
+    }
+
+    unsigned bits = address.GetBits();
+    unsigned length = 0;
+    while (length < bits && (mask.bytes[length / 8] & (0x80 >> (length % 8))) != 0)
+    {
+        ++length;
+    }
+    for (unsigned i = length; i < bits; ++i)
+    {
+        if ((mask.bytes[i / 8] & (0x80 >> (i % 8))) != 0)
+        {
+            return IpPrefix();
+        }
+    }
+    return IpPrefix(address, length);
+}
+
+IpPrefix IpPrefix::Parse(const char* text, size_t length)
+{
+    const char* slash = static_cast<const char*>(memchr(text, '/', length));
+    size_t addressLength = slash != nullptr ? static_cast<size_t>(slash - text) : length;
+    IpAddress address = IpAddress::Parse(text, addressLength);
+    if (address.family == AddressFamily::None)
+    {
+        return IpPrefix();
+    }
+    if (slash == nullptr)
+    {
+        return IpPrefix(address, address.GetBits());
+    }
+
+    unsigned prefixLength = 0;
+    size_t position = addressLength + 1;
+    if (position == length || length - position > 3)
+    {
+        return IpPrefix();
+    }
+    for (; position < length; ++position)
+    {
+        if (text[position] < '0' || text[position] > '9')
+        {
+            return IpPrefix();
+        }
+        prefixLength = prefixLength * 10 + static_cast<unsigned>(text[position] - '0');
+    }
+    if (prefixLength > address.GetBits())
+    {
+        return IpPrefix();
+    }
+    return IpPrefix(address, prefixLength);
+}
+
+IpAddress IpPrefix::GetNetwork() const
+{
+    IpAddress network = address;
+    SetHostBits(network.bytes, address.GetBits(), length, false);
+    return network;
+}
+
+IpAddress IpPrefix::GetMask() const
+{
+    IpAddress mask;
+    mask.family = address.family;
+    SetHostBits(mask.bytes, address.GetBits(), 0, true);
+    SetHostBits(mask.bytes, address.GetBits(), length, false);
+    return mask;
+}
+
+IpAddress IpPrefix::GetLast() const
+{
+    IpAddress last = address;
+    SetHostBits(last.bytes, address.GetBits(), length, true);
+    return last;
+}
+
+uint64_t IpPrefix::GetAddressCount() const
+{
+    unsigned hostBits = address.GetBits() - length;
+    return hostBits >= 64 ? UINT64_MAX : uint64_t(1) << hostBits;
+}
+
+bool IpPrefix::Contains(const IpAddress& other) const
+{
+    if (other.family != address.family || address.family == AddressFamily::None)
+    {
+        return false;
+    }
+    for (unsigned i = 0; i < length / 8u; ++i)
+    {
+        if (address.bytes[i] != other.bytes[i])
+        {
+            return false;
+        }
+    }
+    unsigned rest = length % 8u;
+    return rest == 0 || ((address.bytes[length / 8] ^ other.bytes[length / 8]) & (0xFF00 >> rest)) == 0;
+}
+
+bool IpPrefix::Contains(const IpPrefix& other) const
+{
+    return other.length >= length && Contains(other.address);
+}
+
+size_t IpPrefix::Format(char* buffer) const
+{
+    size_t written = address.Format(buffer);
+    if (address.family == AddressFamily::None)
+    {
+        return written;
+    }
+    char* out = buffer + written;
+    *out++ = '/';
+    if (length >= 100)
+    {
+        *out++ = static_cast<char>('0' + length / 100);
+    }
+    if (length >= 10)
+    {
+        *out++ = static_cast<char>('0' + length / 10 % 10);
+    }
+    *out++ = static_cast<char>('0' + length % 10);
+    *out = '\0';
+    return static_cast<size_t>(out - buffer);
+}
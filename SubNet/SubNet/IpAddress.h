@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SubNet
+{
+    enum class AddressFamily : uint8_t
+    {
+        None,       // Not an address, e.g. text that didn't parse.
+        IPv4,
+        IPv6
+    };
+
+    // An IPv4 or IPv6 address in network byte order. IPv4 uses the first 4 bytes and leaves the
+    // rest zero.
+    struct IpAddress
+    {
+        // Longest text Format writes, with its terminator: INET6_ADDRSTRLEN.
+        static const size_t MaximumText = 46;
+
+        AddressFamily   family;
+        uint8_t         bytes[16];
+
+        IpAddress();
+
+        static IpAddress FromIPv4(uint32_t address);     // In host byte order.
+        static IpAddress FromIPv4Bytes(const uint8_t bytes[4]);
+        static IpAddress FromIPv6Bytes(const uint8_t bytes[16]);
+
+        // Dotted decimal, or IPv6 as in RFC 4291 including "::" and a dotted tail. The family
+        // is None when the text is anything else.
+        static IpAddress Parse(const char* text, size_t length);
+
+        // Writes the address, IPv6 as RFC 5952 recommends, and a terminator into buffer, which
+        // holds MaximumText. Returns the length.
+        size_t Format(char* buffer) const;
+
+        unsigned GetBits() const { return family == AddressFamily::IPv4 ? 32 : 128; }
+
+        bool operator==(const IpAddress& other) const;
+        bool operator!=(const IpAddress& other) const { return !(*this == other); }
+    };
+
+    // An address and the length of its subnet's prefix, e.g. 192.168.1.20/24.
+    struct IpPrefix
+    {
+        static const size_t MaximumText = IpAddress::MaximumText + 4;
+
+        IpAddress   address;    // As given; GetNetwork clears the host bits.
+        uint8_t     length;
+
+        IpPrefix();
+        IpPrefix(const IpAddress& address, unsigned length);
+
+        // From an address and its netmask. The family is None when the mask's ones aren't
+        // contiguous.
+        static IpPrefix FromMask(const IpAddress& address, const IpAddress& mask);
+
+        // "address/length", or just an address for a prefix as long as the address.
+        static IpPrefix Parse(const char* text, size_t length);
+
+        IpAddress GetNetwork() const;
+        IpAddress GetMask() const;
+
+        // The last address, which is the broadcast address of an IPv4 subnet.
+        IpAddress GetLast() const;
+
+        // How many addresses it has, or UINT64_MAX when that doesn't fit.
+        uint64_t GetAddressCount() const;
+
+        bool Contains(const IpAddress& address) const;
+        bool Contains(const IpPrefix& prefix) const;
+
+        // Writes "address/length" and a terminator into buffer, which holds MaximumText.
+        size_t Format(char* buffer) const;
+    };
+}
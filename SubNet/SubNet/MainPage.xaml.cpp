@@ -6,12 +6,7 @@
 #include "pch.h"
 #include "MainPage.xaml.h"
 
-#define _WINSOCK_DEPRECATED_NO_WARNINGS
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include <sstream>
 #include <string>
-#pragma comment(lib, "ws2_32.lib")
 
 using namespace SubNet;
 
@@ -26,70 +21,132 @@ using namespace Windows::UI::Xaml::Input;
 using namespace Windows::UI::Xaml::Media;
 using namespace Windows::UI::Xaml::Navigation;
 
-// From https://tangentsoft.net/wskfaq/examples/getifaces.html
+namespace
+{
+    void AppendAddress(std::wstring& text, const IpAddress& address)
+    {
+        char buffer[IpAddress::MaximumText];
+        size_t length = address.Format(buffer);
+        text.append(buffer, buffer + length);
+    }
+
+    void AppendPrefix(std::wstring& text, const IpPrefix& prefix)
+    {
+        char buffer[IpPrefix::MaximumText];
+        size_t length = prefix.Format(buffer);
+        text.append(buffer, buffer + length);
+    }
+}
+
+// Lists every interface with its addresses, however many there are, in the format of
+// https://tangentsoft.net/wskfaq/examples/getifaces.html, and indexes their subnets for lookups.
 void MainPage::GetInterfaces()
 {
-    std::stringstream ss;
+    m_subnets.Clear();
+    m_subnetOwners.clear();
 
-    WSADATA WinsockData;
-    if (WSAStartup(MAKEWORD(2, 2), &WinsockData) != 0) 
+    int error = GetNetworkInterfaces(m_interfaces);
+    if (error != 0)
     {
-        results->Text = L"Failed to find Winsock 2.2!";
+        std::wstring message = L"Failed to list the network interfaces: error " + std::to_wstring(error);
+        results->Text = ref new Platform::String(message.c_str());
         return;
     }
 
-    SOCKET sd = WSASocket(AF_INET, SOCK_DGRAM, 0, 0, 0, 0);
-    if (sd == SOCKET_ERROR) 
+    // Built in one string, with room for a few addresses per interface.
+    std::wstring text;
+    text.reserve(64 + m_interfaces.size() * 256);
+    text += L"There are ";
+    text += std::to_wstring(m_interfaces.size());
+    text += L" interfaces:\n";
+    for (size_t i = 0; i < m_interfaces.size(); ++i)
     {
-        ss << "Failed to get a socket. Error " << WSAGetLastError() << std::endl; 
-        goto cleanup;
+        const NetworkInterface& networkInterface = m_interfaces[i];
+        uint32_t flags = networkInterface.flags;
+
+        text += L"\n ";
+        text += networkInterface.name;
+        text += L" is ";
+        text += (flags & NetworkInterface::Up) ? L"up" : L"down";
+        if (flags & NetworkInterface::PointToPoint) text += L", is point-to-point";
+        if (flags & NetworkInterface::Loopback)     text += L", is a loopback iface";
+        text += L", and can do: ";
+        if (flags & NetworkInterface::Broadcast) text += L"bcast ";
+        if (flags & NetworkInterface::Multicast) text += L"multicast ";
+        text += L"\n";
+
+        for (size_t j = 0; j < networkInterface.prefixes.size(); ++j)
+        {
+            const IpPrefix& prefix = networkInterface.prefixes[j];
+            text += L"  ";
+            AppendAddress(text, prefix.address);
+            text += L" on ";
+            AppendPrefix(text, IpPrefix(prefix.GetNetwork(), prefix.length));
+            if (prefix.address.family == AddressFamily::IPv4)
+            {
+                if ((flags & NetworkInterface::Broadcast) && prefix.length < 31)
+                {
+                    text += L" has bcast ";
+                    AppendAddress(text, prefix.GetLast());
+                }
+                text += L" and netmask ";
+                AppendAddress(text, prefix.GetMask());
+            }
+            text += L"\n";
+
+            m_subnets.Insert(prefix, static_cast<uint32_t>(m_subnetOwners.size()));
+            m_subnetOwners.push_back(std::make_pair(i, j));
+        }
     }
 
-    INTERFACE_INFO InterfaceList[20];
-    unsigned long nBytesReturned;
-    if (WSAIoctl(sd, SIO_GET_INTERFACE_LIST, 0, 0, &InterfaceList, sizeof(InterfaceList), &nBytesReturned, 0, 0) == SOCKET_ERROR) 
+    results->Text = ref new Platform::String(text.c_str(), static_cast<unsigned int>(text.size()));
+}
+
+void MainPage::Lookup_TextChanged(Platform::Object^ sender, TextChangedEventArgs^ e)
+{
+    const wchar_t* text = lookup->Text->Data();
+    size_t length = lookup->Text->Length();
+    if (length == 0)
     {
-        ss << "Failed calling WSAIoctl: error " << WSAGetLastError() << std::endl;
-        goto cleanup;
+        owner->Text = L"";
+        return;
     }
 
-    int nNumInterfaces = nBytesReturned / sizeof(INTERFACE_INFO);
-    ss << "There are " << nNumInterfaces << " interfaces:" << std::endl;
-    for (int i = 0; i < nNumInterfaces; ++i) 
+    // Addresses are ASCII, so anything else isn't one.
+    char buffer[IpPrefix::MaximumText];
+    bool ascii = length < sizeof(buffer);
+    for (size_t i = 0; ascii && i < length; ++i)
     {
-        ss << std::endl;
-
-        sockaddr_in *pAddress;
-        pAddress = (sockaddr_in *) & (InterfaceList[i].iiAddress);
-        ss << " " << inet_ntoa(pAddress->sin_addr);
-
-        pAddress = (sockaddr_in *) & (InterfaceList[i].iiBroadcastAddress);
-        ss << " has bcast " << inet_ntoa(pAddress->sin_addr);
-
-        pAddress = (sockaddr_in *) & (InterfaceList[i].iiNetmask);
-        ss << " and netmask " << inet_ntoa(pAddress->sin_addr) << std::endl;
-
-        ss << " Iface is ";
-        u_long nFlags = InterfaceList[i].iiFlags;
-        if (nFlags & IFF_UP) ss << "up";
-        else                 ss << "down";
-        if (nFlags & IFF_POINTTOPOINT) ss << ", is point-to-point";
-        if (nFlags & IFF_LOOPBACK)     ss << ", is a loopback iface";
-        ss << ", and can do: ";
-        if (nFlags & IFF_BROADCAST) ss << "bcast ";
-        if (nFlags & IFF_MULTICAST) ss << "multicast ";
-        ss << std::endl;
+        ascii = text[i] < 0x80;
+        buffer[i] = static_cast<char>(text[i]);
     }
 
-cleanup:
-    std::string s = ss.str();
-    std::wstring w(s.begin(), s.end());
-    results->Text = ref new Platform::String(w.c_str());
+    IpAddress address = ascii ? IpAddress::Parse(buffer, length) : IpAddress();
+    if (address.family == AddressFamily::None)
+    {
+        owner->Text = L"Not an IPv4 or IPv6 address";
+        return;
+    }
 
-    WSACleanup();
+    std::wstring answer;
+    AppendAddress(answer, address);
+    uint32_t found = m_subnets.Find(address);
+    if (found == PrefixTrie::NoValue)
+    {
+        answer += L" isn't on the subnet of any interface";
+    }
+    else
+    {
+        const NetworkInterface& networkInterface = m_interfaces[m_subnetOwners[found].first];
+        const IpPrefix& prefix = networkInterface.prefixes[m_subnetOwners[found].second];
+        answer += L" is on ";
+        AppendPrefix(answer, IpPrefix(prefix.GetNetwork(), prefix.length));
+        answer += L" of ";
+        answer += networkInterface.name;
+    }
+    owner->Text = ref new Platform::String(answer.c_str(), static_cast<unsigned int>(answer.size()));
 }
 
-
 MainPage::MainPage()
 {
 	InitializeComponent();
@@ -6,6 +6,11 @@
 #pragma once
 
 #include "MainPage.g.h"
+#include "NetworkInterfaces.h"
+#include "PrefixTrie.h"
+
+#include <utility>
+#include <vector>
 
 namespace SubNet
 {
@@ -19,6 +24,13 @@ namespace SubNet
 
     private:
         void GetInterfaces();
+        void Lookup_TextChanged(Platform::Object^ sender, Windows::UI::Xaml::Controls::TextChangedEventArgs^ e);
+
+        std::vector<NetworkInterface> m_interfaces;
+
+        // Every interface's subnets, to the interface and address they came from.
+        PrefixTrie m_subnets;
+        std::vector<std::pair<size_t, size_t>> m_subnetOwners;
 
 	};
 }
@@ -0,0 +1,177 @@
+#include "NetworkInterfaces.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <iphlpapi.h>
+#pragma comment(lib, "iphlpapi.lib")
+#else
+#include <cerrno>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#endif
+
+using namespace SubNet;
+
+namespace
+{
+    // The address in a sockaddr, family None for anything but IPv4 and IPv6.
+    IpAddress ToAddress(const sockaddr* address)
+    {
+        if (address == nullptr)
+        {
+            return IpAddress();
+        }
+        if (address->sa_family == AF_INET)
+        {
+            const sockaddr_in* in = reinterpret_cast<const sockaddr_in*>(address);
+            return IpAddress::FromIPv4Bytes(reinterpret_cast<const uint8_t*>(&in->sin_addr));
+        }
+        if (address->sa_family == AF_INET6)
+        {
+            const sockaddr_in6* in6 = reinterpret_cast<const sockaddr_in6*>(address);
+            return IpAddress::FromIPv6Bytes(reinterpret_cast<const uint8_t*>(&in6->sin6_addr));
+        }
+        return IpAddress();
+    }
+}
+
+#if defined(_WIN32)
+int SubNet::GetNetworkInterfaces(std::vector<NetworkInterface>& interfaces)
+{
+    interfaces.clear();
+
+    // The size needed comes back when the buffer is too small; adapters can come and go
+    // between calls, so keep going until it fits.
+    const ULONG flags = GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER;
+    ULONG size = 16 * 1024;
+    std::vector<uint64_t> buffer;
+    ULONG result;
+    do
+    {
+        buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        result = GetAdaptersAddresses(AF_UNSPEC, flags, nullptr, reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data()), &size);
+    } while (result == ERROR_BUFFER_OVERFLOW);
+
+    if (result == ERROR_NO_DATA)
+    {
+        return 0;
+    }
+    if (result != NO_ERROR)
+    {
+        return static_cast<int>(result);
+    }
+
+    for (const IP_ADAPTER_ADDRESSES* adapter = reinterpret_cast<IP_ADAPTER_ADDRESSES*>(buffer.data()); adapter != nullptr; adapter = adapter->Next)
+    {
+        NetworkInterface networkInterface;
+        networkInterface.name = adapter->FriendlyName != nullptr ? adapter->FriendlyName : L"";
+        networkInterface.index = adapter->IfIndex != 0 ? adapter->IfIndex : adapter->Ipv6IfIndex;
+        networkInterface.flags = 0;
+        if (adapter->OperStatus == IfOperStatusUp)
+        {
+            networkInterface.flags |= NetworkInterface::Up;
+        }
+        if (adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK)
+        {
+            networkInterface.flags |= NetworkInterface::Loopback;
+        }
+        else if (adapter->IfType == IF_TYPE_PPP || adapter->IfType == IF_TYPE_TUNNEL)
+        {
+            networkInterface.flags |= NetworkInterface::PointToPoint;
+        }
+        else
+        {
+            networkInterface.flags |= NetworkInterface::Broadcast;
+        }
+        if ((adapter->Flags & IP_ADAPTER_NO_MULTICAST) == 0)
+        {
+            networkInterface.flags |= NetworkInterface::Multicast;
+        }
+
+        for (const IP_ADAPTER_UNICAST_ADDRESS* unicast = adapter->FirstUnicastAddress; unicast != nullptr; unicast = unicast->Next)
+        {
+            IpAddress address = ToAddress(unicast->Address.lpSockaddr);
+            if (address.family != AddressFamily::None)
+            {
+                networkInterface.prefixes.push_back(IpPrefix(address, unicast->OnLinkPrefixLength));
+            }
+        }
+        interfaces.push_back(networkInterface);
+    }
+    return 0;
+}
+#else
+int SubNet::GetNetworkInterfaces(std::vector<NetworkInterface>& interfaces)
+{
+    interfaces.clear();
+
+    ifaddrs* list;
+    if (getifaddrs(&list) != 0)
+    {
+        return errno;
+    }
+
+    // One entry per address, and one per interface for its link layer, in interface order.
+    for (const ifaddrs* entry = list; entry != nullptr; entry = entry->ifa_next)
+    {
+        uint32_t index = if_nametoindex(entry->ifa_name);
+        NetworkInterface* networkInterface = nullptr;
+        for (NetworkInterface& existing : interfaces)
+        {
+            if (existing.index == index)
+            {
+                networkInterface = &existing;
+                break;
+            }
+        }
+        if (networkInterface == nullptr)
+        {
+            NetworkInterface added;
+            for (const char* c = entry->ifa_name; *c != '\0'; ++c)
+            {
+                added.name.push_back(static_cast<wchar_t>(static_cast<unsigned char>(*c)));
+            }
+            added.index = index;
+            added.flags = 0;
+            if (entry->ifa_flags & IFF_UP)
+            {
+                added.flags |= NetworkInterface::Up;
+            }
+            if (entry->ifa_flags & IFF_LOOPBACK)
+            {
+                added.flags |= NetworkInterface::Loopback;
+            }
+            if (entry->ifa_flags & IFF_POINTOPOINT)
+            {
+                added.flags |= NetworkInterface::PointToPoint;
+            }
+            if (entry->ifa_flags & IFF_BROADCAST)
+            {
+                added.flags |= NetworkInterface::Broadcast;
+            }
+            if (entry->ifa_flags & IFF_MULTICAST)
+            {
+                added.flags |= NetworkInterface::Multicast;
+            }
+            interfaces.push_back(added);
+            networkInterface = &interfaces.back();
+        }
+
+        IpAddress address = ToAddress(entry->ifa_addr);
+        if (address.family != AddressFamily::None)
+        {
+            IpPrefix prefix = IpPrefix::FromMask(address, ToAddress(entry->ifa_netmask));
+            if (prefix.address.family == AddressFamily::None)
+            {
+                prefix = IpPrefix(address, address.GetBits());
+            }
+            networkInterface->prefixes.push_back(prefix);
+        }
+    }
+
+    freeifaddrs(list);
+    return 0;
+}
+#endif
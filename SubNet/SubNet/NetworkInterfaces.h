@@ -0,0 +1,31 @@
+#pragma once
+
+#include "IpAddress.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SubNet
+{
+    struct NetworkInterface
+    {
+        enum Flags : uint32_t
+        {
+            Up = 1,
+            Loopback = 2,
+            PointToPoint = 4,
+            Broadcast = 8,
+            Multicast = 16
+        };
+
+        std::wstring            name;
+        uint32_t                index;
+        uint32_t                flags;
+        std::vector<IpPrefix>   prefixes;   // Its IPv4 and IPv6 addresses, with their subnets.
+    };
+
+    // Lists the network interfaces and their addresses, however many there are. Returns 0, or
+    // the error the OS gave.
+    int GetNetworkInterfaces(std::vector<NetworkInterface>& interfaces);
+}
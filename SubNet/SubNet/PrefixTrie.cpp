@@ -0,0 +1,197 @@
+#include "PrefixTrie.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace SubNet;
+
+namespace
+{
+    const uint32_t IPv4Root = 0;
+    const uint32_t IPv6Root = 1;
+
+    unsigned CountLeadingZeros(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        // _BitScanReverse64 isn't there on 32-bit targets.
+        unsigned long index;
+        if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+        {
+            return 31 - index;
+        }
+        _BitScanReverse(&index, static_cast<unsigned long>(value));
+        return 63 - index;
+#else
+        return static_cast<unsigned>(__builtin_clzll(value));
+#endif
+    }
+}
+
+PrefixTrie::PrefixTrie()
+{
+    Clear();
+}
+
+void PrefixTrie::Insert(const IpPrefix& prefix, uint32_t value)
+{
+    if (prefix.address.family == AddressFamily::None)
+    {
+        return;
+    }
+
+    unsigned length = prefix.length;
+    Key mask = ToMask(length);
+    Key key = ToKey(prefix.address);
+    key.high &= mask.high;
+    key.low &= mask.low;
+
+    uint32_t index = prefix.address.family == AddressFamily::IPv4 ? IPv4Root : IPv6Root;
+    uint32_t parent = 0;
+    unsigned side = 0;
+    for (;;)
+    {
+        unsigned nodeLength = m_nodes[index].length;
+        unsigned common = GetCommonLength(key, m_nodes[index].key);
+        if (common > nodeLength)
+        {
+            common = nodeLength;
+        }
+        if (common > length)
+        {
+            common = length;
+        }
+
+        if (common < nodeLength)
+        {
+            // The prefix parts from this node before its end: a node for the part they share
+            // goes between it and its parent. Never at a root, which has no bits.
+            Key shared = key;
+            Key sharedMask = ToMask(common);
+            shared.high &= sharedMask.high;
+            shared.low &= sharedMask.low;
+            uint32_t split = AddNode(shared, common, common == length ? value : NoValue);
+            m_nodes[split].children[GetBit(m_nodes[index].key, common)] = index;
+            if (common < length)
+            {
+                uint32_t leaf = AddNode(key, length, value);
+                m_nodes[split].children[GetBit(key, common)] = leaf;
+            }
+            m_nodes[parent].children[side] = split;
+            return;
+        }
+
+        if (length == nodeLength)
+        {
+            m_nodes[index].value = value;
+            return;
+        }
+
+        side = GetBit(key, nodeLength);
+        uint32_t child = m_nodes[index].children[side];
+        if (child == 0)
+        {
+            uint32_t leaf = AddNode(key, length, value);
+            m_nodes[index].children[side] = leaf;
+            return;
+        }
+        parent = index;
+        index = child;
+    }
+}
+
+uint32_t PrefixTrie::Find(const IpAddress& address) const
+{
+    if (address.family == AddressFamily::None)
+    {
+        return NoValue;
+    }
+
+    Key key = ToKey(address);
+    unsigned bits = address.GetBits();
+    uint32_t found = NoValue;
+    uint32_t index = address.family == AddressFamily::IPv4 ? IPv4Root : IPv6Root;
+    for (;;)
+    {
+        const Node& node = m_nodes[index];
+
+        // Every node below one that doesn't match is longer, so can't match either.
+        if (GetCommonLength(key, node.key) < node.length)
+        {
+            break;
+        }
+        if (node.value != NoValue)
+        {
+            found = node.value;
+        }
+        if (node.length >= bits)
+        {
+            break;
+        }
+        index = node.children[GetBit(key, node.length)];
+        if (index == 0)
+        {
+            break;
+        }
+    }
+    return found;
+}
+
+void PrefixTrie::Clear()
+{
+    m_nodes.clear();
+    Key zero = {};
+    AddNode(zero, 0, NoValue);
+    AddNode(zero, 0, NoValue);
+}
+
+PrefixTrie::Key PrefixTrie::ToKey(const IpAddress& address)
+{
+    Key key = {};
+    for (int i = 0; i < 8; ++i)
+    {
+        key.high = key.high << 8 | address.bytes[i];
+        key.low = key.low << 8 | address.bytes[i + 8];
+    }
+    return key;
+}
+
+PrefixTrie::Key PrefixTrie::ToMask(unsigned length)
+{
+    Key mask;
+    mask.high = length == 0 ? 0 : length >= 64 ? UINT64_MAX : UINT64_MAX << (64 - length);
+    mask.low = length <= 64 ? 0 : length >= 128 ? UINT64_MAX : UINT64_MAX << (128 - length);
+    return mask;
+}
+
+unsigned PrefixTrie::GetBit(const Key& key, unsigned position)
+{
+    return position < 64 ?
+        static_cast<unsigned>(key.high >> (63 - position)) & 1 :
+        static_cast<unsigned>(key.low >> (127 - position)) & 1;
+}
+
+unsigned PrefixTrie::GetCommonLength(const Key& a, const Key& b)
+{
+    if (a.high != b.high)
+    {
+        return CountLeadingZeros(a.high ^ b.high);
+    }
+    if (a.low != b.low)
+    {
+        return 64 + CountLeadingZeros(a.low ^ b.low);
+    }
+    return 128;
+}
+
+uint32_t PrefixTrie::AddNode(const Key& key, unsigned length, uint32_t value)
+{
+    Node node;
+    node.key = key;
+    node.children[0] = 0;
+    node.children[1] = 0;
+    node.value = value;
+    node.length = length;
+    m_nodes.push_back(node);
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "IpAddress.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace SubNet
+{
+    // Finds the longest of a set of IPv4 and IPv6 prefixes that contains an address, e.g. which
+    // subnet, and so which interface, an address is on. A binary trie per family with runs of
+    // single children collapsed into one node, so a lookup visits at most one node per prefix
+    // on the way to its match, all in one array.
+    class PrefixTrie
+    {
+    public:
+        static const uint32_t NoValue = UINT32_MAX;
+
+        PrefixTrie();
+
+        // Maps the prefix, without its host bits, to value, replacing any value it had.
+        void Insert(const IpPrefix& prefix, uint32_t value);
+
+        // The value of the longest prefix that contains address, or NoValue.
+        uint32_t Find(const IpAddress& address) const;
+
+        void Clear();
+
+    private:
+        // An address as a 128-bit number, IPv4 in the top 32 bits.
+        struct Key
+        {
+            uint64_t    high;
+            uint64_t    low;
+        };
+
+        // 32 bytes, two to a cache line.
+        struct Node
+        {
+            Key         key;            // The prefix, with its host bits cleared.
+            uint32_t    children[2];    // By the bit after the prefix; 0 for none.
+            uint32_t    value;
+            uint32_t    length;
+        };
+
+        static Key ToKey(const IpAddress& address);
+        static Key ToMask(unsigned length);
+        static unsigned GetBit(const Key& key, unsigned position);
+        static unsigned GetCommonLength(const Key& a, const Key& b);
+
+        uint32_t AddNode(const Key& key, unsigned length, uint32_t value);
+
+        std::vector<Node> m_nodes;  // The IPv4 root, the IPv6 root, then the rest.
+    };
+}
@@ -0,0 +1,36 @@
+#include "IpAddress.h"
+
+#include "Benchmark.h"
+
+#include <string>
+
+using namespace SubNet;
+
+BENCHMARK(IpAddressParseAndFormat)
+{
+    const std::string texts[] = { "192.168.1.20", "2001:db8:abcd:12::1", "fe80::1c2f:3aff:fe4b:5c6d", "::ffff:192.0.2.1" };
+    double parseTime = TestSupport::MeasureNanoseconds(4, [&]
+    {
+        for (const std::string& text : texts)
+        {
+            TestSupport::DoNotOptimize(IpAddress::Parse(text.data(), text.size()));
+        }
+    });
+
+    IpAddress addresses[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        addresses[i] = IpAddress::Parse(texts[i].data(), texts[i].size());
+    }
+    char buffer[IpAddress::MaximumText];
+    double formatTime = TestSupport::MeasureNanoseconds(4, [&]
+    {
+        for (const IpAddress& address : addresses)
+        {
+            TestSupport::DoNotOptimize(address.Format(buffer));
+        }
+    });
+
+    TestSupport::Report("Parse", parseTime, "ns");
+    TestSupport::Report("Format", formatTime, "ns");
+}
@@ -0,0 +1,197 @@
+#include "IpAddress.h"
+
+#include "Check.h"
+
+#include <arpa/inet.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace SubNet;
+
+namespace
+{
+    struct Lcg
+    {
+        uint32_t state = 11;
+
+        uint32_t Next(uint32_t limit)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) % limit;
+        }
+    };
+
+    IpAddress Parse(const std::string& text)
+    {
+        return IpAddress::Parse(text.data(), text.size());
+    }
+
+    std::string Format(const IpAddress& address)
+    {
+        char buffer[IpAddress::MaximumText];
+        size_t length = address.Format(buffer);
+        return std::string(buffer, length);
+    }
+
+    std::string Format(const IpPrefix& prefix)
+    {
+        char buffer[IpPrefix::MaximumText];
+        size_t length = prefix.Format(buffer);
+        return std::string(buffer, length);
+    }
+
+    IpPrefix ParsePrefix(const std::string& text)
+    {
+        return IpPrefix::Parse(text.data(), text.size());
+    }
+
+    // glibc writes ::a.b.c.d for the deprecated IPv4-compatible addresses, which RFC 5952
+    // leaves as hexadecimal.
+    bool IsIPv4Compatible(const uint8_t* bytes)
+    {
+        static const uint8_t zeros[12] = {};
+        return memcmp(bytes, zeros, 12) == 0 && (bytes[12] | bytes[13]) != 0;
+    }
+}
+
+TEST_CASE(IpAddressParsesAndFormatsIPv4)
+{
+    IpAddress address = Parse("192.168.1.20");
+    CHECK(address.family == AddressFamily::IPv4);
+    CHECK(address == IpAddress::FromIPv4(0xC0A80114));
+    CHECK_EQUAL(std::string("192.168.1.20"), Format(address));
+    CHECK_EQUAL(std::string("0.0.0.0"), Format(Parse("0.0.0.0")));
+    CHECK_EQUAL(std::string("255.255.255.255"), Format(Parse("255.255.255.255")));
+
+    const char* invalid[] = { "", "1.2.3", "1.2.3.4.5", "256.1.1.1", "01.2.3.4", "1.2.3.4 ", "1..2.3", "1.2.3.-4", "a.b.c.d", "1234.1.1.1" };
+    for (const char* text : invalid)
+    {
+        CHECK(IpAddress::Parse(text, strlen(text)).family == AddressFamily::None);
+    }
+}
+
+TEST_CASE(IpAddressParsesAndFormatsIPv6)
+{
+    CHECK_EQUAL(std::string("::"), Format(Parse("::")));
+    CHECK_EQUAL(std::string("::1"), Format(Parse("0:0:0:0:0:0:0:1")));
+    CHECK_EQUAL(std::string("2001:db8::1"), Format(Parse("2001:0DB8:0000:0000:0000:0000:0000:0001")));
+    CHECK_EQUAL(std::string("2001:db8:0:1:1:1:1:1"), Format(Parse("2001:db8::1:1:1:1:1")));
+    CHECK_EQUAL(std::string("2001:0:0:1::1"), Format(Parse("2001:0:0:1:0:0:0:1")));
+    CHECK_EQUAL(std::string("fe80::"), Format(Parse("fe80::")));
+    CHECK_EQUAL(std::string("::ffff:192.0.2.1"), Format(Parse("::ffff:c000:201")));
+    CHECK_EQUAL(std::string("64:ff9b::c000:201"), Format(Parse("64:ff9b::192.0.2.1")));
+    CHECK(Parse("::1") != Parse("::2"));
+    CHECK(Parse("::") != Parse("0.0.0.0"));
+
+    const char* invalid[] = { ":", ":::", "1::2::3", "1:2:3:4:5:6:7", "1:2:3:4:5:6:7:8:9", "12345::", "1:2:3:4:5:6:7:", ":1:2:3:4:5:6:7",
+        "::g", "1:2:3:4:5:6:7:1.2.3.4", "::1.2.3", "1:2:3:4:5:6:7:8::" };
+    for (const char* text : invalid)
+    {
+        CHECK(IpAddress::Parse(text, strlen(text)).family == AddressFamily::None);
+    }
+}
+
+TEST_CASE(IpAddressAgreesWithTheSocketLibrary)
+{
+    // Random addresses with runs of zero groups, so "::" lands everywhere.
+    Lcg random;
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint8_t bytes[16];
+        for (int group = 0; group < 8; ++group)
+        {
+            uint32_t value = random.Next(3) == 0 ? 0 : random.Next(4) == 0 ? random.Next(16) : random.Next(65536);
+            bytes[2 * group] = static_cast<uint8_t>(value >> 8);
+            bytes[2 * group + 1] = static_cast<uint8_t>(value);
+        }
+        if (random.Next(16) == 0)
+        {
+            memset(bytes, 0, 10);
+            bytes[10] = bytes[11] = 0xFF;
+        }
+
+        IpAddress address = IpAddress::FromIPv6Bytes(bytes);
+        char expected[INET6_ADDRSTRLEN];
+        CHECK(inet_ntop(AF_INET6, bytes, expected, sizeof(expected)) != nullptr);
+        if (!IsIPv4Compatible(bytes))
+        {
+            CHECK_EQUAL(std::string(expected), Format(address));
+        }
+        CHECK(Parse(expected) == address);
+        CHECK(Parse(Format(address)) == address);
+
+        IpAddress v4 = IpAddress::FromIPv4Bytes(bytes);
+        CHECK(inet_ntop(AF_INET, bytes, expected, sizeof(expected)) != nullptr);
+        CHECK_EQUAL(std::string(expected), Format(v4));
+        CHECK(Parse(expected) == v4);
+    }
+}
+
+TEST_CASE(IpPrefixParsesMasksAndContains)
+{
+    IpPrefix prefix = ParsePrefix("192.168.1.20/24");
+    CHECK_EQUAL(24u, static_cast<unsigned>(prefix.length));
+    CHECK_EQUAL(std::string("192.168.1.20/24"), Format(prefix));
+    CHECK_EQUAL(std::string("192.168.1.0"), Format(prefix.GetNetwork()));
+    CHECK_EQUAL(std::string("255.255.255.0"), Format(prefix.GetMask()));
+    CHECK_EQUAL(std::string("192.168.1.255"), Format(prefix.GetLast()));
+    CHECK_EQUAL(uint64_t(256), prefix.GetAddressCount());
+    CHECK(prefix.Contains(Parse("192.168.1.255")));
+    CHECK(!prefix.Contains(Parse("192.168.2.1")));
+    CHECK(!prefix.Contains(Parse("::ffff:192.168.1.1")));
+    CHECK(prefix.Contains(ParsePrefix("192.168.1.128/25")));
+    CHECK(!prefix.Contains(ParsePrefix("192.168.0.0/16")));
+
+    IpPrefix odd = ParsePrefix("10.1.2.3/13");
+    CHECK_EQUAL(std::string("10.0.0.0"), Format(odd.GetNetwork()));
+    CHECK_EQUAL(std::string("255.248.0.0"), Format(odd.GetMask()));
+    CHECK_EQUAL(std::string("10.7.255.255"), Format(odd.GetLast()));
+    CHECK(odd.Contains(Parse("10.7.0.1")));
+    CHECK(!odd.Contains(Parse("10.8.0.1")));
+
+    IpPrefix v6 = ParsePrefix("2001:db8:abcd:12::1/60");
+    CHECK_EQUAL(std::string("2001:db8:abcd:10::"), Format(v6.GetNetwork()));
+    CHECK_EQUAL(std::string("ffff:ffff:ffff:fff0::"), Format(v6.GetMask()));
+    CHECK_EQUAL(std::string("2001:db8:abcd:1f:ffff:ffff:ffff:ffff"), Format(v6.GetLast()));
+    CHECK_EQUAL(UINT64_MAX, v6.GetAddressCount());
+    CHECK_EQUAL(uint64_t(1) << 63, ParsePrefix("fe80::/65").GetAddressCount());
+    CHECK(v6.Contains(Parse("2001:db8:abcd:1f::5")));
+    CHECK(!v6.Contains(Parse("2001:db8:abcd:20::")));
+
+    CHECK_EQUAL(std::string("::1/128"), Format(ParsePrefix("::1")));
+    CHECK_EQUAL(std::string("0.0.0.0/0"), Format(ParsePrefix("0.0.0.0/0")));
+    CHECK(ParsePrefix("0.0.0.0/0").Contains(Parse("8.8.8.8")));
+
+    const char* invalid[] = { "1.2.3.4/", "1.2.3.4/33", "::/129", "1.2.3.4/1a", "1.2.3.4/0024", "/24", "1.2.3/8" };
+    for (const char* text : invalid)
+    {
+        CHECK(IpPrefix::Parse(text, strlen(text)).address.family == AddressFamily::None);
+    }
+}
+
+TEST_CASE(IpPrefixFromMask)
+{
+    IpPrefix prefix = IpPrefix::FromMask(Parse("172.16.5.4"), Parse("255.255.240.0"));
+    CHECK(prefix.address.family == AddressFamily::IPv4);
+    CHECK_EQUAL(20u, static_cast<unsigned>(prefix.length));
+    CHECK_EQUAL(0u, static_cast<unsigned>(IpPrefix::FromMask(Parse("1.2.3.4"), Parse("0.0.0.0")).length));
+    CHECK_EQUAL(128u, static_cast<unsigned>(IpPrefix::FromMask(Parse("::1"), Parse("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")).length));
+    CHECK_EQUAL(64u, static_cast<unsigned>(IpPrefix::FromMask(Parse("fe80::1"), Parse("ffff:ffff:ffff:ffff::")).length));
+
+    CHECK(IpPrefix::FromMask(Parse("1.2.3.4"), Parse("255.0.255.0")).address.family == AddressFamily::None);
+    CHECK(IpPrefix::FromMask(Parse("1.2.3.4"), Parse("ffff::")).address.family == AddressFamily::None);
+    CHECK(IpPrefix::FromMask(IpAddress(), IpAddress()).address.family == AddressFamily::None);
+
+    // Every mask length gives back its length.
+    for (unsigned length = 0; length <= 128; ++length)
+    {
+        IpPrefix v6(Parse("2001:db8::"), length);
+        CHECK_EQUAL(length, static_cast<unsigned>(IpPrefix::FromMask(v6.address, v6.GetMask()).length));
+        if (length <= 32)
+        {
+            IpPrefix v4(Parse("10.0.0.1"), length);
+            CHECK_EQUAL(length, static_cast<unsigned>(IpPrefix::FromMask(v4.address, v4.GetMask()).length));
+        }
+    }
+}
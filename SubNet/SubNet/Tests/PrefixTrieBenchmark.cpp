@@ -0,0 +1,93 @@
+#include "PrefixTrie.h"
+
+#include "Benchmark.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace SubNet;
+
+namespace
+{
+    struct Lcg
+    {
+        uint32_t state = 3;
+
+        uint32_t Next(uint32_t limit)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) % limit;
+        }
+    };
+
+    IpAddress RandomAddress(Lcg& random, AddressFamily family)
+    {
+        uint8_t bytes[16];
+        for (uint8_t& byte : bytes)
+        {
+            byte = static_cast<uint8_t>(random.Next(256));
+        }
+        return family == AddressFamily::IPv4 ? IpAddress::FromIPv4Bytes(bytes) : IpAddress::FromIPv6Bytes(bytes);
+    }
+
+    void Run(size_t count)
+    {
+        // A mix of IPv4 subnets and IPv6 /48 to /64 prefixes, as a machine with many interfaces
+        // or a routing table has, looked up by addresses half of which are in one of them.
+        Lcg random;
+        PrefixTrie trie;
+        std::vector<IpPrefix> prefixes;
+        for (size_t i = 0; i < count; ++i)
+        {
+            bool v4 = random.Next(2) == 0;
+            IpPrefix prefix(RandomAddress(random, v4 ? AddressFamily::IPv4 : AddressFamily::IPv6), v4 ? 8 + random.Next(25) : 48 + random.Next(17));
+            trie.Insert(prefix, static_cast<uint32_t>(i));
+            prefixes.push_back(prefix);
+        }
+
+        std::vector<IpAddress> addresses;
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            addresses.push_back(i % 2 == 0 ?
+                prefixes[random.Next(static_cast<uint32_t>(count))].GetLast() :
+                RandomAddress(random, random.Next(2) == 0 ? AddressFamily::IPv4 : AddressFamily::IPv6));
+        }
+
+        double trieTime = TestSupport::MeasureNanoseconds(addresses.size(), [&]
+        {
+            for (const IpAddress& address : addresses)
+            {
+                TestSupport::DoNotOptimize(trie.Find(address));
+            }
+        });
+        double linearTime = TestSupport::MeasureNanoseconds(addresses.size(), [&]
+        {
+            for (const IpAddress& address : addresses)
+            {
+                uint32_t found = PrefixTrie::NoValue;
+                unsigned longest = 0;
+                for (size_t i = 0; i < prefixes.size(); ++i)
+                {
+                    if (prefixes[i].Contains(address) && (found == PrefixTrie::NoValue || prefixes[i].length >= longest))
+                    {
+                        longest = prefixes[i].length;
+                        found = static_cast<uint32_t>(i);
+                    }
+                }
+                TestSupport::DoNotOptimize(found);
+            }
+        });
+
+        std::string name = std::to_string(count) + " prefixes";
+        TestSupport::Report((name + ", trie").c_str(), trieTime, "ns/lookup");
+        TestSupport::Report((name + ", linear scan").c_str(), linearTime, "ns/lookup");
+    }
+}
+
+BENCHMARK(PrefixTrieFind)
+{
+    Run(8);
+    Run(256);
+    Run(10000);
+}
@@ -0,0 +1,138 @@
+#include "PrefixTrie.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace SubNet;
+
+namespace
+{
+    // A copy, as CHECK_EQUAL takes a reference and the member has no definition.
+    const uint32_t NoValue = PrefixTrie::NoValue;
+
+    struct Lcg
+    {
+        uint32_t state = 5;
+
+        uint32_t Next(uint32_t limit)
+        {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) % limit;
+        }
+    };
+
+    IpAddress Parse(const char* text)
+    {
+        return IpAddress::Parse(text, strlen(text));
+    }
+
+    IpPrefix ParsePrefix(const char* text)
+    {
+        return IpPrefix::Parse(text, strlen(text));
+    }
+
+    // The longest containing prefix, found by looking at every one, the later of equal ones.
+    uint32_t FindLinear(const std::vector<IpPrefix>& prefixes, const std::vector<uint32_t>& values, const IpAddress& address)
+    {
+        uint32_t found = NoValue;
+        int longest = -1;
+        for (size_t i = 0; i < prefixes.size(); ++i)
+        {
+            if (prefixes[i].Contains(address) && prefixes[i].length >= longest)
+            {
+                longest = prefixes[i].length;
+                found = values[i];
+            }
+        }
+        return found;
+    }
+
+    // Addresses near each other, so the prefixes nest and share leading bits.
+    IpAddress RandomAddress(Lcg& random, AddressFamily family)
+    {
+        uint8_t bytes[16] = {};
+        bytes[0] = static_cast<uint8_t>(random.Next(2) == 0 ? 10 : 192);
+        for (int i = 1; i < 16; ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(random.Next(4) == 0 ? random.Next(256) : random.Next(4));
+        }
+        return family == AddressFamily::IPv4 ? IpAddress::FromIPv4Bytes(bytes) : IpAddress::FromIPv6Bytes(bytes);
+    }
+}
+
+TEST_CASE(PrefixTrieFindsTheLongestPrefix)
+{
+    PrefixTrie trie;
+    CHECK_EQUAL(NoValue, trie.Find(Parse("10.0.0.1")));
+
+    trie.Insert(ParsePrefix("10.0.0.0/8"), 1);
+    trie.Insert(ParsePrefix("10.1.0.0/16"), 2);
+    trie.Insert(ParsePrefix("10.1.2.3/24"), 3);
+    trie.Insert(ParsePrefix("10.1.2.77/32"), 4);
+    trie.Insert(ParsePrefix("fe80::/64"), 5);
+    trie.Insert(ParsePrefix("::/0"), 6);
+
+    CHECK_EQUAL(1u, trie.Find(Parse("10.200.0.1")));
+    CHECK_EQUAL(2u, trie.Find(Parse("10.1.200.1")));
+    CHECK_EQUAL(3u, trie.Find(Parse("10.1.2.1")));
+    CHECK_EQUAL(4u, trie.Find(Parse("10.1.2.77")));
+    CHECK_EQUAL(NoValue, trie.Find(Parse("11.0.0.1")));
+    CHECK_EQUAL(5u, trie.Find(Parse("fe80::1234")));
+    CHECK_EQUAL(6u, trie.Find(Parse("2001:db8::1")));
+
+    // The families are apart, even where the bytes are the same.
+    CHECK_EQUAL(6u, trie.Find(Parse("a01:203::")));
+    CHECK_EQUAL(NoValue, trie.Find(IpAddress()));
+
+    // Inserting again replaces the value; a shorter prefix splits the nodes below it.
+    trie.Insert(ParsePrefix("10.1.0.0/16"), 7);
+    trie.Insert(ParsePrefix("10.1.0.0/12"), 8);
+    CHECK_EQUAL(7u, trie.Find(Parse("10.1.200.1")));
+    CHECK_EQUAL(8u, trie.Find(Parse("10.2.0.1")));
+    CHECK_EQUAL(1u, trie.Find(Parse("10.16.0.1")));
+
+    trie.Insert(ParsePrefix("0.0.0.0/0"), 9);
+    CHECK_EQUAL(9u, trie.Find(Parse("11.0.0.1")));
+
+    trie.Clear();
+    CHECK_EQUAL(NoValue, trie.Find(Parse("10.1.2.77")));
+    CHECK_EQUAL(NoValue, trie.Find(Parse("fe80::1")));
+}
+
+TEST_CASE(PrefixTrieAgreesWithALinearScan)
+{
+    Lcg random;
+    for (int round = 0; round < 20; ++round)
+    {
+        PrefixTrie trie;
+        std::vector<IpPrefix> prefixes;
+        std::vector<uint32_t> values;
+        size_t count = 1 + random.Next(300);
+        for (size_t i = 0; i < count; ++i)
+        {
+            AddressFamily family = random.Next(2) == 0 ? AddressFamily::IPv4 : AddressFamily::IPv6;
+            IpPrefix prefix(RandomAddress(random, family), random.Next(family == AddressFamily::IPv4 ? 33 : 129));
+            uint32_t value = static_cast<uint32_t>(i);
+            trie.Insert(prefix, value);
+            prefixes.push_back(prefix);
+            values.push_back(value);
+        }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            // Half inside a prefix, in its last address or in its network.
+            AddressFamily family = random.Next(2) == 0 ? AddressFamily::IPv4 : AddressFamily::IPv6;
+            IpAddress address = RandomAddress(random, family);
+            if (random.Next(2) == 0)
+            {
+                const IpPrefix& prefix = prefixes[random.Next(static_cast<uint32_t>(prefixes.size()))];
+                address = random.Next(2) == 0 ? prefix.GetLast() : prefix.GetNetwork();
+            }
+            CHECK_EQUAL(FindLinear(prefixes, values, address), trie.Find(address));
+        }
+    }
+}
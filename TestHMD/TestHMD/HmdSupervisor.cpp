@@ -0,0 +1,280 @@
+#include "HmdSupervisor.h"
+
+#include <algorithm>
+
+namespace
+{
+    size_t Index(SupervisorState state)
+    {
+        return static_cast<size_t>(state);
+    }
+}
+
+// For each state, the first rule whose condition holds is applied, and then the rules of the
+// state it leads to, until none holds.
+const HmdSupervisor::Rule HmdSupervisor::Rules[] =
+{
+    { SupervisorState::PortalDown,      Condition::AppUp,       SupervisorState::AppRunning,        Action::None },
+    { SupervisorState::PortalDown,      Condition::PortalReady, SupervisorState::HmdOff,            Action::None },
+    { SupervisorState::PortalDown,      Condition::PortalDue,   SupervisorState::PortalStarting,    Action::LaunchPortal },
+
+    { SupervisorState::PortalStarting,  Condition::AppUp,       SupervisorState::AppRunning,        Action::None },
+    { SupervisorState::PortalStarting,  Condition::PortalReady, SupervisorState::HmdOff,            Action::None },
+    { SupervisorState::PortalStarting,  Condition::PortalLate,  SupervisorState::PortalDown,        Action::None },
+
+    { SupervisorState::HmdOff,          Condition::AppUp,       SupervisorState::AppRunning,        Action::None },
+    { SupervisorState::HmdOff,          Condition::PortalGone,  SupervisorState::PortalDown,        Action::None },
+    { SupervisorState::HmdOff,          Condition::HmdPutOn,    SupervisorState::HmdOn,             Action::None },
+    { SupervisorState::HmdOff,          Condition::AppDue,      SupervisorState::AppStarting,       Action::LaunchApp },
+
+    { SupervisorState::HmdOn,           Condition::AppUp,       SupervisorState::AppRunning,        Action::None },
+    { SupervisorState::HmdOn,           Condition::PortalGone,  SupervisorState::PortalDown,        Action::None },
+    { SupervisorState::HmdOn,           Condition::HmdTakenOff, SupervisorState::HmdOff,            Action::None },
+    { SupervisorState::HmdOn,           Condition::AppDue,      SupervisorState::AppStarting,       Action::LaunchApp },
+
+    { SupervisorState::AppStarting,     Condition::AppUp,       SupervisorState::AppRunning,        Action::None },
+    { SupervisorState::AppStarting,     Condition::PortalGone,  SupervisorState::PortalDown,        Action::None },
+    { SupervisorState::AppStarting,     Condition::AppLate,     SupervisorState::HmdOff,            Action::None },
+
+    { SupervisorState::AppRunning,      Condition::AppGone,     SupervisorState::HmdOff,            Action::None },
+};
+
+HmdSupervisor::Settings::Settings() :
+    portalTimeout(std::chrono::seconds(30)),
+    appTimeout(std::chrono::seconds(10)),
+    firstBackoff(std::chrono::milliseconds(500)),
+    maximumBackoff(std::chrono::seconds(30)),
+    stableTime(std::chrono::seconds(10))
+{
+}
+
+HmdSupervisor::HmdSupervisor(ISupervisorActions* actions, const Settings& settings) :
+    m_actions(actions),
+    m_settings(settings),
+    m_state(SupervisorState::PortalDown),
+    m_started(false),
+    m_portalAttempts(0),
+    m_appAttempts(0),
+    m_appLaunched(false),
+    m_recovering(false),
+    m_timings(),
+    m_recovery()
+{
+}
+
+HmdSupervisor::Clock::time_point HmdSupervisor::Update(const Observation& observation, Clock::time_point now)
+{
+    if (!m_started)
+    {
+        m_started = true;
+        m_enteredAt = now;
+    }
+
+    if (m_state == SupervisorState::AppRunning && now - m_enteredAt >= m_settings.stableTime)
+    {
+        m_appAttempts = 0;
+    }
+
+    if (!observation.appRunning)
+    {
+        if (!observation.hmdOn)
+        {
+            m_recovering = false;
+        }
+        else if (!m_recovering)
+        {
+            m_recovering = true;
+            m_lostAt = now;
+        }
+    }
+
+    // Every state has a way out that needs a new observation or more time, so this ends well
+    // within a lap of the states; the limit only guards against a bad table.
+    for (size_t step = 0; step < 2 * Index(SupervisorState::Count); ++step)
+    {
+        const Rule* applied = nullptr;
+        for (const Rule& rule : Rules)
+        {
+            if (rule.from == m_state && Holds(rule.when, observation, now))
+            {
+                applied = &rule;
+                break;
+            }
+        }
+        if (applied == nullptr)
+        {
+            break;
+        }
+        Apply(*applied, now);
+    }
+
+    return NextDeadline();
+}
+
+const HmdSupervisor::Timing& HmdSupervisor::GetTiming(SupervisorState from, SupervisorState to) const
+{
+    return m_timings[Index(from)][Index(to)];
+}
+
+const char* HmdSupervisor::GetName(SupervisorState state)
+{
+    switch (state)
+    {
+    case SupervisorState::PortalDown:
+        return "portal down";
+    case SupervisorState::PortalStarting:
+        return "portal starting";
+    case SupervisorState::HmdOff:
+        return "HMD off";
+    case SupervisorState::HmdOn:
+        return "HMD on";
+    case SupervisorState::AppStarting:
+        return "MR app starting";
+    case SupervisorState::AppRunning:
+        return "MR app running";
+    default:
+        return "unknown";
+    }
+}
+
+bool HmdSupervisor::Holds(Condition condition, const Observation& observation, Clock::time_point now) const
+{
+    switch (condition)
+    {
+    case Condition::PortalReady:
+        return observation.portalReady;
+    case Condition::PortalGone:
+        return !observation.portalReady;
+    case Condition::PortalDue:
+        return m_portalAttempts == 0 || now >= m_portalFailedAt + Backoff(m_portalAttempts);
+    case Condition::PortalLate:
+        return now - m_enteredAt >= m_settings.portalTimeout;
+    case Condition::HmdPutOn:
+        return observation.hmdOn;
+    case Condition::HmdTakenOff:
+        return !observation.hmdOn;
+    case Condition::AppUp:
+        return observation.appRunning;
+    case Condition::AppGone:
+        return !observation.appRunning;
+    case Condition::AppDue:
+        return (observation.hmdOn || !m_appLaunched) &&
+            (m_appAttempts == 0 || now >= m_appFailedAt + Backoff(m_appAttempts));
+    case Condition::AppLate:
+        return now - m_enteredAt >= m_settings.appTimeout;
+    default:
+        return false;
+    }
+}
+
+void HmdSupervisor::Apply(const Rule& rule, Clock::time_point now)
+{
+    switch (rule.when)
+    {
+    case Condition::PortalReady:
+        m_portalAttempts = 0;
+        break;
+    case Condition::PortalLate:
+        m_portalFailedAt = now;
+        break;
+    case Condition::AppGone:
+    case Condition::AppLate:
+        m_appFailedAt = now;
+        break;
+    case Condition::PortalGone:
+        if (rule.from == SupervisorState::AppStarting)
+        {
+            m_appFailedAt = now;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (rule.to == SupervisorState::AppRunning && m_recovering)
+    {
+        m_recovering = false;
+        Add(m_recovery, std::chrono::duration<double>(now - m_lostAt).count());
+    }
+
+    double seconds = std::chrono::duration<double>(now - m_enteredAt).count();
+    Add(m_timings[Index(rule.from)][Index(rule.to)], seconds);
+    m_state = rule.to;
+    m_enteredAt = now;
+    if (m_actions != nullptr)
+    {
+        m_actions->OnTransition(rule.from, rule.to, seconds);
+    }
+
+    switch (rule.action)
+    {
+    case Action::LaunchPortal:
+        ++m_portalAttempts;
+        if (m_actions != nullptr)
+        {
+            m_actions->LaunchPortal();
+        }
+        break;
+    case Action::LaunchApp:
+        ++m_appAttempts;
+        m_appLaunched = true;
+        if (m_actions != nullptr)
+        {
+            m_actions->LaunchApp();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+HmdSupervisor::Clock::time_point HmdSupervisor::NextDeadline() const
+{
+    switch (m_state)
+    {
+    case SupervisorState::PortalDown:
+        return m_portalFailedAt + Backoff(m_portalAttempts);
+    case SupervisorState::PortalStarting:
+        return m_enteredAt + m_settings.portalTimeout;
+    case SupervisorState::HmdOff:
+        if (m_appLaunched)
+        {
+            return Clock::time_point::max();
+        }
+        return m_appFailedAt + Backoff(m_appAttempts);
+    case SupervisorState::HmdOn:
+        return m_appFailedAt + Backoff(m_appAttempts);
+    case SupervisorState::AppStarting:
+        return m_enteredAt + m_settings.appTimeout;
+    case SupervisorState::AppRunning:
+        if (m_appAttempts == 0)
+        {
+            return Clock::time_point::max();
+        }
+        return m_enteredAt + m_settings.stableTime;
+    default:
+        return Clock::time_point::max();
+    }
+}
+
+HmdSupervisor::Clock::duration HmdSupervisor::Backoff(uint32_t attempts) const
+{
+    if (attempts == 0)
+    {
+        return Clock::duration::zero();
+    }
+
+    Clock::duration backoff = m_settings.firstBackoff;
+    for (uint32_t i = 1; i < attempts && backoff < m_settings.maximumBackoff; ++i)
+    {
+        backoff *= 2;
+    }
+    return std::min(backoff, m_settings.maximumBackoff);
+}
+
+void HmdSupervisor::Add(Timing& timing, double seconds)
+{
+    ++timing.count;
+    timing.totalSeconds += seconds;
+    timing.maximumSeconds = std::max(timing.maximumSeconds, seconds);
+}
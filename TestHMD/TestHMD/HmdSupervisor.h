@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+enum class SupervisorState
+{
+    PortalDown,
+    PortalStarting,     // Launched, waiting for its window.
+    HmdOff,             // Portal ready, app not running, nobody wearing the HMD.
+    HmdOn,              // Portal ready, app not running, HMD worn.
+    AppStarting,        // Launched, waiting for its process.
+    AppRunning,
+    Count
+};
+
+// What HmdSupervisor does, called from Update on its thread.
+class ISupervisorActions
+{
+public:
+    virtual ~ISupervisorActions() {}
+
+    virtual void LaunchPortal() = 0;
+
+    // Brings the MR Portal to the front and launches the MR app in it.
+    virtual void LaunchApp() = 0;
+
+    // seconds is the time spent in from.
+    virtual void OnTransition(SupervisorState from, SupervisorState to, double seconds) = 0;
+};
+
+// Keeps the MR app running in the MR Portal while the HMD is worn. The rules that move
+// between the states are declared in one table, and each fires on what the caller observes,
+// such as a process the watcher saw start or exit, or on a timer, never after a fixed sleep.
+// A launch that doesn't take, or an app that keeps exiting, is retried with exponential
+// backoff. The time is passed in, so the whole thing can be simulated.
+class HmdSupervisor
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Observation
+    {
+        bool    portalReady;    // Its window exists.
+        bool    hmdOn;
+        bool    appRunning;
+    };
+
+    struct Settings
+    {
+        Settings();
+
+        Clock::duration portalTimeout;      // From launching the portal to its window.
+        Clock::duration appTimeout;         // From launching the app to its process.
+        Clock::duration firstBackoff;       // Before the second launch; doubles after that.
+        Clock::duration maximumBackoff;
+
+        // Running this long makes the next launch of the app the first again.
+        Clock::duration stableTime;
+    };
+
+    struct Timing
+    {
+        uint32_t    count;
+        double      totalSeconds;
+        double      maximumSeconds;
+    };
+
+    // Starts in PortalDown; nothing is launched until Update.
+    HmdSupervisor(ISupervisorActions* actions, const Settings& settings = Settings());
+
+    // Applies every rule the observation and the time allow, running their actions. Returns
+    // when to call it again if nothing observed changes before, or Clock::time_point::max().
+    Clock::time_point Update(const Observation& observation, Clock::time_point now);
+
+    SupervisorState GetState() const { return m_state; }
+
+    // The time spent in from on the way to to.
+    const Timing& GetTiming(SupervisorState from, SupervisorState to) const;
+
+    // From the app being wanted and not running, with the HMD worn, to it running again.
+    const Timing& GetRecovery() const { return m_recovery; }
+
+    static const char* GetName(SupervisorState state);
+
+private:
+    enum class Condition
+    {
+        PortalReady,
+        PortalGone,
+        PortalDue,      // No backoff left before launching the portal.
+        PortalLate,     // The portal launch timed out.
+        HmdPutOn,
+        HmdTakenOff,
+        AppUp,
+        AppGone,
+        AppDue,         // The app is wanted, with no backoff left before launching it.
+        AppLate
+    };
+
+    enum class Action
+    {
+        None,
+        LaunchPortal,
+        LaunchApp
+    };
+
+    struct Rule
+    {
+        SupervisorState from;
+        Condition       when;
+        SupervisorState to;
+        Action          action;
+    };
+
+    static const Rule Rules[];
+
+    bool Holds(Condition condition, const Observation& observation, Clock::time_point now) const;
+    void Apply(const Rule& rule, Clock::time_point now);
+    Clock::time_point NextDeadline() const;
+    Clock::duration Backoff(uint32_t attempts) const;
+
+    static void Add(Timing& timing, double seconds);
+
+    ISupervisorActions* m_actions;
+    Settings            m_settings;
+    SupervisorState     m_state;
+    Clock::time_point   m_enteredAt;
+    bool                m_started;
+
+    // Launches since the portal was last ready, and since the app last ran for stableTime.
+    uint32_t            m_portalAttempts;
+    uint32_t            m_appAttempts;
+    Clock::time_point   m_portalFailedAt;
+    Clock::time_point   m_appFailedAt;
+    bool                m_appLaunched;      // Ever; the first launch doesn't wait for the HMD.
+
+    bool                m_recovering;
+    Clock::time_point   m_lostAt;
+
+    Timing              m_timings[static_cast<size_t>(SupervisorState::Count)][static_cast<size_t>(SupervisorState::Count)];
+    Timing              m_recovery;
+};
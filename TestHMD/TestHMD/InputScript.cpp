@@ -0,0 +1,107 @@
+#include "InputScript.h"
+
+InputScript& InputScript::Chord(std::initializer_list<uint16_t> keys)
+{
+    for (uint16_t key : keys)
+    {
+        AddKey(key, false);
+    }
+    for (auto key = keys.end(); key != keys.begin();)
+    {
+        AddKey(*--key, true);
+    }
+    return *this;
+}
+
+InputScript& InputScript::Type(std::initializer_list<uint16_t> keys)
+{
+    for (uint16_t key : keys)
+    {
+        AddKey(key, false);
+        AddKey(key, true);
+    }
+    return *this;
+}
+
+InputScript& InputScript::Click(int32_t x, int32_t y)
+{
+    AddMouse(x, y, MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE);
+    AddMouse(x, y, MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_ABSOLUTE);
+    AddMouse(x, y, MOUSEEVENTF_LEFTUP | MOUSEEVENTF_ABSOLUTE);
+    return *this;
+}
+
+InputScript& InputScript::Wait(std::chrono::milliseconds delay)
+{
+    // Waits with nothing between them add up.
+    if (!m_steps.empty() && m_steps.back().count == 0)
+    {
+        m_steps.back().delay += delay;
+    }
+    else
+    {
+        Step step = { static_cast<uint32_t>(m_inputs.size()), 0, delay };
+        m_steps.push_back(step);
+    }
+    return *this;
+}
+
+void InputScript::MoveStep(size_t step, int32_t x, int32_t y)
+{
+    const Step& moved = m_steps[step];
+    for (uint32_t i = moved.first; i < moved.first + moved.count; ++i)
+    {
+        if (m_inputs[i].type == INPUT_MOUSE)
+        {
+            m_inputs[i].mi.dx = x;
+            m_inputs[i].mi.dy = y;
+        }
+    }
+}
+
+bool InputScript::Play(IInputInjector& injector) const
+{
+    for (const Step& step : m_steps)
+    {
+        if (step.delay.count() > 0)
+        {
+            injector.Wait(step.delay);
+        }
+        if (step.count > 0 && injector.Send(&m_inputs[step.first], step.count) != step.count)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InputScript::AddKey(uint16_t key, bool up)
+{
+    SyntheticInput input = {};
+    input.type = INPUT_KEYBOARD;
+    input.ki.wVk = key;
+    input.ki.dwFlags = (IsExtendedKey(key) ? KEYEVENTF_EXTENDEDKEY : 0) | (up ? KEYEVENTF_KEYUP : 0);
+    m_inputs.push_back(input);
+    Added();
+}
+
+void InputScript::AddMouse(int32_t x, int32_t y, uint32_t flags)
+{
+    SyntheticInput input = {};
+    input.type = INPUT_MOUSE;
+    input.mi.dx = x;
+    input.mi.dy = y;
+    input.mi.dwFlags = flags;
+    m_inputs.push_back(input);
+    Added();
+}
+
+void InputScript::Added()
+{
+    if (m_steps.empty())
+    {
+        Step step = { static_cast<uint32_t>(m_inputs.size() - 1), 0, std::chrono::milliseconds(0) };
+        m_steps.push_back(step);
+    }
+    ++m_steps.back().count;
+}
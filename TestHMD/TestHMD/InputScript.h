@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+
+typedef INPUT SyntheticInput;
+#else
+// The Win32 INPUT layout and the constants scripts use, so they compile and can be checked
+// elsewhere.
+struct SyntheticMouseInput
+{
+    int32_t     dx;
+    int32_t     dy;
+    uint32_t    mouseData;
+    uint32_t    dwFlags;
+    uint32_t    time;
+    uintptr_t   dwExtraInfo;
+};
+
+struct SyntheticKeyboardInput
+{
+    uint16_t    wVk;
+    uint16_t    wScan;
+    uint32_t    dwFlags;
+    uint32_t    time;
+    uintptr_t   dwExtraInfo;
+};
+
+struct SyntheticInput
+{
+    uint32_t    type;
+    union
+    {
+        SyntheticMouseInput     mi;
+        SyntheticKeyboardInput  ki;
+    };
+};
+
+const uint32_t INPUT_MOUSE = 0;
+const uint32_t INPUT_KEYBOARD = 1;
+const uint32_t KEYEVENTF_EXTENDEDKEY = 0x0001;
+const uint32_t KEYEVENTF_KEYUP = 0x0002;
+const uint32_t MOUSEEVENTF_MOVE = 0x0001;
+const uint32_t MOUSEEVENTF_LEFTDOWN = 0x0002;
+const uint32_t MOUSEEVENTF_LEFTUP = 0x0004;
+const uint32_t MOUSEEVENTF_ABSOLUTE = 0x8000;
+#endif
+
+// A set of virtual key codes as 256 bits, built at compile time.
+struct VirtualKeySet
+{
+    uint64_t bits[4];
+
+    constexpr bool Contains(uint16_t key) const
+    {
+        return key < 256 && ((bits[key >> 6] >> (key & 63)) & 1) != 0;
+    }
+};
+
+constexpr VirtualKeySet MakeVirtualKeySet(std::initializer_list<uint8_t> keys)
+{
+    VirtualKeySet set = {};
+    for (uint8_t key : keys)
+    {
+        set.bits[key >> 6] |= uint64_t(1) << (key & 63);
+    }
+    return set;
+}
+
+// The keys sent with KEYEVENTF_EXTENDEDKEY.
+constexpr VirtualKeySet ExtendedKeys = MakeVirtualKeySet({
+    0x03,   // VK_CANCEL
+    0x11,   // VK_CONTROL
+    0x12,   // VK_MENU
+    0x21,   // VK_PRIOR
+    0x22,   // VK_NEXT
+    0x23,   // VK_END
+    0x24,   // VK_HOME
+    0x25,   // VK_LEFT
+    0x26,   // VK_UP
+    0x27,   // VK_RIGHT
+    0x28,   // VK_DOWN
+    0x2C,   // VK_SNAPSHOT
+    0x2D,   // VK_INSERT
+    0x2E,   // VK_DELETE
+    0x6F,   // VK_DIVIDE
+    0x90,   // VK_NUMLOCK
+    0xA3,   // VK_RCONTROL
+    0xA4,   // VK_LMENU
+    0xA5    // VK_RMENU
+});
+
+constexpr bool IsExtendedKey(uint16_t key)
+{
+    return ExtendedKeys.Contains(key);
+}
+
+static_assert(IsExtendedKey(0x27) && !IsExtendedKey(0x59) && !IsExtendedKey(0x5B), "VK_RIGHT is extended, Y and VK_LWIN aren't");
+
+// Submits input. SendInput on Windows; tests record it.
+class IInputInjector
+{
+public:
+    virtual ~IInputInjector() {}
+
+    // Returns how many of the inputs were injected.
+    virtual uint32_t Send(const SyntheticInput* inputs, uint32_t count) = 0;
+
+    virtual void Wait(std::chrono::milliseconds delay) = 0;
+};
+
+// Synthetic keyboard and mouse input, compiled once into one array of INPUTs and played as
+// steps. Everything added between two waits is a step, and is injected with one call, so
+// nothing else can interleave with a chord or a click.
+class InputScript
+{
+public:
+    struct Step
+    {
+        uint32_t                    first;      // Index in GetInputs.
+        uint32_t                    count;
+        std::chrono::milliseconds   delay;      // Waited before it.
+    };
+
+    // Presses the keys in order and releases them in reverse, e.g. { VK_LWIN, 'Y' }.
+    InputScript& Chord(std::initializer_list<uint16_t> keys);
+
+    // Presses and releases each key in turn.
+    InputScript& Type(std::initializer_list<uint16_t> keys);
+
+    // Moves the mouse to x, y, normalized as for MOUSEEVENTF_ABSOLUTE, and clicks the left
+    // button.
+    InputScript& Click(int32_t x, int32_t y);
+
+    // Starts a new step after delay.
+    InputScript& Wait(std::chrono::milliseconds delay);
+
+    // Points the mouse input of a step at x, y, for a target only known when it is played.
+    void MoveStep(size_t step, int32_t x, int32_t y);
+
+    // Returns false, and stops, when a step isn't injected in full.
+    bool Play(IInputInjector& injector) const;
+
+    const std::vector<Step>& GetSteps() const { return m_steps; }
+    const std::vector<SyntheticInput>& GetInputs() const { return m_inputs; }
+
+private:
+    void AddKey(uint16_t key, bool up);
+    void AddMouse(int32_t x, int32_t y, uint32_t flags);
+    void Added();
+
+    std::vector<SyntheticInput> m_inputs;
+    std::vector<Step>           m_steps;
+};
@@ -0,0 +1,469 @@
+#include "ProcessWatcher.h"
+
+#include <algorithm>
+#include <cwctype>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <tlhelp32.h>
+#else
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const intptr_t NoHandle = -1;
+
+    void ToLower(std::wstring& text)
+    {
+        for (wchar_t& c : text)
+        {
+            c = static_cast<wchar_t>(towlower(c));
+        }
+    }
+
+#if defined(_WIN32)
+    HANDLE ToHandle(intptr_t handle)
+    {
+        return reinterpret_cast<HANDLE>(handle);
+    }
+#else
+    // Longest comm the kernel keeps; longer names are cut.
+    const ssize_t CommLength = 15;
+
+    bool ReadProcFile(const char* path, char* buffer, size_t size, ssize_t& length)
+    {
+        int file = open(path, O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            return false;
+        }
+        length = read(file, buffer, size);
+        close(file);
+        return length > 0;
+    }
+
+    // The executable file name of a process: its comm, or the file name of argv[0] when the
+    // comm may have been cut. False when the process has gone.
+    bool ReadName(const char* pid, std::wstring& name)
+    {
+        char path[64];
+        char buffer[4096];
+        ssize_t length;
+        snprintf(path, sizeof(path), "/proc/%s/comm", pid);
+        if (!ReadProcFile(path, buffer, sizeof(buffer), length))
+        {
+            return false;
+        }
+        if (buffer[length - 1] == '\n')
+        {
+            --length;
+        }
+
+        const char* start = buffer;
+        if (length >= CommLength)
+        {
+            ssize_t commandLength;
+            snprintf(path, sizeof(path), "/proc/%s/cmdline", pid);
+            if (ReadProcFile(path, buffer, sizeof(buffer) - 1, commandLength))
+            {
+                buffer[commandLength] = '\0';
+                const char* slash = strrchr(buffer, '/');
+                start = slash != nullptr ? slash + 1 : buffer;
+                length = static_cast<ssize_t>(strlen(start));
+            }
+        }
+
+        name.clear();
+        for (ssize_t i = 0; i < length; ++i)
+        {
+            name.push_back(static_cast<wchar_t>(static_cast<unsigned char>(start[i])));
+        }
+        return true;
+    }
+
+    // Subscribes to the kernel's process events. -1 where they can't be had, such as without
+    // CAP_NET_ADMIN on older kernels; starts are then found at the next tick.
+    int OpenProcessConnector()
+    {
+        int connector = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_CONNECTOR);
+        if (connector < 0)
+        {
+            return -1;
+        }
+
+        sockaddr_nl address = {};
+        address.nl_family = AF_NETLINK;
+        address.nl_groups = CN_IDX_PROC;
+
+        alignas(nlmsghdr) char message[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))] = {};
+        nlmsghdr* header = reinterpret_cast<nlmsghdr*>(message);
+        header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+        header->nlmsg_type = NLMSG_DONE;
+        header->nlmsg_pid = static_cast<__u32>(getpid());
+        cn_msg* request = static_cast<cn_msg*>(NLMSG_DATA(header));
+        request->id.idx = CN_IDX_PROC;
+        request->id.val = CN_VAL_PROC;
+        request->len = sizeof(proc_cn_mcast_op);
+        const proc_cn_mcast_op operation = PROC_CN_MCAST_LISTEN;
+        memcpy(request->data, &operation, sizeof(operation));
+
+        if (bind(connector, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            send(connector, message, header->nlmsg_len, 0) < 0)
+        {
+            close(connector);
+            return -1;
+        }
+        return connector;
+    }
+#endif
+}
+
+ProcessWatcher::ProcessWatcher() :
+    m_statistics()
+{
+#if defined(_WIN32)
+    HANDLE interrupt = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_interrupt = interrupt != nullptr ? reinterpret_cast<intptr_t>(interrupt) : NoHandle;
+
+    // Windows only signals process starts through WMI, which is too heavy to keep open here,
+    // so they are found by the snapshot at the next tick.
+    m_starts = NoHandle;
+#else
+    m_interrupt = eventfd(0, EFD_CLOEXEC);
+    m_starts = OpenProcessConnector();
+#endif
+}
+
+ProcessWatcher::~ProcessWatcher()
+{
+    for (Watched& watched : m_watched)
+    {
+        Close(watched);
+    }
+#if defined(_WIN32)
+    if (m_interrupt != NoHandle)
+    {
+        CloseHandle(ToHandle(m_interrupt));
+    }
+#else
+    if (m_interrupt != NoHandle)
+    {
+        close(static_cast<int>(m_interrupt));
+    }
+    if (m_starts != NoHandle)
+    {
+        close(static_cast<int>(m_starts));
+    }
+#endif
+}
+
+size_t ProcessWatcher::Watch(const std::wstring& name)
+{
+    std::wstring key = name;
+    ToLower(key);
+    auto found = m_index.find(key);
+    if (found != m_index.end())
+    {
+        return found->second;
+    }
+
+    Watched watched;
+    watched.name = name;
+    watched.id = 0;
+    watched.handle = NoHandle;
+    watched.exited = false;
+    m_watched.push_back(watched);
+    m_index.emplace(key, m_watched.size() - 1);
+    return m_watched.size() - 1;
+}
+
+bool ProcessWatcher::Refresh()
+{
+    m_found.assign(m_watched.size(), 0);
+    ++m_statistics.snapshots;
+
+#if defined(_WIN32)
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+    for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry))
+    {
+        ++m_statistics.processesScanned;
+        m_key.assign(entry.szExeFile);
+        Find(m_key, entry.th32ProcessID, m_found);
+    }
+    CloseHandle(snapshot);
+#else
+    DIR* processes = opendir("/proc");
+    if (processes == nullptr)
+    {
+        return false;
+    }
+
+    while (dirent* entry = readdir(processes))
+    {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9')
+        {
+            continue;
+        }
+        ++m_statistics.processesScanned;
+        if (ReadName(entry->d_name, m_key))
+        {
+            Find(m_key, static_cast<ProcessId>(strtoul(entry->d_name, nullptr, 10)), m_found);
+        }
+    }
+    closedir(processes);
+#endif
+
+    return Update(m_found);
+}
+
+bool ProcessWatcher::Wait(std::chrono::milliseconds timeout)
+{
+#if defined(_WIN32)
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    Watched* owners[MAXIMUM_WAIT_OBJECTS];
+    DWORD count = 0;
+    handles[count++] = ToHandle(m_interrupt);
+    for (Watched& watched : m_watched)
+    {
+        if (watched.handle != NoHandle && count < MAXIMUM_WAIT_OBJECTS)
+        {
+            owners[count] = &watched;
+            handles[count++] = ToHandle(watched.handle);
+        }
+    }
+
+    DWORD result = WaitForMultipleObjects(count, handles, FALSE, static_cast<DWORD>(timeout.count()));
+    if (result == WAIT_OBJECT_0 || result == WAIT_FAILED)
+    {
+        return false;
+    }
+    if (result == WAIT_TIMEOUT)
+    {
+        ++m_statistics.tickWakeups;
+    }
+    else
+    {
+        ++m_statistics.exitWakeups;
+        owners[result - WAIT_OBJECT_0]->exited = true;
+    }
+    return Refresh();
+#else
+    std::vector<pollfd> handles;
+    std::vector<Watched*> owners;
+    handles.push_back({ static_cast<int>(m_interrupt), POLLIN, 0 });
+    handles.push_back({ static_cast<int>(m_starts), POLLIN, 0 });
+    for (Watched& watched : m_watched)
+    {
+        if (watched.handle != NoHandle)
+        {
+            handles.push_back({ static_cast<int>(watched.handle), POLLIN, 0 });
+            owners.push_back(&watched);
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;)
+    {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        int ready = poll(handles.data(), handles.size(), remaining.count() > 0 ? static_cast<int>(remaining.count()) : 0);
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ready < 0)
+        {
+            return false;
+        }
+        if (handles[0].revents != 0)
+        {
+            uint64_t count;
+            ssize_t taken = read(static_cast<int>(m_interrupt), &count, sizeof(count));
+            (void)taken;
+            return false;
+        }
+        if (ready == 0)
+        {
+            ++m_statistics.tickWakeups;
+            return Refresh();
+        }
+        bool exited = false;
+        for (size_t i = 2; i < handles.size(); ++i)
+        {
+            if (handles[i].revents != 0)
+            {
+                owners[i - 2]->exited = true;
+                exited = true;
+            }
+        }
+        if (exited)
+        {
+            ++m_statistics.exitWakeups;
+            return Refresh();
+        }
+
+        // Every exec on the system arrives here; only those of watched names refresh.
+        bool started = false;
+        alignas(nlmsghdr) char buffer[4096];
+        ssize_t length;
+        while ((length = recv(static_cast<int>(m_starts), buffer, sizeof(buffer), 0)) > 0)
+        {
+            for (nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer); NLMSG_OK(header, static_cast<unsigned int>(length)); header = NLMSG_NEXT(header, length))
+            {
+                // The event follows the 20 byte message header, so it is copied to be aligned.
+                const cn_msg* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+                proc_event event = {};
+                memcpy(&event, message->data, std::min<size_t>(sizeof(event), message->len));
+                if (event.what == proc_event::PROC_EVENT_EXEC && !started)
+                {
+                    started = ExecMatches(static_cast<ProcessId>(event.event_data.exec.process_tgid));
+                }
+            }
+        }
+        if (started)
+        {
+            ++m_statistics.startWakeups;
+            return Refresh();
+        }
+    }
+#endif
+}
+
+void ProcessWatcher::Interrupt()
+{
+#if defined(_WIN32)
+    SetEvent(ToHandle(m_interrupt));
+#else
+    const uint64_t one = 1;
+    ssize_t written = write(static_cast<int>(m_interrupt), &one, sizeof(one));
+    (void)written;
+#endif
+}
+
+bool ProcessWatcher::IsRunning(size_t watch) const
+{
+    return m_watched[watch].id != 0;
+}
+
+bool ProcessWatcher::IsRunning(size_t watch, ProcessId& id) const
+{
+    id = m_watched[watch].id;
+    return id != 0;
+}
+
+void ProcessWatcher::Open(Watched& watched)
+{
+    // A process that has exited but is still listed is signalled already. One that can't be
+    // opened is taken to be running, and found to have exited at a tick.
+#if defined(_WIN32)
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, watched.id);
+    watched.handle = process != nullptr ? reinterpret_cast<intptr_t>(process) : NoHandle;
+    const bool exited = process != nullptr && WaitForSingleObject(process, 0) == WAIT_OBJECT_0;
+#else
+    long process = syscall(SYS_pidfd_open, static_cast<pid_t>(watched.id), 0);
+    watched.handle = process >= 0 ? static_cast<intptr_t>(process) : NoHandle;
+    pollfd handle = { static_cast<int>(process), POLLIN, 0 };
+    const bool exited = process >= 0 && poll(&handle, 1, 0) > 0;
+#endif
+    if (exited)
+    {
+        Close(watched);
+        watched.id = 0;
+    }
+}
+
+void ProcessWatcher::Close(Watched& watched)
+{
+    if (watched.handle != NoHandle)
+    {
+#if defined(_WIN32)
+        CloseHandle(ToHandle(watched.handle));
+#else
+        close(static_cast<int>(watched.handle));
+#endif
+        watched.handle = NoHandle;
+    }
+}
+
+bool ProcessWatcher::Update(const std::vector<ProcessId>& found)
+{
+    bool changed = false;
+    for (size_t i = 0; i < m_watched.size(); ++i)
+    {
+        Watched& watched = m_watched[i];
+        const bool wasRunning = watched.id != 0;
+        if (found[i] != watched.id || watched.exited)
+        {
+            Close(watched);
+            watched.id = found[i];
+            watched.exited = false;
+            if (watched.id != 0)
+            {
+                Open(watched);
+            }
+        }
+        changed = changed || wasRunning != (watched.id != 0);
+    }
+    return changed;
+}
+
+bool ProcessWatcher::ExecMatches(ProcessId id)
+{
+#if defined(_WIN32)
+    (void)id;
+    return false;
+#else
+    char pid[16];
+    snprintf(pid, sizeof(pid), "%u", id);
+    if (!ReadName(pid, m_key))
+    {
+        return false;
+    }
+    // The process already followed, seen again because its exec was queued before the
+    // snapshot that found it, is no start.
+    ToLower(m_key);
+    auto match = m_index.find(m_key);
+    return match != m_index.end() && m_watched[match->second].id != id;
+#endif
+}
+
+void ProcessWatcher::Find(std::wstring& name, ProcessId id, std::vector<ProcessId>& found) const
+{
+    ToLower(name);
+    auto match = m_index.find(name);
+    if (match != m_index.end())
+    {
+        // Keep following the process already watched while it runs. One that has exited can
+        // still be listed until it has been cleaned up.
+        const Watched& watched = m_watched[match->second];
+        ProcessId& current = found[match->second];
+        if (id == watched.id && watched.exited)
+        {
+            return;
+        }
+        if (current == 0 || id == watched.id)
+        {
+            current = id;
+        }
+    }
+}
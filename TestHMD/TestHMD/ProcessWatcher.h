@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Tracks whether processes with the given executable names are running. Every refresh takes
+// one snapshot of the process table and resolves all the watched names in a single pass,
+// through a hash of the lower-case names. Between refreshes Wait blocks until a watched
+// process exits, which the OS signals on every platform, or one starts, where the OS can
+// signal that too (the proc connector on Linux, when the process may use it), and otherwise
+// until the next tick.
+class ProcessWatcher
+{
+public:
+    typedef uint32_t ProcessId;
+
+    struct Statistics
+    {
+        uint64_t    snapshots;
+        uint64_t    processesScanned;
+        uint64_t    exitWakeups;        // Waits ended by a watched process exiting.
+        uint64_t    startWakeups;       // Waits ended by a watched process starting.
+        uint64_t    tickWakeups;        // Waits that timed out.
+    };
+
+    ProcessWatcher();
+    ~ProcessWatcher();
+
+    // Adds a name, such as L"HoloShellApp.exe", compared without case. Returns its index for
+    // IsRunning. Adding a name again returns the same index. Call Refresh afterwards.
+    size_t Watch(const std::wstring& name);
+
+    // Takes a snapshot. Returns whether any watched name started or stopped running.
+    bool Refresh();
+
+    // Refreshes when a watched process exits or starts, or when timeout has passed, whichever
+    // is first. Returns whether anything changed, false when interrupted.
+    bool Wait(std::chrono::milliseconds timeout);
+
+    // Ends a Wait on another thread early, or the next one if none is running, so the watching
+    // thread can be stopped. Everything else is for one thread at a time.
+    void Interrupt();
+
+    // The id is that of one of the processes when several have the name.
+    bool IsRunning(size_t watch) const;
+    bool IsRunning(size_t watch, ProcessId& id) const;
+
+    const Statistics& GetStatistics() const { return m_statistics; }
+
+    ProcessWatcher(const ProcessWatcher&) = delete;
+    ProcessWatcher& operator=(const ProcessWatcher&) = delete;
+
+private:
+    struct Watched
+    {
+        std::wstring    name;
+        ProcessId       id;         // 0 when not running.
+        intptr_t        handle;     // Signalled when the process exits, or -1.
+        bool            exited;     // Signalled, though it may still be in the process table.
+    };
+
+    void Open(Watched& watched);
+    void Close(Watched& watched);
+    bool Update(const std::vector<ProcessId>& found);
+    bool ExecMatches(ProcessId id);
+    void Find(std::wstring& name, ProcessId id, std::vector<ProcessId>& found) const;
+
+    std::vector<Watched>                        m_watched;
+    std::unordered_map<std::wstring, size_t>    m_index;        // Lower-case name to index.
+    std::wstring                                m_key;          // Reused for lookups.
+    std::vector<ProcessId>                      m_found;
+    intptr_t                                    m_interrupt;    // Event signalled by Interrupt.
+    intptr_t                                    m_starts;       // Process start notifications, or -1.
+    Statistics                                  m_statistics;
+};
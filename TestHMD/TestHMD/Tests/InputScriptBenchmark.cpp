@@ -0,0 +1,67 @@
+#include "InputScript.h"
+
+#include "Benchmark.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    // Costs a system call per Send, as SendInput does, and doesn't wait.
+    class SystemCallInjector : public IInputInjector
+    {
+    public:
+        SystemCallInjector() : m_null(open("/dev/null", O_WRONLY | O_CLOEXEC)) {}
+        ~SystemCallInjector() { close(m_null); }
+
+        uint32_t Send(const SyntheticInput* inputs, uint32_t count) override
+        {
+            ssize_t written = write(m_null, inputs, count * sizeof(SyntheticInput));
+            return written < 0 ? 0 : count;
+        }
+
+        void Wait(std::chrono::milliseconds) override {}
+
+    private:
+        int m_null;
+    };
+
+    void AddPortalScript(InputScript& script)
+    {
+        script
+            .Chord({ 0x5B, 'Y' }).Wait(std::chrono::seconds(1))
+            .Chord({ 0x5B, 'Y' }).Wait(std::chrono::seconds(1))
+            .Chord({ 0x5B, 0x26 }).Wait(std::chrono::seconds(1))
+            .Chord({ 0x5B, 0x10, 0x27 }).Wait(std::chrono::seconds(1))
+            .Click(0, 0);
+    }
+}
+
+BENCHMARK(InputScriptPlay)
+{
+    // The MR Portal input, compiled once and played a step per call, against built each time
+    // and sent an input per call as TestHMD used to.
+    SystemCallInjector injector;
+    InputScript script;
+    AddPortalScript(script);
+    const size_t inputs = script.GetInputs().size();
+
+    double compiled = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(script.Play(injector));
+    });
+    double perInput = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        InputScript built;
+        AddPortalScript(built);
+        for (const SyntheticInput& input : built.GetInputs())
+        {
+            TestSupport::DoNotOptimize(injector.Send(&input, 1));
+        }
+    });
+
+    TestSupport::Report("inputs", static_cast<double>(inputs), "");
+    TestSupport::Report("calls, a step per call", static_cast<double>(script.GetSteps().size()), "");
+    TestSupport::Report("compiled, a step per call", compiled, "ns");
+    TestSupport::Report("built each time, an input per call", perInput, "ns");
+}
@@ -0,0 +1,166 @@
+#include "InputScript.h"
+
+#include "Check.h"
+
+#include <vector>
+
+namespace
+{
+    // The virtual keys TestHMD uses.
+    const uint16_t VirtualKeyShift = 0x10;
+    const uint16_t VirtualKeyRight = 0x27;
+    const uint16_t VirtualKeyUp = 0x26;
+    const uint16_t VirtualKeyWindows = 0x5B;
+
+    // Records what is played, with the waits as calls of their own, and can refuse input
+    // after a number of calls.
+    class RecordingInjector : public IInputInjector
+    {
+    public:
+        struct Call
+        {
+            std::vector<SyntheticInput>     inputs;
+            std::chrono::milliseconds       delay;
+        };
+
+        uint32_t Send(const SyntheticInput* inputs, uint32_t count) override
+        {
+            calls.push_back(Call{ std::vector<SyntheticInput>(inputs, inputs + count), std::chrono::milliseconds(0) });
+            return static_cast<int>(calls.size()) > blockAfter ? count / 2 : count;
+        }
+
+        void Wait(std::chrono::milliseconds delay) override
+        {
+            calls.push_back(Call{ std::vector<SyntheticInput>(), delay });
+        }
+
+        std::vector<Call>   calls;
+        int                 blockAfter = 1000;
+    };
+
+    bool IsKey(const SyntheticInput& input, uint16_t key, uint32_t flags)
+    {
+        return input.type == INPUT_KEYBOARD && input.ki.wVk == key && input.ki.dwFlags == flags;
+    }
+
+    bool IsMouse(const SyntheticInput& input, int32_t x, int32_t y, uint32_t flags)
+    {
+        return input.type == INPUT_MOUSE && input.mi.dx == x && input.mi.dy == y && input.mi.dwFlags == flags;
+    }
+}
+
+TEST_CASE(InputScriptChordsPressInOrderAndReleaseInReverse)
+{
+    InputScript script;
+    script.Chord({ VirtualKeyWindows, VirtualKeyShift, VirtualKeyRight });
+
+    const std::vector<SyntheticInput>& inputs = script.GetInputs();
+    CHECK_EQUAL(6u, inputs.size());
+    CHECK(IsKey(inputs[0], VirtualKeyWindows, 0));
+    CHECK(IsKey(inputs[1], VirtualKeyShift, 0));
+    CHECK(IsKey(inputs[2], VirtualKeyRight, KEYEVENTF_EXTENDEDKEY));
+    CHECK(IsKey(inputs[3], VirtualKeyRight, KEYEVENTF_EXTENDEDKEY | KEYEVENTF_KEYUP));
+    CHECK(IsKey(inputs[4], VirtualKeyShift, KEYEVENTF_KEYUP));
+    CHECK(IsKey(inputs[5], VirtualKeyWindows, KEYEVENTF_KEYUP));
+
+    CHECK_EQUAL(1u, script.GetSteps().size());
+    CHECK_EQUAL(0u, script.GetSteps()[0].first);
+    CHECK_EQUAL(6u, script.GetSteps()[0].count);
+    CHECK(script.GetSteps()[0].delay.count() == 0);
+
+    InputScript typed;
+    typed.Type({ 'A', VirtualKeyUp });
+    CHECK_EQUAL(4u, typed.GetInputs().size());
+    CHECK(IsKey(typed.GetInputs()[0], 'A', 0));
+    CHECK(IsKey(typed.GetInputs()[1], 'A', KEYEVENTF_KEYUP));
+    CHECK(IsKey(typed.GetInputs()[2], VirtualKeyUp, KEYEVENTF_EXTENDEDKEY));
+    CHECK(IsKey(typed.GetInputs()[3], VirtualKeyUp, KEYEVENTF_EXTENDEDKEY | KEYEVENTF_KEYUP));
+}
+
+TEST_CASE(InputScriptExtendedKeys)
+{
+    const uint16_t extended[] = { 0x03, 0x11, 0x12, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x2C, 0x2D, 0x2E, 0x6F, 0x90, 0xA3, 0xA4, 0xA5 };
+    int count = 0;
+    for (uint16_t key = 0; key < 300; ++key)
+    {
+        count += IsExtendedKey(key) ? 1 : 0;
+    }
+    CHECK_EQUAL(static_cast<int>(sizeof(extended) / sizeof(extended[0])), count);
+    for (uint16_t key : extended)
+    {
+        CHECK(IsExtendedKey(key));
+    }
+}
+
+TEST_CASE(InputScriptPlaysEachStepWithOneCallAfterItsWait)
+{
+    // The MR Portal script TestHMD plays.
+    InputScript script;
+    script
+        .Chord({ VirtualKeyWindows, 'Y' }).Wait(std::chrono::seconds(1))
+        .Chord({ VirtualKeyWindows, 'Y' }).Wait(std::chrono::seconds(1))
+        .Chord({ VirtualKeyWindows, VirtualKeyUp }).Wait(std::chrono::seconds(1));
+    CHECK_EQUAL(12u, script.GetInputs().size());
+    CHECK_EQUAL(4u, script.GetSteps().size());
+
+    RecordingInjector injector;
+    CHECK(script.Play(injector));
+    CHECK_EQUAL(6u, injector.calls.size());
+    for (size_t i = 0; i < injector.calls.size(); ++i)
+    {
+        const RecordingInjector::Call& call = injector.calls[i];
+        CHECK_EQUAL(i % 2 == 0 ? 4u : 0u, call.inputs.size());
+        CHECK(call.delay == (i % 2 == 0 ? std::chrono::milliseconds(0) : std::chrono::milliseconds(1000)));
+    }
+    CHECK(IsKey(injector.calls[4].inputs[1], VirtualKeyUp, KEYEVENTF_EXTENDEDKEY));
+
+    // Waits with nothing between them add up, and a script may start with one.
+    InputScript waits;
+    waits.Wait(std::chrono::milliseconds(100)).Wait(std::chrono::milliseconds(200)).Type({ 'Q' })
+        .Wait(std::chrono::milliseconds(5)).Wait(std::chrono::milliseconds(5));
+    CHECK_EQUAL(2u, waits.GetSteps().size());
+    CHECK(waits.GetSteps()[0].delay == std::chrono::milliseconds(300));
+    CHECK_EQUAL(2u, waits.GetSteps()[0].count);
+    CHECK(waits.GetSteps()[1].delay == std::chrono::milliseconds(10));
+    CHECK_EQUAL(0u, waits.GetSteps()[1].count);
+}
+
+TEST_CASE(InputScriptMoveStepOnlyMovesTheMouse)
+{
+    InputScript script;
+    script.Wait(std::chrono::seconds(1)).Click(0, 0).Type({ 'A' }).Wait(std::chrono::milliseconds(10)).Click(7, 8);
+    script.MoveStep(0, 1000, 2000);
+
+    const std::vector<SyntheticInput>& inputs = script.GetInputs();
+    CHECK_EQUAL(8u, inputs.size());
+    CHECK(IsMouse(inputs[0], 1000, 2000, MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE));
+    CHECK(IsMouse(inputs[1], 1000, 2000, MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_ABSOLUTE));
+    CHECK(IsMouse(inputs[2], 1000, 2000, MOUSEEVENTF_LEFTUP | MOUSEEVENTF_ABSOLUTE));
+    CHECK(IsKey(inputs[3], 'A', 0));
+    CHECK(IsKey(inputs[4], 'A', KEYEVENTF_KEYUP));
+    CHECK(IsMouse(inputs[5], 7, 8, MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE));
+
+    script.MoveStep(1, -1, -2);
+    CHECK(IsMouse(inputs[7], -1, -2, MOUSEEVENTF_LEFTUP | MOUSEEVENTF_ABSOLUTE));
+    CHECK(IsMouse(inputs[2], 1000, 2000, MOUSEEVENTF_LEFTUP | MOUSEEVENTF_ABSOLUTE));
+}
+
+TEST_CASE(InputScriptPlayStopsWhenInputIsBlocked)
+{
+    InputScript script;
+    script.Chord({ VirtualKeyWindows, 'Y' }).Wait(std::chrono::seconds(1)).Chord({ VirtualKeyWindows, VirtualKeyUp });
+
+    RecordingInjector injector;
+    injector.blockAfter = 0;
+    CHECK(!script.Play(injector));
+    CHECK_EQUAL(1u, injector.calls.size());
+
+    RecordingInjector later;
+    later.blockAfter = 2;
+    CHECK(!script.Play(later));
+    CHECK_EQUAL(3u, later.calls.size());
+
+    InputScript empty;
+    CHECK(empty.Play(later));
+    CHECK_EQUAL(3u, later.calls.size());
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Copies of sleep under names nothing else on the machine runs, started and stopped by the
+// tests.
+class SleeperDirectory
+{
+public:
+    SleeperDirectory()
+    {
+        char directory[] = "/tmp/ProcessWatcherXXXXXX";
+        m_directory = mkdtemp(directory) != nullptr ? directory : "";
+    }
+
+    ~SleeperDirectory()
+    {
+        for (const std::string& path : m_copies)
+        {
+            unlink(path.c_str());
+        }
+        rmdir(m_directory.c_str());
+    }
+
+    // Makes name an executable that sleeps, and returns its path.
+    std::string Add(const std::string& name)
+    {
+        std::string path = m_directory + "/" + name;
+        std::ifstream source("/bin/sleep", std::ios::binary);
+        std::ofstream copy(path, std::ios::binary);
+        copy << source.rdbuf();
+        copy.close();
+        chmod(path.c_str(), 0755);
+        m_copies.push_back(path);
+        return path;
+    }
+
+private:
+    std::string                 m_directory;
+    std::vector<std::string>    m_copies;
+};
+
+// Runs path for seconds, or until Stop.
+class Sleeper
+{
+public:
+    Sleeper(const std::string& path, const char* seconds = "60") : m_id(fork())
+    {
+        if (m_id == 0)
+        {
+            execl(path.c_str(), path.c_str(), seconds, static_cast<char*>(nullptr));
+            _exit(127);
+        }
+    }
+
+    ~Sleeper()
+    {
+        Stop();
+    }
+
+    pid_t GetId() const { return m_id; }
+
+    // Kills the process and, unless reap is false, collects its exit so it leaves the
+    // process table.
+    void Stop(bool reap = true)
+    {
+        if (m_id > 0 && !m_stopped)
+        {
+            kill(m_id, SIGKILL);
+            m_stopped = true;
+        }
+        if (m_id > 0 && reap && !m_reaped)
+        {
+            waitpid(m_id, nullptr, 0);
+            m_reaped = true;
+        }
+    }
+
+private:
+    pid_t   m_id;
+    bool    m_stopped = false;
+    bool    m_reaped = false;
+};
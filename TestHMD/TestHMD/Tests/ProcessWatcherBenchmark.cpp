@@ -0,0 +1,70 @@
+#include "ProcessWatcher.h"
+
+#include "Benchmark.h"
+#include "ProcessTestSupport.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+BENCHMARK(ProcessWatcherRefresh)
+{
+    // One snapshot for all the names, against the one snapshot per name TestHMD used to take.
+    const wchar_t* names[] =
+    {
+        L"MixedRealityPortal.exe", L"HoloShellApp.exe", L"MixedRealityPortalHost.exe", L"HolographicShell.exe",
+        L"SpatialAudio.exe", L"MrApp.exe", L"PerceptionSimulation.exe", L"Hmd.exe",
+    };
+
+    ProcessWatcher all;
+    for (const wchar_t* name : names)
+    {
+        all.Watch(name);
+    }
+    double together = TestSupport::MeasureNanoseconds(1, [&] { all.Refresh(); });
+
+    ProcessWatcher one;
+    one.Watch(names[0]);
+    double single = TestSupport::MeasureNanoseconds(1, [&] { one.Refresh(); });
+
+    const ProcessWatcher::Statistics& statistics = all.GetStatistics();
+    TestSupport::Report("processes in a snapshot", static_cast<double>(statistics.processesScanned) / statistics.snapshots, "");
+    TestSupport::Report("Refresh, 8 names", together / 1000.0, "us");
+    TestSupport::Report("a snapshot per name, 8 names", 8 * single / 1000.0, "us");
+}
+
+BENCHMARK(ProcessWatcherExitLatency)
+{
+    // From killing a watched process to Wait returning, with a 1 s tick.
+    SleeperDirectory directory;
+    std::string path = directory.Add("PwBenchSleeper");
+    ProcessWatcher watcher;
+    size_t watch = watcher.Watch(L"PwBenchSleeper");
+
+    double total = 0.0;
+    const int runs = 20;
+    for (int run = 0; run < runs; ++run)
+    {
+        Sleeper sleeper(path);
+        while (!watcher.IsRunning(watch))
+        {
+            watcher.Refresh();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::chrono::steady_clock::time_point killed;
+        std::thread killer([&sleeper, &killed]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            killed = std::chrono::steady_clock::now();
+            sleeper.Stop(false);
+        });
+        while (watcher.IsRunning(watch))
+        {
+            watcher.Wait(std::chrono::seconds(1));
+        }
+        total += std::chrono::duration<double>(std::chrono::steady_clock::now() - killed).count();
+        killer.join();
+    }
+    TestSupport::Report("exit to Wait returning", total / runs * 1e6, "us");
+}
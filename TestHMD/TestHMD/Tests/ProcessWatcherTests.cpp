@@ -0,0 +1,133 @@
+#include "ProcessWatcher.h"
+
+#include "Check.h"
+#include "ProcessTestSupport.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // A new process shows in /proc once exec has replaced its name, a moment after fork.
+    bool RefreshUntilRunning(ProcessWatcher& watcher, size_t watch)
+    {
+        for (int i = 0; i < 200 && !watcher.IsRunning(watch); ++i)
+        {
+            watcher.Refresh();
+            if (!watcher.IsRunning(watch))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+        return watcher.IsRunning(watch);
+    }
+
+    double SecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+TEST_CASE(ProcessWatcherWatchesNamesWithoutCase)
+{
+    ProcessWatcher watcher;
+    size_t shell = watcher.Watch(L"HoloShellApp.exe");
+    CHECK_EQUAL(shell, watcher.Watch(L"holoshellapp.EXE"));
+    size_t portal = watcher.Watch(L"MixedRealityPortal.exe");
+    CHECK(portal != shell);
+
+    CHECK(!watcher.Refresh());
+    CHECK(!watcher.IsRunning(shell));
+    ProcessWatcher::ProcessId id = 1;
+    CHECK(!watcher.IsRunning(portal, id));
+    CHECK_EQUAL(0u, id);
+    CHECK_EQUAL(1u, static_cast<unsigned int>(watcher.GetStatistics().snapshots));
+    CHECK(watcher.GetStatistics().processesScanned > 0);
+}
+
+TEST_CASE(ProcessWatcherFindsProcessesAndTheirExits)
+{
+    SleeperDirectory directory;
+    std::string path = directory.Add("PwSleeperOne");
+    ProcessWatcher watcher;
+    size_t watch = watcher.Watch(L"pwsleeperone");
+    CHECK(!watcher.Refresh());
+
+    Sleeper sleeper(path);
+    CHECK(RefreshUntilRunning(watcher, watch));
+    ProcessWatcher::ProcessId id;
+    CHECK(watcher.IsRunning(watch, id));
+    CHECK_EQUAL(static_cast<ProcessWatcher::ProcessId>(sleeper.GetId()), id);
+
+    // The exit ends a long wait at once, even before the process has been collected and so
+    // is still in the process table.
+    std::thread killer([&sleeper]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        sleeper.Stop(false);
+    });
+    Clock::time_point start = Clock::now();
+    CHECK(watcher.Wait(std::chrono::seconds(10)));
+    CHECK(SecondsSince(start) < 2.0);
+    killer.join();
+    CHECK(!watcher.IsRunning(watch));
+    CHECK_EQUAL(1u, static_cast<unsigned int>(watcher.GetStatistics().exitWakeups));
+
+    sleeper.Stop();
+    CHECK(!watcher.Refresh());
+}
+
+TEST_CASE(ProcessWatcherFindsLongNamesAndNewStarts)
+{
+    // Longer than the 15 characters the kernel keeps of a name.
+    SleeperDirectory directory;
+    std::string path = directory.Add("PwSleeperWithALongName");
+    ProcessWatcher watcher;
+    size_t watch = watcher.Watch(L"PwSleeperWithALongName");
+    watcher.Refresh();
+
+    // Found by a start notification where the process may have them, else at the tick.
+    Sleeper sleeper(path);
+    Clock::time_point start = Clock::now();
+    bool changed = false;
+    while (!changed && SecondsSince(start) < 5.0)
+    {
+        changed = watcher.Wait(std::chrono::milliseconds(100));
+    }
+    CHECK(changed);
+    CHECK(watcher.IsRunning(watch));
+    const ProcessWatcher::Statistics& statistics = watcher.GetStatistics();
+    CHECK(statistics.startWakeups + statistics.tickWakeups >= 1);
+}
+
+TEST_CASE(ProcessWatcherWaitEndsOnInterrupt)
+{
+    ProcessWatcher watcher;
+    watcher.Watch(L"NotRunning.exe");
+    watcher.Refresh();
+
+    // From another thread during the wait, and before the next one.
+    std::thread interrupter([&watcher]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        watcher.Interrupt();
+    });
+    Clock::time_point start = Clock::now();
+    CHECK(!watcher.Wait(std::chrono::seconds(10)));
+    CHECK(SecondsSince(start) < 2.0);
+    interrupter.join();
+
+    watcher.Interrupt();
+    start = Clock::now();
+    CHECK(!watcher.Wait(std::chrono::seconds(10)));
+    CHECK(SecondsSince(start) < 1.0);
+
+    // A tick refreshes.
+    uint64_t snapshots = watcher.GetStatistics().snapshots;
+    CHECK(!watcher.Wait(std::chrono::milliseconds(20)));
+    CHECK_EQUAL(snapshots + 1, watcher.GetStatistics().snapshots);
+    CHECK(watcher.GetStatistics().tickWakeups >= 1);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// The benchmarks of the portable engines. A BENCHMARK registers itself like a TEST_CASE, and
+// BenchmarkMain.cpp runs every one, or those whose names contain its argument. They aren't
+// run by ctest: build in Release and run the *Benchmark executables by hand.
+namespace TestSupport
+{
+    struct BenchmarkCase
+    {
+        const char*     name;
+        void            (*function)();
+    };
+
+    inline std::vector<BenchmarkCase>& GetBenchmarks()
+    {
+        static std::vector<BenchmarkCase> benchmarks;
+        return benchmarks;
+    }
+
+    struct BenchmarkRegistration
+    {
+        BenchmarkRegistration(const char* name, void (*function)())
+        {
+            GetBenchmarks().push_back({ name, function });
+        }
+    };
+
+    // Keeps the compiler from optimizing away a result that is otherwise unused.
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        volatile const T* sink = &value;
+        (void)sink;
+#endif
+    }
+
+    // Calls body until at least minimumSeconds have passed, five times over, and returns the
+    // fastest time per item, in nanoseconds, of body doing itemsPerCall items per call.
+    template<typename TBody>
+    double MeasureNanoseconds(double itemsPerCall, TBody&& body, double minimumSeconds = 0.1)
+    {
+        typedef std::chrono::steady_clock Clock;
+        double best = 0;
+        for (int round = 0; round < 5; ++round)
+        {
+            long calls = 0;
+            Clock::time_point start = Clock::now();
+            double elapsed;
+            do
+            {
+                body();
+                ++calls;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed < minimumSeconds);
+
+            double perItem = elapsed * 1e9 / (calls * itemsPerCall);
+            if (round == 0 || perItem < best)
+            {
+                best = perItem;
+            }
+        }
+        return best;
+    }
+
+    inline void Report(const char* name, double value, const char* unit)
+    {
+        printf("  %-58s %12.2f %s\n", name, value, unit);
+    }
+}
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static TestSupport::BenchmarkRegistration name##Registration(#name, &name); \
+    static void name()
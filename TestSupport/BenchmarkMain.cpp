@@ -0,0 +1,17 @@
+#include "Benchmark.h"
+
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    for (const TestSupport::BenchmarkCase& benchmark : TestSupport::GetBenchmarks())
+    {
+        if (filter == nullptr || strstr(benchmark.name, filter) != nullptr)
+        {
+            printf("%s\n", benchmark.name);
+            benchmark.function();
+        }
+    }
+    return 0;
+}
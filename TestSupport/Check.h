@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// The unit tests of the portable engines in these samples. A TEST_CASE registers itself, a
+// CHECK that fails is reported and counted without stopping the case, and TestMain.cpp runs
+// every case, or those whose names contain its argument.
+namespace TestSupport
+{
+    struct TestCase
+    {
+        const char*     name;
+        void            (*function)();
+    };
+
+    inline std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    inline int& GetFailureCount()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct Registration
+    {
+        Registration(const char* name, void (*function)())
+        {
+            GetTestCases().push_back({ name, function });
+        }
+    };
+
+    inline void Fail(const char* file, int line, const std::string& message)
+    {
+        fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+        ++GetFailureCount();
+    }
+
+    template<typename T>
+    std::string ToString(const T& value)
+    {
+        std::ostringstream stream;
+        stream << value;
+        return stream.str();
+    }
+
+    template<typename TExpected, typename TActual>
+    void CheckEqual(const TExpected& expected, const TActual& actual, const char* expectedText, const char* actualText, const char* file, int line)
+    {
+        if (!(expected == actual))
+        {
+            Fail(file, line, std::string("CHECK_EQUAL(") + expectedText + ", " + actualText + "): expected " + ToString(expected) + ", got " + ToString(actual));
+        }
+    }
+
+    int RunTests(int argc, char** argv);
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static TestSupport::Registration name##Registration(#name, &name); \
+    static void name()
+
+#define CHECK(expression) \
+    ((expression) ? (void)0 : TestSupport::Fail(__FILE__, __LINE__, "CHECK(" #expression ") failed"))
+
+#define CHECK_EQUAL(expected, actual) \
+    TestSupport::CheckEqual((expected), (actual), #expected, #actual, __FILE__, __LINE__)
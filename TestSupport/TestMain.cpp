@@ -0,0 +1,34 @@
+#include "Check.h"
+
+#include <cstring>
+
+int TestSupport::RunTests(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& testCase : GetTestCases())
+    {
+        if (filter != nullptr && strstr(testCase.name, filter) == nullptr)
+        {
+            continue;
+        }
+
+        int failuresBefore = GetFailureCount();
+        testCase.function();
+        ++run;
+        if (GetFailureCount() != failuresBefore)
+        {
+            ++failed;
+            fprintf(stderr, "FAILED %s\n", testCase.name);
+        }
+    }
+
+    printf("%d of %d test cases passed\n", run - failed, run);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    return TestSupport::RunTests(argc, argv);
+}
@@ -38,6 +38,10 @@ MainPage::MainPage()
     m_transform = ref new BitmapTransform();
     m_bitmap1 = nullptr;
     m_bitmap2 = nullptr;
+    m_inputHandlerInstalled = false;
+    m_navigation = 0;
+    webview1->NavigationStarting += ref new TypedEventHandler<WebView^, WebViewNavigationStartingEventArgs^>(this, &MainPage::OnNavigationStarting);
+    webview1->NavigationCompleted += ref new TypedEventHandler<WebView^, WebViewNavigationCompletedEventArgs^>(this, &MainPage::OnNavigationCompleted);
     TimeSpan span;
     span.Duration = 10000000L / 60L;
     m_dispatcherTimer = ref new DispatcherTimer();
@@ -46,16 +50,52 @@ MainPage::MainPage()
     m_dispatcherTimer->Start();
 }
 
+// Called from the secondary view's thread. The click is queued and sent to the
+// page with the rest of the frame's input by FlushInput on the next timer tick.
 void MainPage::PointerReleased(int x, int y)
 {
-    CoreApplication::MainView->Dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([this, x, y]()
+    m_inputBatch.Click(x, y);
+}
+
+void MainPage::OnNavigationStarting(WebView^ sender, WebViewNavigationStartingEventArgs^ args)
+{
+    ++m_navigation;
+    m_inputHandlerInstalled = false;
+    m_inputBatch.Clear();
+}
+
+void MainPage::OnNavigationCompleted(WebView^ sender, WebViewNavigationCompletedEventArgs^ args)
+{
+    if (!args->IsSuccess)
     {
-        auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
-        std::wstringstream w;
-        w << L"document.elementFromPoint(" << x << "," << y << L").click()";
-        scripts->Append(ref new Platform::String(w.str().c_str()));
-        webview1->InvokeScriptAsync(ref new Platform::String(L"eval"), scripts);
-    }));
+        return;
+    }
+
+    // Install the input handler once per page instead of eval'ing a script per event. The
+    // script finishes later, so ignore it if another navigation has started since: that page
+    // doesn't have the handler.
+    uint32_t navigation = m_navigation;
+    auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
+    scripts->Append(Platform::StringReference(DX::WebViewInputBatch::HandlerScript()));
+    create_task(webview1->InvokeScriptAsync(ref new Platform::String(L"eval"), scripts)).then([this, navigation](Platform::String^)
+    {
+        if (navigation == m_navigation)
+        {
+            m_inputHandlerInstalled = true;
+        }
+    });
+}
+
+void MainPage::FlushInput()
+{
+    if (!m_inputHandlerInstalled || !m_inputBatch.Flush(m_inputArgument))
+    {
+        return;
+    }
+
+    auto scripts = ref new Platform::Collections::Vector<Platform::String^>();
+    scripts->Append(ref new Platform::String(m_inputArgument.c_str(), (unsigned int)m_inputArgument.size()));
+    webview1->InvokeScriptAsync(Platform::StringReference(DX::WebViewInputBatch::HandlerFunction()), scripts);
 }
 
 
@@ -100,7 +140,9 @@ void MainPage::TimerTick(Platform::Object^ sender, Platform::Object^ e)
     //scripts->Append(ref new Platform::String(L"document.elementFromPoint(105,95).click()"));
 
     //webview1->InvokeScriptAsync(ref new Platform::String(L"eval"), scripts);
-    
+
+    FlushInput();
+
     m_timer.Tick([&]()
     {
         Update();
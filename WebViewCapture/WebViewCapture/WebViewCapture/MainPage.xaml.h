@@ -7,6 +7,7 @@
 
 #include "MainPage.g.h"
 #include "StepTimer.h"
+#include "..\..\..\DXCommon\Core\WebViewInputBatch.h"
 #include <mutex>
 #include <algorithm>
 
@@ -27,6 +28,9 @@ namespace WebViewCapture
         void TimerTick(Platform::Object^ sender, Platform::Object^ e);
         Concurrency::task<void> DisplayScaledBitmap(unsigned int width, unsigned int height);
         void viewButton_Click(Platform::Object^ sender, Windows::UI::Xaml::RoutedEventArgs^ e);
+        void OnNavigationStarting(Windows::UI::Xaml::Controls::WebView^ sender, Windows::UI::Xaml::Controls::WebViewNavigationStartingEventArgs^ args);
+        void OnNavigationCompleted(Windows::UI::Xaml::Controls::WebView^ sender, Windows::UI::Xaml::Controls::WebViewNavigationCompletedEventArgs^ args);
+        void FlushInput();
 
         Windows::UI::Xaml::DispatcherTimer^ m_dispatcherTimer;
         DX::StepTimer m_timer;
@@ -35,5 +39,9 @@ namespace WebViewCapture
         Windows::UI::Xaml::Media::Imaging::WriteableBitmap^ m_bitmap2;
         Platform::Agile<Windows::ApplicationModel::Core::CoreApplicationView> m_secondaryView;
         std::mutex m_mutex;
+        DX::WebViewInputBatch m_inputBatch;
+        std::wstring m_inputArgument;
+        bool m_inputHandlerInstalled;
+        uint32_t m_navigation;      // Counts navigations, so a handler installed on an earlier page is ignored.
     };
 }
@@ -86,12 +86,15 @@ namespace CS_Client
             sb.Append("Primes found (unordered): ");
             PrimesUnOrderedResult.Text = sb.ToString();
 
-            // primeFoundEvent is a user-defined event in nativeObject
-            // It passes the results back to this thread as they are produced
+            // primesFoundEvent is a user-defined event in nativeObject
+            // It passes the results back to this thread in batches as they are produced
             // and the event handler that we define here immediately displays them.
-            nativeObject.primeFoundEvent += (n) =>
+            nativeObject.primesFoundEvent += (primes) =>
             {
-                sb.Append(n.ToString()).Append(" ");
+                foreach (var n in primes)
+                {
+                    sb.Append(n.ToString()).Append(" ");
+                }
                 PrimesUnOrderedResult.Text = sb.ToString();
             };
 
@@ -102,7 +102,7 @@ function ButtonOrdered_Click() {
 
 function ButtonUnordered_Click() {
     document.getElementById('unorderedPrimes').innerHTML = "Primes found (unordered): ";
-    nativeObject.onprimefoundevent = handler_unordered;
+    nativeObject.onprimesfoundevent = handler_unordered;
 
     nativeObject.getPrimesUnordered(2, 10000).then(
         function () { },
@@ -115,8 +115,9 @@ function ButtonUnordered_Click() {
         });
 }
 
-var handler_unordered = function (n) {
-    document.getElementById('unorderedPrimes').innerHTML += n.target.toString() + " ";
+// Each event carries a batch of primes, which is added to the page in one go.
+var handler_unordered = function (e) {
+    document.getElementById('unorderedPrimes').innerHTML += e.target.join(" ") + " ";
 };
 
 function ButtonClear_Click() {
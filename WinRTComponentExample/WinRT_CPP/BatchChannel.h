@@ -0,0 +1,348 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WinRT_CPP
+{
+    // Carries results from worker threads to a slower consumer, such as the UI thread, in
+    // batches. Each producer fills a buffer of its own, and a full buffer becomes a batch. A
+    // collector thread publishes the batches, and also a partly filled buffer once its first
+    // item is maxDelay old, so no result waits much longer than that. A published batch stays
+    // in flight until the consumer acknowledges it. With maxInFlight batches in flight the
+    // collector stops publishing and batches queue up, and with maxQueued queued, Push waits:
+    // a consumer that falls behind slows the producers down instead of having work pile up
+    // for it.
+    //
+    // Standard C++ only, so it can be built and measured on any platform.
+    template <typename T>
+    class BatchChannel
+    {
+    public:
+        typedef std::function<void()> Acknowledge;
+
+        // Called on the collector thread, one batch at a time, and must not throw. It may take
+        // the batch's contents. The batch is in flight until acknowledge has been called, once,
+        // from any thread; acknowledge can outlive the channel.
+        typedef std::function<void(std::vector<T>& batch, Acknowledge acknowledge)> PublishCallback;
+
+        struct Statistics
+        {
+            uint64_t    batches;
+            uint64_t    items;
+            uint64_t    producerWaits;  // Batches a producer had to wait to queue.
+
+            // From the first item of a batch being pushed to the batch being published.
+            double      meanLatency;    // Seconds.
+            double      maxLatency;     // Seconds.
+        };
+
+        BatchChannel(
+            unsigned int producerCount,
+            size_t batchSize,
+            std::chrono::milliseconds maxDelay,
+            size_t maxInFlight,
+            size_t maxQueued,
+            PublishCallback publish);
+
+        // Closes the channel.
+        ~BatchChannel();
+
+        // Appends values to producer's buffer; any thread may push to any producer, but threads
+        // sharing one contend for it. May wait while the consumer catches up. Returns false,
+        // dropping what it couldn't queue, once the channel has been cancelled.
+        bool Push(unsigned int producer, const T* values, size_t count);
+
+        // Publishes everything pushed so far, including the last batches regardless of how many
+        // are in flight, and stops the collector. Nothing may be pushed afterwards.
+        void Close();
+
+        // Drops the queued batches and makes Push return false from now on.
+        void Cancel();
+
+        Statistics GetStatistics() const;
+
+        BatchChannel(const BatchChannel&) = delete;
+        BatchChannel& operator=(const BatchChannel&) = delete;
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Batch
+        {
+            std::vector<T>      items;
+            Clock::time_point   started;
+        };
+
+        // Padded so that producers don't share a cache line.
+        struct Producer
+        {
+            std::mutex          mutex;
+            std::vector<T>      items;
+            Clock::time_point   started;
+            char                padding[64];
+        };
+
+        // What acknowledgements need, which may come after the channel is gone.
+        struct Shared
+        {
+            std::mutex              mutex;
+            std::condition_variable ready;
+            size_t                  inFlight;
+        };
+
+        bool Enqueue(Batch batch);
+        Clock::time_point FlushProducers(bool all);
+        void Collect();
+
+        const size_t                    m_batchSize;
+        const std::chrono::milliseconds m_maxDelay;
+        const size_t                    m_maxInFlight;
+        const size_t                    m_maxQueued;
+        const PublishCallback           m_publish;
+        const unsigned int              m_producerCount;
+        std::unique_ptr<Producer[]>     m_producers;
+
+        // The queue and the state below are guarded by m_shared->mutex.
+        std::shared_ptr<Shared>         m_shared;
+        std::condition_variable         m_space;
+        std::deque<Batch>               m_queue;
+        bool                            m_closing;
+        bool                            m_cancelled;
+        Statistics                      m_statistics;
+        double                          m_totalLatency;
+
+        std::thread                     m_collector;
+    };
+
+    template <typename T>
+    BatchChannel<T>::BatchChannel(
+        unsigned int producerCount,
+        size_t batchSize,
+        std::chrono::milliseconds maxDelay,
+        size_t maxInFlight,
+        size_t maxQueued,
+        PublishCallback publish) :
+        m_batchSize(std::max<size_t>(1, batchSize)),
+        m_maxDelay(maxDelay),
+        m_maxInFlight(std::max<size_t>(1, maxInFlight)),
+        m_maxQueued(std::max<size_t>(1, maxQueued)),
+        m_publish(std::move(publish)),
+        m_producerCount(std::max(1u, producerCount)),
+        m_producers(new Producer[std::max(1u, producerCount)]),
+        m_shared(std::make_shared<Shared>()),
+        m_closing(false),
+        m_cancelled(false),
+        m_statistics(),
+        m_totalLatency(0.0)
+    {
+        m_shared->inFlight = 0;
+        m_collector = std::thread([this] { Collect(); });
+    }
+
+    template <typename T>
+    BatchChannel<T>::~BatchChannel()
+    {
+        Close();
+    }
+
+    template <typename T>
+    bool BatchChannel<T>::Push(unsigned int producer, const T* values, size_t count)
+    {
+        Producer& buffer = m_producers[producer % m_producerCount];
+        std::unique_lock<std::mutex> lock(buffer.mutex);
+        while (count > 0)
+        {
+            if (buffer.items.empty())
+            {
+                buffer.items.reserve(m_batchSize);
+                buffer.started = Clock::now();
+            }
+
+            size_t take = std::min(count, m_batchSize - buffer.items.size());
+            buffer.items.insert(buffer.items.end(), values, values + take);
+            values += take;
+            count -= take;
+
+            if (buffer.items.size() == m_batchSize)
+            {
+                Batch batch;
+                batch.items.swap(buffer.items);
+                batch.started = buffer.started;
+
+                // Not under the buffer's lock, so the collector can still flush it meanwhile.
+                lock.unlock();
+                if (!Enqueue(std::move(batch)))
+                {
+                    return false;
+                }
+                lock.lock();
+            }
+        }
+
+        std::lock_guard<std::mutex> sharedLock(m_shared->mutex);
+        return !m_cancelled;
+    }
+
+    template <typename T>
+    void BatchChannel<T>::Close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            m_closing = true;
+        }
+        m_shared->ready.notify_all();
+
+        if (m_collector.joinable())
+        {
+            m_collector.join();
+        }
+    }
+
+    template <typename T>
+    void BatchChannel<T>::Cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            m_cancelled = true;
+            m_queue.clear();
+        }
+        m_shared->ready.notify_all();
+        m_space.notify_all();
+    }
+
+    template <typename T>
+    typename BatchChannel<T>::Statistics BatchChannel<T>::GetStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        Statistics statistics = m_statistics;
+        statistics.meanLatency = m_statistics.batches > 0 ? m_totalLatency / m_statistics.batches : 0.0;
+        return statistics;
+    }
+
+    template <typename T>
+    bool BatchChannel<T>::Enqueue(Batch batch)
+    {
+        std::unique_lock<std::mutex> lock(m_shared->mutex);
+        if (m_queue.size() >= m_maxQueued && !m_cancelled)
+        {
+            ++m_statistics.producerWaits;
+            m_space.wait(lock, [this] { return m_queue.size() < m_maxQueued || m_cancelled; });
+        }
+        if (m_cancelled)
+        {
+            return false;
+        }
+
+        m_queue.push_back(std::move(batch));
+        m_shared->ready.notify_all();
+        return true;
+    }
+
+    // Queues the partly filled buffers whose first item is maxDelay old, or all of them, and
+    // returns when the next of the others will be. Doesn't wait for space: it runs on the
+    // collector, which is what makes space, and adds at most one batch per producer.
+    template <typename T>
+    typename BatchChannel<T>::Clock::time_point BatchChannel<T>::FlushProducers(bool all)
+    {
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = now + m_maxDelay;
+        for (unsigned int i = 0; i < m_producerCount; ++i)
+        {
+            Batch batch;
+            {
+                std::lock_guard<std::mutex> lock(m_producers[i].mutex);
+                if (m_producers[i].items.empty())
+                {
+                    continue;
+                }
+                if (!all && m_producers[i].started + m_maxDelay > now)
+                {
+                    next = std::min(next, m_producers[i].started + m_maxDelay);
+                    continue;
+                }
+                batch.items.swap(m_producers[i].items);
+                batch.started = m_producers[i].started;
+            }
+
+            std::lock_guard<std::mutex> lock(m_shared->mutex);
+            if (!m_cancelled)
+            {
+                m_queue.push_back(std::move(batch));
+            }
+        }
+        return next;
+    }
+
+    template <typename T>
+    void BatchChannel<T>::Collect()
+    {
+        std::shared_ptr<Shared> shared = m_shared;
+        Acknowledge acknowledge = [shared]
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            --shared->inFlight;
+            shared->ready.notify_all();
+        };
+
+        Clock::time_point flushTime = Clock::now() + m_maxDelay;
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        for (;;)
+        {
+            shared->ready.wait_until(lock, flushTime, [this, &shared]
+            {
+                return m_cancelled || m_closing || (!m_queue.empty() && shared->inFlight < m_maxInFlight);
+            });
+            if (m_cancelled)
+            {
+                return;
+            }
+
+            if (!m_queue.empty() && (shared->inFlight < m_maxInFlight || m_closing))
+            {
+                Batch batch = std::move(m_queue.front());
+                m_queue.pop_front();
+                ++shared->inFlight;
+
+                double latency = std::chrono::duration<double>(Clock::now() - batch.started).count();
+                ++m_statistics.batches;
+                m_statistics.items += batch.items.size();
+                m_statistics.maxLatency = std::max(m_statistics.maxLatency, latency);
+                m_totalLatency += latency;
+
+                lock.unlock();
+                m_space.notify_all();
+                m_publish(batch.items, acknowledge);
+                lock.lock();
+                continue;
+            }
+
+            // While batches are backed up, flushing would only queue more.
+            if (m_closing || (Clock::now() >= flushTime && m_queue.size() < m_maxQueued))
+            {
+                bool all = m_closing;
+                lock.unlock();
+                flushTime = FlushProducers(all);
+                lock.lock();
+
+                if (all && m_queue.empty())
+                {
+                    return;
+                }
+            }
+            else if (Clock::now() >= flushTime)
+            {
+                flushTime = Clock::now() + m_maxDelay;
+            }
+        }
+    }
+}
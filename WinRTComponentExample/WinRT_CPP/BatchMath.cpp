@@ -0,0 +1,389 @@
+﻿#include "BatchMath.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BATCH_MATH_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC compiles AVX2 intrinsics without /arch:AVX2. They only run once the CPU has been checked.
+#define BATCH_MATH_AVX2
+#else
+#define BATCH_MATH_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#else
+#define BATCH_MATH_X86 0
+#endif
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    // Values per chunk when a batch is split across workers, and the smallest batch that is.
+    const size_t ParallelChunkSize = 16384;
+    const size_t MinParallelCount = 2 * ParallelChunkSize;
+
+    void EvaluateScalar(BatchMathFunction function, const double* values, const double* exponents, double* results, size_t count)
+    {
+        switch (function)
+        {
+        case BatchMathFunction::Log:
+            std::transform(values, values + count, results, [](double x) { return std::log(x); });
+            break;
+        case BatchMathFunction::Log10:
+            std::transform(values, values + count, results, [](double x) { return std::log10(x); });
+            break;
+        case BatchMathFunction::Exp:
+            std::transform(values, values + count, results, [](double x) { return std::exp(x); });
+            break;
+        case BatchMathFunction::Sqrt:
+            std::transform(values, values + count, results, [](double x) { return std::sqrt(x); });
+            break;
+        case BatchMathFunction::Pow:
+            std::transform(values, values + count, exponents, results, [](double x, double y) { return std::pow(x, y); });
+            break;
+        }
+    }
+
+#if BATCH_MATH_X86
+    // exp(x) = 2^k exp(r) with k = round(x / ln 2) and |r| <= ln 2 / 2, ln 2 split in two so
+    // that r is exact. exp(r) is its Taylor series to r^13 / 13!, which leaves out less than
+    // a twentieth of an ulp.
+    const double Log2E = 1.44269504088896338700e+00;
+    const double Ln2Hi = 6.93147180369123816490e-01;
+    const double Ln2Lo = 1.90821492927058770002e-10;
+    const double ExpCoefficients[] =
+    {
+        1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+        1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+    };
+
+    // Within this, 2^k and the result are normal numbers.
+    const double ExpVectorLimit = 708.0;
+
+    // Added to a small integral double, leaves the integer in the low bits of its mantissa.
+    const double IntegerMagic = 6755399441055744.0;     // 1.5 * 2^52
+
+    // log(x) = k ln 2 + log(1 + f) with x = 2^k (1 + f) and sqrt(2) / 2 <= 1 + f < sqrt(2), and
+    // log(1 + f) = f - hfsq + s (hfsq + R(s^2)) with s = f / (2 + f) and hfsq = f^2 / 2, as in
+    // fdlibm's e_log.c, whose minimax coefficients for R these are.
+    const double Lg1 = 6.666666666666735130e-01;
+    const double Lg2 = 3.999999999940941908e-01;
+    const double Lg3 = 2.857142874366239149e-01;
+    const double Lg4 = 2.222219843214978396e-01;
+    const double Lg5 = 1.818357216161805012e-01;
+    const double Lg6 = 1.531383769920937332e-01;
+    const double Lg7 = 1.479819860511658591e-01;
+    const double Sqrt2 = 1.41421356237309504880e+00;
+    const double InvLn10 = 4.34294481903251816668e-01;
+    const double Log10Of2Hi = 3.01029995663611771306e-01;
+    const double Log10Of2Lo = 3.69423907715893078616e-13;
+
+    BATCH_MATH_AVX2 __m256d ExpAvx2(__m256d x, __m256d xLow)
+    {
+        __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(Log2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        __m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(Ln2Hi), x);
+        r = _mm256_add_pd(_mm256_fnmadd_pd(k, _mm256_set1_pd(Ln2Lo), r), xLow);
+
+        __m256d p = _mm256_set1_pd(ExpCoefficients[0]);
+        for (size_t i = 1; i < sizeof(ExpCoefficients) / sizeof(ExpCoefficients[0]); ++i)
+        {
+            p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(ExpCoefficients[i]));
+        }
+
+        // 2^k, built from k + 1023 in the exponent bits.
+        __m256i biased = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(IntegerMagic + 1023.0)));
+        return _mm256_mul_pd(p, _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52)));
+    }
+
+    // Splits normal positive x into k and f, and returns log(1 + f) = f - (hfsq - tail).
+    BATCH_MATH_AVX2 __m256d LogParts(__m256d x, __m256d& k, __m256d& f, __m256d& tail)
+    {
+        const __m256d one = _mm256_set1_pd(1.0);
+        __m256i bits = _mm256_castpd_si256(x);
+
+        // The exponent field as a double, through the mantissa of 2^52.
+        __m256i exponent = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0)));
+        k = _mm256_sub_pd(_mm256_castsi256_pd(exponent), _mm256_set1_pd(4503599627370496.0 + 1023.0));
+
+        __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)),
+            _mm256_castpd_si256(one)));
+        __m256d high = _mm256_cmp_pd(m, _mm256_set1_pd(Sqrt2), _CMP_GT_OQ);
+        m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), high);
+        k = _mm256_add_pd(k, _mm256_and_pd(high, one));
+
+        f = _mm256_sub_pd(m, one);
+        __m256d hfsq = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), f), f);
+        __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+        __m256d z = _mm256_mul_pd(s, s);
+        __m256d w = _mm256_mul_pd(z, z);
+
+        // R = Lg1 z + Lg2 z^2 + ... + Lg7 z^7, in halves of odd and even powers of z.
+        __m256d odd = _mm256_fmadd_pd(w, _mm256_set1_pd(Lg7), _mm256_set1_pd(Lg5));
+        odd = _mm256_fmadd_pd(w, odd, _mm256_set1_pd(Lg3));
+        odd = _mm256_mul_pd(z, _mm256_fmadd_pd(w, odd, _mm256_set1_pd(Lg1)));
+        __m256d even = _mm256_fmadd_pd(w, _mm256_set1_pd(Lg6), _mm256_set1_pd(Lg4));
+        even = _mm256_mul_pd(w, _mm256_fmadd_pd(w, even, _mm256_set1_pd(Lg2)));
+        tail = _mm256_mul_pd(s, _mm256_add_pd(hfsq, _mm256_add_pd(odd, even)));
+
+        return _mm256_sub_pd(f, _mm256_sub_pd(hfsq, tail));
+    }
+
+    // Lanes of x that are normal, positive and finite.
+    BATCH_MATH_AVX2 __m256d IsNormalPositive(__m256d x)
+    {
+        return _mm256_and_pd(
+            _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MIN), _CMP_GE_OQ),
+            _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ));
+    }
+
+    // Lanes of x with |x| <= limit.
+    BATCH_MATH_AVX2 __m256d IsWithin(__m256d x, double limit)
+    {
+        return _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), _mm256_set1_pd(limit), _CMP_LE_OQ);
+    }
+
+    BATCH_MATH_AVX2 __m256d LogAvx2(__m256d x, __m256d& valid)
+    {
+        __m256d k, f, tail;
+        __m256d log1pf = LogParts(x, k, f, tail);
+        valid = IsNormalPositive(x);
+        return _mm256_fmadd_pd(k, _mm256_set1_pd(Ln2Hi), _mm256_fmadd_pd(k, _mm256_set1_pd(Ln2Lo), log1pf));
+    }
+
+    BATCH_MATH_AVX2 __m256d Log10Avx2(__m256d x, __m256d& valid)
+    {
+        __m256d k, f, tail;
+        __m256d log1pf = LogParts(x, k, f, tail);
+        valid = IsNormalPositive(x);
+        __m256d low = _mm256_fmadd_pd(k, _mm256_set1_pd(Log10Of2Lo), _mm256_mul_pd(log1pf, _mm256_set1_pd(InvLn10)));
+        return _mm256_fmadd_pd(k, _mm256_set1_pd(Log10Of2Hi), low);
+    }
+
+    BATCH_MATH_AVX2 __m256d ExpLanesAvx2(__m256d x, __m256d& valid)
+    {
+        valid = IsWithin(x, ExpVectorLimit);
+        return ExpAvx2(x, _mm256_setzero_pd());
+    }
+
+    BATCH_MATH_AVX2 __m256d SqrtAvx2(__m256d x, __m256d& valid)
+    {
+        valid = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        return _mm256_sqrt_pd(x);
+    }
+
+    // log(x) as high + low, accurate to about 2^-100 relative, for Pow: a product
+    // y log(x) of up to ExpVectorLimit would otherwise carry the log's rounding error into
+    // the result hundreds of times over.
+    BATCH_MATH_AVX2 __m256d LogDoubleDouble(__m256d x, __m256d& low)
+    {
+        __m256d k, f, tail;
+        LogParts(x, k, f, tail);
+
+        // f^2 / 2 exactly, as hfsqHigh + hfsqLow.
+        __m256d square = _mm256_mul_pd(f, f);
+        __m256d hfsqHigh = _mm256_mul_pd(square, _mm256_set1_pd(0.5));
+        __m256d hfsqLow = _mm256_mul_pd(_mm256_fmsub_pd(f, f, square), _mm256_set1_pd(0.5));
+
+        // f - hfsqHigh with its rounding error; |f| > |hfsqHigh|, so a fast two-sum.
+        __m256d difference = _mm256_sub_pd(f, hfsqHigh);
+        __m256d differenceError = _mm256_sub_pd(_mm256_sub_pd(f, difference), hfsqHigh);
+
+        // k ln2Hi is exact. Adding the difference to it, with a full two-sum since either can
+        // be the larger.
+        __m256d kLn2 = _mm256_mul_pd(k, _mm256_set1_pd(Ln2Hi));
+        __m256d high = _mm256_add_pd(kLn2, difference);
+        __m256d addend = _mm256_sub_pd(high, kLn2);
+        __m256d sumError = _mm256_add_pd(_mm256_sub_pd(kLn2, _mm256_sub_pd(high, addend)), _mm256_sub_pd(difference, addend));
+
+        low = _mm256_add_pd(
+            _mm256_add_pd(sumError, _mm256_sub_pd(differenceError, hfsqLow)),
+            _mm256_fmadd_pd(k, _mm256_set1_pd(Ln2Lo), tail));
+
+        // Renormalized, so that low is within half an ulp of high. Exp's reduced argument
+        // would otherwise leave the range its polynomial is accurate in.
+        __m256d sum = _mm256_add_pd(high, low);
+        low = _mm256_sub_pd(low, _mm256_sub_pd(sum, high));
+        return sum;
+    }
+
+    BATCH_MATH_AVX2 __m256d PowAvx2(__m256d x, __m256d y, __m256d& valid)
+    {
+        __m256d logLow;
+        __m256d log = LogDoubleDouble(x, logLow);
+        valid = IsNormalPositive(x);
+
+        // y log(x) as a sum of two doubles, so that the product isn't rounded either.
+        __m256d product = _mm256_mul_pd(y, log);
+        __m256d productLow = _mm256_fmadd_pd(y, logLow, _mm256_fmsub_pd(y, log, product));
+        valid = _mm256_and_pd(valid, IsWithin(product, ExpVectorLimit));
+        return ExpAvx2(product, productLow);
+    }
+
+    // Runs Lanes four values at a time. Lanes it marks invalid, and the values the last group
+    // is padded with, go to the scalar functions.
+    template <__m256d Lanes(__m256d, __m256d&)>
+    BATCH_MATH_AVX2 void RunAvx2(BatchMathFunction function, const double* values, double* results, size_t count)
+    {
+        for (size_t i = 0; i < count; i += 4)
+        {
+            if (count - i < 4)
+            {
+                EvaluateScalar(function, values + i, nullptr, results + i, count - i);
+                break;
+            }
+
+            // The invalid lanes are patched before the store, which may overwrite values.
+            __m256d valid;
+            __m256d result = Lanes(_mm256_loadu_pd(values + i), valid);
+            int validMask = _mm256_movemask_pd(valid);
+            if (validMask != 0xF)
+            {
+                alignas(32) double lanes[4];
+                _mm256_store_pd(lanes, result);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if ((validMask & (1 << lane)) == 0)
+                    {
+                        EvaluateScalar(function, values + i + lane, nullptr, lanes + lane, 1);
+                    }
+                }
+                result = _mm256_load_pd(lanes);
+            }
+            _mm256_storeu_pd(results + i, result);
+        }
+    }
+
+    BATCH_MATH_AVX2 void RunPowAvx2(const double* values, const double* exponents, double* results, size_t count)
+    {
+        for (size_t i = 0; i < count; i += 4)
+        {
+            if (count - i < 4)
+            {
+                EvaluateScalar(BatchMathFunction::Pow, values + i, exponents + i, results + i, count - i);
+                break;
+            }
+
+            __m256d valid;
+            __m256d result = PowAvx2(_mm256_loadu_pd(values + i), _mm256_loadu_pd(exponents + i), valid);
+            int validMask = _mm256_movemask_pd(valid);
+            if (validMask != 0xF)
+            {
+                alignas(32) double lanes[4];
+                _mm256_store_pd(lanes, result);
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    if ((validMask & (1 << lane)) == 0)
+                    {
+                        EvaluateScalar(BatchMathFunction::Pow, values + i + lane, exponents + i + lane, lanes + lane, 1);
+                    }
+                }
+                result = _mm256_load_pd(lanes);
+            }
+            _mm256_storeu_pd(results + i, result);
+        }
+    }
+
+    BATCH_MATH_AVX2 void EvaluateAvx2(BatchMathFunction function, const double* values, const double* exponents, double* results, size_t count)
+    {
+        switch (function)
+        {
+        case BatchMathFunction::Log:
+            RunAvx2<LogAvx2>(function, values, results, count);
+            break;
+        case BatchMathFunction::Log10:
+            RunAvx2<Log10Avx2>(function, values, results, count);
+            break;
+        case BatchMathFunction::Exp:
+            RunAvx2<ExpLanesAvx2>(function, values, results, count);
+            break;
+        case BatchMathFunction::Sqrt:
+            RunAvx2<SqrtAvx2>(function, values, results, count);
+            break;
+        case BatchMathFunction::Pow:
+            RunPowAvx2(values, exponents, results, count);
+            break;
+        }
+
+        // Back to SSE code without the penalty for dirty upper halves.
+        _mm256_zeroupper();
+    }
+#endif
+}
+
+BatchMathKernels WinRT_CPP::GetBestBatchMathKernels()
+{
+#if BATCH_MATH_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return BatchMathKernels::Scalar;
+    }
+
+    // FMA, OSXSAVE and AVX, and the OS saving the YMM registers.
+    __cpuid(info, 1);
+    const int fmaXsaveAvx = (1 << 12) | (1 << 27) | (1 << 28);
+    if ((info[2] & fmaXsaveAvx) != fmaXsaveAvx || (_xgetbv(0) & 6) != 6)
+    {
+        return BatchMathKernels::Scalar;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0 ? BatchMathKernels::Avx2 : BatchMathKernels::Scalar;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? BatchMathKernels::Avx2 : BatchMathKernels::Scalar;
+#endif
+#else
+    return BatchMathKernels::Scalar;
+#endif
+}
+
+void WinRT_CPP::EvaluateBatch(
+    BatchMathFunction function,
+    const double* values,
+    const double* exponents,
+    double* results,
+    size_t count,
+    BatchMathKernels kernels)
+{
+#if BATCH_MATH_X86
+    if (kernels == BatchMathKernels::Avx2)
+    {
+        EvaluateAvx2(function, values, exponents, results, count);
+        return;
+    }
+#endif
+    EvaluateScalar(function, values, exponents, results, count);
+}
+
+void WinRT_CPP::EvaluateBatch(
+    ComputePool& pool,
+    BatchMathFunction function,
+    const double* values,
+    const double* exponents,
+    double* results,
+    size_t count)
+{
+    static const BatchMathKernels kernels = GetBestBatchMathKernels();
+    if (count < MinParallelCount || pool.GetWorkerCount() == 1)
+    {
+        EvaluateBatch(function, values, exponents, results, count, kernels);
+        return;
+    }
+
+    pool.ParallelFor(0, static_cast<int64_t>(count), ParallelChunkSize,
+        [=](unsigned int, int64_t begin, int64_t end)
+    {
+        const double* chunkExponents = exponents != nullptr ? exponents + begin : nullptr;
+        EvaluateBatch(function, values + begin, chunkExponents, results + begin, static_cast<size_t>(end - begin), kernels);
+    },
+        std::chrono::milliseconds(100),
+        nullptr);
+}
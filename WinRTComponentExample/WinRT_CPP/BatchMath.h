@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <cstddef>
+
+#include "ComputePool.h"
+
+namespace WinRT_CPP
+{
+    enum class BatchMathFunction
+    {
+        Log,
+        Log10,
+        Exp,
+        Sqrt,
+        Pow,        // values raised to exponents.
+    };
+
+    enum class BatchMathKernels
+    {
+        Scalar,     // The C runtime's functions, one value at a time.
+        Avx2,       // Four values at a time with AVX2 and FMA.
+    };
+
+    // The fastest kernels the CPU and OS support.
+    BatchMathKernels GetBestBatchMathKernels();
+
+    // results[i] = function(values[i]), or pow(values[i], exponents[i]) for Pow; exponents
+    // is only read for Pow. results may be values.
+    //
+    // The AVX2 kernels are polynomial approximations. Exp and Log are within 1.2 ulp of the
+    // exact result, Log10 within 2 and Sqrt is correctly rounded. Pow is exp(exponent *
+    // log(value)) with the log and the product carried in two doubles: within 2 ulp while
+    // that product is below about 20, with the error growing to about 2e-14 relative for the
+    // largest results. Values the polynomials don't cover, such as zero, negative,
+    // subnormal, infinite and NaN values and results that would overflow or underflow, go
+    // to the C runtime's functions.
+    void EvaluateBatch(
+        BatchMathFunction function,
+        const double* values,
+        const double* exponents,
+        double* results,
+        size_t count,
+        BatchMathKernels kernels);
+
+    // The same with the best kernels, split into chunks across the pool's workers when count
+    // is large enough to be worth it.
+    void EvaluateBatch(
+        ComputePool& pool,
+        BatchMathFunction function,
+        const double* values,
+        const double* exponents,
+        double* results,
+        size_t count);
+}
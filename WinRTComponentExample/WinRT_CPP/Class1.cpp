@@ -1,8 +1,13 @@
 ﻿#include "pch.h"
 #include "Class1.h"
 
+#include "BatchChannel.h"
+#include "BatchMath.h"
+#include "ComputePool.h"
+#include "PrimeSieve.h"
+
+#include <algorithm>
 #include <ppltasks.h>
-#include <concurrent_vector.h>
 
 using namespace WinRT_CPP;
 using namespace Platform;
@@ -12,6 +17,36 @@ using namespace Windows::Foundation::Collections;
 using namespace Windows::Foundation;
 using namespace Windows::UI::Core;
 
+namespace
+{
+    // How often the prime searches report progress.
+    const std::chrono::milliseconds ProgressInterval(50);
+
+    // GetPrimesUnordered passes primes to the UI thread in batches of up to PrimeBatchSize, at
+    // least every PrimeBatchDelay. Once MaxPrimeBatchesInFlight have been dispatched and not
+    // yet handled, batches queue up, and once MaxPrimeBatchesQueued are waiting the workers
+    // pause until the UI thread catches up.
+    const size_t PrimeBatchSize = 4096;
+    const std::chrono::milliseconds PrimeBatchDelay(16);
+    const size_t MaxPrimeBatchesInFlight = 4;
+    const size_t MaxPrimeBatchesQueued = 16;
+
+    // The prime searches run for as long as their range takes and can be held up by the UI
+    // thread, so the synchronous math, which usually runs on the UI thread, has workers of its
+    // own rather than waiting for a search to finish with the pool.
+    ComputePool& GetSearchPool()
+    {
+        static ComputePool pool;
+        return pool;
+    }
+
+    ComputePool& GetMathPool()
+    {
+        static ComputePool pool;
+        return pool;
+    }
+}
+
 Class1::Class1()
 {
 
@@ -21,45 +56,60 @@ Class1::Class1()
 IVector<double>^ Class1::ComputeResult(double input)
 {
     // Implement your function in ISO C++ or
-    // call into your C++ lib or DLL here. This example uses AMP.
-    float numbers[] = { 1.0, 10.0, 60.0, 100.0, 600.0, 10000.0 };
-    array_view<float, 1> logs(6, numbers);
-
-    // See http://msdn.microsoft.com/en-us/library/hh305254.aspx
-    parallel_for_each(
-        logs.extent,
-        [=](index<1> idx) restrict(amp)
-    {
-        logs[idx] = concurrency::fast_math::log10(logs[idx]);
-    }
-    );
+    // call into your C++ lib or DLL here. This example uses
+    // the component's batch math.
+    double numbers[] = { 1.0, 10.0, 60.0, 100.0, 600.0, 10000.0 };
+    const size_t count = sizeof(numbers) / sizeof(numbers[0]);
+
+    std::vector<double> logs(count);
+    EvaluateBatch(GetMathPool(), BatchMathFunction::Log10, numbers, nullptr, logs.data(), count);
+
+    // Return a Windows Runtime-compatible type across the ABI.
+    // The Vector takes the results in one piece and is
+    // implicitly cast to IVector<double>.
+    return ref new Vector<double>(std::move(logs));
+}
 
-    // Return a Windows Runtime-compatible type across the ABI
-    auto res = ref new Vector<double>();
-    int len = safe_cast<int>(logs.extent.size());
-    for (int i = 0; i < len; i++)
+Array<double>^ Class1::Evaluate(MathFunction function, const Array<double>^ values)
+{
+    BatchMathFunction batchFunction;
+    switch (function)
     {
-        res->Append(logs[i]);
+    case MathFunction::Log:
+        batchFunction = BatchMathFunction::Log;
+        break;
+    case MathFunction::Log10:
+        batchFunction = BatchMathFunction::Log10;
+        break;
+    case MathFunction::Exp:
+        batchFunction = BatchMathFunction::Exp;
+        break;
+    case MathFunction::Sqrt:
+        batchFunction = BatchMathFunction::Sqrt;
+        break;
+    default:
+        throw ref new InvalidArgumentException();
     }
 
-    // res is implicitly cast to IVector<double>
-    return res;
+    // The results are written straight into the array that is returned.
+    auto results = ref new Array<double>(values->Length);
+    EvaluateBatch(GetMathPool(), batchFunction, values->Data, nullptr, results->Data, values->Length);
+    return results;
 }
 
-// Determines whether the input value is prime.
-bool Class1::is_prime(int n)
+Array<double>^ Class1::Pow(const Array<double>^ values, const Array<double>^ exponents)
 {
-    if (n < 2)
-        return false;
-    for (int i = 2; i < n; ++i)
+    if (values->Length != exponents->Length)
     {
-        if ((n % i) == 0)
-            return false;
+        throw ref new InvalidArgumentException();
     }
-    return true;
+
+    auto results = ref new Array<double>(values->Length);
+    EvaluateBatch(GetMathPool(), BatchMathFunction::Pow, values->Data, exponents->Data, results->Data, values->Length);
+    return results;
 }
 
-// This method computes all primes, orders them, then returns the ordered results.
+// This method computes all primes in order, then returns the ordered results.
 IAsyncOperationWithProgress<IVector<int>^, double>^ Class1::GetPrimesOrdered(int first, int last)
 {
     return create_async([this, first, last]
@@ -68,49 +118,39 @@ IAsyncOperationWithProgress<IVector<int>^, double>^ Class1::GetPrimesOrdered(int
         if (first < 0 || last < 0) {
             throw ref new InvalidArgumentException();
         }
-        // Perform the computation in parallel.
-        concurrent_vector<int> primes;
-        long operation = 0;
-        long range = last - first + 1;
-        double lastPercent = 0.0;
-
-        parallel_for(first, last + 1, [this, &primes, &operation,
-            range, &lastPercent, reporter](int n) {
-
-            // Increment and store the number of times the parallel
-            // loop has been called on all threads combined. There
-            // is a performance cost to maintaining a count, and
-            // passing the delegate back to the UI thread, but it's
-            // necessary if we want to display a determinate progress
-            // bar that goes from 0 to 100%. We can avoid the cost by
-            // setting the ProgressBar IsDeterminate property to false
-            // or by using a ProgressRing.
-            if (InterlockedIncrement(&operation) % 100 == 0)
-            {
-                reporter.report(100.0 * operation / range);
-            }
 
-            // If the value is prime, add it to the local vector.
-            if (is_prime(n)) {
-                primes.push_back(n);
+        // Sieve the range in parallel. The primes arrive in order, so they are only appended.
+        std::vector<int> primes;
+        bool completed = SievePrimes(GetSearchPool(), first, last,
+            [&primes](const uint64_t* block, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                primes.push_back(static_cast<int>(block[i]));
             }
+            return !is_task_cancellation_requested();
+        },
+            ProgressInterval,
+            [&reporter](double done)
+        {
+            reporter.report(100.0 * done);
+            return !is_task_cancellation_requested();
         });
 
-        // Sort the results.
-        std::sort(begin(primes), end(primes), std::less<int>());
+        if (!completed) {
+            cancel_current_task();
+        }
         reporter.report(100.0);
 
-        // Copy the results to a Vector object, which is
+        // Move the results to a Vector object, which is
         // implicitly converted to the IVector return type. IVector
         // makes collections of data available to other
         // Windows Runtime components.
-        return ref new Vector<int>(primes.begin(), primes.end());
+        return ref new Vector<int>(std::move(primes));
     });
 }
 
-// This method returns no value. Instead, it fires an event each time a
-// prime is found, and passes the prime through the event.
-// It also passes progress info.
+// This method returns no value. Instead, it fires events with batches of
+// the primes as they are found. It also passes progress info.
 IAsyncActionWithProgress<double>^ Class1::GetPrimesUnordered(int first, int last)
 {
 
@@ -125,41 +165,70 @@ IAsyncActionWithProgress<double>^ Class1::GetPrimesUnordered(int first, int last
             throw ref new InvalidArgumentException();
         }
 
-        // In this particular example, we don't actually use this to store
-        // results since we pass results one at a time directly back to
-        // UI as they are found. However, we have to provide this variable
-        // as a parameter to parallel_for.
-        concurrent_vector<int> primes;
-        long operation = 0;
-        long range = last - first + 1;
-        double lastPercent = 0.0;
-
-        // Perform the computation in parallel.
-        parallel_for(first, last + 1,
-            [this, &primes, &operation, range, &lastPercent, reporter](int n)
+        ComputePool& pool = GetSearchPool();
+
+        // Since the primes are found on worker threads, we have to use a CoreDispatcher
+        // object to fire the events on the UI thread. One dispatch carries a whole batch.
+        // The workers wait in Push while the UI thread is behind, which is why nothing the
+        // UI thread waits for runs on this pool.
+        BatchChannel<int> channel(pool.GetWorkerCount(), PrimeBatchSize, PrimeBatchDelay, MaxPrimeBatchesInFlight, MaxPrimeBatchesQueued,
+            [this](std::vector<int>& batch, BatchChannel<int>::Acknowledge acknowledge)
         {
-            // Store the number of times the parallel loop has been called  
-            // on all threads combined. See comment in previous method.
-            if (InterlockedIncrement(&operation) % 100 == 0)
+            auto primes = ref new Array<int>(batch.data(), static_cast<unsigned int>(batch.size()));
+            m_dispatcher->RunAsync(CoreDispatcherPriority::Normal,
+                ref new DispatchedHandler([this, primes, acknowledge]()
             {
-                reporter.report(100.0 * operation / range);
-            }
+                try
+                {
+                    this->primesFoundEvent(primes);
+                }
+                catch (...)
+                {
+                    acknowledge();
+                    throw;
+                }
+                acknowledge();
+
+            }, Platform::CallbackContext::Any));
+        });
 
-            // If the value is prime, pass it immediately to the UI thread.
-            if (is_prime(n))
+        // Each worker pushes the primes of the chunks it sieves to a buffer of its own.
+        bool completed = SievePrimesUnordered(pool, first, last,
+            [&channel](unsigned int worker, const uint64_t* block, size_t count)
+        {
+            int primes[1024];
+            for (size_t i = 0; i < count; i += 1024)
             {
-                // Since this code is probably running on a worker
-                // thread, and we are passing the data back to the
-                // UI thread, we have to use a CoreDispatcher object.
-                m_dispatcher->RunAsync(CoreDispatcherPriority::Normal,
-                    ref new DispatchedHandler([this, n, operation, range]()
+                size_t length = std::min<size_t>(1024, count - i);
+                for (size_t j = 0; j < length; ++j)
                 {
-                    this->primeFoundEvent(n);
-
-                }, Platform::CallbackContext::Any));
+                    primes[j] = static_cast<int>(block[i + j]);
+                }
+                if (!channel.Push(worker, primes, length))
+                {
+                    return false;
+                }
+            }
+            return true;
+        },
+            ProgressInterval,
+            [&reporter, &channel](double done)
+        {
+            reporter.report(100.0 * done);
 
+            // Also releases workers waiting for the UI thread.
+            if (is_task_cancellation_requested()) {
+                channel.Cancel();
+                return false;
             }
+            return true;
         });
+
+        if (!completed) {
+            channel.Cancel();
+            cancel_current_task();
+        }
+        channel.Close();
         reporter.report(100.0);
     });
 }
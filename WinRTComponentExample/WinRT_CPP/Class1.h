@@ -2,12 +2,19 @@
 
 #include <collection.h>
 #include <ppl.h>
-#include <amp.h>
-#include <amp_math.h>
 
 namespace WinRT_CPP
 {
-    public delegate void PrimeFoundHandler(int result);
+    public delegate void PrimesFoundHandler(const Platform::Array<int>^ results);
+
+    // Functions Class1::Evaluate applies to each value of an array.
+    public enum class MathFunction
+    {
+        Log,
+        Log10,
+        Exp,
+        Sqrt
+    };
     
     public ref class Class1 sealed
     {
@@ -17,16 +24,22 @@ namespace WinRT_CPP
         // Synchronous method.
         Windows::Foundation::Collections::IVector<double>^  ComputeResult(double input);
 
+        // Synchronous batch math. Large arrays are split across threads that the prime
+        // searches don't use, so a running search doesn't hold up the caller, and four values
+        // at a time are evaluated with SIMD where the CPU supports it.
+        Platform::Array<double>^ Evaluate(MathFunction function, const Platform::Array<double>^ values);
+        Platform::Array<double>^ Pow(const Platform::Array<double>^ values, const Platform::Array<double>^ exponents);
+
         // Asynchronous methods
         Windows::Foundation::IAsyncOperationWithProgress<Windows::Foundation::Collections::IVector<int>^, double>^
             GetPrimesOrdered(int first, int last);
         Windows::Foundation::IAsyncActionWithProgress<double>^ GetPrimesUnordered(int first, int last);
 
-        // Event whose type is a delegate "class"
-        event PrimeFoundHandler^ primeFoundEvent;
+        // Event whose type is a delegate "class". Fired on the UI thread by GetPrimesUnordered
+        // with each batch of primes.
+        event PrimesFoundHandler^ primesFoundEvent;
 
     private:
-        bool is_prime(int n);
         Windows::UI::Core::CoreDispatcher^ m_dispatcher;
     };
 }
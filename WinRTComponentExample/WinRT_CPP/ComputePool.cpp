@@ -0,0 +1,243 @@
+﻿#include "ComputePool.h"
+
+#include <algorithm>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    uint64_t PackChunks(uint64_t next, uint64_t end)
+    {
+        return (next << 32) | end;
+    }
+
+    uint32_t NextChunk(uint64_t chunks)
+    {
+        return static_cast<uint32_t>(chunks >> 32);
+    }
+
+    uint32_t EndChunk(uint64_t chunks)
+    {
+        return static_cast<uint32_t>(chunks);
+    }
+
+    // Chunk indices have to fit the 32-bit halves of WorkerState::chunks.
+    const int64_t MaxChunkCount = 0x7FFFFFFF;
+}
+
+ComputePool::ComputePool(unsigned int threadCount) :
+    m_generation(0),
+    m_running(0),
+    m_stopping(false),
+    m_body(nullptr),
+    m_first(0),
+    m_last(0),
+    m_chunkSize(1),
+    m_cancelled(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reset(new WorkerState[threadCount]);
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        m_workers[i].chunks.store(0, std::memory_order_relaxed);
+        m_workers[i].completed.store(0, std::memory_order_relaxed);
+    }
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        m_threads.emplace_back([this, i] { Run(i); });
+    }
+}
+
+ComputePool::~ComputePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+bool ComputePool::ParallelFor(
+    int64_t first,
+    int64_t last,
+    int64_t chunkSize,
+    const ChunkBody& body,
+    std::chrono::milliseconds progressInterval,
+    const ProgressCallback& progress)
+{
+    if (last <= first)
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> loopLock(m_loopMutex);
+
+    const int64_t count = last - first;
+    chunkSize = std::max(chunkSize, std::max<int64_t>(1, (count + MaxChunkCount - 1) / MaxChunkCount));
+    const uint64_t chunkCount = static_cast<uint64_t>((count + chunkSize - 1) / chunkSize);
+
+    // Equal shares to start with; stealing evens out chunks that take longer than others.
+    const unsigned int workerCount = GetWorkerCount();
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_workers[i].chunks.store(PackChunks(chunkCount * i / workerCount, chunkCount * (i + 1) / workerCount), std::memory_order_relaxed);
+        m_workers[i].completed.store(0, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_first = first;
+        m_last = last;
+        m_chunkSize = chunkSize;
+        m_cancelled.store(false, std::memory_order_relaxed);
+        m_error = nullptr;
+        m_running = workerCount;
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_done.wait_for(lock, progressInterval, [this] { return m_running == 0; }))
+    {
+        lock.unlock();
+
+        int64_t completed = 0;
+        for (unsigned int i = 0; i < workerCount; ++i)
+        {
+            completed += m_workers[i].completed.load(std::memory_order_relaxed);
+        }
+        if (progress && !progress(completed))
+        {
+            m_cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        lock.lock();
+    }
+
+    m_body = nullptr;
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    lock.unlock();
+
+    if (error != nullptr)
+    {
+        std::rethrow_exception(error);
+    }
+    return !m_cancelled.load(std::memory_order_relaxed);
+}
+
+void ComputePool::Run(unsigned int worker)
+{
+    uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [this, generation] { return m_stopping || m_generation != generation; });
+            if (m_stopping)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        RunLoop(worker);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_running == 0)
+        {
+            m_done.notify_all();
+        }
+    }
+}
+
+void ComputePool::RunLoop(unsigned int worker)
+{
+    uint32_t chunk;
+    while (!m_cancelled.load(std::memory_order_relaxed) && (TakeChunk(worker, chunk) || StealChunk(worker, chunk)))
+    {
+        int64_t begin = m_first + static_cast<int64_t>(chunk) * m_chunkSize;
+        int64_t end = std::min(begin + m_chunkSize, m_last);
+        try
+        {
+            (*m_body)(worker, begin, end);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_error == nullptr)
+            {
+                m_error = std::current_exception();
+            }
+            m_cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        // Only this worker writes its counter, so this is a plain store to a line it owns.
+        WorkerState& state = m_workers[worker];
+        state.completed.store(state.completed.load(std::memory_order_relaxed) + (end - begin), std::memory_order_relaxed);
+    }
+}
+
+bool ComputePool::TakeChunk(unsigned int worker, uint32_t& chunk)
+{
+    std::atomic<uint64_t>& chunks = m_workers[worker].chunks;
+    uint64_t current = chunks.load(std::memory_order_acquire);
+    while (NextChunk(current) < EndChunk(current))
+    {
+        if (chunks.compare_exchange_weak(current, PackChunks(NextChunk(current) + 1, EndChunk(current)), std::memory_order_acq_rel))
+        {
+            chunk = NextChunk(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Takes the back half of the chunks of the worker with the most left, runs the first of them
+// and keeps the rest as its own. A chunk taken this way is never put back, so a packed range
+// never repeats and a CAS can't succeed against a stale one.
+bool ComputePool::StealChunk(unsigned int worker, uint32_t& chunk)
+{
+    const unsigned int workerCount = GetWorkerCount();
+    for (;;)
+    {
+        unsigned int victim = worker;
+        uint64_t victimChunks = 0;
+        uint32_t mostLeft = 0;
+        for (unsigned int i = 1; i < workerCount; ++i)
+        {
+            unsigned int candidate = (worker + i) % workerCount;
+            uint64_t chunks = m_workers[candidate].chunks.load(std::memory_order_acquire);
+            uint32_t left = EndChunk(chunks) > NextChunk(chunks) ? EndChunk(chunks) - NextChunk(chunks) : 0;
+            if (left > mostLeft)
+            {
+                victim = candidate;
+                victimChunks = chunks;
+                mostLeft = left;
+            }
+        }
+        if (mostLeft == 0)
+        {
+            return false;
+        }
+
+        uint32_t stolen = (mostLeft + 1) / 2;
+        uint32_t end = EndChunk(victimChunks);
+        if (m_workers[victim].chunks.compare_exchange_strong(victimChunks, PackChunks(NextChunk(victimChunks), end - stolen), std::memory_order_acq_rel))
+        {
+            chunk = end - stolen;
+            m_workers[worker].chunks.store(PackChunks(end - stolen + 1, end), std::memory_order_release);
+            return true;
+        }
+    }
+}
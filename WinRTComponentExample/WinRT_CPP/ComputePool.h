@@ -0,0 +1,90 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WinRT_CPP
+{
+    // Worker threads for the component's parallel loops. A loop's index range is cut into
+    // chunks and each worker starts with an equal share of them; a worker that runs out steals
+    // half of the chunks another worker has left. The loop body is called once per chunk, with
+    // the index of the worker running it, so it can collect results in a buffer of its own and
+    // nothing is shared between workers per element.
+    //
+    // Standard C++ only, so it can be built and measured on any platform.
+    class ComputePool
+    {
+    public:
+        typedef std::function<void(unsigned int worker, int64_t begin, int64_t end)> ChunkBody;
+
+        // Called by the thread running the loop with the number of indices finished so far.
+        // Returning false cancels the loop.
+        typedef std::function<bool(int64_t completed)> ProgressCallback;
+
+        // threadCount 0 means one per hardware thread.
+        explicit ComputePool(unsigned int threadCount = 0);
+        ~ComputePool();
+
+        unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+        // Runs body over [first, last) in chunks of at most chunkSize indices and waits for it.
+        // While waiting, calls progress every progressInterval; the workers only count finished
+        // chunks in counters of their own. Returns false if progress cancelled the loop, in
+        // which case chunks not yet started are skipped. An exception thrown by body cancels
+        // the loop too and is rethrown here. One loop runs at a time; other callers wait.
+        bool ParallelFor(
+            int64_t first,
+            int64_t last,
+            int64_t chunkSize,
+            const ChunkBody& body,
+            std::chrono::milliseconds progressInterval,
+            const ProgressCallback& progress);
+
+        ComputePool(const ComputePool&) = delete;
+        ComputePool& operator=(const ComputePool&) = delete;
+
+    private:
+        // Chunks a worker has left, [next, end) packed into one word so that the owner taking
+        // from the front and thieves taking from the back agree through a single CAS. Padded
+        // so that workers don't share cache lines.
+        struct WorkerState
+        {
+            std::atomic<uint64_t>   chunks;
+            std::atomic<int64_t>    completed;
+            char                    padding[128 - sizeof(std::atomic<uint64_t>) - sizeof(std::atomic<int64_t>)];
+        };
+
+        void Run(unsigned int worker);
+        void RunLoop(unsigned int worker);
+        bool TakeChunk(unsigned int worker, uint32_t& chunk);
+        bool StealChunk(unsigned int worker, uint32_t& chunk);
+
+        std::vector<std::thread>        m_threads;
+        std::unique_ptr<WorkerState[]>  m_workers;
+
+        // Serializes ParallelFor calls.
+        std::mutex                      m_loopMutex;
+
+        // The current loop, published to the workers under m_mutex.
+        std::mutex                      m_mutex;
+        std::condition_variable         m_start;
+        std::condition_variable         m_done;
+        uint64_t                        m_generation;
+        unsigned int                    m_running;
+        bool                            m_stopping;
+        const ChunkBody*                m_body;
+        int64_t                         m_first;
+        int64_t                         m_last;
+        int64_t                         m_chunkSize;
+        std::atomic<bool>               m_cancelled;
+        std::exception_ptr              m_error;
+    };
+}
@@ -0,0 +1,340 @@
+﻿#include "PrimeSieve.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    // The residues mod 30 of the numbers that aren't multiples of 2, 3 or 5, one bit each.
+    const uint32_t Residues[8] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+    // The bit of each residue mod 30, or -1 if it isn't in Residues.
+    const int ResidueBits[30] =
+    {
+        -1,  0, -1, -1, -1, -1, -1,  1, -1, -1,
+        -1,  2, -1,  3, -1, -1, -1,  4, -1,  5,
+        -1, -1, -1,  6, -1, -1, -1, -1, -1,  7
+    };
+
+    // 32 KB, which is 983,040 numbers: a segment stays in L1 while it is sieved.
+    const uint64_t SegmentBytes = 32 * 1024;
+
+    // Where to cross off each base prime is worked out once per chunk, with divisions, and
+    // carried from segment to segment within it.
+    const uint64_t MaxChunkSegments = 8;
+
+    // Enough chunks in a window for stealing to even out the workers before they wait for
+    // each other at the end of it.
+    const uint64_t WindowChunksPerWorker = 4;
+
+    unsigned int LowestBit(uint32_t bits)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return static_cast<unsigned int>(index);
+#else
+        return static_cast<unsigned int>(__builtin_ctz(bits));
+#endif
+    }
+
+    uint64_t SquareRoot(uint64_t n)
+    {
+        uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+        while (root * root > n)
+        {
+            --root;
+        }
+        while ((root + 1) * (root + 1) <= n)
+        {
+            ++root;
+        }
+        return root;
+    }
+
+    // The primes from 7 to limit, which are the ones the wheel doesn't already leave out.
+    std::vector<uint32_t> SieveBasePrimes(uint64_t limit)
+    {
+        std::vector<uint32_t> primes;
+        std::vector<bool> composite(static_cast<size_t>(limit / 2 + 1), false);
+        for (uint64_t n = 3; n <= limit; n += 2)
+        {
+            if (composite[static_cast<size_t>(n / 2)])
+            {
+                continue;
+            }
+            if (n >= 7)
+            {
+                primes.push_back(static_cast<uint32_t>(n));
+            }
+            for (uint64_t multiple = n * n; multiple <= limit; multiple += 2 * n)
+            {
+                composite[static_cast<size_t>(multiple / 2)] = true;
+            }
+        }
+        return primes;
+    }
+
+    // A worker's segment and, for each base prime and residue, the next byte to cross off
+    // counted from the start of the current segment. Reused from chunk to chunk.
+    struct WorkerSieve
+    {
+        std::vector<uint8_t>    segment;
+        std::vector<uint32_t>   next;
+    };
+
+    class Sieve
+    {
+    public:
+        Sieve(uint64_t first, uint64_t last, unsigned int workerCount) :
+            m_first(first),
+            m_last(last),
+            m_startByte(first / 30),
+            m_endByte(last / 30 + 1),
+            m_basePrimes(SieveBasePrimes(SquareRoot(last))),
+            m_workers(workerCount)
+        {
+            uint64_t segmentCount = (m_endByte - m_startByte + SegmentBytes - 1) / SegmentBytes;
+            uint64_t chunkSegments = std::min(MaxChunkSegments, std::max<uint64_t>(1, segmentCount / (workerCount * WindowChunksPerWorker)));
+            m_chunkBytes = chunkSegments * SegmentBytes;
+            m_chunkCount = (m_endByte - m_startByte + m_chunkBytes - 1) / m_chunkBytes;
+
+            for (auto& worker : m_workers)
+            {
+                worker.segment.resize(static_cast<size_t>(SegmentBytes));
+                worker.next.resize(m_basePrimes.size() * 8);
+            }
+        }
+
+        uint64_t GetChunkCount() const { return m_chunkCount; }
+
+        // Appends the primes of chunk to primes.
+        void SieveChunk(unsigned int worker, uint64_t chunk, std::vector<uint64_t>& primes)
+        {
+            WorkerSieve& state = m_workers[worker];
+            const uint64_t chunkStart = m_startByte + chunk * m_chunkBytes;
+            const uint64_t chunkEnd = std::min(chunkStart + m_chunkBytes, m_endByte);
+
+            // Primes whose square is past the chunk cross off nothing in it.
+            const size_t primeCount = static_cast<size_t>(std::upper_bound(m_basePrimes.begin(), m_basePrimes.end(), chunkEnd * 30,
+                [](uint64_t limit, uint32_t prime) { return limit <= uint64_t(prime) * prime; }) - m_basePrimes.begin());
+
+            // The multiples of p crossed off by residue bit j are p * q with q = 30k + Residues[j]
+            // and q >= p, all in the same bit of every pth byte.
+            for (size_t i = 0; i < primeCount; ++i)
+            {
+                const uint64_t p = m_basePrimes[i];
+                for (int j = 0; j < 8; ++j)
+                {
+                    const uint64_t offset = p * Residues[j] / 30;
+                    uint64_t k = p > Residues[j] ? (p - Residues[j] + 29) / 30 : 0;
+                    if (chunkStart > offset)
+                    {
+                        k = std::max(k, (chunkStart - offset + p - 1) / p);
+                    }
+                    state.next[i * 8 + j] = static_cast<uint32_t>(p * k + offset - chunkStart);
+                }
+            }
+
+            for (uint64_t segmentStart = chunkStart; segmentStart < chunkEnd; segmentStart += SegmentBytes)
+            {
+                const uint32_t segmentBytes = static_cast<uint32_t>(std::min(SegmentBytes, chunkEnd - segmentStart));
+                uint8_t* segment = state.segment.data();
+                std::fill(segment, segment + segmentBytes, uint8_t(0xFF));
+
+                for (size_t i = 0; i < primeCount; ++i)
+                {
+                    const uint32_t p = m_basePrimes[i];
+                    for (int j = 0; j < 8; ++j)
+                    {
+                        const uint8_t mask = static_cast<uint8_t>(~(1u << ResidueBits[p * Residues[j] % 30]));
+                        uint32_t byte = state.next[i * 8 + j];
+                        for (; byte < segmentBytes; byte += p)
+                        {
+                            segment[byte] &= mask;
+                        }
+                        state.next[i * 8 + j] = byte - segmentBytes;
+                    }
+                }
+
+                ClearOutsideRange(segment[0], segmentStart);
+                ClearOutsideRange(segment[segmentBytes - 1], segmentStart + segmentBytes - 1);
+
+                for (uint32_t byte = 0; byte < segmentBytes; ++byte)
+                {
+                    const uint64_t base = (segmentStart + byte) * 30;
+                    for (uint32_t bits = segment[byte]; bits != 0; bits &= bits - 1)
+                    {
+                        primes.push_back(base + Residues[LowestBit(bits)]);
+                    }
+                }
+            }
+        }
+
+    private:
+        // Clears 1, which the wheel leaves in, and the numbers outside [first, last] that share
+        // a byte with the ends of the range.
+        void ClearOutsideRange(uint8_t& bits, uint64_t byte) const
+        {
+            for (int j = 0; j < 8; ++j)
+            {
+                const uint64_t n = byte * 30 + Residues[j];
+                if (n == 1 || n < m_first || n > m_last)
+                {
+                    bits &= static_cast<uint8_t>(~(1u << j));
+                }
+            }
+        }
+
+        uint64_t                    m_first;
+        uint64_t                    m_last;
+        uint64_t                    m_startByte;
+        uint64_t                    m_endByte;
+        uint64_t                    m_chunkBytes;
+        uint64_t                    m_chunkCount;
+        std::vector<uint32_t>       m_basePrimes;
+        std::vector<WorkerSieve>    m_workers;
+    };
+
+    // The wheel leaves out 2, 3 and 5.
+    bool PassSmallPrimes(uint64_t first, uint64_t last, const PrimeBlockCallback& primes)
+    {
+        std::vector<uint64_t> smallPrimes;
+        for (uint64_t prime : { 2, 3, 5 })
+        {
+            if (prime >= first && prime <= last)
+            {
+                smallPrimes.push_back(prime);
+            }
+        }
+        return smallPrimes.empty() || primes(smallPrimes.data(), smallPrimes.size());
+    }
+}
+
+bool WinRT_CPP::SievePrimes(
+    ComputePool& pool,
+    uint64_t first,
+    uint64_t last,
+    const PrimeBlockCallback& primes,
+    std::chrono::milliseconds progressInterval,
+    const SieveProgressCallback& progress)
+{
+    if (last > MaxSieveLast)
+    {
+        throw std::invalid_argument("SievePrimes: last is too large.");
+    }
+    if (first > last)
+    {
+        return true;
+    }
+    if (!PassSmallPrimes(first, last, primes))
+    {
+        return false;
+    }
+
+    Sieve sieve(first, last, pool.GetWorkerCount());
+    const uint64_t chunkCount = sieve.GetChunkCount();
+    const uint64_t windowChunks = pool.GetWorkerCount() * WindowChunksPerWorker;
+    std::vector<std::vector<uint64_t>> blocks(static_cast<size_t>(windowChunks));
+
+    auto lastProgress = std::chrono::steady_clock::now();
+    auto reportProgress = [&](uint64_t chunksDone)
+    {
+        lastProgress = std::chrono::steady_clock::now();
+        return !progress || progress(static_cast<double>(chunksDone) / chunkCount);
+    };
+
+    for (uint64_t window = 0; window < chunkCount; window += windowChunks)
+    {
+        const uint64_t count = std::min(windowChunks, chunkCount - window);
+        bool completed = pool.ParallelFor(0, static_cast<int64_t>(count), 1,
+            [&sieve, &blocks, window](unsigned int worker, int64_t begin, int64_t end)
+        {
+            for (int64_t i = begin; i < end; ++i)
+            {
+                blocks[static_cast<size_t>(i)].clear();
+                sieve.SieveChunk(worker, window + i, blocks[static_cast<size_t>(i)]);
+            }
+        },
+            progressInterval,
+            [&reportProgress, window](int64_t done) { return reportProgress(window + done); });
+
+        if (!completed)
+        {
+            return false;
+        }
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const std::vector<uint64_t>& block = blocks[static_cast<size_t>(i)];
+            if (!block.empty() && !primes(block.data(), block.size()))
+            {
+                return false;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() - lastProgress >= progressInterval && !reportProgress(window + count))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WinRT_CPP::SievePrimesUnordered(
+    ComputePool& pool,
+    uint64_t first,
+    uint64_t last,
+    const WorkerPrimeBlockCallback& primes,
+    std::chrono::milliseconds progressInterval,
+    const SieveProgressCallback& progress)
+{
+    if (last > MaxSieveLast)
+    {
+        throw std::invalid_argument("SievePrimesUnordered: last is too large.");
+    }
+    if (first > last)
+    {
+        return true;
+    }
+    if (!PassSmallPrimes(first, last, [&primes](const uint64_t* block, size_t count) { return primes(0, block, count); }))
+    {
+        return false;
+    }
+
+    Sieve sieve(first, last, pool.GetWorkerCount());
+    const uint64_t chunkCount = sieve.GetChunkCount();
+    std::vector<std::vector<uint64_t>> blocks(pool.GetWorkerCount());
+    std::atomic<bool> stopped(false);
+
+    bool completed = pool.ParallelFor(0, static_cast<int64_t>(chunkCount), 1,
+        [&sieve, &blocks, &stopped, &primes](unsigned int worker, int64_t begin, int64_t end)
+    {
+        std::vector<uint64_t>& block = blocks[worker];
+        for (int64_t i = begin; i < end && !stopped.load(std::memory_order_relaxed); ++i)
+        {
+            block.clear();
+            sieve.SieveChunk(worker, i, block);
+            if (!block.empty() && !primes(worker, block.data(), block.size()))
+            {
+                stopped.store(true, std::memory_order_relaxed);
+            }
+        }
+    },
+        progressInterval,
+        [&stopped, &progress, chunkCount](int64_t done)
+    {
+        return !stopped.load(std::memory_order_relaxed) && (!progress || progress(static_cast<double>(done) / chunkCount));
+    });
+
+    return completed && !stopped.load(std::memory_order_relaxed);
+}
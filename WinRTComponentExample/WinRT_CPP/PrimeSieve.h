@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "ComputePool.h"
+
+namespace WinRT_CPP
+{
+    // Receives primes in increasing order, a block at a time, on the thread that called
+    // SievePrimes. Returning false stops the sieve.
+    typedef std::function<bool(const uint64_t* primes, size_t count)> PrimeBlockCallback;
+
+    // Receives the primes of one chunk of the range on the worker that sieved it, so blocks
+    // come from several threads at once and in no particular order. Returning false stops the
+    // sieve.
+    typedef std::function<bool(unsigned int worker, const uint64_t* primes, size_t count)> WorkerPrimeBlockCallback;
+
+    // Called with the fraction of the range sieved so far, from 0 to 1. Returning false stops
+    // the sieve.
+    typedef std::function<bool(double done)> SieveProgressCallback;
+
+    // Largest last SievePrimes accepts. The primes up to its square root are sieved in one piece.
+    const uint64_t MaxSieveLast = uint64_t(1) << 44;
+
+    // Passes every prime in [first, last] to primes, in increasing order. A segmented sieve of
+    // Eratosthenes on a mod 30 wheel: each byte holds the eight numbers in 30 that aren't
+    // multiples of 2, 3 or 5, and segments are small enough to stay in a core's L1 cache. The
+    // workers of pool sieve a window of consecutive chunks of segments at a time, and the
+    // window's primes are passed on chunk by chunk as soon as it is done, so they come out in
+    // order without being sorted and only a window's worth is held at once.
+    //
+    // progress is called about every progressInterval. Returns false if a callback stopped the
+    // sieve. Throws std::invalid_argument if last is greater than MaxSieveLast.
+    bool SievePrimes(
+        ComputePool& pool,
+        uint64_t first,
+        uint64_t last,
+        const PrimeBlockCallback& primes,
+        std::chrono::milliseconds progressInterval,
+        const SieveProgressCallback& progress);
+
+    // The same primes, passed to primes by the workers as soon as each chunk is done, without
+    // the windows that keep SievePrimes in order.
+    bool SievePrimesUnordered(
+        ComputePool& pool,
+        uint64_t first,
+        uint64_t last,
+        const WorkerPrimeBlockCallback& primes,
+        std::chrono::milliseconds progressInterval,
+        const SieveProgressCallback& progress);
+}
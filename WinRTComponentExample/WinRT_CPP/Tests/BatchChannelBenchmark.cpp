@@ -0,0 +1,199 @@
+#include "BatchChannel.h"
+
+#include "Benchmark.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    void Spin(int nanoseconds)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(nanoseconds);
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    // Stands in for the UI thread's dispatcher: a thread that runs what is posted to it, with
+    // a fixed cost per dispatch and per item handled.
+    class FakeDispatcher
+    {
+    public:
+        FakeDispatcher() : m_stop(false), m_dispatches(0), m_thread([this] { Run(); })
+        {
+        }
+
+        ~FakeDispatcher()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_ready.notify_all();
+            m_thread.join();
+        }
+
+        void Post(std::function<void()> work)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_work.push_back(std::move(work));
+            }
+            m_ready.notify_all();
+        }
+
+        uint64_t GetDispatches()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_dispatches;
+        }
+
+    private:
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;)
+            {
+                m_ready.wait(lock, [this] { return m_stop || !m_work.empty(); });
+                if (m_work.empty())
+                {
+                    return;
+                }
+                std::function<void()> work = std::move(m_work.front());
+                m_work.pop_front();
+                ++m_dispatches;
+                lock.unlock();
+
+                // What a RunAsync round trip costs the UI thread, roughly.
+                Spin(2000);
+                work();
+                lock.lock();
+            }
+        }
+
+        std::mutex                          m_mutex;
+        std::condition_variable             m_ready;
+        std::deque<std::function<void()>>   m_work;
+        bool                                m_stop;
+        uint64_t                            m_dispatches;
+        std::thread                         m_thread;
+    };
+
+    // Pushes count items from producers threads through a channel to the fake UI thread, whose
+    // handler raises an event, at 200 ns each, for each batch or for each item.
+    void Measure(const char* name, size_t batchSize, unsigned int producers, int count, bool eventPerItem)
+    {
+        uint64_t dispatches = 0;
+        uint64_t waits = 0;
+        double nanoseconds = TestSupport::MeasureNanoseconds(count, [&]
+        {
+            FakeDispatcher dispatcher;
+            uint64_t sum = 0;
+            {
+                BatchChannel<int> channel(producers, batchSize, std::chrono::milliseconds(16), 4, 16,
+                    [&dispatcher, &sum, eventPerItem](std::vector<int>& batch, BatchChannel<int>::Acknowledge acknowledge)
+                {
+                    auto items = std::make_shared<std::vector<int>>(std::move(batch));
+                    dispatcher.Post([items, acknowledge, &sum, eventPerItem]
+                    {
+                        // An event for the batch, or one for each of its items.
+                        Spin(eventPerItem ? 0 : 200);
+                        for (int item : *items)
+                        {
+                            if (eventPerItem)
+                            {
+                                Spin(200);
+                            }
+                            sum += static_cast<uint64_t>(item);
+                        }
+                        acknowledge();
+                    });
+                });
+
+                std::vector<std::thread> threads;
+                for (unsigned int producer = 0; producer < producers; ++producer)
+                {
+                    threads.emplace_back([&channel, producer, producers, count]
+                    {
+                        int block[256];
+                        for (int i = static_cast<int>(producer) * 256; i < count; i += static_cast<int>(producers) * 256)
+                        {
+                            for (int j = 0; j < 256; ++j)
+                            {
+                                block[j] = i + j;
+                            }
+                            channel.Push(producer, block, 256);
+                        }
+                    });
+                }
+                for (auto& thread : threads)
+                {
+                    thread.join();
+                }
+                channel.Close();
+                waits = channel.GetStatistics().producerWaits;
+            }
+            dispatches = dispatcher.GetDispatches();
+            TestSupport::DoNotOptimize(sum);
+        });
+
+        TestSupport::Report(name, nanoseconds, "ns/item");
+        TestSupport::Report((std::string(name) + ", dispatches").c_str(), static_cast<double>(dispatches), "");
+        TestSupport::Report((std::string(name) + ", producer waits").c_str(), static_cast<double>(waits), "");
+    }
+}
+
+BENCHMARK(BatchChannelToAUiThread)
+{
+    // What GetPrimesUnordered used to do - a dispatch per batch that still raised an event per
+    // prime - against one event per batch, and a dispatch per prime for scale.
+    const int count = 1 << 18;
+    Measure("batches of 4096, event per item", 4096, 2, count, true);
+    Measure("batches of 4096, event per batch", 4096, 2, count, false);
+    Measure("batches of 1", 1, 2, count / 16, false);
+}
+
+BENCHMARK(BatchChannelPush)
+{
+    // The producers' side alone, with a consumer that acknowledges at once.
+    for (unsigned int producers : { 1u, 4u })
+    {
+        const int count = 1 << 20;
+        double nanoseconds = TestSupport::MeasureNanoseconds(count, [&]
+        {
+            BatchChannel<int> channel(producers, 4096, std::chrono::milliseconds(16), 4, 16,
+                [](std::vector<int>& batch, BatchChannel<int>::Acknowledge acknowledge)
+            {
+                TestSupport::DoNotOptimize(batch.data());
+                acknowledge();
+            });
+            std::vector<std::thread> threads;
+            for (unsigned int producer = 0; producer < producers; ++producer)
+            {
+                threads.emplace_back([&channel, producer, producers, count]
+                {
+                    int block[1024] = {};
+                    for (int i = 0; i < count / static_cast<int>(producers); i += 1024)
+                    {
+                        channel.Push(producer, block, 1024);
+                    }
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        });
+        TestSupport::Report(producers == 1 ? "Push, 1 producer" : "Push, 4 producers", nanoseconds, "ns/item");
+    }
+}
@@ -0,0 +1,254 @@
+#include "BatchChannel.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    typedef BatchChannel<int> IntChannel;
+
+    // What the publish callback saw, with the acknowledgements it held back.
+    struct Published
+    {
+        std::mutex                              mutex;
+        std::vector<std::vector<int>>           batches;
+        std::vector<IntChannel::Acknowledge>    pending;
+
+        size_t BatchCount()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return batches.size();
+        }
+
+        void AcknowledgeAll()
+        {
+            std::vector<IntChannel::Acknowledge> acknowledgements;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                acknowledgements.swap(pending);
+            }
+            for (auto& acknowledge : acknowledgements)
+            {
+                acknowledge();
+            }
+        }
+
+        std::vector<int> Items()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<int> items;
+            for (const auto& batch : batches)
+            {
+                items.insert(items.end(), batch.begin(), batch.end());
+            }
+            return items;
+        }
+    };
+
+    IntChannel::PublishCallback Record(Published& published, bool acknowledgeNow)
+    {
+        return [&published, acknowledgeNow](std::vector<int>& batch, IntChannel::Acknowledge acknowledge)
+        {
+            {
+                std::lock_guard<std::mutex> lock(published.mutex);
+                published.batches.push_back(std::move(batch));
+                if (!acknowledgeNow)
+                {
+                    published.pending.push_back(acknowledge);
+                }
+            }
+            if (acknowledgeNow)
+            {
+                acknowledge();
+            }
+        };
+    }
+
+    template <typename Predicate>
+    bool WaitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST_CASE(BatchChannelDeliversEveryItemOnceInBatches)
+{
+    Published published;
+    const unsigned int producers = 4;
+    const int perProducer = 10007;
+    {
+        IntChannel channel(producers, 100, std::chrono::milliseconds(5), 4, 8, Record(published, true));
+        std::vector<std::thread> threads;
+        for (unsigned int producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&channel, producer]
+            {
+                // Blocks of varied sizes, some larger than a batch.
+                int next = static_cast<int>(producer) * perProducer;
+                const int end = next + perProducer;
+                int block[333];
+                for (int size = 1; next < end; size = size % 333 + 37)
+                {
+                    int length = std::min(size, end - next);
+                    std::iota(block, block + length, next);
+                    CHECK(channel.Push(producer, block, static_cast<size_t>(length)));
+                    next += length;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        channel.Close();
+
+        IntChannel::Statistics statistics = channel.GetStatistics();
+        CHECK_EQUAL(static_cast<uint64_t>(producers * perProducer), statistics.items);
+        CHECK_EQUAL(static_cast<uint64_t>(published.BatchCount()), statistics.batches);
+        CHECK(statistics.meanLatency <= statistics.maxLatency);
+    }
+
+    // A producer's items stay in order, and only the flushed batches are short.
+    std::vector<int> items = published.Items();
+    std::vector<int> sorted = items;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> expected(producers * perProducer);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(sorted == expected);
+
+    std::vector<int> last(producers, -1);
+    bool inOrder = true;
+    for (int item : items)
+    {
+        int& previous = last[static_cast<size_t>(item / perProducer)];
+        inOrder = inOrder && item > previous;
+        previous = item;
+    }
+    CHECK(inOrder);
+    for (const auto& batch : published.batches)
+    {
+        CHECK(!batch.empty() && batch.size() <= 100);
+    }
+}
+
+TEST_CASE(BatchChannelFlushesPartBatchesAfterTheDelay)
+{
+    Published published;
+    IntChannel channel(2, 1000, std::chrono::milliseconds(10), 4, 8, Record(published, true));
+
+    // The part batch is published once its first item is the delay old, however the
+    // collector's wakeups fall.
+    int values[] = { 1, 2, 3 };
+    auto pushed = std::chrono::steady_clock::now();
+    CHECK(channel.Push(1, values, 3));
+    CHECK(WaitFor([&published] { return published.BatchCount() == 1; }));
+    CHECK(std::chrono::steady_clock::now() - pushed >= std::chrono::milliseconds(10));
+    CHECK(published.Items() == std::vector<int>({ 1, 2, 3 }));
+    CHECK(channel.GetStatistics().maxLatency >= 0.010);
+
+    // Nothing more is published while nothing is pushed.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK_EQUAL(static_cast<size_t>(1), published.BatchCount());
+}
+
+TEST_CASE(BatchChannelHoldsProducersBackUntilTheConsumerAcknowledges)
+{
+    // Two batches in flight, then three queued, then the producer waits.
+    Published published;
+    IntChannel channel(1, 10, std::chrono::milliseconds(1), 2, 3, Record(published, false));
+    std::atomic<bool> pushed(false);
+    std::thread producer([&channel, &pushed]
+    {
+        int values[100];
+        std::iota(values, values + 100, 0);
+        CHECK(channel.Push(0, values, 100));
+        pushed = true;
+    });
+
+    CHECK(WaitFor([&published, &channel] { return published.BatchCount() == 2 && channel.GetStatistics().producerWaits >= 1; }));
+    CHECK_EQUAL(static_cast<size_t>(2), published.BatchCount());
+    CHECK(!pushed.load());
+
+    // Each acknowledgement lets more through.
+    while (!WaitFor([&pushed, &published] { return pushed.load() && published.BatchCount() == 10; }, std::chrono::milliseconds(20)))
+    {
+        published.AcknowledgeAll();
+    }
+    producer.join();
+    published.AcknowledgeAll();
+    channel.Close();
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(published.Items() == expected);
+}
+
+TEST_CASE(BatchChannelCancelReleasesWaitingProducers)
+{
+    Published published;
+    std::vector<IntChannel::Acknowledge> late;
+    {
+        IntChannel channel(1, 10, std::chrono::milliseconds(1), 1, 1, Record(published, false));
+        std::atomic<int> result(-1);
+        std::thread producer([&channel, &result]
+        {
+            int values[1000] = {};
+            result = channel.Push(0, values, 1000) ? 1 : 0;
+        });
+
+        // One batch in flight and one queued before the producer waits.
+        CHECK(WaitFor([&published, &channel] { return published.BatchCount() == 1 && channel.GetStatistics().producerWaits >= 1; }));
+        channel.Cancel();
+        producer.join();
+        CHECK_EQUAL(0, result.load());
+
+        int value = 1;
+        CHECK(!channel.Push(0, &value, 1));
+
+        std::lock_guard<std::mutex> lock(published.mutex);
+        late.swap(published.pending);
+    }
+
+    // Acknowledgements may come after the channel is gone.
+    CHECK(!late.empty());
+    for (auto& acknowledge : late)
+    {
+        acknowledge();
+    }
+    CHECK_EQUAL(static_cast<size_t>(1), published.BatchCount());
+}
+
+TEST_CASE(BatchChannelClosePublishesPastTheInFlightLimit)
+{
+    Published published;
+    IntChannel channel(3, 4, std::chrono::seconds(10), 1, 100, Record(published, false));
+    int values[] = { 1, 2, 3, 4, 5, 6 };
+    for (unsigned int producer = 0; producer < 3; ++producer)
+    {
+        CHECK(channel.Push(producer, values, 6));
+    }
+    channel.Close();
+
+    // A full batch and the rest from each producer, none of them acknowledged.
+    CHECK_EQUAL(static_cast<size_t>(6), published.BatchCount());
+    CHECK_EQUAL(static_cast<size_t>(18), published.Items().size());
+    published.AcknowledgeAll();
+}
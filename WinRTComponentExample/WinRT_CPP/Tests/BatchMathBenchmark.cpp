@@ -0,0 +1,66 @@
+#include "BatchMath.h"
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+BENCHMARK(BatchMathThroughput)
+{
+    const size_t count = 1 << 16;
+    std::vector<double> values(count);
+    std::vector<double> exponents(count);
+    std::vector<double> results(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = 0.001 + static_cast<double>(i) * 0.37;
+        exponents[i] = std::fmod(static_cast<double>(i) * 0.013, 4.0) - 2.0;
+    }
+
+    const struct
+    {
+        BatchMathFunction   function;
+        const char*         name;
+    } functions[] =
+    {
+        { BatchMathFunction::Log, "log" }, { BatchMathFunction::Log10, "log10" }, { BatchMathFunction::Exp, "exp" },
+        { BatchMathFunction::Sqrt, "sqrt" }, { BatchMathFunction::Pow, "pow" },
+    };
+
+    // Exp wants arguments it neither overflows nor underflows on.
+    std::vector<double> expValues(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        expValues[i] = std::fmod(values[i], 1400.0) - 700.0;
+    }
+
+    const BatchMathKernels best = GetBestBatchMathKernels();
+    ComputePool pool;
+    for (const auto& entry : functions)
+    {
+        const double* input = entry.function == BatchMathFunction::Exp ? expValues.data() : values.data();
+        auto run = [&](BatchMathKernels kernels)
+        {
+            return TestSupport::MeasureNanoseconds(count, [&]
+            {
+                EvaluateBatch(entry.function, input, exponents.data(), results.data(), count, kernels);
+                TestSupport::DoNotOptimize(results.data());
+            });
+        };
+
+        std::string name(entry.name);
+        TestSupport::Report((name + " scalar").c_str(), run(BatchMathKernels::Scalar), "ns/value");
+        if (best == BatchMathKernels::Avx2)
+        {
+            TestSupport::Report((name + " AVX2").c_str(), run(BatchMathKernels::Avx2), "ns/value");
+        }
+        TestSupport::Report((name + " pool").c_str(), TestSupport::MeasureNanoseconds(count, [&]
+        {
+            EvaluateBatch(pool, entry.function, input, exponents.data(), results.data(), count);
+            TestSupport::DoNotOptimize(results.data());
+        }), "ns/value");
+    }
+}
@@ -0,0 +1,226 @@
+#include "BatchMath.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    const BatchMathFunction AllFunctions[] =
+    {
+        BatchMathFunction::Log, BatchMathFunction::Log10, BatchMathFunction::Exp, BatchMathFunction::Sqrt, BatchMathFunction::Pow
+    };
+
+    double Reference(BatchMathFunction function, double x, double y)
+    {
+        switch (function)
+        {
+        case BatchMathFunction::Log:    return std::log(x);
+        case BatchMathFunction::Log10:  return std::log10(x);
+        case BatchMathFunction::Exp:    return std::exp(x);
+        case BatchMathFunction::Sqrt:   return std::sqrt(x);
+        case BatchMathFunction::Pow:    return std::pow(x, y);
+        }
+        return 0.0;
+    }
+
+    // Doubles as integers that are in the same order, so that the difference counts the
+    // doubles in between.
+    int64_t Ordered(double value)
+    {
+        int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? std::numeric_limits<int64_t>::min() - bits : bits;
+    }
+
+    uint64_t UlpDistance(double a, double b)
+    {
+        int64_t difference = Ordered(a) - Ordered(b);
+        return static_cast<uint64_t>(difference < 0 ? -difference : difference);
+    }
+
+    // The same value, or both NaN.
+    bool Same(double expected, double actual)
+    {
+        return (std::isnan(expected) && std::isnan(actual)) || Ordered(expected) == Ordered(actual);
+    }
+
+    struct Lcg
+    {
+        uint64_t state = 12345;
+
+        // Uniform in [low, high).
+        double Next(double low, double high)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return low + (high - low) * static_cast<double>(state >> 11) / 9007199254740992.0;
+        }
+    };
+
+    // The largest difference from the C runtime over count values, in ulps. The C runtime is
+    // itself within about half an ulp of the exact result.
+    uint64_t WorstUlps(BatchMathFunction function, const std::vector<double>& values, const std::vector<double>& exponents, BatchMathKernels kernels)
+    {
+        std::vector<double> results(values.size());
+        EvaluateBatch(function, values.data(), exponents.data(), results.data(), values.size(), kernels);
+        uint64_t worst = 0;
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            uint64_t ulps = UlpDistance(Reference(function, values[i], exponents[i]), results[i]);
+            worst = ulps > worst ? ulps : worst;
+        }
+        return worst;
+    }
+
+    // Values spread evenly in log space from 2^-1020 to 2^1020, and some near 1 where log
+    // loses the most.
+    std::vector<double> PositiveValues(Lcg& random, size_t count)
+    {
+        std::vector<double> values(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            values[i] = i % 4 == 0 ? random.Next(0.5, 2.0) : std::exp2(random.Next(-1020.0, 1020.0));
+        }
+        return values;
+    }
+}
+
+TEST_CASE(BatchMathKernelsMatchTheCRuntime)
+{
+    // Scalar is the C runtime, so it is exact against itself, and anything is within the
+    // documented error of the AVX2 kernels plus the C runtime's own half ulp.
+    const BatchMathKernels best = GetBestBatchMathKernels();
+    const size_t count = 100003;
+    Lcg random;
+    std::vector<double> positive = PositiveValues(random, count);
+    std::vector<double> exponentsOfE(count);
+    std::vector<double> unused(count, 0.0);
+    for (double& x : exponentsOfE)
+    {
+        x = random.Next(-707.0, 707.0);
+    }
+
+    for (BatchMathKernels kernels : { BatchMathKernels::Scalar, best })
+    {
+        const bool scalar = kernels == BatchMathKernels::Scalar;
+        CHECK(WorstUlps(BatchMathFunction::Log, positive, unused, kernels) <= (scalar ? 0u : 2u));
+        CHECK(WorstUlps(BatchMathFunction::Log10, positive, unused, kernels) <= (scalar ? 0u : 3u));
+        CHECK(WorstUlps(BatchMathFunction::Sqrt, positive, unused, kernels) == 0u);
+        CHECK(WorstUlps(BatchMathFunction::Exp, exponentsOfE, unused, kernels) <= (scalar ? 0u : 2u));
+    }
+}
+
+TEST_CASE(BatchMathPowIsAccurateOverItsRange)
+{
+    const BatchMathKernels best = GetBestBatchMathKernels();
+    const size_t count = 50000;
+    Lcg random;
+
+    // |y log x| below 20, where Pow is within 2 ulp.
+    std::vector<double> values(count);
+    std::vector<double> exponents(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = std::exp2(random.Next(-20.0, 20.0));
+        exponents[i] = random.Next(-19.0, 19.0) / std::fabs(std::log(values[i]) + 1e-3);
+    }
+    CHECK(WorstUlps(BatchMathFunction::Pow, values, exponents, best) <= 3u);
+
+    // Results up to the edges of the double range, within about 2e-14 relative.
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = random.Next(1e-3, 1e3);
+        exponents[i] = random.Next(-700.0, 700.0) / std::log(values[i]);
+    }
+    std::vector<double> results(count);
+    EvaluateBatch(BatchMathFunction::Pow, values.data(), exponents.data(), results.data(), count, best);
+    double worst = 0.0;
+    for (size_t i = 0; i < count; i++)
+    {
+        double expected = std::pow(values[i], exponents[i]);
+        double relative = std::fabs(results[i] - expected) / expected;
+        worst = relative > worst ? relative : worst;
+    }
+    CHECK(worst < 3e-14);
+}
+
+TEST_CASE(BatchMathSpecialValuesMatchTheCRuntime)
+{
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double subnormal = std::numeric_limits<double>::denorm_min() * 12345;
+    const std::vector<double> values =
+    {
+        0.0, -0.0, -1.0, 1.0, infinity, -infinity, nan, subnormal, DBL_MIN, DBL_MAX,
+        709.8, 710.0, -745.2, -746.0, -708.5, 2.0, 10.0, 1e-300, 0.5, 4.0, 1.0000000000000002
+    };
+    const std::vector<double> exponents =
+    {
+        0.0, -1.0, 0.5, nan, 2.0, 3.0, 0.0, 2.0, -1.0, 2.0,
+        1.0, 0.5, 3.0, -0.5, 2.0, 1100.0, -400.0, 2.0, infinity, -infinity, 1e17
+    };
+
+    for (BatchMathFunction function : AllFunctions)
+    {
+        std::vector<double> results(values.size());
+        EvaluateBatch(function, values.data(), exponents.data(), results.data(), values.size(), GetBestBatchMathKernels());
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            double expected = Reference(function, values[i], exponents[i]);
+            CHECK(Same(expected, results[i]) || (std::isfinite(expected) && expected != 0.0 && UlpDistance(expected, results[i]) <= 3));
+        }
+    }
+}
+
+TEST_CASE(BatchMathHandlesEveryLengthAndInPlaceResults)
+{
+    // Lengths that leave each of the four lanes over, in place, and across the pool.
+    const BatchMathKernels best = GetBestBatchMathKernels();
+    Lcg random;
+    std::vector<double> values = PositiveValues(random, 100000);
+    std::vector<double> exponents(values.size());
+    for (double& y : exponents)
+    {
+        y = random.Next(-2.0, 2.0);
+    }
+
+    for (BatchMathFunction function : AllFunctions)
+    {
+        std::vector<double> expected(values.size());
+        EvaluateBatch(function, values.data(), exponents.data(), expected.data(), values.size(), best);
+
+        // The values left over from the last group of four go to the C runtime, so a short
+        // batch is only within the error bounds of a long one, which for Pow of these values
+        // are relative.
+        for (size_t count = 0; count <= 9; count++)
+        {
+            std::vector<double> outOfPlace(count);
+            EvaluateBatch(function, values.data(), exponents.data(), outOfPlace.data(), count, best);
+            std::vector<double> inPlace(values.begin(), values.begin() + count);
+            inPlace.push_back(-42.0);
+            EvaluateBatch(function, inPlace.data(), exponents.data(), inPlace.data(), count, best);
+            CHECK(std::equal(outOfPlace.begin(), outOfPlace.end(), inPlace.begin(), Same));
+            CHECK(inPlace[count] == -42.0);
+            for (size_t i = 0; i < count; i++)
+            {
+                CHECK(Same(expected[i], inPlace[i]) || std::fabs(expected[i] - inPlace[i]) <= 3e-14 * std::fabs(expected[i]));
+            }
+        }
+
+        for (unsigned int threads : { 1u, 3u })
+        {
+            ComputePool pool(threads);
+            std::vector<double> results(values.size());
+            EvaluateBatch(pool, function, values.data(), exponents.data(), results.data(), results.size());
+            CHECK(std::equal(results.begin(), results.end(), expected.begin(), Same));
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#include "ComputePool.h"
+
+#include "Benchmark.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+BENCHMARK(ComputePoolLoops)
+{
+    ComputePool pool;
+    const std::chrono::milliseconds interval(50);
+
+    // The cost of a loop and of each chunk, with bodies that do nothing.
+    double loop = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        pool.ParallelFor(0, 1, 1, [](unsigned int, int64_t, int64_t) {}, interval, nullptr);
+    });
+    double chunk = TestSupport::MeasureNanoseconds(10000, [&]
+    {
+        pool.ParallelFor(0, 10000, 1, [](unsigned int, int64_t, int64_t) {}, interval, nullptr);
+    });
+
+    // A cheap predicate over 10 million numbers, counted per worker, against a plain loop.
+    const int64_t Count = 10000000;
+    std::vector<int64_t> counts(pool.GetWorkerCount() * 16);
+    double parallel = TestSupport::MeasureNanoseconds(Count, [&]
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        pool.ParallelFor(0, Count, 64 * 1024, [&counts](unsigned int worker, int64_t begin, int64_t end)
+        {
+            int64_t found = 0;
+            for (int64_t i = begin; i < end; i++)
+            {
+                found += (i * 2654435761u) % 7 == 0;
+            }
+            counts[worker * 16] += found;
+        }, interval, nullptr);
+        TestSupport::DoNotOptimize(counts.data());
+    });
+    double serial = TestSupport::MeasureNanoseconds(Count, [&]
+    {
+        int64_t found = 0;
+        for (int64_t i = 0; i < Count; i++)
+        {
+            found += (i * 2654435761u) % 7 == 0;
+        }
+        TestSupport::DoNotOptimize(found);
+    });
+
+    TestSupport::Report("workers", pool.GetWorkerCount(), "threads");
+    TestSupport::Report("ParallelFor, one empty chunk", loop / 1000, "us/loop");
+    TestSupport::Report("ParallelFor, 10000 empty chunks", chunk, "ns/chunk");
+    TestSupport::Report("predicate over 10M, ParallelFor", parallel * Count / 1e6, "ms");
+    TestSupport::Report("predicate over 10M, one thread", serial * Count / 1e6, "ms");
+}
@@ -0,0 +1,185 @@
+#include "ComputePool.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    const std::chrono::milliseconds ProgressInterval(5);
+
+    // Runs a loop over [first, last) and checks that every index was visited exactly once, in
+    // chunks no larger than chunkSize and by valid workers.
+    bool CoversEachIndexOnce(ComputePool& pool, int64_t first, int64_t last, int64_t chunkSize)
+    {
+        std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[static_cast<size_t>(last - first)]);
+        for (int64_t i = 0; i < last - first; i++)
+        {
+            visits[i].store(0);
+        }
+        std::atomic<bool> valid(true);
+
+        bool finished = pool.ParallelFor(first, last, chunkSize, [&](unsigned int worker, int64_t begin, int64_t end)
+        {
+            if (worker >= pool.GetWorkerCount() || begin < first || end > last || end <= begin || end - begin > chunkSize)
+            {
+                valid = false;
+            }
+            for (int64_t i = begin; i < end; i++)
+            {
+                visits[i - first].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, ProgressInterval, nullptr);
+
+        for (int64_t i = 0; i < last - first; i++)
+        {
+            if (visits[i].load() != 1)
+            {
+                return false;
+            }
+        }
+        return finished && valid;
+    }
+}
+
+TEST_CASE(ComputePoolCoversEveryIndexOnce)
+{
+    for (unsigned int threads : { 1u, 3u, 4u })
+    {
+        ComputePool pool(threads);
+        CHECK_EQUAL(threads, pool.GetWorkerCount());
+        CHECK(CoversEachIndexOnce(pool, 0, 1, 1));
+        CHECK(CoversEachIndexOnce(pool, 0, 100000, 1000));
+        CHECK(CoversEachIndexOnce(pool, -5000, 5003, 7));
+        CHECK(CoversEachIndexOnce(pool, 10, 13, 100));
+        CHECK(CoversEachIndexOnce(pool, 0, 20000, 1));
+    }
+
+    // Empty ranges return at once without calling the body.
+    ComputePool pool(2);
+    bool called = false;
+    CHECK(pool.ParallelFor(5, 5, 1, [&called](unsigned int, int64_t, int64_t) { called = true; }, ProgressInterval, nullptr));
+    CHECK(pool.ParallelFor(5, 2, 1, [&called](unsigned int, int64_t, int64_t) { called = true; }, ProgressInterval, nullptr));
+    CHECK(!called);
+}
+
+TEST_CASE(ComputePoolBalancesUnevenChunks)
+{
+    // The first worker's share is slow; the others finish theirs and steal from it, so the
+    // loop takes well under the time one worker would need for its whole share.
+    ComputePool pool(4);
+    std::vector<std::atomic<int>> chunksRun(4);
+    for (auto& count : chunksRun)
+    {
+        count = 0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    CHECK(pool.ParallelFor(0, 64, 1, [&](unsigned int worker, int64_t begin, int64_t)
+    {
+        if (begin < 16)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        chunksRun[worker]++;
+    }, ProgressInterval, nullptr));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(elapsed < std::chrono::milliseconds(120));
+    CHECK(chunksRun[0].load() < 16);
+}
+
+TEST_CASE(ComputePoolReportsProgressAndCancels)
+{
+    ComputePool pool(3);
+    std::vector<int64_t> reports;
+    std::atomic<int64_t> ran(0);
+    bool finished = pool.ParallelFor(0, 400, 1, [&ran](unsigned int, int64_t begin, int64_t end)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ran += end - begin;
+    }, ProgressInterval, [&reports](int64_t completed)
+    {
+        reports.push_back(completed);
+        return completed < 30;
+    });
+
+    // Progress only grows, and once it asks to stop the chunks not started are skipped.
+    CHECK(!finished);
+    CHECK(!reports.empty());
+    bool increasing = true;
+    for (size_t i = 1; i < reports.size(); i++)
+    {
+        increasing = increasing && reports[i] >= reports[i - 1];
+    }
+    CHECK(increasing);
+    CHECK(reports.back() >= 30);
+    CHECK(ran.load() < 400);
+
+    // The pool is ready for the next loop.
+    CHECK(CoversEachIndexOnce(pool, 0, 1000, 10));
+}
+
+TEST_CASE(ComputePoolRethrowsTheFirstException)
+{
+    ComputePool pool(4);
+    std::atomic<int64_t> ran(0);
+    bool caught = false;
+    try
+    {
+        pool.ParallelFor(0, 100000, 10, [&ran](unsigned int, int64_t begin, int64_t end)
+        {
+            if (begin == 500)
+            {
+                throw std::runtime_error("bad chunk");
+            }
+            ran += end - begin;
+        }, ProgressInterval, nullptr);
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(ran.load() < 100000);
+
+    // An error doesn't carry over to the next loop.
+    CHECK(CoversEachIndexOnce(pool, 0, 5000, 10));
+}
+
+TEST_CASE(ComputePoolRunsOneLoopAtATime)
+{
+    // Two threads run loops on one pool. Each counts its chunks in flight, and no chunk of one
+    // loop may run while a chunk of the other is in flight.
+    ComputePool pool(2);
+    std::atomic<int> inFlight[2];
+    inFlight[0] = 0;
+    inFlight[1] = 0;
+    std::atomic<bool> overlapped(false);
+    auto loop = [&](int caller)
+    {
+        for (int repeat = 0; repeat < 20; repeat++)
+        {
+            pool.ParallelFor(0, 8, 1, [&](unsigned int, int64_t, int64_t)
+            {
+                inFlight[caller]++;
+                if (inFlight[1 - caller].load() != 0)
+                {
+                    overlapped = true;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                inFlight[caller]--;
+            }, ProgressInterval, nullptr);
+        }
+    };
+
+    std::thread other(loop, 1);
+    loop(0);
+    other.join();
+    CHECK(!overlapped.load());
+}
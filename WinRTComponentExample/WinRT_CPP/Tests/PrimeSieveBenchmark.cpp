@@ -0,0 +1,74 @@
+#include "PrimeSieve.h"
+
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    // What the component's GetPrimesOrdered did before the sieve: trial division.
+    bool IsPrime(uint64_t n)
+    {
+        if (n < 2)
+        {
+            return false;
+        }
+        for (uint64_t divisor = 2; divisor * divisor <= n; divisor++)
+        {
+            if (n % divisor == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+BENCHMARK(PrimeSieveRanges)
+{
+    ComputePool pool;
+    const std::chrono::milliseconds interval(100);
+
+    double trialDivision = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        uint64_t count = 0;
+        for (uint64_t n = 0; n <= 100000; n++)
+        {
+            count += IsPrime(n);
+        }
+        TestSupport::DoNotOptimize(count);
+    });
+
+    auto count = [&pool, interval](uint64_t last)
+    {
+        uint64_t primes = 0;
+        SievePrimes(pool, 0, last, [&primes](const uint64_t*, size_t blockCount)
+        {
+            primes += blockCount;
+            return true;
+        }, interval, nullptr);
+        return primes;
+    };
+
+    double small = TestSupport::MeasureNanoseconds(1, [&] { TestSupport::DoNotOptimize(count(100000)); });
+    double million = TestSupport::MeasureNanoseconds(1, [&] { TestSupport::DoNotOptimize(count(1000000)); });
+    double hundredMillion = TestSupport::MeasureNanoseconds(1, [&] { TestSupport::DoNotOptimize(count(100000000)); }, 1.0);
+    double unordered = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        std::vector<uint64_t> counts(pool.GetWorkerCount() * 8);
+        SievePrimesUnordered(pool, 0, 100000000, [&counts](unsigned int worker, const uint64_t*, size_t blockCount)
+        {
+            counts[worker * 8] += blockCount;
+            return true;
+        }, interval, nullptr);
+        TestSupport::DoNotOptimize(counts.data());
+    }, 1.0);
+
+    TestSupport::Report("trial division up to 1e5", trialDivision / 1e6, "ms");
+    TestSupport::Report("SievePrimes up to 1e5", small / 1e6, "ms");
+    TestSupport::Report("SievePrimes up to 1e6", million / 1e6, "ms");
+    TestSupport::Report("SievePrimes up to 1e8", hundredMillion / 1e6, "ms");
+    TestSupport::Report("SievePrimesUnordered up to 1e8", unordered / 1e6, "ms");
+}
@@ -0,0 +1,204 @@
+#include "PrimeSieve.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace WinRT_CPP;
+
+namespace
+{
+    const std::chrono::milliseconds ProgressInterval(10);
+
+    // The primes in [first, last] by a plain segmented sieve, to compare against.
+    std::vector<uint64_t> ReferencePrimes(uint64_t first, uint64_t last)
+    {
+        uint64_t root = 1;
+        while ((root + 1) * (root + 1) <= last)
+        {
+            root++;
+        }
+        std::vector<bool> smallComposite(static_cast<size_t>(root + 1), false);
+        std::vector<uint64_t> basePrimes;
+        for (uint64_t n = 2; n <= root; n++)
+        {
+            if (!smallComposite[static_cast<size_t>(n)])
+            {
+                basePrimes.push_back(n);
+                for (uint64_t multiple = n * n; multiple <= root; multiple += n)
+                {
+                    smallComposite[static_cast<size_t>(multiple)] = true;
+                }
+            }
+        }
+
+        std::vector<bool> composite(static_cast<size_t>(last - first + 1), false);
+        for (uint64_t prime : basePrimes)
+        {
+            uint64_t start = std::max(prime * prime, (first + prime - 1) / prime * prime);
+            for (uint64_t multiple = start; multiple <= last; multiple += prime)
+            {
+                composite[static_cast<size_t>(multiple - first)] = true;
+            }
+        }
+
+        std::vector<uint64_t> primes;
+        for (uint64_t n = std::max<uint64_t>(first, 2); n <= last; n++)
+        {
+            if (!composite[static_cast<size_t>(n - first)])
+            {
+                primes.push_back(n);
+            }
+        }
+        return primes;
+    }
+
+    std::vector<uint64_t> Ordered(ComputePool& pool, uint64_t first, uint64_t last)
+    {
+        std::vector<uint64_t> primes;
+        SievePrimes(pool, first, last, [&primes](const uint64_t* block, size_t count)
+        {
+            primes.insert(primes.end(), block, block + count);
+            return true;
+        }, ProgressInterval, nullptr);
+        return primes;
+    }
+
+    std::vector<uint64_t> Unordered(ComputePool& pool, uint64_t first, uint64_t last)
+    {
+        std::mutex mutex;
+        std::vector<uint64_t> primes;
+        SievePrimesUnordered(pool, first, last, [&](unsigned int, const uint64_t* block, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            primes.insert(primes.end(), block, block + count);
+            return true;
+        }, ProgressInterval, nullptr);
+        std::sort(primes.begin(), primes.end());
+        return primes;
+    }
+
+    uint64_t Count(ComputePool& pool, uint64_t first, uint64_t last)
+    {
+        uint64_t count = 0;
+        SievePrimes(pool, first, last, [&count](const uint64_t*, size_t blockCount)
+        {
+            count += blockCount;
+            return true;
+        }, ProgressInterval, nullptr);
+        return count;
+    }
+}
+
+TEST_CASE(PrimeSieveMatchesAPlainSieve)
+{
+    uint32_t seed = 99;
+    auto random = [&seed](uint64_t limit)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        uint64_t high = seed;
+        seed = seed * 1664525u + 1013904223u;
+        return ((high << 32) | seed) % limit;
+    };
+
+    for (unsigned int threads : { 1u, 3u, 4u })
+    {
+        ComputePool pool(threads);
+
+        // The small primes the wheel leaves out, the edges of the wheel and of segments and
+        // chunks (983,040 numbers a segment), and random ranges, some far from zero.
+        std::vector<std::pair<uint64_t, uint64_t>> ranges =
+        {
+            { 0, 0 }, { 0, 1 }, { 0, 2 }, { 2, 2 }, { 0, 30 }, { 3, 7 }, { 5, 6 }, { 29, 31 }, { 30, 60 },
+            { 0, 983040 }, { 983039, 983041 + 30 }, { 983040 * 8 - 100, 983040 * 8 + 100 },
+            { 0, 9000000 }, { 1000000000000 - 1000, 1000000000000 + 1000000 },
+        };
+        for (int i = 0; i < 20; i++)
+        {
+            uint64_t first = random(i % 2 == 0 ? 20000000 : 10000000000ull);
+            ranges.push_back({ first, first + random(3000000) });
+        }
+
+        for (const auto& range : ranges)
+        {
+            std::vector<uint64_t> expected = ReferencePrimes(range.first, range.second);
+            std::vector<uint64_t> ordered = Ordered(pool, range.first, range.second);
+            CHECK(ordered == expected);
+            CHECK(Unordered(pool, range.first, range.second) == expected);
+        }
+    }
+}
+
+TEST_CASE(PrimeSieveCountsThePrimesBelowPowersOfTen)
+{
+    ComputePool pool(4);
+    const uint64_t counts[] = { 4, 25, 168, 1229, 9592, 78498, 664579, 5761455 };
+    uint64_t limit = 10;
+    for (uint64_t expected : counts)
+    {
+        CHECK_EQUAL(expected, Count(pool, 0, limit));
+        limit *= 10;
+    }
+}
+
+TEST_CASE(PrimeSieveStopsWhenACallbackSaysSo)
+{
+    ComputePool pool(3);
+
+    // The block callback, after the first block.
+    int blocks = 0;
+    CHECK(!SievePrimes(pool, 0, 100000000, [&blocks](const uint64_t*, size_t) { return ++blocks < 2; }, ProgressInterval, nullptr));
+    CHECK_EQUAL(2, blocks);
+
+    std::atomic<int> workerBlocks(0);
+    CHECK(!SievePrimesUnordered(pool, 0, 100000000, [&workerBlocks](unsigned int, const uint64_t*, size_t)
+    {
+        return ++workerBlocks < 2;
+    }, ProgressInterval, nullptr));
+    CHECK(workerBlocks.load() < 50);
+
+    // The progress callback, once a little of the range is done. Progress only grows and
+    // stays within [0, 1].
+    std::vector<double> reports;
+    CHECK(!SievePrimes(pool, 0, 1000000000, [](const uint64_t*, size_t) { return true; }, std::chrono::milliseconds(1), [&reports](double done)
+    {
+        reports.push_back(done);
+        return done < 0.02;
+    }));
+    CHECK(!reports.empty());
+    CHECK(reports.back() >= 0.02 && reports.back() < 0.5);
+    CHECK(std::is_sorted(reports.begin(), reports.end()));
+
+    // A range that finishes reports no more than all of it.
+    double lastReport = 0.0;
+    CHECK(SievePrimes(pool, 0, 50000000, [](const uint64_t*, size_t) { return true; }, std::chrono::milliseconds(1), [&lastReport](double done)
+    {
+        lastReport = done;
+        return true;
+    }));
+    CHECK(lastReport <= 1.0);
+}
+
+TEST_CASE(PrimeSieveRejectsRangesPastItsLimit)
+{
+    ComputePool pool(2);
+    auto ignore = [](const uint64_t*, size_t) { return true; };
+    bool threw = false;
+    try
+    {
+        SievePrimes(pool, 0, MaxSieveLast + 1, ignore, ProgressInterval, nullptr);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // An empty range is fine, and the very top of the range is sieved correctly.
+    CHECK(SievePrimes(pool, 10, 9, ignore, ProgressInterval, nullptr));
+    CHECK(Ordered(pool, MaxSieveLast - 2000, MaxSieveLast) == ReferencePrimes(MaxSieveLast - 2000, MaxSieveLast));
+}
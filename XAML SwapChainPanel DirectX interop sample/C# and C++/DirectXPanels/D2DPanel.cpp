@@ -48,31 +48,41 @@ void D2DPanel::Render()
         return;
     }
 
+    // The board only changes when the panel framework marks it dirty, e.g. after a resize or device loss.
+    if (m_dirtyRegion.IsEmpty())
+    {
+        return;
+    }
+
     m_d2dContext->BeginDraw();
-    m_d2dContext->Clear(m_backgroundColor);
-
-    // Set up simple tic-tac-toe game board.
-    float horizontalSpacing = m_renderTargetWidth / 3.0f;
-    float verticalSpacing = m_renderTargetHeight / 3.0f;
-
-    // Since the unit mode is set to pixels in CreateDeviceResources(), here we scale the line thickness by the composition scale so that elements 
-    // are rendered in the same position but larger as you zoom in. Whether or not the composition scale should be factored into the size or position 
-    // of elements depends on the app's scenario.
-    float lineThickness = m_compositionScaleX * 2.0f;
-    float strokeThickness = m_compositionScaleX * 4.0f;
-
-    // Draw grid lines.
-    m_d2dContext->DrawLine(Point2F(horizontalSpacing, 0), Point2F(horizontalSpacing, m_renderTargetHeight), m_strokeBrush.Get(), lineThickness);
-    m_d2dContext->DrawLine(Point2F(horizontalSpacing * 2, 0), Point2F(horizontalSpacing * 2, m_renderTargetHeight), m_strokeBrush.Get(), lineThickness);
-    m_d2dContext->DrawLine(Point2F(0, verticalSpacing), Point2F(m_renderTargetWidth, verticalSpacing), m_strokeBrush.Get(), lineThickness);
-    m_d2dContext->DrawLine(Point2F(0, verticalSpacing * 2), Point2F(m_renderTargetWidth, verticalSpacing * 2), m_strokeBrush.Get(), lineThickness);
-
-    // Draw center circle.
-    m_d2dContext->DrawEllipse(Ellipse(Point2F(m_renderTargetWidth / 2.0f, m_renderTargetHeight / 2.0f), horizontalSpacing / 2.0f - strokeThickness, verticalSpacing / 2.0f - strokeThickness), m_strokeBrush.Get(), strokeThickness);
-
-    // Draw top left X.
-    m_d2dContext->DrawLine(Point2F(0, 0), Point2F(horizontalSpacing - lineThickness, verticalSpacing - lineThickness), m_strokeBrush.Get(), strokeThickness);
-    m_d2dContext->DrawLine(Point2F(horizontalSpacing - lineThickness, 0), Point2F(0, verticalSpacing - lineThickness), m_strokeBrush.Get(), strokeThickness);
+
+    RenderDirtyRegion([this]()
+    {
+        m_d2dContext->Clear(m_backgroundColor);
+
+        // Set up simple tic-tac-toe game board.
+        float horizontalSpacing = m_renderTargetWidth / 3.0f;
+        float verticalSpacing = m_renderTargetHeight / 3.0f;
+
+        // Since the unit mode is set to pixels in CreateDeviceResources(), here we scale the line thickness by the composition scale so that elements 
+        // are rendered in the same position but larger as you zoom in. Whether or not the composition scale should be factored into the size or position 
+        // of elements depends on the app's scenario.
+        float lineThickness = m_compositionScaleX * 2.0f;
+        float strokeThickness = m_compositionScaleX * 4.0f;
+
+        // Draw grid lines.
+        m_d2dContext->DrawLine(Point2F(horizontalSpacing, 0), Point2F(horizontalSpacing, m_renderTargetHeight), m_strokeBrush.Get(), lineThickness);
+        m_d2dContext->DrawLine(Point2F(horizontalSpacing * 2, 0), Point2F(horizontalSpacing * 2, m_renderTargetHeight), m_strokeBrush.Get(), lineThickness);
+        m_d2dContext->DrawLine(Point2F(0, verticalSpacing), Point2F(m_renderTargetWidth, verticalSpacing), m_strokeBrush.Get(), lineThickness);
+        m_d2dContext->DrawLine(Point2F(0, verticalSpacing * 2), Point2F(m_renderTargetWidth, verticalSpacing * 2), m_strokeBrush.Get(), lineThickness);
+
+        // Draw center circle.
+        m_d2dContext->DrawEllipse(Ellipse(Point2F(m_renderTargetWidth / 2.0f, m_renderTargetHeight / 2.0f), horizontalSpacing / 2.0f - strokeThickness, verticalSpacing / 2.0f - strokeThickness), m_strokeBrush.Get(), strokeThickness);
+
+        // Draw top left X.
+        m_d2dContext->DrawLine(Point2F(0, 0), Point2F(horizontalSpacing - lineThickness, verticalSpacing - lineThickness), m_strokeBrush.Get(), strokeThickness);
+        m_d2dContext->DrawLine(Point2F(horizontalSpacing - lineThickness, 0), Point2F(0, verticalSpacing - lineThickness), m_strokeBrush.Get(), strokeThickness);
+    });
 
     m_d2dContext->EndDraw();
 
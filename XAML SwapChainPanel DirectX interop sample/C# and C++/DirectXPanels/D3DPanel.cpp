@@ -48,44 +48,27 @@ D3DPanel::D3DPanel() :
 
 D3DPanel::~D3DPanel()
 {
-    m_renderLoopWorker->Cancel();
+    DirectXPanelBase::StopRenderLoop();
 }
 
 void D3DPanel::StartRenderLoop()
 {
-    // If the animation render loop is already running then do not start another thread.
-    if (m_renderLoopWorker != nullptr && m_renderLoopWorker->Status == AsyncStatus::Started)
+    // Calculate the updated frame and render once per vertical blanking interval. The loop waits for the vblank,
+    // which ensures the app isn't updating and rendering faster than the display can refresh, and applies
+    // size changes between frames so the UI thread never waits on rendering.
+    DirectXPanelBase::StartRenderLoop([this]()
     {
-        return;
-    }
-
-    // Create a task that will be run on a background thread.
-    auto workItemHandler = ref new WorkItemHandler([this](IAsyncAction ^ action)
-    {
-        // Calculate the updated frame and render once per vertical blanking interval.
-        while (action->Status == AsyncStatus::Started)
+        m_timer.Tick([&]()
         {
-            m_timer.Tick([&]()
-            {
-                critical_section::scoped_lock lock(m_criticalSection);
-                Render();
-            });
-
-            // Halt the thread until the next vblank is reached.
-            // This ensures the app isn't updating and rendering faster than the display can refresh,
-            // which would unnecessarily spend extra CPU and GPU resources.  This helps improve battery life.
-            m_dxgiOutput->WaitForVBlank();
-        }
+            Render();
+        });
     });
-    
-    // Run task on a dedicated high priority background thread.
-    m_renderLoopWorker = ThreadPool::RunAsync(workItemHandler, WorkItemPriority::High, WorkItemOptions::TimeSliced);
 }
 
 void D3DPanel::StopRenderLoop()
 {
-    // Cancel the asynchronous task and let the render thread exit.
-    m_renderLoopWorker->Cancel();
+    // Stop the render loop and let the render thread exit.
+    DirectXPanelBase::StopRenderLoop();
 }
 
 void D3DPanel::Render()
@@ -183,21 +166,6 @@ void D3DPanel::CreateDeviceResources()
 {
     DirectXPanelBase::CreateDeviceResources();
 
-    // Retrieve DXGIOutput representing the main adapter output.
-    ComPtr<IDXGIFactory1> dxgiFactory;
-    ThrowIfFailed(
-        CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory))
-        );
-
-    ComPtr<IDXGIAdapter> dxgiAdapter;
-    ThrowIfFailed(
-        dxgiFactory->EnumAdapters(0, &dxgiAdapter)
-        );
-
-    ThrowIfFailed(
-        dxgiAdapter->EnumOutputs(0, &m_dxgiOutput)
-        );
-
     // Asynchronously load vertex shader and create input layout.
     auto loadVSTask = DX::ReadDataAsync(L"DirectXPanels\\SimpleVertexShader.cso");
     auto createVSTask = loadVSTask.then([this](const std::vector<byte>& fileData) {
@@ -23,14 +23,28 @@ namespace DirectXPanels
         void StartRenderLoop();
         void StopRenderLoop();
 
+        // Render loop frame timing over the last few seconds, in milliseconds, refreshed about twice a second.
+        property double AverageFrameTime
+        {
+            double get() { return GetFrameStatistics().averageInterval / 1000.0; }
+        }
+        property double WorstFrameTime
+        {
+            // 99th percentile, so a single hitch doesn't hide the typical worst case.
+            double get() { return GetFrameStatistics().p99Interval / 1000.0; }
+        }
+        property uint64 MissedFrameCount
+        {
+            // Frames that took noticeably longer than one display refresh.
+            uint64 get() { return GetFrameStatistics().missedFrameCount; }
+        }
+
     private protected:
 
         virtual void Render() override;
         virtual void CreateDeviceResources() override;
         virtual void CreateSizeDependentResources() override;
 
-        Microsoft::WRL::ComPtr<IDXGIOutput>                 m_dxgiOutput;
-
         Microsoft::WRL::ComPtr<ID3D11RenderTargetView>      m_renderTargetView;
         Microsoft::WRL::ComPtr<ID3D11DepthStencilView>      m_depthStencilView;
         Microsoft::WRL::ComPtr<ID3D11VertexShader>          m_vertexShader;
@@ -46,7 +60,6 @@ namespace DirectXPanels
 
         float	                                            m_degreesPerSecond;
 
-        Windows::Foundation::IAsyncAction^					m_renderLoopWorker;
         // Rendering loop timer.
         DX::StepTimer                                       m_timer;
 
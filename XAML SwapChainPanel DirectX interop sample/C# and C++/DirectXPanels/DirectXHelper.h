@@ -25,6 +25,12 @@ namespace DX
     { 
         return D2D1::ColorF(color.R / 255.0f, color.G / 255.0f, color.B / 255.0f, color.A / 255.0f); 
     }
+
+    // Packs a color as 0xAARRGGBB, e.g. for use as a lookup key.
+    inline uint32_t ConvertToArgb(Windows::UI::Color color)
+    {
+        return (static_cast<uint32_t>(color.A) << 24) | (static_cast<uint32_t>(color.R) << 16) | (static_cast<uint32_t>(color.G) << 8) | color.B;
+    }
     
 	// Converts between Point types.
     inline D2D1_POINT_2F ConvertToPoint2F(Windows::Foundation::Point point) 
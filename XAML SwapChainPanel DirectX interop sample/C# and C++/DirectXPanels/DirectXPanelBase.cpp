@@ -36,6 +36,9 @@ using namespace DX;
 
 static const float m_dipsPerInch = 96.0f;
 
+// Frames between updates of the render loop's published frame statistics.
+static const uint64_t m_frameStatisticsPeriod = 30;
+
 DirectXPanelBase::DirectXPanelBase() :
     m_loadingComplete(false),
     m_backgroundColor(D2D1::ColorF(D2D1::ColorF::White)), // Default to white background.
@@ -43,8 +46,15 @@ DirectXPanelBase::DirectXPanelBase() :
     m_compositionScaleX(1.0f),
     m_compositionScaleY(1.0f),
     m_height(1.0f),
-    m_width(1.0f)
+    m_width(1.0f),
+    m_renderLoopRunning(false),
+    m_frameStatistics()
 {
+    m_requestedSurface.width = m_width;
+    m_requestedSurface.height = m_height;
+    m_requestedSurface.compositionScaleX = m_compositionScaleX;
+    m_requestedSurface.compositionScaleY = m_compositionScaleY;
+
     this->SizeChanged += ref new Windows::UI::Xaml::SizeChangedEventHandler(this, &DirectXPanelBase::OnSizeChanged);
     this->CompositionScaleChanged += ref new Windows::Foundation::TypedEventHandler<SwapChainPanel^, Object^>(this, &DirectXPanelBase::OnCompositionScaleChanged);
     Application::Current->Suspending += ref new SuspendingEventHandler(this, &DirectXPanelBase::OnSuspending);
@@ -286,6 +296,10 @@ void DirectXPanelBase::CreateSizeDependentResources()
 
     m_d2dContext->SetDpi(m_dipsPerInch * m_compositionScaleX, m_dipsPerInch * m_compositionScaleY);
     m_d2dContext->SetTarget(m_d2dTargetBitmap.Get());
+
+    // The new buffers have undefined content, so the next frames must be drawn and presented in full.
+    m_dirtyRegion.SetBounds(static_cast<int32_t>(m_renderTargetWidth), static_cast<int32_t>(m_renderTargetHeight));
+    m_presentedDirtyRegion.SetBounds(static_cast<int32_t>(m_renderTargetWidth), static_cast<int32_t>(m_renderTargetHeight));
 }
 
 void DirectXPanelBase::Present()
@@ -296,6 +310,15 @@ void DirectXPanelBase::Present()
     parameters.pScrollRect = nullptr;
     parameters.pScrollOffset = nullptr;
 
+    // Only pass dirty rects when the panel reported damage and it covers part of the surface;
+    // otherwise the whole buffer is presented.
+    static_assert(sizeof(DirtyRect) == sizeof(RECT), "DirtyRect must match RECT.");
+    if (!m_dirtyRegion.IsEmpty() && !m_dirtyRegion.IsFull())
+    {
+        parameters.DirtyRectsCount = static_cast<UINT>(m_dirtyRegion.GetRects().size());
+        parameters.pDirtyRects = reinterpret_cast<RECT*>(const_cast<DirtyRect*>(m_dirtyRegion.GetRects().data()));
+    }
+
     HRESULT hr = S_OK;
 
     hr = m_swapChain->Present1(1, 0, &parameters);
@@ -307,7 +330,209 @@ void DirectXPanelBase::Present()
     else
     {
         ThrowIfFailed(hr);
+
+        // Remember what this frame changed; the next back buffer doesn't have it yet.
+        m_presentedDirtyRegion.Clear();
+        if (m_dirtyRegion.IsEmpty())
+        {
+            m_presentedDirtyRegion.AddAll();
+        }
+        else
+        {
+            m_presentedDirtyRegion.Add(m_dirtyRegion);
+        }
+        m_dirtyRegion.Clear();
+    }
+}
+
+void DirectXPanelBase::Invalidate(const D2D1_RECT_F& rect)
+{
+    // Round out to whole pixels, with one more for antialiased edges.
+    m_dirtyRegion.Add(DirtyRectFromDips(rect.left, rect.top, rect.right, rect.bottom, m_compositionScaleX, m_compositionScaleY, 1));
+}
+
+void DirectXPanelBase::InvalidateAll()
+{
+    m_dirtyRegion.AddAll();
+}
+
+void DirectXPanelBase::RenderDirtyRegion(const std::function<void()>& draw)
+{
+    DirtyRegion redraw = m_dirtyRegion;
+    redraw.Add(m_presentedDirtyRegion);
+
+    // Clip rectangles are in DIPs unless the panel switched the context to pixel units.
+    bool pixels = m_d2dContext->GetUnitMode() == D2D1_UNIT_MODE_PIXELS;
+    float scaleX = pixels ? 1.0f : 1.0f / m_compositionScaleX;
+    float scaleY = pixels ? 1.0f : 1.0f / m_compositionScaleY;
+
+    for (const auto& rect : redraw.GetRects())
+    {
+        m_d2dContext->PushAxisAlignedClip(
+            RectF(rect.left * scaleX, rect.top * scaleY, rect.right * scaleX, rect.bottom * scaleY),
+            D2D1_ANTIALIAS_MODE_ALIASED
+            );
+
+        draw();
+
+        m_d2dContext->PopAxisAlignedClip();
+    }
+}
+
+void DirectXPanelBase::CreateLayerBitmap(ID2D1Bitmap1** bitmap)
+{
+    float dpiX, dpiY;
+    m_d2dContext->GetDpi(&dpiX, &dpiY);
+
+    ThrowIfFailed(
+        m_d2dContext->CreateBitmap(
+        m_d2dTargetBitmap->GetPixelSize(),
+        nullptr,
+        0,
+        BitmapProperties1(
+        D2D1_BITMAP_OPTIONS_TARGET,
+        PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+        dpiX,
+        dpiY
+        ),
+        bitmap
+        )
+        );
+}
+
+void DirectXPanelBase::StartRenderLoop(const std::function<void()>& frame)
+{
+    if (m_renderLoopWorker != nullptr && m_renderLoopWorker->Status == AsyncStatus::Started)
+    {
+        return;
+    }
+
+    m_renderLoopRunning = true;
+
+    auto workItemHandler = ref new WorkItemHandler([this, frame](IAsyncAction^ action)
+    {
+        ComPtr<IDXGIOutput> output;
+        FramePacer pacer;
+        FrameStatistics statistics;
+
+        // Start each frame at the vertical blank, so that it picks up all the input and state changes that arrived
+        // during the last refresh. The output is looked up again after a failure, since the device may have been
+        // recreated on a different adapter; in the meantime the pacer falls back to its deadline timer.
+        pacer.SetWaitFunction([this, &output]()
+        {
+            if (output == nullptr)
+            {
+                critical_section::scoped_lock lock(m_criticalSection);
+
+                ComPtr<IDXGIDevice> dxgiDevice;
+                ComPtr<IDXGIAdapter> dxgiAdapter;
+                if (m_d3dDevice == nullptr ||
+                    FAILED(m_d3dDevice.As(&dxgiDevice)) ||
+                    FAILED(dxgiDevice->GetAdapter(&dxgiAdapter)) ||
+                    FAILED(dxgiAdapter->EnumOutputs(0, &output)))
+                {
+                    output = nullptr;
+                    return false;
+                }
+            }
+
+            if (FAILED(output->WaitForVBlank()))
+            {
+                output = nullptr;
+                return false;
+            }
+            return true;
+        });
+
+        uint64_t previousFrameStart = 0;
+
+        while (m_renderLoopRunning && action->Status == AsyncStatus::Started)
+        {
+            uint64_t frameStart = pacer.WaitForNextFrame();
+
+            {
+                critical_section::scoped_lock lock(m_criticalSection);
+
+                ApplySurfaceParameters();
+
+                if (m_loadingComplete && m_renderLoopRunning)
+                {
+                    frame();
+                }
+            }
+
+            if (previousFrameStart != 0)
+            {
+                statistics.AddFrame(frameStart - previousFrameStart, FramePacer::Now() - frameStart);
+
+                if (statistics.GetFrameCount() % m_frameStatisticsPeriod == 0)
+                {
+                    m_frameStatisticsMailbox.Post(statistics.GetSummary());
+                }
+            }
+            previousFrameStart = frameStart;
+        }
+    });
+
+    // Run task on a dedicated high priority background thread.
+    m_renderLoopWorker = ThreadPool::RunAsync(workItemHandler, WorkItemPriority::High, WorkItemOptions::TimeSliced);
+}
+
+void DirectXPanelBase::StopRenderLoop()
+{
+    m_renderLoopRunning = false;
+
+    if (m_renderLoopWorker != nullptr)
+    {
+        m_renderLoopWorker->Cancel();
+    }
+
+    // Apply any change the loop didn't get to, since nothing else will.
+    critical_section::scoped_lock lock(m_criticalSection);
+    ApplySurfaceParameters();
+}
+
+FrameStatistics::Summary DirectXPanelBase::GetFrameStatistics()
+{
+    m_frameStatisticsMailbox.Take(m_frameStatistics);
+    return m_frameStatistics;
+}
+
+// Hands the surface parameters last set by the UI thread to the render loop if it is running,
+// or applies them immediately otherwise. Must be called on the UI thread.
+void DirectXPanelBase::UpdateSurfaceParameters()
+{
+    m_surfaceMailbox.Post(m_requestedSurface);
+
+    if (!m_renderLoopRunning)
+    {
+        critical_section::scoped_lock lock(m_criticalSection);
+        ApplySurfaceParameters();
+    }
+}
+
+// Recreates size-dependent resources if new surface parameters were posted. Must be called with
+// m_criticalSection held.
+void DirectXPanelBase::ApplySurfaceParameters()
+{
+    SurfaceParameters parameters;
+    if (!m_surfaceMailbox.Take(parameters))
+    {
+        return;
+    }
+
+    if (parameters.width == m_width && parameters.height == m_height &&
+        parameters.compositionScaleX == m_compositionScaleX && parameters.compositionScaleY == m_compositionScaleY)
+    {
+        return;
     }
+
+    m_width = parameters.width;
+    m_height = parameters.height;
+    m_compositionScaleX = parameters.compositionScaleX;
+    m_compositionScaleY = parameters.compositionScaleY;
+
+    CreateSizeDependentResources();
 }
 
 void DirectXPanelBase::OnSuspending(Object^ sender, SuspendingEventArgs^ e)
@@ -322,31 +547,25 @@ void DirectXPanelBase::OnSuspending(Object^ sender, SuspendingEventArgs^ e)
 
 void DirectXPanelBase::OnSizeChanged(Object^ sender, SizeChangedEventArgs^ e)
 {
-    if (m_width != e->NewSize.Width || m_height != e->NewSize.Height)
+    if (m_requestedSurface.width != e->NewSize.Width || m_requestedSurface.height != e->NewSize.Height)
     {        
-        critical_section::scoped_lock lock(m_criticalSection);
-
-        // Store values so they can be accessed from a background thread.
-        m_width = max(e->NewSize.Width, 1.0f);
-        m_height = max(e->NewSize.Height, 1.0f);
+        m_requestedSurface.width = max(e->NewSize.Width, 1.0f);
+        m_requestedSurface.height = max(e->NewSize.Height, 1.0f);
 
         // Recreate size-dependent resources when the panel's size changes.
-        CreateSizeDependentResources();
+        UpdateSurfaceParameters();
     }
 }
 
 void DirectXPanelBase::OnCompositionScaleChanged(SwapChainPanel ^sender, Object ^args)
 {
-    if (m_compositionScaleX != CompositionScaleX || m_compositionScaleY != CompositionScaleY)
+    if (m_requestedSurface.compositionScaleX != CompositionScaleX || m_requestedSurface.compositionScaleY != CompositionScaleY)
     {        
-        critical_section::scoped_lock lock(m_criticalSection);
-
-        // Store values so they can be accessed from a background thread.
-        m_compositionScaleX = this->CompositionScaleX;
-        m_compositionScaleY = this->CompositionScaleY;
+        m_requestedSurface.compositionScaleX = this->CompositionScaleX;
+        m_requestedSurface.compositionScaleY = this->CompositionScaleY;
         
         // Recreate size-dependent resources when the composition scale changes.
-        CreateSizeDependentResources();
+        UpdateSurfaceParameters();
     }    
 }
 
@@ -6,7 +6,23 @@
 
 #pragma once
 #include "pch.h"
+#include <atomic>
 #include <concrt.h>
+#include <functional>
+#include "DirtyRegion.h"
+#include "FrameScheduler.h"
+
+namespace DX
+{
+    // Size in DIPs and composition scale of a panel's swap chain.
+    struct SurfaceParameters
+    {
+        float width;
+        float height;
+        float compositionScaleX;
+        float compositionScaleY;
+    };
+}
 
 namespace DirectXPanels
 {
@@ -30,6 +46,32 @@ namespace DirectXPanels
         virtual void Render() { };
         virtual void Present();
 
+        // Damage tracking. Panels mark what they change in a frame before calling Present, which passes
+        // the rectangles on to the compositor. A frame that marks nothing is presented in full.
+        void Invalidate(const D2D1_RECT_F& rect);
+        void InvalidateAll();
+
+        // Calls draw once for each area of the back buffer that is out of date, with drawing clipped to
+        // it. Must be called between BeginDraw and EndDraw.
+        void RenderDirtyRegion(const std::function<void()>& draw);
+
+        // Creates a bitmap with the pixel size and DPI of the swap chain that can be used as a render target
+        // and drawn onto the back buffer without scaling.
+        void CreateLayerBitmap(ID2D1Bitmap1** bitmap);
+
+        // Calls frame on a dedicated high priority thread once per display refresh, with m_criticalSection held,
+        // until StopRenderLoop is called. While the loop runs, size and composition scale changes are handed to it
+        // through a mailbox and applied before its next frame, so the UI thread never waits for a frame in progress.
+        void StartRenderLoop(const std::function<void()>& frame);
+        void StopRenderLoop();
+
+        // Frame timing of the render loop over its last few seconds, refreshed a few times a second.
+        // UI thread only.
+        DX::FrameStatistics::Summary GetFrameStatistics();
+
+        void UpdateSurfaceParameters();
+        void ApplySurfaceParameters();
+
         Microsoft::WRL::ComPtr<ID3D11Device1>                               m_d3dDevice;
         Microsoft::WRL::ComPtr<ID3D11DeviceContext1>                        m_d3dContext;
         Microsoft::WRL::ComPtr<IDXGISwapChain2>                             m_swapChain;
@@ -55,5 +97,21 @@ namespace DirectXPanels
         float                                                               m_height;
         float                                                               m_width;
 
+        // Pixels changed in the frame being drawn, and in the last presented frame. With a flip model
+        // swap chain the back buffer holds the frame before last, so both must be redrawn.
+        DX::DirtyRegion                                                     m_dirtyRegion;
+        DX::DirtyRegion                                                     m_presentedDirtyRegion;
+
+        Windows::Foundation::IAsyncAction^                                  m_renderLoopWorker;
+        std::atomic<bool>                                                   m_renderLoopRunning;
+
+        // Surface parameters as last set by the UI thread, and the ones waiting for the render loop.
+        DX::SurfaceParameters                                               m_requestedSurface;
+        DX::Mailbox<DX::SurfaceParameters>                                  m_surfaceMailbox;
+
+        // Published by the render loop, read on the UI thread.
+        DX::Mailbox<DX::FrameStatistics::Summary>                           m_frameStatisticsMailbox;
+        DX::FrameStatistics::Summary                                        m_frameStatistics;
+
     };
 }
\ No newline at end of file
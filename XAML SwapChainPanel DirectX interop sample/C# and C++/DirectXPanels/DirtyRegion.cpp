@@ -0,0 +1,198 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#include "DirtyRegion.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // Extra pixels two rectangles may cover when merged before that costs more than presenting
+    // and clipping to them separately.
+    const int64_t MergeSlack = 64 * 64;
+
+    // Fraction of the surface, in eighths, above which the whole surface is treated as dirty.
+    const int64_t FullThresholdEighths = 6;
+
+    int64_t MergeCost(const DirtyRect& a, const DirtyRect& b)
+    {
+        return a.Union(b).Area() - a.Area() - b.Area();
+    }
+}
+
+DirtyRect DirtyRect::Union(const DirtyRect& other) const
+{
+    if (IsEmpty())
+    {
+        return other;
+    }
+    if (other.IsEmpty())
+    {
+        return *this;
+    }
+    return
+    {
+        std::min(left, other.left),
+        std::min(top, other.top),
+        std::max(right, other.right),
+        std::max(bottom, other.bottom)
+    };
+}
+
+DirtyRect DirtyRect::Intersect(const DirtyRect& other) const
+{
+    return
+    {
+        std::max(left, other.left),
+        std::max(top, other.top),
+        std::min(right, other.right),
+        std::min(bottom, other.bottom)
+    };
+}
+
+DirtyRect DX::DirtyRectFromDips(float left, float top, float right, float bottom, float scaleX, float scaleY, int32_t padding)
+{
+    return
+    {
+        static_cast<int32_t>(std::floor(left * scaleX)) - padding,
+        static_cast<int32_t>(std::floor(top * scaleY)) - padding,
+        static_cast<int32_t>(std::ceil(right * scaleX)) + padding,
+        static_cast<int32_t>(std::ceil(bottom * scaleY)) + padding
+    };
+}
+
+DirtyRegion::DirtyRegion(size_t maxRects) :
+    m_bounds({ 0, 0, 0, 0 }),
+    m_maxRects(std::max<size_t>(maxRects, 1)),
+    m_full(false)
+{
+}
+
+void DirtyRegion::SetBounds(int32_t width, int32_t height)
+{
+    m_bounds = { 0, 0, width, height };
+    AddAll();
+}
+
+void DirtyRegion::Add(const DirtyRect& rect)
+{
+    if (m_full)
+    {
+        return;
+    }
+
+    DirtyRect clipped = rect.Intersect(m_bounds);
+    if (clipped.IsEmpty())
+    {
+        return;
+    }
+
+    Insert(clipped);
+
+    while (m_rects.size() > m_maxRects)
+    {
+        // Merge the cheapest pair and insert the result again, since it may now touch others.
+        size_t bestA = 0;
+        size_t bestB = 1;
+        int64_t bestCost = INT64_MAX;
+        for (size_t a = 0; a < m_rects.size(); a++)
+        {
+            for (size_t b = a + 1; b < m_rects.size(); b++)
+            {
+                int64_t cost = MergeCost(m_rects[a], m_rects[b]);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestA = a;
+                    bestB = b;
+                }
+            }
+        }
+
+        DirtyRect merged = m_rects[bestA].Union(m_rects[bestB]);
+        m_rects.erase(m_rects.begin() + bestB);
+        m_rects.erase(m_rects.begin() + bestA);
+        Insert(merged);
+    }
+
+    if (GetArea() * 8 >= m_bounds.Area() * FullThresholdEighths)
+    {
+        AddAll();
+    }
+}
+
+void DirtyRegion::Add(const DirtyRegion& other)
+{
+    if (other.m_full)
+    {
+        AddAll();
+        return;
+    }
+
+    for (const auto& rect : other.m_rects)
+    {
+        Add(rect);
+    }
+}
+
+void DirtyRegion::AddAll()
+{
+    m_rects.clear();
+    if (!m_bounds.IsEmpty())
+    {
+        m_rects.push_back(m_bounds);
+    }
+    m_full = true;
+}
+
+void DirtyRegion::Clear()
+{
+    m_rects.clear();
+    m_full = false;
+}
+
+int64_t DirtyRegion::GetArea() const
+{
+    // The rectangles never overlap, so their areas add up.
+    int64_t area = 0;
+    for (const auto& rect : m_rects)
+    {
+        area += rect.Area();
+    }
+    return area;
+}
+
+void DirtyRegion::Insert(DirtyRect rect)
+{
+    // Absorb every rectangle the new one overlaps, touches or is cheap to merge with. Growing
+    // the rectangle can bring others into range, so scan again after each merge.
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < m_rects.size(); i++)
+        {
+            if (m_rects[i].Contains(rect))
+            {
+                return;
+            }
+
+            if (m_rects[i].Touches(rect) || MergeCost(m_rects[i], rect) <= MergeSlack)
+            {
+                rect = rect.Union(m_rects[i]);
+                m_rects[i] = m_rects.back();
+                m_rects.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    m_rects.push_back(rect);
+}
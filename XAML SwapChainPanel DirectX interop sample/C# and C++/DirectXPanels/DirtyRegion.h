@@ -0,0 +1,82 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Damage tracking for partial presentation. Has no DXGI dependencies; DirtyRect has the same
+// layout as a Win32 RECT so the rectangles can be passed to IDXGISwapChain1::Present1 as is.
+namespace DX
+{
+    // Pixel rectangle, right and bottom exclusive.
+    struct DirtyRect
+    {
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+
+        bool IsEmpty() const { return right <= left || bottom <= top; }
+        int64_t Area() const { return IsEmpty() ? 0 : static_cast<int64_t>(right - left) * (bottom - top); }
+
+        bool Contains(const DirtyRect& other) const
+        {
+            return left <= other.left && top <= other.top && right >= other.right && bottom >= other.bottom;
+        }
+
+        // True if the rectangles overlap or share an edge.
+        bool Touches(const DirtyRect& other) const
+        {
+            return left <= other.right && other.left <= right && top <= other.bottom && other.top <= bottom;
+        }
+
+        DirtyRect Union(const DirtyRect& other) const;
+        DirtyRect Intersect(const DirtyRect& other) const;
+    };
+
+    // Returns the pixel rectangle covering a rectangle given in DIPs at the given scale, widened
+    // by padding pixels on each side, e.g. for antialiased edges.
+    DirtyRect DirtyRectFromDips(float left, float top, float right, float bottom, float scaleX, float scaleY, int32_t padding);
+
+    // A set of non-overlapping rectangles within a surface.
+    //
+    // Added rectangles are merged with any they overlap or touch, and with any they are close
+    // enough to that the union wastes fewer pixels than the per-rectangle overhead. Past
+    // maxRects, the pair that wastes the least is merged. Once the region covers most of the
+    // surface it becomes the full surface, which is cheaper to present than many rectangles.
+    class DirtyRegion
+    {
+    public:
+        explicit DirtyRegion(size_t maxRects = 8);
+
+        // Sets the surface size, clipping all further rectangles to it, and marks it fully dirty.
+        void SetBounds(int32_t width, int32_t height);
+
+        void Add(const DirtyRect& rect);
+        void Add(const DirtyRegion& other);
+        void AddAll();
+        void Clear();
+
+        bool IsEmpty() const                            { return m_rects.empty(); }
+        bool IsFull() const                             { return m_full; }
+        const std::vector<DirtyRect>& GetRects() const  { return m_rects; }
+        const DirtyRect& GetBounds() const              { return m_bounds; }
+
+        // Pixels covered by the region.
+        int64_t GetArea() const;
+
+    private:
+        void Insert(DirtyRect rect);
+
+        std::vector<DirtyRect>  m_rects;
+        DirtyRect               m_bounds;
+        size_t                  m_maxRects;
+        bool                    m_full;
+    };
+}
@@ -41,11 +41,25 @@ DependencyProperty^ DrawingPanel::m_brushFitsToCurveProperty = nullptr;
 DependencyProperty^ DrawingPanel::m_brushSizeProperty = nullptr;
 DependencyProperty^ DrawingPanel::m_brushIsEraserProperty = nullptr;
 
+// How far past the latest pointer sample to draw predicted ink, in microseconds. A frame drawn now reaches
+// the screen about one refresh later.
+static const uint64_t m_predictionLookahead = 16667;
+
+// Moves shorter than this, in DIPs, are merged into the next segment.
+static const float m_minSegmentLength = 0.5f;
+
 DrawingPanel::DrawingPanel() :
     m_drawingState(DrawingState::Uninitialized),
     m_currentStrokeIndex(0),
     m_currentStrokeSegmentIndex(0),
-    m_activePointerId(0)
+    m_activePointerId(0),
+    m_strokeLayerVersion(0),
+    m_strokeLayerValid(false),
+    m_strokeLayerDirty(InkBounds::Empty()),
+    m_activeStrokeBounds(InkBounds::Empty()),
+    m_frameRequested(false),
+    m_inkActive(false),
+    m_hasPrediction(false)
 {
     critical_section::scoped_lock lock(m_criticalSection);
 
@@ -97,6 +111,7 @@ void DrawingPanel::StartProcessingInput()
         m_inkManager->SetDefaultDrawingAttributes(m_inkDrawingAttributes);
 
         m_drawingState = DrawingState::None;
+        Render();
 
         // The CoreIndependentInputSource will raise pointer events for the specified device types on whichever thread it's created on.
         m_coreInput = CreateCoreIndependentInputSource(
@@ -116,6 +131,12 @@ void DrawingPanel::StartProcessingInput()
 
     // Run task on a dedicated high priority background thread.
     m_inputLoopWorker = ThreadPool::RunAsync(workItemHandler, WorkItemPriority::High, WorkItemOptions::TimeSliced);
+
+    // Draw once per display refresh on a separate thread, so input handling never waits on rendering.
+    StartRenderLoop([this]()
+    {
+        RenderFrame();
+    });
 }
 
 void DrawingPanel::StopProcessingInput()
@@ -123,6 +144,8 @@ void DrawingPanel::StopProcessingInput()
     // A call to ProcessEvents() with the ProcessUntilQuit flag will only return by default when the window closes.
     // Calling StopProcessEvents allows ProcessEvents to return even if the window isn't closing so the background thread can exit.
     m_coreInput->Dispatcher->StopProcessEvents();
+
+    StopRenderLoop();
 }
 
 #pragma region DependencyProperty change handlers
@@ -213,63 +236,118 @@ void DrawingPanel::CreateDeviceResources()
         m_d2dContext->CreateSolidColorBrush(ConvertToColorF(BrushColor), &m_strokeBrush)
         );
 
+    // Cached brushes belong to the previous device. Stroke geometries come from the factory and are kept.
+    m_strokeBrushes.clear();
+
     m_loadingComplete = true;
 }
 
 void DrawingPanel::CreateSizeDependentResources()
 {
-    m_currentBuffer.Reset();
-    m_previousBuffer.Reset();
+    m_strokeLayer.Reset();
 
     DirectXPanelBase::CreateSizeDependentResources();
 
-    ThrowIfFailed(
-        m_swapChain->GetBuffer(
-        0,
-        __uuidof(ID3D11Texture2D),
-        &m_currentBuffer
-        )
-        );
+    // Create the completed stroke layer with the same pixel size and DPI as the swap chain so it
+    // can be copied onto the back buffer without scaling. It is redrawn in full by the next frame.
+    m_strokeLayerValid = false;
+    m_strokeLayerDirty = InkBounds::Empty();
+    m_hasPrediction = false;
 
-    ThrowIfFailed(
-        m_swapChain->GetBuffer(
-        1,
-        __uuidof(ID3D11Texture2D),
-        &m_previousBuffer
-        )
-        );
+    CreateLayerBitmap(&m_strokeLayer);
 }
 
 void DrawingPanel::Render()
 {
-    if (!m_loadingComplete)
+    // Frames are drawn by the render loop; this only requests one, so it can be called from any thread.
+    if (m_drawingState != DrawingState::Uninitialized)
+    {
+        m_frameRequested = true;
+    }
+}
+
+// Draws the live ink queued since the last frame, and the completed strokes if a frame was requested.
+// Called by the render loop with m_criticalSection held.
+void DrawingPanel::RenderFrame()
+{
+    if (m_drawingState == DrawingState::Uninitialized || m_drawingState == DrawingState::Replaying)
     {
         return;
     }
 
-    // Render and present the DirectX content.
+    m_frameSamples.clear();
+    m_pointerSamples.PopAll(m_frameSamples);
+    bool frameRequested = m_frameRequested.exchange(false);
 
-    if (m_drawingState != DrawingState::Uninitialized)
+    // The stroke layer is invalid after the render loop applied a size change.
+    if (!frameRequested && m_frameSamples.empty() && !m_hasPrediction && m_strokeLayerValid)
     {
-        m_coreInput->Dispatcher->RunAsync(CoreDispatcherPriority::Normal, ref new DispatchedHandler([=]()
-        {
-            m_d2dContext->BeginDraw();
+        return;
+    }
+
+    // Last frame's predicted tail is erased, and redrawn below if the stroke continues.
+    if (m_hasPrediction)
+    {
+        Invalidate(m_predictionBounds);
+        m_hasPrediction = false;
+    }
+
+    // The layer must hold the completed strokes before live ink is drawn into it. When a stroke ends,
+    // its live ink is replaced by the stroke the ink manager fitted.
+    if (frameRequested || !m_strokeLayerValid)
+    {
+        UpdateStrokeLayer();
+    }
+    if (RenderActiveStroke())
+    {
+        UpdateStrokeLayer();
+    }
 
-            m_d2dContext->Clear(m_backgroundColor);
+    // Extend the stroke to where the pointer is expected to be when this frame reaches the screen.
+    float predictedX, predictedY;
+    if (m_inkActive && m_predictor.Predict(m_predictionLookahead, predictedX, predictedY))
+    {
+        float halfWidth = BrushSize.Height * 0.5f;
+        m_predictedPoint = Point2F(predictedX, predictedY);
+        m_predictionBounds = RectF(
+            min(m_lastInkPoint.x, predictedX) - halfWidth,
+            min(m_lastInkPoint.y, predictedY) - halfWidth,
+            max(m_lastInkPoint.x, predictedX) + halfWidth,
+            max(m_lastInkPoint.y, predictedY) + halfWidth
+            );
+        m_hasPrediction = true;
+        Invalidate(m_predictionBounds);
+    }
 
-            RenderCompletedStrokes();
+    // Nothing to draw if no strokes changed since the last frame.
+    if (m_dirtyRegion.IsEmpty())
+    {
+        return;
+    }
 
-            HRESULT hr = m_d2dContext->EndDraw();
-            // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
-            // is lost. It will be handled during the next call to Present.
-            if (hr != D2DERR_RECREATE_TARGET)
-            {
-                ThrowIfFailed(hr);
-            }
+    m_d2dContext->BeginDraw();
 
-            Present();
-        }));
+    RenderDirtyRegion([this]()
+    {
+        m_d2dContext->Clear(m_backgroundColor);
+
+        RenderCompletedStrokes();
+
+        if (m_hasPrediction)
+        {
+            m_d2dContext->DrawLine(m_lastInkPoint, m_predictedPoint, m_strokeBrush.Get(), BrushSize.Height, m_inkStrokeStyle.Get());
+        }
+    });
+
+    HRESULT hr = m_d2dContext->EndDraw();
+    // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
+    // is lost. It will be handled during the next call to Present.
+    if (hr != D2DERR_RECREATE_TARGET)
+    {
+        ThrowIfFailed(hr);
     }
+
+    Present();
 }
 
 void DrawingPanel::Update()
@@ -300,6 +378,7 @@ void DrawingPanel::OnPointerPressed(Object^ sender, PointerEventArgs^ e)
         {
             m_drawingState = DrawingState::Inking;
             m_inkManager->Mode = InkManipulationMode::Inking;
+            QueuePointerSample(e->CurrentPoint, PointerSampleKind::Down);
         }
 
         auto pointerPoint = e->CurrentPoint;
@@ -315,9 +394,16 @@ void DrawingPanel::OnPointerMoved(Object^ sender, PointerEventArgs^ e)
 
     if (m_drawingState == DrawingState::Inking && e->CurrentPoint->PointerId == m_activePointerId)
     {
-        critical_section::scoped_lock lock(m_criticalSection);
+        // Queue every sample the pointer reported since the last event, not just the latest, so fast strokes
+        // keep their shape. The render loop draws them on the next frame without waiting for the lock.
+        auto points = e->GetIntermediatePoints();
+        for (unsigned int i = points->Size; i > 0; i--)
+        {
+            // Intermediate points are ordered newest first.
+            QueuePointerSample(points->GetAt(i - 1), PointerSampleKind::Move);
+        }
 
-        RenderActiveStroke(e->CurrentPoint);
+        critical_section::scoped_lock lock(m_criticalSection);
 
         // Pass pointer information to ink manager.        
         m_inkManager->ProcessPointerUpdate(e->CurrentPoint);
@@ -326,14 +412,11 @@ void DrawingPanel::OnPointerMoved(Object^ sender, PointerEventArgs^ e)
     {
         critical_section::scoped_lock lock(m_criticalSection);
 
-        // Pass pointer information to ink manager.        
-        auto invalidatedRect = safe_cast<Windows::Foundation::Rect>(m_inkManager->ProcessPointerUpdate(e->CurrentPoint));
-
-        // Re-render the current scene if any strokes were erased.
-        if (invalidatedRect.Width > 0 && invalidatedRect.Height > 0)
-        {
-            Render();
-        }
+        // Hit-test the eraser's path against the stroke index rather than passing the update to
+        // the ink manager, which tests every stroke. Render() is only called if strokes were erased.
+        Point position = e->CurrentPoint->Position;
+        EraseStrokes(m_previousPoint, position);
+        m_previousPoint = position;
     }
 }
 
@@ -350,11 +433,18 @@ void DrawingPanel::OnPointerReleased(Object^ sender, PointerEventArgs^ e)
     {
         critical_section::scoped_lock lock(m_criticalSection);
 
+        bool wasInking = m_drawingState == DrawingState::Inking;
         m_drawingState = DrawingState::None;
         auto pointerPoint = e->CurrentPoint;
         // Pass pointer information to ink manager.
         m_inkManager->ProcessPointerUp(pointerPoint);
 
+        // Queued after the ink manager has completed the stroke, so the frame that ends the live ink can draw it.
+        if (wasInking)
+        {
+            QueuePointerSample(pointerPoint, PointerSampleKind::Up);
+        }
+
         // Reset active pointer ID.
         m_activePointerId = 0;
 
@@ -399,29 +489,75 @@ void DrawingPanel::OnPointerReleased(Object^ sender, PointerEventArgs^ e)
     }
 }
 
-void DrawingPanel::RenderActiveStroke(PointerPoint^ newPoint)
+void DrawingPanel::QueuePointerSample(PointerPoint^ point, PointerSampleKind kind)
 {
-    // Must be called on the background thread.
+    Point position = point->Position;
+    m_pointerSamples.Push({ position.X, position.Y, point->Timestamp, kind, point->PointerId });
+}
 
-    // While actively inking, copy the last presented buffer to the current buffer since it contains the live ink strokes
-    // drawn in response to previous pointer move events, then draw the current stroke segment.
-    m_d3dContext->CopyResource(m_currentBuffer.Get(), m_previousBuffer.Get());
+// Draws the live ink segments queued since the last frame into the stroke layer. Returns true if a
+// stroke ended, after marking its live ink to be replaced by the completed stroke.
+// Must be called on the render loop thread, outside of BeginDraw/EndDraw.
+bool DrawingPanel::RenderActiveStroke()
+{
+    if (m_frameSamples.empty() || m_strokeLayer == nullptr)
+    {
+        return false;
+    }
+
+    float width = BrushSize.Height;
+    bool strokeEnded = false;
 
+    m_d2dContext->SetTarget(m_strokeLayer.Get());
     m_d2dContext->BeginDraw();
 
-    Point newPosition = newPoint->Position;
+    for (const auto& sample : m_frameSamples)
+    {
+        D2D1_POINT_2F point = Point2F(sample.x, sample.y);
+
+        if (sample.kind == PointerSampleKind::Down)
+        {
+            m_inkActive = true;
+            m_lastInkPoint = point;
+            m_predictor.Reset();
+            m_predictor.AddSample(sample.x, sample.y, sample.timestamp);
+            continue;
+        }
 
-    m_d2dContext->DrawLine(
-        Point2F(m_previousPoint.X, m_previousPoint.Y),
-        Point2F(newPosition.X, newPosition.Y),
-        m_strokeBrush.Get(),
-        BrushSize.Height,
-        m_inkStrokeStyle.Get()
-        );
+        if (!m_inkActive)
+        {
+            continue;
+        }
 
-    m_previousPoint = newPosition;
+        float dx = point.x - m_lastInkPoint.x;
+        float dy = point.y - m_lastInkPoint.y;
+        if (sample.kind == PointerSampleKind::Move && dx * dx + dy * dy < m_minSegmentLength * m_minSegmentLength)
+        {
+            continue;
+        }
+
+        m_d2dContext->DrawLine(m_lastInkPoint, point, m_strokeBrush.Get(), width, m_inkStrokeStyle.Get());
+
+        // Present only the area covered by the new segment.
+        InkBounds segmentBounds = InkBounds::Empty();
+        segmentBounds.Add(DX::InkPoint{ m_lastInkPoint.x, m_lastInkPoint.y });
+        segmentBounds.Add(DX::InkPoint{ point.x, point.y });
+        segmentBounds.Inflate(width * 0.5f);
+        Invalidate(RectF(segmentBounds.left, segmentBounds.top, segmentBounds.right, segmentBounds.bottom));
+        m_activeStrokeBounds.Add(segmentBounds);
+
+        m_lastInkPoint = point;
+        m_predictor.AddSample(sample.x, sample.y, sample.timestamp);
+
+        if (sample.kind == PointerSampleKind::Up)
+        {
+            m_inkActive = false;
+            strokeEnded = true;
+        }
+    }
 
     HRESULT hr = m_d2dContext->EndDraw();
+    m_d2dContext->SetTarget(m_d2dTargetBitmap.Get());
 
     // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
     // is lost. It will be handled during the next call to Present.
@@ -430,30 +566,305 @@ void DrawingPanel::RenderActiveStroke(PointerPoint^ newPoint)
         ThrowIfFailed(hr);
     }
 
-    Present();
+    if (strokeEnded)
+    {
+        m_strokeLayerDirty.Add(m_activeStrokeBounds);
+        m_activeStrokeBounds = InkBounds::Empty();
+    }
+
+    return strokeEnded;
 }
 
 void DrawingPanel::RenderCompletedStrokes(unsigned int strokeCount)
 {
-    // Must be called on the background thread.
+    // Must be called on the background thread, after SyncStrokeStore.
 
-    // Get previous ink strokes from the ink manager up to the given count and render them.
-    auto strokes = m_inkManager->GetStrokes();
+    // When all strokes are requested and the layer is current, a single bitmap copy replaces
+    // drawing every stroke.
+    if (m_strokeLayerValid &&
+        m_strokeLayerVersion == m_strokeStore.GetVersion() &&
+        strokeCount == m_strokeStore.GetStrokeCount())
+    {
+        m_d2dContext->DrawBitmap(m_strokeLayer.Get(), nullptr, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+        return;
+    }
+
+    // Otherwise draw the cached geometries of the strokes up to the given count.
+    if (strokeCount > m_strokeStore.GetStrokeCount())
+    {
+        strokeCount = static_cast<unsigned int>(m_strokeStore.GetStrokeCount());
+    }
 
     for (unsigned int i = 0; i < strokeCount; i++)
+    {
+        RenderStoredStroke(i);
+    }
+}
+
+// Draws one stroke from the stroke store with its cached geometry and brush.
+void DrawingPanel::RenderStoredStroke(size_t strokeIndex)
+{
+    if (m_strokeGeometries[strokeIndex] == nullptr)
+    {
+        return;
+    }
+
+    const InkStrokeInfo& stroke = m_strokeStore.GetStroke(strokeIndex);
+    m_d2dContext->DrawGeometry(
+        m_strokeGeometries[strokeIndex].Get(),
+        GetStrokeBrush(stroke.color),
+        stroke.width,
+        m_inkStrokeStyle.Get()
+        );
+}
+
+// Brings the stroke store up to date with the ink manager. Strokes are only appended (inking, loading)
+// or removed (erasing) and keep their relative order, so merging the two lists finds the changes and
+// only new strokes are tessellated.
+void DrawingPanel::SyncStrokeStore()
+{
+    auto strokes = m_inkManager->GetStrokes();
+    unsigned int strokeCount = strokes->Size;
+
+    // Appending moves the last stroke, so an unchanged count and last stroke mean nothing changed.
+    if (strokeCount == m_storedStrokes.size() &&
+        (strokeCount == 0 || strokes->GetAt(strokeCount - 1) == m_storedStrokes.back()))
+    {
+        return;
+    }
+
+    std::vector<size_t> removed;
+    unsigned int matched = 0;
+    for (size_t i = 0; i < m_storedStrokes.size(); i++)
+    {
+        if (matched < strokeCount && strokes->GetAt(matched) == m_storedStrokes[i])
+        {
+            matched++;
+        }
+        else
+        {
+            removed.push_back(i);
+        }
+    }
+
+    if (!removed.empty())
+    {
+        for (size_t index : removed)
+        {
+            const InkStrokeInfo& stroke = m_strokeStore.GetStroke(index);
+            m_strokeIndex.RemoveStroke(stroke.id);
+            m_strokeLayerDirty.Add(stroke.bounds);
+        }
+
+        m_strokeStore.RemoveStrokes(removed);
+
+        size_t write = 0;
+        size_t nextRemoved = 0;
+        for (size_t i = 0; i < m_storedStrokes.size(); i++)
+        {
+            if (nextRemoved < removed.size() && removed[nextRemoved] == i)
+            {
+                nextRemoved++;
+                continue;
+            }
+            m_storedStrokes[write] = m_storedStrokes[i];
+            m_strokeGeometries[write] = m_strokeGeometries[i];
+            write++;
+        }
+        m_storedStrokes.resize(write);
+        m_strokeGeometries.resize(write);
+    }
+
+    std::vector<DX::InkBezierSegment> segments;
+    std::vector<DX::InkPoint> polyline;
+    for (unsigned int i = matched; i < strokeCount; i++)
     {
         auto stroke = strokes->GetAt(i);
-        ComPtr<ID2D1PathGeometry> strokeGeometry;
-        ConvertStrokeToGeometry(stroke, &strokeGeometry);
+        auto renderingSegments = stroke->GetRenderingSegments();
+        unsigned int segmentCount = renderingSegments->Size;
 
-        // Create brush from current stroke
-        ComPtr<ID2D1SolidColorBrush> strokeBrush;
-        ThrowIfFailed(
-            m_d2dContext->CreateSolidColorBrush(ConvertToColorF(stroke->DrawingAttributes->Color), &strokeBrush)
+        // The first rendering segment only carries the start point; the rest are Bezier segments.
+        DX::InkPoint start = { 0.0f, 0.0f };
+        segments.clear();
+        for (unsigned int j = 0; j < segmentCount; j++)
+        {
+            auto segment = renderingSegments->GetAt(j);
+            if (j == 0)
+            {
+                start = { segment->Position.X, segment->Position.Y };
+                continue;
+            }
+            segments.push_back({
+                { segment->BezierControlPoint1.X, segment->BezierControlPoint1.Y },
+                { segment->BezierControlPoint2.X, segment->BezierControlPoint2.Y },
+                { segment->Position.X, segment->Position.Y }
+            });
+        }
+
+        size_t index = m_strokeStore.AddStroke(
+            start,
+            segments.data(),
+            segments.size(),
+            stroke->DrawingAttributes->Size.Width,
+            ConvertToArgb(stroke->DrawingAttributes->Color)
             );
 
-        m_d2dContext->DrawGeometry(strokeGeometry.Get(), strokeBrush.Get(), stroke->DrawingAttributes->Size.Width, m_inkStrokeStyle.Get());
+        const InkStrokeInfo& stored = m_strokeStore.GetStroke(index);
+        m_strokeLayerDirty.Add(stored.bounds);
+
+        // The spatial index holds the stroke flattened to well under a pixel, for eraser hit testing.
+        polyline.clear();
+        m_strokeStore.FlattenStroke(index, 0.25f, polyline);
+        m_strokeIndex.AddStroke(stored.id, polyline.data(), polyline.size(), stored.width * 0.5f);
+
+        ComPtr<ID2D1PathGeometry> geometry;
+        if (segmentCount > 0)
+        {
+            CreateStrokeGeometry(index, &geometry);
+        }
+
+        m_storedStrokes.push_back(stroke);
+        m_strokeGeometries.push_back(geometry);
+    }
+}
+
+// Redraws the completed stroke layer if the stored strokes have changed since it was last drawn.
+// When the layer is otherwise current, only the region covered by added and removed strokes and
+// by finished live ink is cleared and redrawn. Must be called outside of BeginDraw/EndDraw, since it switches the render target.
+void DrawingPanel::UpdateStrokeLayer()
+{
+    SyncStrokeStore();
+
+    if (m_strokeLayer == nullptr ||
+        (m_strokeLayerValid && m_strokeLayerVersion == m_strokeStore.GetVersion() && m_strokeLayerDirty.IsEmpty()))
+    {
+        return;
+    }
+
+    bool partial = m_strokeLayerValid && !m_strokeLayerDirty.IsEmpty();
+    m_strokeLayerValid = false;
+
+    m_d2dContext->SetTarget(m_strokeLayer.Get());
+    m_d2dContext->BeginDraw();
+
+    if (partial)
+    {
+        // Widen the region by a pixel or so to take in the antialiased edges of the strokes.
+        InkBounds dirty = m_strokeLayerDirty;
+        dirty.Inflate(1.0f);
+
+        m_d2dContext->PushAxisAlignedClip(RectF(dirty.left, dirty.top, dirty.right, dirty.bottom), D2D1_ANTIALIAS_MODE_ALIASED);
+        m_d2dContext->Clear(ColorF(0, 0.0f));
+
+        for (size_t i = 0; i < m_strokeStore.GetStrokeCount(); i++)
+        {
+            if (m_strokeStore.GetStroke(i).bounds.Intersects(dirty))
+            {
+                RenderStoredStroke(i);
+            }
+        }
+
+        m_d2dContext->PopAxisAlignedClip();
+
+        Invalidate(RectF(dirty.left, dirty.top, dirty.right, dirty.bottom));
+    }
+    else
+    {
+        m_d2dContext->Clear(ColorF(0, 0.0f));
+
+        RenderCompletedStrokes(static_cast<unsigned int>(m_strokeStore.GetStrokeCount()));
+
+        InvalidateAll();
     }
+
+    HRESULT hr = m_d2dContext->EndDraw();
+    m_d2dContext->SetTarget(m_d2dTargetBitmap.Get());
+
+    // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
+    // is lost. It will be handled during the next call to Present.
+    if (hr != D2DERR_RECREATE_TARGET)
+    {
+        ThrowIfFailed(hr);
+
+        m_strokeLayerVersion = m_strokeStore.GetVersion();
+        m_strokeLayerValid = true;
+        m_strokeLayerDirty = InkBounds::Empty();
+    }
+}
+
+// Erases the strokes the eraser touched while moving from start to end. Candidate strokes come
+// from the spatial index, so only segments near the eraser are tested.
+// Must be called on the background thread.
+void DrawingPanel::EraseStrokes(Point start, Point end)
+{
+    SyncStrokeStore();
+
+    std::vector<uint32_t> hits;
+    m_strokeIndex.HitTest({ start.X, start.Y }, { end.X, end.Y }, BrushSize.Width * 0.5f, hits);
+    if (hits.empty())
+    {
+        return;
+    }
+
+    for (uint32_t id : hits)
+    {
+        size_t index = m_strokeStore.FindStroke(id);
+        if (index != InkStrokeStore::InvalidIndex)
+        {
+            m_storedStrokes[index]->Selected = true;
+        }
+    }
+
+    // The next SyncStrokeStore sees the deleted strokes and marks their bounds for redrawing.
+    m_inkManager->DeleteSelected();
+
+    Render();
+}
+
+// Builds a path geometry from a stroke's stored Bezier segments.
+void DrawingPanel::CreateStrokeGeometry(size_t strokeIndex, ID2D1PathGeometry** geometry)
+{
+    ThrowIfFailed(
+        m_d2dFactory->CreatePathGeometry(geometry)
+        );
+
+    ComPtr<ID2D1GeometrySink> sink;
+    ThrowIfFailed(
+        (*geometry)->Open(&sink)
+        );
+
+    sink->SetSegmentFlags(D2D1_PATH_SEGMENT_FORCE_ROUND_LINE_JOIN);
+    sink->SetFillMode(D2D1_FILL_MODE_ALTERNATE);
+
+    const DX::InkPoint* points = m_strokeStore.GetStrokePoints(strokeIndex);
+    uint32_t segmentCount = m_strokeStore.GetStroke(strokeIndex).segmentCount;
+
+    sink->BeginFigure(Point2F(points[0].x, points[0].y), D2D1_FIGURE_BEGIN_FILLED);
+
+    // Points are stored as D2D1_BEZIER_SEGMENT lays them out, so the segments are added in one call.
+    static_assert(sizeof(DX::InkBezierSegment) == sizeof(D2D1_BEZIER_SEGMENT), "InkBezierSegment must match D2D1_BEZIER_SEGMENT.");
+    if (segmentCount > 0)
+    {
+        sink->AddBeziers(reinterpret_cast<const D2D1_BEZIER_SEGMENT*>(points + 1), segmentCount);
+    }
+
+    sink->EndFigure(D2D1_FIGURE_END_OPEN);
+    ThrowIfFailed(
+        sink->Close()
+        );
+}
+
+// Returns the cached brush for a 0xAARRGGBB stroke color, creating it on first use.
+ID2D1SolidColorBrush* DrawingPanel::GetStrokeBrush(uint32_t color)
+{
+    auto& brush = m_strokeBrushes[color];
+    if (brush == nullptr)
+    {
+        ThrowIfFailed(
+            m_d2dContext->CreateSolidColorBrush(ColorF(color & 0x00FFFFFF, (color >> 24) / 255.0f), &brush)
+            );
+    }
+    return brush.Get();
 }
 
 // Converts bezier control points in each segment to a path geometry bezier curve.
@@ -547,11 +958,8 @@ void DrawingPanel::BeginStrokesReplayFromStream(IRandomAccessStream^ stream, int
         ComPtr<ID2D1PathGeometry> strokeGeometry;
         ConvertStrokeToGeometry(stroke, m_currentStrokeSegmentIndex, &strokeGeometry);
 
-        // Create brush from stroke
-        ComPtr<ID2D1SolidColorBrush> strokeBrush;
-        ThrowIfFailed(
-            m_d2dContext->CreateSolidColorBrush(ConvertToColorF(stroke->DrawingAttributes->Color), &strokeBrush)
-            );
+        // Completed strokes are drawn from the stroke store.
+        SyncStrokeStore();
 
         m_d2dContext->BeginDraw();
 
@@ -564,7 +972,10 @@ void DrawingPanel::BeginStrokesReplayFromStream(IRandomAccessStream^ stream, int
         }
 
         // Render segments of the current stroke.
-        m_d2dContext->DrawGeometry(strokeGeometry.Get(), strokeBrush.Get(), stroke->DrawingAttributes->Size.Width, m_inkStrokeStyle.Get());
+        m_d2dContext->DrawGeometry(strokeGeometry.Get(), GetStrokeBrush(ConvertToArgb(stroke->DrawingAttributes->Color)), stroke->DrawingAttributes->Size.Width, m_inkStrokeStyle.Get());
+
+        // Replay frames redraw the whole surface.
+        InvalidateAll();
 
         HRESULT hr = m_d2dContext->EndDraw();
 
@@ -7,6 +7,10 @@
 #pragma once
 #include "pch.h"
 #include "DirectXPanelBase.h"
+#include "InkSpatialIndex.h"
+#include "InkStrokeStore.h"
+#include "PointerInput.h"
+#include <unordered_map>
 
 namespace DirectXPanels
 {
@@ -142,10 +146,19 @@ namespace DirectXPanels
         void OnPointerMoved(Platform::Object^ sender, Windows::UI::Core::PointerEventArgs^ e);
         void OnPointerReleased(Platform::Object^ sender, Windows::UI::Core::PointerEventArgs^ e);
 
-        void RenderActiveStroke(Windows::UI::Input::PointerPoint^ newPoint);
+        void QueuePointerSample(Windows::UI::Input::PointerPoint^ point, DX::PointerSampleKind kind);
+        void RenderFrame();
+        bool RenderActiveStroke();
         void RenderCompletedStrokes(unsigned int strokeCount);
         inline void RenderCompletedStrokes() { RenderCompletedStrokes(m_inkManager->GetStrokes()->Size); }
 
+        void SyncStrokeStore();
+        void UpdateStrokeLayer();
+        void RenderStoredStroke(size_t strokeIndex);
+        void EraseStrokes(Windows::Foundation::Point start, Windows::Foundation::Point end);
+        void CreateStrokeGeometry(size_t strokeIndex, ID2D1PathGeometry** geometry);
+        ID2D1SolidColorBrush* GetStrokeBrush(uint32_t color);
+
         void ConvertStrokeToGeometry(Windows::UI::Input::Inking::InkStroke^ stroke, unsigned int segmentCount, ID2D1PathGeometry** geometry);
         inline void ConvertStrokeToGeometry(Windows::UI::Input::Inking::InkStroke^ stroke, ID2D1PathGeometry** geometry) { ConvertStrokeToGeometry(stroke, stroke->GetRenderingSegments()->Size, geometry); }
 
@@ -169,19 +182,45 @@ namespace DirectXPanels
         Windows::UI::Core::CoreIndependentInputSource^						m_coreInput;
         Windows::Foundation::IAsyncAction^									m_inputLoopWorker;
 
-        Microsoft::WRL::ComPtr<ID3D11Texture2D>                             m_currentBuffer;
-        Microsoft::WRL::ComPtr<ID3D11Texture2D>                             m_previousBuffer;
-
         Microsoft::WRL::ComPtr<ID2D1StrokeStyle>                            m_inkStrokeStyle;
         Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>                        m_strokeBrush;
 
         Windows::UI::Input::Inking::InkManager^								m_inkManager;
         Windows::UI::Input::Inking::InkDrawingAttributes^					m_inkDrawingAttributes;
         Windows::Foundation::Point                                          m_previousPoint;
+        DX::InkBounds                                                       m_activeStrokeBounds;
         unsigned int                                                        m_activePointerId;
 
         Windows::System::Threading::ThreadPoolTimer^                        m_replayTimer;
         unsigned int                                                        m_currentStrokeIndex;
         unsigned int                                                        m_currentStrokeSegmentIndex;
+
+        // Completed strokes, tessellated once when they are added to the ink manager. Entries in
+        // m_storedStrokes and m_strokeGeometries line up with the strokes in m_strokeStore.
+        DX::InkStrokeStore                                                  m_strokeStore;
+        std::vector<Windows::UI::Input::Inking::InkStroke^>                 m_storedStrokes;
+        std::vector<Microsoft::WRL::ComPtr<ID2D1PathGeometry>>              m_strokeGeometries;
+        std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>> m_strokeBrushes;
+        DX::InkSpatialIndex                                                 m_strokeIndex;
+
+        // All completed strokes drawn over a transparent background, redrawn only when m_strokeStore
+        // changes. m_strokeLayerDirty covers the strokes added or removed since the last redraw.
+        Microsoft::WRL::ComPtr<ID2D1Bitmap1>                                m_strokeLayer;
+        uint64_t                                                            m_strokeLayerVersion;
+        bool                                                                m_strokeLayerValid;
+        DX::InkBounds                                                       m_strokeLayerDirty;
+
+        // Live ink. The input thread queues pointer samples and requests frames; the render thread draws
+        // the new segments into m_strokeLayer, where they stay until the completed stroke replaces them,
+        // and draws a predicted tail on the back buffer only.
+        DX::PointerSampleBuffer                                             m_pointerSamples;
+        std::atomic<bool>                                                   m_frameRequested;
+        std::vector<DX::PointerSample>                                      m_frameSamples;
+        DX::PointerPredictor                                                m_predictor;
+        bool                                                                m_inkActive;
+        D2D1_POINT_2F                                                       m_lastInkPoint;
+        bool                                                                m_hasPrediction;
+        D2D1_POINT_2F                                                       m_predictedPoint;
+        D2D1_RECT_F                                                         m_predictionBounds;
     };
 }
\ No newline at end of file
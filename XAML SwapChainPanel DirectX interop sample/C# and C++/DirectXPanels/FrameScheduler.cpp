@@ -0,0 +1,165 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace DX;
+
+namespace
+{
+    // Bounds for how early the deadline timer wakes from sleep to yield until the deadline. The
+    // amount adapts to how far the system's sleeps overshoot, which ranges from tens of
+    // microseconds to a full timer tick.
+    const uint64_t MinSleepSlack = 500;
+    const uint64_t MaxSleepSlack = 16000;
+}
+
+FrameStatistics::FrameStatistics()
+{
+    Reset();
+}
+
+void FrameStatistics::AddFrame(uint64_t interval, uint64_t workTime)
+{
+    m_intervals[m_next] = interval;
+    m_workTimes[m_next] = workTime;
+    m_next = (m_next + 1) % WindowSize;
+    m_count = std::min(m_count + 1, WindowSize);
+    m_frameCount++;
+}
+
+void FrameStatistics::Reset()
+{
+    m_count = 0;
+    m_next = 0;
+    m_frameCount = 0;
+}
+
+FrameStatistics::Summary FrameStatistics::GetSummary() const
+{
+    Summary summary = {};
+    summary.frameCount = m_frameCount;
+    if (m_count == 0)
+    {
+        return summary;
+    }
+
+    uint64_t intervals[WindowSize];
+    uint64_t intervalTotal = 0;
+    uint64_t workTotal = 0;
+    for (size_t i = 0; i < m_count; i++)
+    {
+        intervals[i] = m_intervals[i];
+        intervalTotal += m_intervals[i];
+        workTotal += m_workTimes[i];
+    }
+
+    std::sort(intervals, intervals + m_count);
+    summary.averageInterval = static_cast<double>(intervalTotal) / m_count;
+    summary.averageWorkTime = static_cast<double>(workTotal) / m_count;
+    summary.medianInterval = intervals[m_count / 2];
+    summary.p99Interval = intervals[std::min(m_count - 1, m_count * 99 / 100)];
+    summary.maxInterval = intervals[m_count - 1];
+
+    // A frame that took about two intervals or more showed the previous image twice.
+    uint64_t missedThreshold = summary.medianInterval + summary.medianInterval / 2;
+    summary.missedFrameCount = static_cast<uint64_t>(intervals + m_count - std::upper_bound(intervals, intervals + m_count, missedThreshold));
+
+    return summary;
+}
+
+FramePacer::FramePacer(uint64_t interval) :
+    m_now(&FramePacer::Now),
+    m_sleep(&FramePacer::Sleep),
+    m_interval(interval),
+    m_nextDeadline(0),
+    m_missedDeadlines(0),
+    m_sleepSlack(MinSleepSlack)
+{
+}
+
+uint64_t FramePacer::Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void FramePacer::Sleep(uint64_t microseconds)
+{
+    if (microseconds == 0)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+    }
+}
+
+void FramePacer::SetClock(const std::function<uint64_t()>& now, const std::function<void(uint64_t)>& sleep)
+{
+    m_now = now;
+    m_sleep = sleep;
+    m_nextDeadline = 0;
+}
+
+uint64_t FramePacer::WaitForNextFrame()
+{
+    if (m_wait && m_wait())
+    {
+        // Keep the deadline timer in phase with the display in case it has to take over.
+        uint64_t now = m_now();
+        m_nextDeadline = now + m_interval;
+        return now;
+    }
+
+    uint64_t now = m_now();
+    if (m_nextDeadline == 0)
+    {
+        m_nextDeadline = now;
+    }
+
+    if (now <= m_nextDeadline)
+    {
+        WaitUntil(m_nextDeadline);
+        now = m_now();
+        m_nextDeadline += m_interval;
+        return now;
+    }
+
+    // The previous frame ran past this frame's deadline. Start now, and move the next deadline
+    // to the next slot on the grid rather than trying to make up the slots that were missed.
+    uint64_t late = (now - m_nextDeadline) / m_interval;
+    m_missedDeadlines += late;
+    m_nextDeadline += (late + 1) * m_interval;
+    return now;
+}
+
+void FramePacer::WaitUntil(uint64_t deadline)
+{
+    // Sleep until shortly before the deadline, then yield until it passes. Sleeps can wake late
+    // by up to a timer tick, so the margin follows the largest recent overshoot, decaying
+    // slowly so that one slow wake doesn't keep the thread yielding for long.
+    uint64_t start = m_now();
+    if (deadline > start + m_sleepSlack)
+    {
+        uint64_t requested = deadline - start - m_sleepSlack;
+        m_sleep(requested);
+
+        uint64_t slept = m_now() - start;
+        uint64_t overshoot = slept > requested ? slept - requested : 0;
+        m_sleepSlack = std::max(m_sleepSlack - m_sleepSlack / 16, overshoot + overshoot / 4);
+        m_sleepSlack = std::min(std::max(m_sleepSlack, MinSleepSlack), MaxSleepSlack);
+    }
+
+    while (m_now() < deadline)
+    {
+        m_sleep(0);
+    }
+}
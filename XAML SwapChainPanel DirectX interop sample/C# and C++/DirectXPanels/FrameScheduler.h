@@ -0,0 +1,147 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Render loop scheduling: frame pacing, frame time statistics and a mailbox for handing state
+// to the render thread. Has no DXGI or WinRT dependencies, so it can be built and tested on
+// any platform.
+namespace DX
+{
+    // Passes the latest value of some state from one producer thread to one consumer thread
+    // without locks. A value posted before the previous one was taken replaces it, so the
+    // consumer only ever sees the newest state. Both sides are wait-free.
+    template<typename T>
+    class Mailbox
+    {
+    public:
+        Mailbox() :
+            m_back(0),
+            m_shared(1),
+            m_front(2)
+        {
+        }
+
+        // Producer only.
+        void Post(const T& value)
+        {
+            m_slots[m_back] = value;
+            unsigned int previous = m_shared.exchange(m_back | FreshBit, std::memory_order_acq_rel);
+            m_back = previous & IndexMask;
+        }
+
+        // Consumer only. Returns false if nothing was posted since the last call.
+        bool Take(T& value)
+        {
+            if ((m_shared.load(std::memory_order_relaxed) & FreshBit) == 0)
+            {
+                return false;
+            }
+
+            unsigned int previous = m_shared.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & IndexMask;
+            value = m_slots[m_front];
+            return true;
+        }
+
+    private:
+        static const unsigned int IndexMask = 3;
+        static const unsigned int FreshBit = 4;
+
+        // Three slots: one owned by each side and one being handed over, whose index is in
+        // m_shared along with whether it holds a value the consumer hasn't taken yet.
+        T                           m_slots[3];
+        unsigned int                m_back;
+        std::atomic<unsigned int>   m_shared;
+        unsigned int                m_front;
+    };
+
+    // Frame intervals and work times over a sliding window of recent frames. Times are in
+    // microseconds.
+    class FrameStatistics
+    {
+    public:
+        struct Summary
+        {
+            uint64_t    frameCount;         // Frames recorded since the last Reset.
+            uint64_t    missedFrameCount;   // Frames in the window that took over 1.5 times the median interval.
+            double      averageInterval;
+            uint64_t    medianInterval;
+            uint64_t    p99Interval;
+            uint64_t    maxInterval;
+            double      averageWorkTime;
+        };
+
+        static const size_t WindowSize = 256;
+
+        FrameStatistics();
+
+        // interval is the time since the previous frame started; workTime is how long this
+        // frame took from its start until it was handed to the display.
+        void AddFrame(uint64_t interval, uint64_t workTime);
+
+        void Reset();
+
+        uint64_t GetFrameCount() const { return m_frameCount; }
+
+        // Sorts a copy of the window, so meant to be called a few times a second at most.
+        Summary GetSummary() const;
+
+    private:
+        uint64_t    m_intervals[WindowSize];
+        uint64_t    m_workTimes[WindowSize];
+        size_t      m_count;
+        size_t      m_next;
+        uint64_t    m_frameCount;
+    };
+
+    // Decides when each frame starts. With a wait function, such as one that waits for the
+    // display's vertical blank, frames follow the display. Otherwise, or while the wait function
+    // fails, a deadline timer starts frames at a fixed interval on a fixed grid, so a late frame
+    // doesn't shift every frame after it and a long stall doesn't cause a burst of catch-up frames.
+    class FramePacer
+    {
+    public:
+        // interval is the deadline timer's frame interval in microseconds.
+        explicit FramePacer(uint64_t interval = 16667);
+
+        // wait blocks until the next frame should start and returns false if it can't.
+        void SetWaitFunction(const std::function<bool()>& wait) { m_wait = wait; }
+        void SetInterval(uint64_t interval)                      { m_interval = interval; }
+
+        // Replaces the clock the deadline timer reads and the function it sleeps with, so that it
+        // can run against a simulated clock. now returns microseconds on a monotonic clock, and
+        // sleep blocks for about the given number of microseconds, or yields when given zero.
+        void SetClock(const std::function<uint64_t()>& now, const std::function<void(uint64_t)>& sleep);
+
+        // Blocks until the next frame should start and returns the time it started.
+        uint64_t WaitForNextFrame();
+
+        // Deadline timer slots that passed while the previous frame was still running.
+        uint64_t GetMissedDeadlineCount() const { return m_missedDeadlines; }
+
+        // Microseconds on a monotonic clock. The default clock of the deadline timer.
+        static uint64_t Now();
+
+    private:
+        static void Sleep(uint64_t microseconds);
+
+        void WaitUntil(uint64_t deadline);
+
+        std::function<bool()>           m_wait;
+        std::function<uint64_t()>       m_now;
+        std::function<void(uint64_t)>   m_sleep;
+        uint64_t                        m_interval;
+        uint64_t                        m_nextDeadline;
+        uint64_t                        m_missedDeadlines;
+        uint64_t                        m_sleepSlack;
+    };
+}
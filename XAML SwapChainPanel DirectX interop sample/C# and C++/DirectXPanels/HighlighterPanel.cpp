@@ -35,9 +35,22 @@ using namespace D2D1;
 using namespace DirectXPanels;
 using namespace DX;
 
+// Width of the highlighter ink, in DIPs.
+static const float m_inkWidth = 10.0f;
+
+// How far past the latest pointer sample to draw predicted ink, in microseconds. A frame drawn now reaches
+// the screen about one refresh later.
+static const uint64_t m_predictionLookahead = 16667;
+
+// Moves shorter than this, in DIPs, are merged into the next segment.
+static const float m_minSegmentLength = 0.5f;
+
 HighlighterPanel::HighlighterPanel() :
     m_drawingState(DrawingState::None),
-    m_activePointerId(0)
+    m_activePointerId(0),
+    m_inkActive(false),
+    m_redrawRequested(false),
+    m_hasPrediction(false)
 {
     // Set alpha mode to premultiplied to enable transparency.
     m_alphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
@@ -76,6 +89,12 @@ void HighlighterPanel::StartProcessingInput()
 
     // Run task on a dedicated high priority background thread.
     m_inputLoopWorker = ThreadPool::RunAsync(workItemHandler, WorkItemPriority::High, WorkItemOptions::TimeSliced);
+
+    // Draw the queued input once per display refresh on a separate thread, so input handling never waits on rendering.
+    StartRenderLoop([this]()
+    {
+        RenderInk();
+    });
 }
 
 void HighlighterPanel::StopProcessingInput()
@@ -83,6 +102,8 @@ void HighlighterPanel::StopProcessingInput()
     // A call to ProcessEvents() with the ProcessUntilQuit flag will only return by default when the window closes.
     // Calling StopProcessEvents allows ProcessEvents to return even if the window isn't closing so the background thread can exit.
     m_coreInput->Dispatcher->StopProcessEvents();
+
+    StopRenderLoop();
 }
 
 void HighlighterPanel::CreateDeviceResources()
@@ -115,26 +136,29 @@ void HighlighterPanel::CreateDeviceResources()
 
 void HighlighterPanel::CreateSizeDependentResources()
 {
-    m_currentBuffer.Reset();
-    m_previousBuffer.Reset();
+    m_inkLayer.Reset();
 
     DirectXPanelBase::CreateSizeDependentResources();
 
-    ThrowIfFailed(
-        m_swapChain->GetBuffer(
-        0,
-        __uuidof(ID3D11Texture2D),
-        &m_currentBuffer
-        )
-        );
+    // Create the ink layer and clear it, since a new bitmap has undefined content.
+    CreateLayerBitmap(&m_inkLayer);
 
-    ThrowIfFailed(
-        m_swapChain->GetBuffer(
-        1,
-        __uuidof(ID3D11Texture2D),
-        &m_previousBuffer
-        )
-        );
+    m_d2dContext->SetTarget(m_inkLayer.Get());
+    m_d2dContext->BeginDraw();
+    m_d2dContext->Clear(ColorF(0, 0.0f));
+    HRESULT hr = m_d2dContext->EndDraw();
+    m_d2dContext->SetTarget(m_d2dTargetBitmap.Get());
+
+    // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
+    // is lost. It will be handled during the next call to Present.
+    if (hr != D2DERR_RECREATE_TARGET)
+    {
+        ThrowIfFailed(hr);
+    }
+
+    // The render loop redraws the surface if it applied this change.
+    m_hasPrediction = false;
+    m_redrawRequested = true;
 }
 
 void HighlighterPanel::Render()
@@ -151,8 +175,12 @@ void HighlighterPanel::Render()
     // Note that in this simple example, the strokes the user has drawn are not preserved when the panel's size changes or when the device is lost.  
     // For an example of preserving strokes, see the DrawingPanel implemention used in Scenario2.
 
-    // Clear the surface with a transparent background color.
+    // Clear the surface with a transparent background color and draw the ink layer over it.
     m_d2dContext->Clear(m_backgroundColor);
+    m_d2dContext->DrawBitmap(m_inkLayer.Get(), nullptr, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+    m_hasPrediction = false;
+    m_redrawRequested = false;
+    InvalidateAll();
 
     HRESULT hr = m_d2dContext->EndDraw();
 
@@ -173,43 +201,131 @@ void HighlighterPanel::OnPointerPressed(Object^ sender, PointerEventArgs^ e)
         m_drawingState == DrawingState::None)
     {
         m_drawingState = DrawingState::Inking;
-        m_previousPoint = e->CurrentPoint->Position;
         // Store active pointer ID: only one contact can be inking at a time.
         m_activePointerId = e->CurrentPoint->PointerId;
+
+        QueuePointerSample(e->CurrentPoint, PointerSampleKind::Down);
     }
 }
 
 void HighlighterPanel::OnPointerMoved(Object^ sender, PointerEventArgs^ e)
 {
-    if (!m_loadingComplete)
+    // Handle the PointerMoved event, which will be raised on a background thread.
+
+    if (m_drawingState == DrawingState::Inking && e->CurrentPoint->PointerId == m_activePointerId)
     {
-        return;
+        // Queue every sample the pointer reported since the last event, not just the latest, so fast strokes
+        // keep their shape. The render thread picks them up on the next frame; nothing is drawn here.
+        auto points = e->GetIntermediatePoints();
+        for (unsigned int i = points->Size; i > 0; i--)
+        {
+            // Intermediate points are ordered newest first.
+            QueuePointerSample(points->GetAt(i - 1), PointerSampleKind::Move);
+        }
     }
+}
 
-    // Handle the PointerMoved event, which will be raised on a background thread.
+void HighlighterPanel::OnPointerReleased(Object^ sender, PointerEventArgs^ e)
+{
+    // Handle the PointerReleased event, which will be raised on a background thread.
 
-    if (m_drawingState == DrawingState::Inking && e->CurrentPoint->PointerId == m_activePointerId)
+    if (e->CurrentPoint->Properties->PointerUpdateKind == PointerUpdateKind::RightButtonReleased)
     {
-        critical_section::scoped_lock lock(m_criticalSection);
+        // When right-clicks are unhandled on the background thread, the platform can use them for AppBar invocation.
+        e->Handled = false;
+    }
+    else if (m_drawingState == DrawingState::Inking)
+    {
+        QueuePointerSample(e->CurrentPoint, PointerSampleKind::Up);
 
-        auto pointerPosition = e->CurrentPoint->Position;
+        m_drawingState = DrawingState::None;
+        // Reset active pointer ID.
+        m_activePointerId = 0;
+    }
+}
 
-        // While actively inking, copy the back buffer to the active buffer then draw the current stroke segment.
-        m_d3dContext->CopyResource(m_currentBuffer.Get(), m_previousBuffer.Get());
+void HighlighterPanel::QueuePointerSample(PointerPoint^ point, PointerSampleKind kind)
+{
+    Point position = point->Position;
+    m_pointerSamples.Push({ position.X, position.Y, point->Timestamp, kind, point->PointerId });
+}
 
-        m_d2dContext->BeginDraw();
+// Draws the pointer samples queued since the last frame and presents the area they changed.
+// Called by the render loop with m_criticalSection held.
+void HighlighterPanel::RenderInk()
+{
+    m_frameSamples.clear();
+    m_pointerSamples.PopAll(m_frameSamples);
 
-        m_d2dContext->DrawLine(
-            D2D1::Point2F(m_previousPoint.X, m_previousPoint.Y),
-            D2D1::Point2F(pointerPosition.X, pointerPosition.Y),
-            m_strokeBrush.Get(),
-            10.0f,
-            m_inkStrokeStyle.Get()
-            );
+    if (m_frameSamples.empty() && !m_hasPrediction && !m_redrawRequested)
+    {
+        return;
+    }
+
+    if (m_redrawRequested)
+    {
+        InvalidateAll();
+        m_redrawRequested = false;
+    }
+
+    // Last frame's predicted tail is erased, and redrawn below if the stroke continues.
+    if (m_hasPrediction)
+    {
+        Invalidate(m_predictionBounds);
+        m_hasPrediction = false;
+    }
 
-        m_previousPoint = pointerPosition;
+    // Draw every new segment into the ink layer in one pass.
+    if (!m_frameSamples.empty())
+    {
+        m_d2dContext->SetTarget(m_inkLayer.Get());
+        m_d2dContext->BeginDraw();
+
+        for (const auto& sample : m_frameSamples)
+        {
+            D2D1_POINT_2F point = Point2F(sample.x, sample.y);
+
+            if (sample.kind == PointerSampleKind::Down)
+            {
+                m_inkActive = true;
+                m_lastInkPoint = point;
+                m_predictor.Reset();
+                m_predictor.AddSample(sample.x, sample.y, sample.timestamp);
+                continue;
+            }
+
+            if (!m_inkActive)
+            {
+                continue;
+            }
+
+            float dx = point.x - m_lastInkPoint.x;
+            float dy = point.y - m_lastInkPoint.y;
+            if (sample.kind == PointerSampleKind::Move && dx * dx + dy * dy < m_minSegmentLength * m_minSegmentLength)
+            {
+                continue;
+            }
+
+            m_d2dContext->DrawLine(m_lastInkPoint, point, m_strokeBrush.Get(), m_inkWidth, m_inkStrokeStyle.Get());
+
+            Invalidate(RectF(
+                min(m_lastInkPoint.x, point.x) - m_inkWidth * 0.5f,
+                min(m_lastInkPoint.y, point.y) - m_inkWidth * 0.5f,
+                max(m_lastInkPoint.x, point.x) + m_inkWidth * 0.5f,
+                max(m_lastInkPoint.y, point.y) + m_inkWidth * 0.5f
+                ));
+
+            m_lastInkPoint = point;
+            m_predictor.AddSample(sample.x, sample.y, sample.timestamp);
+
+            if (sample.kind == PointerSampleKind::Up)
+            {
+                m_inkActive = false;
+            }
+        }
 
         HRESULT hr = m_d2dContext->EndDraw();
+        m_d2dContext->SetTarget(m_d2dTargetBitmap.Get());
 
         // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
         // is lost. It will be handled during the next call to Present.
@@ -217,25 +333,50 @@ void HighlighterPanel::OnPointerMoved(Object^ sender, PointerEventArgs^ e)
         {
             ThrowIfFailed(hr);
         }
-        Present();
     }
-}
 
-void HighlighterPanel::OnPointerReleased(Object^ sender, PointerEventArgs^ e)
-{
-    // Handle the PointerReleased event, which will be raised on a background thread.
+    // Extend the stroke to where the pointer is expected to be when this frame reaches the screen.
+    float predictedX, predictedY;
+    if (m_inkActive && m_predictor.Predict(m_predictionLookahead, predictedX, predictedY))
+    {
+        m_predictedPoint = Point2F(predictedX, predictedY);
+        m_predictionBounds = RectF(
+            min(m_lastInkPoint.x, predictedX) - m_inkWidth * 0.5f,
+            min(m_lastInkPoint.y, predictedY) - m_inkWidth * 0.5f,
+            max(m_lastInkPoint.x, predictedX) + m_inkWidth * 0.5f,
+            max(m_lastInkPoint.y, predictedY) + m_inkWidth * 0.5f
+            );
+        m_hasPrediction = true;
+        Invalidate(m_predictionBounds);
+    }
 
-    if (e->CurrentPoint->Properties->PointerUpdateKind == PointerUpdateKind::RightButtonReleased)
+    if (m_dirtyRegion.IsEmpty())
     {
-        // When right-clicks are unhandled on the background thread, the platform can use them for AppBar invocation.
-        e->Handled = false;
+        return;
     }
-    else if (m_drawingState == DrawingState::Inking)
+
+    m_d2dContext->BeginDraw();
+
+    RenderDirtyRegion([this]()
     {
-        m_drawingState = DrawingState::None;
-        // Reset active pointer ID.
-        m_activePointerId = 0;
+        m_d2dContext->Clear(m_backgroundColor);
+        m_d2dContext->DrawBitmap(m_inkLayer.Get(), nullptr, 1.0f, D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR);
+
+        if (m_hasPrediction)
+        {
+            m_d2dContext->DrawLine(m_lastInkPoint, m_predictedPoint, m_strokeBrush.Get(), m_inkWidth, m_inkStrokeStyle.Get());
+        }
+    });
+
+    HRESULT hr = m_d2dContext->EndDraw();
+
+    // We ignore D2DERR_RECREATE_TARGET here. This error indicates that the device
+    // is lost. It will be handled during the next call to Present.
+    if (hr != D2DERR_RECREATE_TARGET)
+    {
+        ThrowIfFailed(hr);
     }
+    Present();
 }
 
 void HighlighterPanel::OnDeviceLost()
@@ -7,13 +7,14 @@
 #pragma once
 #include "pch.h"
 #include "DirectXPanelBase.h"
+#include "PointerInput.h"
 
 namespace DirectXPanels
 {
     // Hosts a DirectX rendering surface that supports drawing yellow ink.  If a MinBlend composite mode is applied to the panel, this will simulate a
-    // highlighter effect. Ink is drawn in response to user input and does not synchronize with the vertical blanking interval, providing the lowest 
-    // possible latency while drawing at the cost of additional CPU and GPU work. The content is not preserved, so it may disappear on suspend or
-    // if the DirectX device is recreated.
+    // highlighter effect. Pointer samples are queued by the input thread and drawn once per display refresh by a render thread, which extends
+    // the ink to where the pointer is predicted to be when the frame is shown. The content is not preserved, so it may disappear if the panel
+    // is resized or the DirectX device is recreated.
 
     [Windows::Foundation::Metadata::WebHostHidden]
     public ref class HighlighterPanel sealed : public DirectXPanels::DirectXPanelBase
@@ -43,18 +44,32 @@ namespace DirectXPanels
         void OnPointerMoved(Platform::Object^ sender, Windows::UI::Core::PointerEventArgs^ e);
         void OnPointerReleased(Platform::Object^ sender, Windows::UI::Core::PointerEventArgs^ e);
 
+        void QueuePointerSample(Windows::UI::Input::PointerPoint^ point, DX::PointerSampleKind kind);
+        void RenderInk();
+
         DrawingState                                                        m_drawingState;
         
         Windows::UI::Core::CoreIndependentInputSource^                      m_coreInput;
         Windows::Foundation::IAsyncAction^                                  m_inputLoopWorker;
 
-        Microsoft::WRL::ComPtr<ID3D11Texture2D>                             m_currentBuffer;
-        Microsoft::WRL::ComPtr<ID3D11Texture2D>                             m_previousBuffer;
-
         Microsoft::WRL::ComPtr<ID2D1StrokeStyle>                            m_inkStrokeStyle;
         Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>                        m_strokeBrush;
 
-        Windows::Foundation::Point                                          m_previousPoint;
         unsigned int                                                        m_activePointerId;
+
+        // Written by the input thread, read by the render thread.
+        DX::PointerSampleBuffer                                             m_pointerSamples;
+
+        // Render thread state. The ink drawn so far is kept in m_inkLayer; the predicted tail is drawn
+        // on the back buffer only and replaced every frame.
+        Microsoft::WRL::ComPtr<ID2D1Bitmap1>                                m_inkLayer;
+        std::vector<DX::PointerSample>                                      m_frameSamples;
+        DX::PointerPredictor                                                m_predictor;
+        bool                                                                m_inkActive;
+        bool                                                                m_redrawRequested;
+        D2D1_POINT_2F                                                       m_lastInkPoint;
+        bool                                                                m_hasPrediction;
+        D2D1_POINT_2F                                                       m_predictedPoint;
+        D2D1_RECT_F                                                         m_predictionBounds;
     };
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#include "InkSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // Limits the cells one rectangle may cover, so a stray huge coordinate cannot stall the
+    // input thread. Anything larger is clamped to this many cells per side around its start.
+    const int32_t MaxCellsPerSide = 1024;
+
+    inline int32_t CellCoordinate(float value, float inverseCellSize)
+    {
+        return static_cast<int32_t>(std::floor(value * inverseCellSize));
+    }
+
+    inline uint64_t CellKey(int32_t x, int32_t y)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    inline float Cross(InkPoint origin, InkPoint a, InkPoint b)
+    {
+        return (a.x - origin.x) * (b.y - origin.y) - (a.y - origin.y) * (b.x - origin.x);
+    }
+}
+
+InkSpatialIndex::InkSpatialIndex(float cellSize) :
+    m_cellSize(cellSize),
+    m_inverseCellSize(1.0f / cellSize),
+    m_segmentCount(0)
+{
+}
+
+template<typename TFunction>
+void InkSpatialIndex::ForEachCell(float left, float top, float right, float bottom, TFunction function) const
+{
+    int32_t x0 = CellCoordinate(left, m_inverseCellSize);
+    int32_t y0 = CellCoordinate(top, m_inverseCellSize);
+    int32_t x1 = std::min(CellCoordinate(right, m_inverseCellSize), x0 + MaxCellsPerSide - 1);
+    int32_t y1 = std::min(CellCoordinate(bottom, m_inverseCellSize), y0 + MaxCellsPerSide - 1);
+
+    for (int32_t y = y0; y <= y1; y++)
+    {
+        for (int32_t x = x0; x <= x1; x++)
+        {
+            function(CellKey(x, y));
+        }
+    }
+}
+
+void InkSpatialIndex::AddStroke(uint32_t strokeId, const InkPoint* points, size_t pointCount, float halfWidth)
+{
+    std::vector<uint64_t>& strokeCells = m_strokeCells[strokeId].cells;
+
+    // A single point is stored as a zero-length segment so that dots can be erased too.
+    size_t segmentCount = pointCount > 1 ? pointCount - 1 : pointCount;
+    for (size_t i = 0; i < segmentCount; i++)
+    {
+        Segment segment = { strokeId, halfWidth, points[i], points[std::min(i + 1, pointCount - 1)] };
+
+        ForEachCell(
+            std::min(segment.start.x, segment.end.x) - halfWidth,
+            std::min(segment.start.y, segment.end.y) - halfWidth,
+            std::max(segment.start.x, segment.end.x) + halfWidth,
+            std::max(segment.start.y, segment.end.y) + halfWidth,
+            [&](uint64_t key)
+        {
+            m_cells[key].push_back(segment);
+            strokeCells.push_back(key);
+        });
+    }
+    m_strokeCells[strokeId].segmentCount += segmentCount;
+    m_segmentCount += segmentCount;
+
+    std::sort(strokeCells.begin(), strokeCells.end());
+    strokeCells.erase(std::unique(strokeCells.begin(), strokeCells.end()), strokeCells.end());
+}
+
+void InkSpatialIndex::RemoveStroke(uint32_t strokeId)
+{
+    auto strokeCells = m_strokeCells.find(strokeId);
+    if (strokeCells == m_strokeCells.end())
+    {
+        return;
+    }
+
+    for (uint64_t key : strokeCells->second.cells)
+    {
+        auto cell = m_cells.find(key);
+        if (cell == m_cells.end())
+        {
+            continue;
+        }
+
+        auto& segments = cell->second;
+        auto removed = std::remove_if(segments.begin(), segments.end(), [strokeId](const Segment& segment)
+        {
+            return segment.strokeId == strokeId;
+        });
+        segments.erase(removed, segments.end());
+
+        if (segments.empty())
+        {
+            m_cells.erase(cell);
+        }
+    }
+
+    m_segmentCount -= strokeCells->second.segmentCount;
+    m_strokeCells.erase(strokeCells);
+}
+
+void InkSpatialIndex::Clear()
+{
+    m_cells.clear();
+    m_strokeCells.clear();
+    m_segmentCount = 0;
+}
+
+void InkSpatialIndex::HitTest(InkPoint start, InkPoint end, float radius, std::vector<uint32_t>& strokeIds) const
+{
+    size_t firstResult = strokeIds.size();
+
+    ForEachCell(
+        std::min(start.x, end.x) - radius,
+        std::min(start.y, end.y) - radius,
+        std::max(start.x, end.x) + radius,
+        std::max(start.y, end.y) + radius,
+        [&](uint64_t key)
+    {
+        auto cell = m_cells.find(key);
+        if (cell == m_cells.end())
+        {
+            return;
+        }
+
+        for (const Segment& segment : cell->second)
+        {
+            float reach = radius + segment.halfWidth;
+            if (SegmentDistanceSquared(start, end, segment.start, segment.end) <= reach * reach)
+            {
+                strokeIds.push_back(segment.strokeId);
+            }
+        }
+    });
+
+    // A stroke is usually hit through several segments and cells.
+    std::sort(strokeIds.begin() + firstResult, strokeIds.end());
+    strokeIds.erase(std::unique(strokeIds.begin() + firstResult, strokeIds.end()), strokeIds.end());
+}
+
+float DX::PointSegmentDistanceSquared(InkPoint point, InkPoint start, InkPoint end)
+{
+    float dx = end.x - start.x;
+    float dy = end.y - start.y;
+    float lengthSquared = dx * dx + dy * dy;
+
+    float t = 0.0f;
+    if (lengthSquared > 0.0f)
+    {
+        t = ((point.x - start.x) * dx + (point.y - start.y) * dy) / lengthSquared;
+        t = std::min(std::max(t, 0.0f), 1.0f);
+    }
+
+    float x = start.x + t * dx - point.x;
+    float y = start.y + t * dy - point.y;
+    return x * x + y * y;
+}
+
+float DX::SegmentDistanceSquared(InkPoint start0, InkPoint end0, InkPoint start1, InkPoint end1)
+{
+    // Segments that properly cross are zero apart; otherwise the closest pair of points
+    // includes an end point of one of them.
+    float d0 = Cross(start0, end0, start1);
+    float d1 = Cross(start0, end0, end1);
+    float d2 = Cross(start1, end1, start0);
+    float d3 = Cross(start1, end1, end0);
+    if (((d0 > 0.0f && d1 < 0.0f) || (d0 < 0.0f && d1 > 0.0f)) &&
+        ((d2 > 0.0f && d3 < 0.0f) || (d2 < 0.0f && d3 > 0.0f)))
+    {
+        return 0.0f;
+    }
+
+    return std::min(
+        std::min(PointSegmentDistanceSquared(start0, start1, end1), PointSegmentDistanceSquared(end0, start1, end1)),
+        std::min(PointSegmentDistanceSquared(start1, start0, end0), PointSegmentDistanceSquared(end1, start0, end0))
+        );
+}
@@ -0,0 +1,74 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "InkStrokeStore.h"
+
+namespace DX
+{
+    // Uniform grid over the line segments of flattened ink strokes, used to find the strokes an
+    // eraser touches without testing every segment. Each segment is filed under every cell its
+    // bounding box, widened by half the stroke width, overlaps.
+    //
+    // Not thread safe; the owner serializes access.
+    class InkSpatialIndex
+    {
+    public:
+        // cellSize is in the same units as the stroke points. A few times the typical segment
+        // length keeps both the cells per segment and the segments per cell low.
+        explicit InkSpatialIndex(float cellSize = 64.0f);
+
+        // Adds the polyline of a stroke. Hits are measured from the stroke's edge, halfWidth
+        // away from its center line.
+        void AddStroke(uint32_t strokeId, const InkPoint* points, size_t pointCount, float halfWidth);
+        void RemoveStroke(uint32_t strokeId);
+        void Clear();
+
+        // Appends to strokeIds, sorted and without duplicates, the ids of strokes that come within
+        // radius of the segment from start to end.
+        void HitTest(InkPoint start, InkPoint end, float radius, std::vector<uint32_t>& strokeIds) const;
+
+        size_t GetSegmentCount() const { return m_segmentCount; }
+
+    private:
+        struct Segment
+        {
+            uint32_t    strokeId;
+            float       halfWidth;
+            InkPoint    start;
+            InkPoint    end;
+        };
+
+        // The cells a stroke was filed under, so it can be removed without a full scan.
+        struct StrokeCells
+        {
+            size_t                  segmentCount;
+            std::vector<uint64_t>   cells;
+        };
+
+        // Calls function with the key of every cell the rectangle overlaps.
+        template<typename TFunction>
+        void ForEachCell(float left, float top, float right, float bottom, TFunction function) const;
+
+        float                                               m_cellSize;
+        float                                               m_inverseCellSize;
+        std::unordered_map<uint64_t, std::vector<Segment>>  m_cells;
+        std::unordered_map<uint32_t, StrokeCells>           m_strokeCells;
+        size_t                                              m_segmentCount;
+    };
+
+    // Squared distance from point to the segment from start to end.
+    float PointSegmentDistanceSquared(InkPoint point, InkPoint start, InkPoint end);
+
+    // Squared distance between the closest points of two segments; zero if they cross.
+    float SegmentDistanceSquared(InkPoint start0, InkPoint end0, InkPoint start1, InkPoint end1);
+}
@@ -0,0 +1,176 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#include "InkStrokeStore.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // Upper bound on the pieces a single Bezier segment is split into, so a degenerate
+    // tolerance cannot produce an unbounded polyline.
+    const int MaxFlattenSegments = 64;
+
+    InkPoint Evaluate(InkPoint p0, InkPoint p1, InkPoint p2, InkPoint p3, float t)
+    {
+        float u = 1.0f - t;
+        float b0 = u * u * u;
+        float b1 = 3.0f * u * u * t;
+        float b2 = 3.0f * u * t * t;
+        float b3 = t * t * t;
+        return
+        {
+            b0 * p0.x + b1 * p1.x + b2 * p2.x + b3 * p3.x,
+            b0 * p0.y + b1 * p1.y + b2 * p2.y + b3 * p3.y
+        };
+    }
+}
+
+InkStrokeStore::InkStrokeStore() :
+    m_version(0),
+    m_nextId(1)
+{
+}
+
+size_t InkStrokeStore::AddStroke(InkPoint start, const InkBezierSegment* segments, size_t segmentCount, float width, uint32_t color)
+{
+    InkStrokeInfo stroke;
+    stroke.id = m_nextId++;
+    stroke.firstPoint = static_cast<uint32_t>(m_points.size());
+    stroke.segmentCount = static_cast<uint32_t>(segmentCount);
+    stroke.width = width;
+    stroke.color = color;
+    stroke.bounds = InkBounds::Empty();
+
+    // A Bezier curve lies inside the hull of its control points, so their bounds contain the stroke.
+    m_points.push_back(start);
+    stroke.bounds.Add(start);
+    for (size_t i = 0; i < segmentCount; i++)
+    {
+        m_points.push_back(segments[i].control1);
+        m_points.push_back(segments[i].control2);
+        m_points.push_back(segments[i].end);
+        stroke.bounds.Add(segments[i].control1);
+        stroke.bounds.Add(segments[i].control2);
+        stroke.bounds.Add(segments[i].end);
+    }
+    stroke.bounds.Inflate(width * 0.5f);
+
+    m_strokes.push_back(stroke);
+    m_version++;
+    return m_strokes.size() - 1;
+}
+
+void InkStrokeStore::RemoveStrokes(const std::vector<size_t>& sortedIndices)
+{
+    if (sortedIndices.empty())
+    {
+        return;
+    }
+
+    // Compact strokes and points in place, moving each kept stroke down over the removed ones.
+    size_t nextRemoved = 0;
+    size_t strokeWrite = 0;
+    uint32_t pointWrite = 0;
+    for (size_t i = 0; i < m_strokes.size(); i++)
+    {
+        if (nextRemoved < sortedIndices.size() && sortedIndices[nextRemoved] == i)
+        {
+            nextRemoved++;
+            continue;
+        }
+
+        InkStrokeInfo stroke = m_strokes[i];
+        uint32_t pointCount = 1 + 3 * stroke.segmentCount;
+        if (stroke.firstPoint != pointWrite)
+        {
+            std::copy(
+                m_points.begin() + stroke.firstPoint,
+                m_points.begin() + stroke.firstPoint + pointCount,
+                m_points.begin() + pointWrite
+                );
+            stroke.firstPoint = pointWrite;
+        }
+        pointWrite += pointCount;
+        m_strokes[strokeWrite++] = stroke;
+    }
+
+    m_strokes.resize(strokeWrite);
+    m_points.resize(pointWrite);
+    m_version++;
+}
+
+void InkStrokeStore::Clear()
+{
+    m_strokes.clear();
+    m_points.clear();
+    m_version++;
+}
+
+size_t InkStrokeStore::FindStroke(uint32_t id) const
+{
+    // Ids increase in drawing order and removal keeps that order, so the strokes are sorted by id.
+    auto stroke = std::lower_bound(m_strokes.begin(), m_strokes.end(), id, [](const InkStrokeInfo& info, uint32_t value)
+    {
+        return info.id < value;
+    });
+
+    if (stroke == m_strokes.end() || stroke->id != id)
+    {
+        return InvalidIndex;
+    }
+    return static_cast<size_t>(stroke - m_strokes.begin());
+}
+
+InkBounds InkStrokeStore::GetBounds() const
+{
+    InkBounds bounds = InkBounds::Empty();
+    for (const auto& stroke : m_strokes)
+    {
+        bounds.Add(stroke.bounds);
+    }
+    return bounds;
+}
+
+size_t InkStrokeStore::FlattenStroke(size_t index, float tolerance, std::vector<InkPoint>& points) const
+{
+    const InkStrokeInfo& stroke = m_strokes[index];
+    const InkPoint* p = m_points.data() + stroke.firstPoint;
+    size_t initialSize = points.size();
+
+    points.push_back(p[0]);
+    for (uint32_t i = 0; i < stroke.segmentCount; i++, p += 3)
+    {
+        FlattenBezier(p[0], p[1], p[2], p[3], tolerance, points);
+    }
+    return points.size() - initialSize;
+}
+
+void DX::FlattenBezier(InkPoint p0, InkPoint p1, InkPoint p2, InkPoint p3, float tolerance, std::vector<InkPoint>& points)
+{
+    // Split into n equal steps of t, where n bounds the distance between the curve and its
+    // chords by the largest second difference of the control points (Wang's formula).
+    float ddx = std::max(std::fabs(p0.x - 2.0f * p1.x + p2.x), std::fabs(p1.x - 2.0f * p2.x + p3.x));
+    float ddy = std::max(std::fabs(p0.y - 2.0f * p1.y + p2.y), std::fabs(p1.y - 2.0f * p2.y + p3.y));
+    float dd = std::sqrt(ddx * ddx + ddy * ddy);
+
+    int n = 1;
+    if (tolerance > 0.0f && dd > 0.0f)
+    {
+        n = static_cast<int>(std::ceil(std::sqrt(0.75f * dd / tolerance)));
+        n = std::min(std::max(n, 1), MaxFlattenSegments);
+    }
+
+    float step = 1.0f / n;
+    for (int i = 1; i < n; i++)
+    {
+        points.push_back(Evaluate(p0, p1, p2, p3, i * step));
+    }
+    points.push_back(p3);
+}
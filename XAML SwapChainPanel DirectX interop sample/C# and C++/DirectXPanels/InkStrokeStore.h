@@ -0,0 +1,143 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Retained storage for completed ink strokes. Has no WinRT or Direct2D dependencies, so it
+// can be built and measured on any platform.
+namespace DX
+{
+    struct InkPoint
+    {
+        float x;
+        float y;
+    };
+
+    // One cubic Bezier segment, continuing from the end point of the previous segment.
+    struct InkBezierSegment
+    {
+        InkPoint control1;
+        InkPoint control2;
+        InkPoint end;
+    };
+
+    // Axis-aligned rectangle. Empty when right < left.
+    struct InkBounds
+    {
+        float left;
+        float top;
+        float right;
+        float bottom;
+
+        static InkBounds Empty() { return { 0.0f, 0.0f, -1.0f, -1.0f }; }
+
+        bool IsEmpty() const { return right < left || bottom < top; }
+
+        bool Intersects(const InkBounds& other) const
+        {
+            return !IsEmpty() && !other.IsEmpty() &&
+                left <= other.right && other.left <= right &&
+                top <= other.bottom && other.top <= bottom;
+        }
+
+        void Add(InkPoint point)
+        {
+            if (IsEmpty())
+            {
+                left = right = point.x;
+                top = bottom = point.y;
+                return;
+            }
+            if (point.x < left) left = point.x;
+            if (point.x > right) right = point.x;
+            if (point.y < top) top = point.y;
+            if (point.y > bottom) bottom = point.y;
+        }
+
+        void Add(const InkBounds& other)
+        {
+            if (!other.IsEmpty())
+            {
+                Add(InkPoint{ other.left, other.top });
+                Add(InkPoint{ other.right, other.bottom });
+            }
+        }
+
+        void Inflate(float amount)
+        {
+            if (!IsEmpty())
+            {
+                left -= amount;
+                top -= amount;
+                right += amount;
+                bottom += amount;
+            }
+        }
+    };
+
+    // A stored stroke. Its points are the start point followed by three points (two control
+    // points and an end point) per Bezier segment.
+    struct InkStrokeInfo
+    {
+        uint32_t    id;         // Unique within the store and increasing in drawing order.
+        uint32_t    firstPoint;
+        uint32_t    segmentCount;
+        float       width;
+        uint32_t    color;      // 0xAARRGGBB
+        InkBounds   bounds;     // Control point hull inflated by half the width.
+    };
+
+    // Completed strokes in drawing order. The points of all strokes share one array, so a
+    // stroke costs 24 bytes per segment plus one InkStrokeInfo.
+    //
+    // Not thread safe; the owner serializes access.
+    class InkStrokeStore
+    {
+    public:
+        InkStrokeStore();
+
+        // Appends a stroke and returns its index.
+        size_t AddStroke(InkPoint start, const InkBezierSegment* segments, size_t segmentCount, float width, uint32_t color);
+
+        // Removes the strokes at the given indices, which must be sorted ascending, in one pass.
+        void RemoveStrokes(const std::vector<size_t>& sortedIndices);
+
+        void Clear();
+
+        size_t GetStrokeCount() const                       { return m_strokes.size(); }
+        const InkStrokeInfo& GetStroke(size_t index) const  { return m_strokes[index]; }
+        const InkPoint* GetStrokePoints(size_t index) const { return m_points.data() + m_strokes[index].firstPoint; }
+
+        // Returns the index of the stroke with the given id, or InvalidIndex if it was removed.
+        size_t FindStroke(uint32_t id) const;
+        static const size_t InvalidIndex = static_cast<size_t>(-1);
+
+        // Union of all stroke bounds.
+        InkBounds GetBounds() const;
+
+        // Incremented by every change, so caches built from the store can tell when they are stale.
+        uint64_t GetVersion() const                         { return m_version; }
+
+        // Appends the stroke as a polyline to points, subdividing each Bezier segment until it
+        // is within tolerance of the curve. Returns the number of points appended.
+        size_t FlattenStroke(size_t index, float tolerance, std::vector<InkPoint>& points) const;
+
+    private:
+        std::vector<InkStrokeInfo>  m_strokes;
+        std::vector<InkPoint>       m_points;
+        uint64_t                    m_version;
+        uint32_t                    m_nextId;
+    };
+
+    // Appends the cubic Bezier from p0 through p1, p2 to p3 as line segments to points, not
+    // including p0. The number of segments is chosen from the control polygon so that the
+    // polyline stays within tolerance of the curve.
+    void FlattenBezier(InkPoint p0, InkPoint p1, InkPoint p2, InkPoint p3, float tolerance, std::vector<InkPoint>& points);
+}
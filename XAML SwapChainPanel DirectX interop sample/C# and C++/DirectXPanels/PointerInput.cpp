@@ -0,0 +1,213 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#include "PointerInput.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // Samples closer together than this, in microseconds, are treated as one when estimating
+    // velocity; some digitizers report bursts with identical timestamps.
+    const double MinSampleInterval = 500.0;
+
+    // Fits velocity, in units per microsecond, to samples by least squares over time.
+    bool FitVelocity(const float* x, const float* y, const double* t, size_t count, double& vx, double& vy)
+    {
+        if (count < 2)
+        {
+            return false;
+        }
+
+        double meanT = 0.0, meanX = 0.0, meanY = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            meanT += t[i];
+            meanX += x[i];
+            meanY += y[i];
+        }
+        meanT /= count;
+        meanX /= count;
+        meanY /= count;
+
+        double stt = 0.0, stx = 0.0, sty = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            double dt = t[i] - meanT;
+            stt += dt * dt;
+            stx += dt * (x[i] - meanX);
+            sty += dt * (y[i] - meanY);
+        }
+
+        if (stt < MinSampleInterval * MinSampleInterval)
+        {
+            return false;
+        }
+
+        vx = stx / stt;
+        vy = sty / stt;
+        return true;
+    }
+}
+
+PointerSampleBuffer::PointerSampleBuffer(size_t capacity) :
+    m_write(0),
+    m_read(0),
+    m_dropped(0)
+{
+    size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    m_samples.resize(size);
+    m_mask = size - 1;
+}
+
+bool PointerSampleBuffer::Push(const PointerSample& sample)
+{
+    uint64_t write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) >= m_samples.size())
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_samples[static_cast<size_t>(write) & m_mask] = sample;
+    m_write.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+size_t PointerSampleBuffer::PopAll(std::vector<PointerSample>& samples)
+{
+    uint64_t read = m_read.load(std::memory_order_relaxed);
+    uint64_t write = m_write.load(std::memory_order_acquire);
+
+    for (uint64_t i = read; i < write; i++)
+    {
+        samples.push_back(m_samples[static_cast<size_t>(i) & m_mask]);
+    }
+
+    m_read.store(write, std::memory_order_release);
+    return static_cast<size_t>(write - read);
+}
+
+PointerPredictor::PointerPredictor() :
+    m_count(0),
+    m_next(0),
+    m_maxLookahead(25000),
+    m_maxDistance(24.0f)
+{
+}
+
+void PointerPredictor::Reset()
+{
+    m_count = 0;
+    m_next = 0;
+}
+
+void PointerPredictor::SetLimits(uint64_t maxLookahead, float maxDistance)
+{
+    m_maxLookahead = maxLookahead;
+    m_maxDistance = maxDistance;
+}
+
+void PointerPredictor::AddSample(float x, float y, uint64_t timestamp)
+{
+    m_history[m_next] = { x, y, timestamp };
+    m_next = (m_next + 1) % HistorySize;
+    m_count = std::min(m_count + 1, HistorySize);
+}
+
+bool PointerPredictor::Predict(uint64_t lookahead, float& x, float& y) const
+{
+    if (m_count < 3)
+    {
+        return false;
+    }
+
+    // Unpack the history oldest first, with times relative to the latest sample.
+    float hx[HistorySize];
+    float hy[HistorySize];
+    double ht[HistorySize];
+    size_t first = (m_next + HistorySize - m_count) % HistorySize;
+    const Sample& latest = m_history[(m_next + HistorySize - 1) % HistorySize];
+    for (size_t i = 0; i < m_count; i++)
+    {
+        const Sample& sample = m_history[(first + i) % HistorySize];
+        hx[i] = sample.x;
+        hy[i] = sample.y;
+        ht[i] = static_cast<double>(sample.timestamp) - static_cast<double>(latest.timestamp);
+    }
+
+    double vx, vy;
+    if (!FitVelocity(hx, hy, ht, m_count, vx, vy))
+    {
+        return false;
+    }
+
+    // A pen that is stopping shows it first in the latest interval, which the fit lags behind.
+    // Trust that interval alone when it is much slower than the fit.
+    double lastInterval = ht[m_count - 1] - ht[m_count - 2];
+    bool stopping = false;
+    if (lastInterval >= MinSampleInterval)
+    {
+        double lx = (hx[m_count - 1] - hx[m_count - 2]) / lastInterval;
+        double ly = (hy[m_count - 1] - hy[m_count - 2]) / lastInterval;
+        if (lx * lx + ly * ly < 0.25 * (vx * vx + vy * vy))
+        {
+            vx = lx;
+            vy = ly;
+            stopping = true;
+        }
+    }
+
+    // Acceleration from the change in velocity between the older and newer halves of the history.
+    double ax = 0.0, ay = 0.0;
+    size_t half = m_count / 2;
+    double v0x, v0y, v1x, v1y;
+    if (!stopping && half >= 2 &&
+        FitVelocity(hx, hy, ht, half + 1, v0x, v0y) &&
+        FitVelocity(hx + half, hy + half, ht + half, m_count - half, v1x, v1y))
+    {
+        double span = (ht[m_count - 1] + ht[half]) * 0.5 - (ht[half] + ht[0]) * 0.5;
+        if (span > 0.0)
+        {
+            ax = (v1x - v0x) / span;
+            ay = (v1y - v0y) / span;
+        }
+
+        // Deceleration strong enough to reverse direction within the lookahead is more likely a
+        // stop than a turn, so keep just the velocity.
+        if (ax * vx + ay * vy < 0.0)
+        {
+            ax = 0.0;
+            ay = 0.0;
+        }
+    }
+
+    double dt = static_cast<double>(std::min(lookahead, m_maxLookahead));
+    double dx = vx * dt + 0.5 * ax * dt * dt;
+    double dy = vy * dt + 0.5 * ay * dt * dt;
+
+    double distance = std::sqrt(dx * dx + dy * dy);
+    if (distance < 1e-3)
+    {
+        return false;
+    }
+    if (distance > m_maxDistance)
+    {
+        dx *= m_maxDistance / distance;
+        dy *= m_maxDistance / distance;
+    }
+
+    x = latest.x + static_cast<float>(dx);
+    y = latest.y + static_cast<float>(dy);
+    return true;
+}
@@ -0,0 +1,99 @@
+﻿//*********************************************************
+//
+// Copyright (c) Microsoft. All rights reserved.
+//
+//*********************************************************
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pointer sample queueing and prediction for ink rendering. Has no WinRT dependencies, so it can
+// be built and tested on any platform.
+namespace DX
+{
+    enum class PointerSampleKind : uint32_t
+    {
+        Down,
+        Move,
+        Up
+    };
+
+    struct PointerSample
+    {
+        float               x;
+        float               y;
+        uint64_t            timestamp;  // Microseconds, as in PointerPoint::Timestamp.
+        PointerSampleKind   kind;
+        uint32_t            pointerId;
+    };
+
+    // Single-producer, single-consumer queue of pointer samples. The input thread pushes every
+    // sample as it arrives; the render thread takes all queued samples once per frame. Neither
+    // side blocks or allocates.
+    class PointerSampleBuffer
+    {
+    public:
+        // capacity is rounded up to a power of two.
+        explicit PointerSampleBuffer(size_t capacity = 256);
+
+        // Producer only. Returns false, dropping the sample, if the consumer has fallen a full
+        // buffer behind.
+        bool Push(const PointerSample& sample);
+
+        // Consumer only. Appends every queued sample to samples, oldest first, and returns how many.
+        size_t PopAll(std::vector<PointerSample>& samples);
+
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<PointerSample>  m_samples;
+        size_t                      m_mask;
+
+        // Kept on separate cache lines so the two threads don't contend on them.
+        alignas(64) std::atomic<uint64_t>   m_write;
+        alignas(64) std::atomic<uint64_t>   m_read;
+        std::atomic<uint64_t>               m_dropped;
+    };
+
+    // Extrapolates where a pointer will be a short time after its latest sample, so ink can be
+    // drawn ahead of the pen to hide a frame of latency. Velocity is fitted over the last few
+    // samples and acceleration over their first and second halves. The prediction is limited in
+    // time and distance so that a sudden stop or turn overshoots by at most a few pixels.
+    class PointerPredictor
+    {
+    public:
+        PointerPredictor();
+
+        // Starts a new stroke.
+        void Reset();
+
+        void AddSample(float x, float y, uint64_t timestamp);
+
+        // Predicts the position lookahead microseconds after the latest sample. Returns false if
+        // there is too little history or the pointer is not moving.
+        bool Predict(uint64_t lookahead, float& x, float& y) const;
+
+        // Largest prediction, in microseconds and in the units of the samples.
+        void SetLimits(uint64_t maxLookahead, float maxDistance);
+
+    private:
+        struct Sample
+        {
+            float       x;
+            float       y;
+            uint64_t    timestamp;
+        };
+
+        static const size_t HistorySize = 6;
+
+        Sample      m_history[HistorySize];
+        size_t      m_count;
+        size_t      m_next;
+        uint64_t    m_maxLookahead;
+        float       m_maxDistance;
+    };
+}
@@ -0,0 +1,61 @@
+#include "DirtyRegion.h"
+
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace DX;
+
+BENCHMARK(DirtyRegionInkFrame)
+{
+    // A frame of ink on a 2560 x 1440 surface: a pen stroke adds a run of small overlapping
+    // rectangles along its path, and an eraser elsewhere adds a few larger ones.
+    std::vector<DirtyRect> rects;
+    for (int32_t i = 0; i < 24; i++)
+    {
+        rects.push_back({ 400 + i * 6, 300 + i * 2, 400 + i * 6 + 12, 300 + i * 2 + 12 });
+    }
+    for (int32_t i = 0; i < 4; i++)
+    {
+        rects.push_back({ 1800 + i * 20, 900, 1800 + i * 20 + 40, 940 });
+    }
+
+    DirtyRegion region;
+    region.SetBounds(2560, 1440);
+    size_t rectCount = 0;
+    int64_t area = 0;
+    double stroke = TestSupport::MeasureNanoseconds(static_cast<double>(rects.size()), [&]
+    {
+        region.Clear();
+        for (const DirtyRect& rect : rects)
+        {
+            region.Add(rect);
+        }
+        rectCount = region.GetRects().size();
+        area = region.GetArea();
+    });
+
+    // Scattered rectangles that can't be merged cheaply, so every Add past the eighth runs the
+    // pairwise merge.
+    std::vector<DirtyRect> scattered;
+    for (int32_t i = 0; i < 64; i++)
+    {
+        int32_t x = (i * 397) % 2500;
+        int32_t y = (i * 211) % 1400;
+        scattered.push_back({ x, y, x + 8, y + 8 });
+    }
+    double worst = TestSupport::MeasureNanoseconds(static_cast<double>(scattered.size()), [&]
+    {
+        region.Clear();
+        for (const DirtyRect& rect : scattered)
+        {
+            region.Add(rect);
+        }
+        TestSupport::DoNotOptimize(region.GetRects().size());
+    });
+
+    TestSupport::Report("Add, pen and eraser frame", stroke, "ns/rect");
+    TestSupport::Report("Add, pen and eraser frame, rectangles presented", static_cast<double>(rectCount), "rects");
+    TestSupport::Report("Add, pen and eraser frame, share of surface", 100.0 * area / (2560.0 * 1440.0), "%");
+    TestSupport::Report("Add, 64 scattered rectangles over the limit", worst, "ns/rect");
+}
@@ -0,0 +1,223 @@
+#include "DirtyRegion.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    struct Random
+    {
+        uint32_t state;
+
+        explicit Random(uint32_t seed) : state(seed) {}
+
+        int32_t Next(int32_t low, int32_t high)
+        {
+            state = state * 1664525u + 1013904223u;
+            return low + static_cast<int32_t>((state >> 8) % static_cast<uint32_t>(high - low + 1));
+        }
+    };
+
+    bool Covers(const DirtyRegion& region, int32_t x, int32_t y)
+    {
+        for (const DirtyRect& rect : region.GetRects())
+        {
+            if (x >= rect.left && x < rect.right && y >= rect.top && y < rect.bottom)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Disjoint(const DirtyRegion& region)
+    {
+        const std::vector<DirtyRect>& rects = region.GetRects();
+        for (size_t a = 0; a < rects.size(); a++)
+        {
+            for (size_t b = a + 1; b < rects.size(); b++)
+            {
+                if (!rects[a].Intersect(rects[b]).IsEmpty())
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(DirtyRectArithmetic)
+{
+    DirtyRect a = { 0, 0, 10, 10 };
+    DirtyRect b = { 10, 5, 20, 15 };
+    CHECK_EQUAL(100, a.Area());
+    CHECK(a.Touches(b));
+    CHECK(a.Intersect(b).IsEmpty());
+    CHECK(!a.Touches({ 11, 0, 20, 10 }));
+
+    DirtyRect both = a.Union(b);
+    CHECK(both.left == 0 && both.top == 0 && both.right == 20 && both.bottom == 15);
+    CHECK(both.Contains(a) && both.Contains(b) && !a.Contains(both));
+
+    DirtyRect empty = { 5, 5, 5, 9 };
+    CHECK(empty.IsEmpty());
+    CHECK_EQUAL(0, empty.Area());
+    DirtyRect same = a.Union(empty);
+    CHECK(same.left == 0 && same.right == 10 && same.bottom == 10);
+
+    // DIPs to pixels rounds outward before padding.
+    DirtyRect pixels = DirtyRectFromDips(10.2f, 20.7f, 30.1f, 40.0f, 1.5f, 2.0f, 1);
+    CHECK(pixels.left == 14 && pixels.top == 40 && pixels.right == 47 && pixels.bottom == 81);
+}
+
+TEST_CASE(DirtyRegionMergesTouchingAndNearbyRectangles)
+{
+    DirtyRegion region;
+    region.SetBounds(1000, 1000);
+    CHECK(region.IsFull());
+    CHECK_EQUAL(1u, region.GetRects().size());
+    region.Clear();
+    CHECK(region.IsEmpty() && !region.IsFull());
+
+    // Far apart, they stay separate; sharing an edge, they merge.
+    region.Add({ 0, 0, 10, 10 });
+    region.Add({ 500, 500, 510, 510 });
+    CHECK_EQUAL(2u, region.GetRects().size());
+    region.Add({ 10, 0, 20, 10 });
+    CHECK_EQUAL(2u, region.GetRects().size());
+    CHECK_EQUAL(300, region.GetArea());
+
+    // A rectangle already covered changes nothing, and one a few pixels away is cheaper to merge.
+    region.Add({ 2, 2, 8, 8 });
+    CHECK_EQUAL(300, region.GetArea());
+    region.Add({ 515, 500, 525, 510 });
+    CHECK_EQUAL(2u, region.GetRects().size());
+    CHECK_EQUAL(450, region.GetArea());
+
+    // Rectangles are clipped to the surface, and ones entirely outside it are ignored.
+    region.Add({ 990, 990, 1100, 1100 });
+    region.Add({ -50, 2000, -10, 2100 });
+    CHECK_EQUAL(550, region.GetArea());
+    CHECK(Disjoint(region));
+}
+
+TEST_CASE(DirtyRegionKeepsToTheRectangleLimit)
+{
+    DirtyRegion region;
+    region.SetBounds(8000, 8000);
+    region.Clear();
+
+    // A 10 x 10 grid of rectangles too far apart to merge cheaply: only eight may be kept.
+    for (int32_t y = 0; y < 10; y++)
+    {
+        for (int32_t x = 0; x < 10; x++)
+        {
+            region.Add({ x * 300, y * 300, x * 300 + 100, y * 300 + 100 });
+            CHECK(region.GetRects().size() <= 8);
+            CHECK(Disjoint(region));
+        }
+    }
+    CHECK_EQUAL(8u, region.GetRects().size());
+    CHECK(!region.IsFull());
+
+    DirtyRegion small(3);
+    small.SetBounds(4000, 4000);
+    small.Clear();
+    for (int32_t i = 0; i < 6; i++)
+    {
+        small.Add({ i * 600, i * 600, i * 600 + 4, i * 600 + 4 });
+    }
+    CHECK_EQUAL(3u, small.GetRects().size());
+}
+
+TEST_CASE(DirtyRegionBecomesFullPastThreeQuarters)
+{
+    DirtyRegion region;
+    region.SetBounds(100, 100);
+    region.Clear();
+
+    region.Add({ 0, 0, 100, 74 });
+    CHECK(!region.IsFull());
+    region.Add({ 0, 74, 100, 75 });
+    CHECK(region.IsFull());
+    CHECK_EQUAL(10000, region.GetArea());
+
+    // Once full, adding does nothing, and adding a full region to another fills it.
+    region.Add({ 0, 0, 1, 1 });
+    CHECK_EQUAL(1u, region.GetRects().size());
+
+    DirtyRegion other;
+    other.SetBounds(100, 100);
+    other.Clear();
+    other.Add({ 0, 0, 5, 5 });
+    other.Add(region);
+    CHECK(other.IsFull());
+
+    DirtyRegion partial;
+    partial.SetBounds(100, 100);
+    partial.Clear();
+    partial.Add({ 90, 90, 95, 95 });
+    other.Clear();
+    other.Add({ 0, 0, 5, 5 });
+    other.Add(partial);
+    CHECK_EQUAL(2u, other.GetRects().size());
+    CHECK_EQUAL(50, other.GetArea());
+}
+
+TEST_CASE(DirtyRegionCoversEveryAddedPixelWithDisjointRectangles)
+{
+    const int32_t Width = 320;
+    const int32_t Height = 200;
+    Random random(2024);
+    std::vector<uint8_t> expected(Width * Height);
+
+    for (int round = 0; round < 300; round++)
+    {
+        DirtyRegion region(static_cast<size_t>(random.Next(1, 8)));
+        region.SetBounds(Width, Height);
+        region.Clear();
+        std::fill(expected.begin(), expected.end(), 0);
+
+        int rectCount = random.Next(1, 24);
+        for (int i = 0; i < rectCount; i++)
+        {
+            // Some hang over the edges of the surface.
+            int32_t left = random.Next(-20, Width);
+            int32_t top = random.Next(-20, Height);
+            DirtyRect rect = { left, top, left + random.Next(1, 40), top + random.Next(1, 40) };
+            region.Add(rect);
+
+            for (int32_t y = rect.top < 0 ? 0 : rect.top; y < rect.bottom && y < Height; y++)
+            {
+                for (int32_t x = rect.left < 0 ? 0 : rect.left; x < rect.right && x < Width; x++)
+                {
+                    expected[y * Width + x] = 1;
+                }
+            }
+        }
+
+        CHECK(Disjoint(region));
+        for (const DirtyRect& rect : region.GetRects())
+        {
+            CHECK(!rect.IsEmpty() && region.GetBounds().Contains(rect));
+        }
+
+        int64_t missed = 0;
+        for (int32_t y = 0; y < Height; y++)
+        {
+            for (int32_t x = 0; x < Width; x++)
+            {
+                if (expected[y * Width + x] != 0 && !Covers(region, x, y))
+                {
+                    missed++;
+                }
+            }
+        }
+        CHECK_EQUAL(0, missed);
+    }
+}
@@ -0,0 +1,67 @@
+#include "FrameScheduler.h"
+
+#include "Benchmark.h"
+
+#include <algorithm>
+
+using namespace DX;
+
+BENCHMARK(FrameSchedulerBookkeeping)
+{
+    // The per-frame costs on the render thread: the surface mailbox, and the statistics with a
+    // summary posted every 30 frames.
+    struct Surface
+    {
+        float width;
+        float height;
+        float scaleX;
+        float scaleY;
+    };
+    Mailbox<Surface> mailbox;
+    Surface surface = {};
+    double handOver = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        mailbox.Post({ 800.0f, 600.0f, 1.5f, 1.5f });
+        mailbox.Take(surface);
+        TestSupport::DoNotOptimize(surface);
+    });
+
+    FrameStatistics statistics;
+    uint64_t interval = 16000;
+    double add = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        interval = interval * 1103515245 + 12345;
+        statistics.AddFrame(16000 + interval % 1000, 4000);
+    });
+    double summary = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(statistics.GetSummary());
+    });
+
+    TestSupport::Report("Mailbox Post and Take", handOver, "ns/frame");
+    TestSupport::Report("FrameStatistics AddFrame", add, "ns/frame");
+    TestSupport::Report("FrameStatistics GetSummary, 256 frames", summary / 1000, "us");
+}
+
+BENCHMARK(FramePacerDeadlineAccuracy)
+{
+    // How far past each 60 Hz deadline the timer actually starts frames, over two seconds.
+    const uint64_t Interval = 16667;
+    const int Frames = 120;
+    FramePacer pacer(Interval);
+
+    uint64_t first = pacer.WaitForNextFrame();
+    uint64_t total = 0;
+    uint64_t worst = 0;
+    for (int frame = 1; frame <= Frames; frame++)
+    {
+        uint64_t start = pacer.WaitForNextFrame();
+        uint64_t lateness = start - (first + frame * Interval);
+        total += lateness;
+        worst = std::max(worst, lateness);
+    }
+
+    TestSupport::Report("FramePacer lateness, mean", static_cast<double>(total) / Frames, "us");
+    TestSupport::Report("FramePacer lateness, worst", static_cast<double>(worst), "us");
+    TestSupport::Report("FramePacer missed deadlines", static_cast<double>(pacer.GetMissedDeadlineCount()), "frames");
+}
@@ -0,0 +1,269 @@
+#include "FrameScheduler.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace DX;
+
+namespace
+{
+    // Large enough that a torn copy would show up as mismatched fields.
+    struct State
+    {
+        uint64_t sequence;
+        uint64_t values[7];
+    };
+
+    State MakeState(uint64_t sequence)
+    {
+        State state;
+        state.sequence = sequence;
+        for (uint64_t i = 0; i < 7; i++)
+        {
+            state.values[i] = sequence * 7 + i;
+        }
+        return state;
+    }
+
+    bool Consistent(const State& state)
+    {
+        for (uint64_t i = 0; i < 7; i++)
+        {
+            if (state.values[i] != state.sequence * 7 + i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A clock for FramePacer that only moves when the pacer sleeps or a test advances it, so
+    // the deadline timer can be checked exactly. Each sleep overshoots by a fixed amount, and a
+    // yield takes a microsecond.
+    struct SimulatedClock
+    {
+        uint64_t    time = 1000000;
+        uint64_t    overshoot = 0;
+        int         sleeps = 0;
+
+        void Attach(FramePacer& pacer)
+        {
+            pacer.SetClock([this] { return time; }, [this](uint64_t microseconds)
+            {
+                if (microseconds == 0)
+                {
+                    time += 1;
+                }
+                else
+                {
+                    time += microseconds + overshoot;
+                    ++sleeps;
+                }
+            });
+        }
+    };
+}
+
+TEST_CASE(MailboxHandsOverOnlyTheLatestValue)
+{
+    Mailbox<int> mailbox;
+    int value = -1;
+    CHECK(!mailbox.Take(value));
+    CHECK_EQUAL(-1, value);
+
+    mailbox.Post(1);
+    CHECK(mailbox.Take(value));
+    CHECK_EQUAL(1, value);
+    CHECK(!mailbox.Take(value));
+
+    // Values posted before the consumer gets to them are replaced.
+    mailbox.Post(2);
+    mailbox.Post(3);
+    mailbox.Post(4);
+    CHECK(mailbox.Take(value));
+    CHECK_EQUAL(4, value);
+    CHECK(!mailbox.Take(value));
+
+    for (int i = 5; i < 50; i++)
+    {
+        mailbox.Post(i);
+        if (i % 3 == 0)
+        {
+            CHECK(mailbox.Take(value));
+            CHECK_EQUAL(i, value);
+        }
+    }
+    CHECK(mailbox.Take(value));
+    CHECK_EQUAL(49, value);
+}
+
+TEST_CASE(MailboxPassesWholeValuesBetweenThreads)
+{
+    const uint64_t Count = 200000;
+    Mailbox<State> mailbox;
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]
+    {
+        for (uint64_t i = 1; i <= Count; i++)
+        {
+            mailbox.Post(MakeState(i));
+            if (i % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        done.store(true);
+    });
+
+    // The consumer sees values in order, never a torn one, and finally the last one posted.
+    State state = {};
+    uint64_t last = 0;
+    uint64_t taken = 0;
+    bool ordered = true;
+    bool consistent = true;
+    for (;;)
+    {
+        bool finished = done.load();
+        while (mailbox.Take(state))
+        {
+            consistent = consistent && Consistent(state);
+            ordered = ordered && state.sequence > last;
+            last = state.sequence;
+            taken++;
+        }
+        if (finished)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    producer.join();
+
+    CHECK(consistent);
+    CHECK(ordered);
+    CHECK_EQUAL(Count, last);
+    CHECK(taken >= 1);
+}
+
+TEST_CASE(FrameStatisticsSummarizesTheWindow)
+{
+    FrameStatistics statistics;
+    FrameStatistics::Summary summary = statistics.GetSummary();
+    CHECK_EQUAL(0u, summary.frameCount);
+    CHECK_EQUAL(0u, summary.maxInterval);
+
+    // 97 frames on time, two that showed the previous image twice and one long stall.
+    for (int i = 0; i < 97; i++)
+    {
+        statistics.AddFrame(16000 + (i % 3) * 500, 4000);
+    }
+    statistics.AddFrame(33000, 10000);
+    statistics.AddFrame(34000, 10000);
+    statistics.AddFrame(100000, 10000);
+
+    summary = statistics.GetSummary();
+    CHECK_EQUAL(100u, summary.frameCount);
+    CHECK_EQUAL(16500u, summary.medianInterval);
+    CHECK_EQUAL(100000u, summary.p99Interval);
+    CHECK_EQUAL(100000u, summary.maxInterval);
+    CHECK_EQUAL(3u, summary.missedFrameCount);
+    CHECK(summary.averageWorkTime > 4179.9 && summary.averageWorkTime < 4180.1);
+
+    // Only the latest 256 frames are summarized, but all are counted.
+    for (int i = 0; i < 256; i++)
+    {
+        statistics.AddFrame(8000, 2000);
+    }
+    summary = statistics.GetSummary();
+    CHECK_EQUAL(356u, summary.frameCount);
+    CHECK_EQUAL(8000u, summary.maxInterval);
+    CHECK_EQUAL(0u, summary.missedFrameCount);
+    CHECK(summary.averageInterval == 8000.0);
+
+    statistics.Reset();
+    CHECK_EQUAL(0u, statistics.GetFrameCount());
+    CHECK_EQUAL(0u, statistics.GetSummary().maxInterval);
+}
+
+TEST_CASE(FramePacerFollowsTheWaitFunction)
+{
+    FramePacer pacer(1000000);
+    SimulatedClock clock;
+    clock.Attach(pacer);
+
+    // With a working wait function, frames start when it returns and the long interval of the
+    // deadline timer never comes into it.
+    int waits = 0;
+    pacer.SetWaitFunction([&waits, &clock] { ++waits; clock.time += 16667; return true; });
+
+    uint64_t start = clock.time;
+    for (uint64_t frame = 1; frame <= 5; frame++)
+    {
+        CHECK_EQUAL(start + frame * 16667, pacer.WaitForNextFrame());
+    }
+    CHECK_EQUAL(5, waits);
+    CHECK_EQUAL(0, clock.sleeps);
+    CHECK_EQUAL(0u, pacer.GetMissedDeadlineCount());
+}
+
+TEST_CASE(FramePacerKeepsFramesOnAFixedGrid)
+{
+    const uint64_t Interval = 10000;
+    const uint64_t Overshoot = 700;
+    FramePacer pacer(Interval);
+    SimulatedClock clock;
+    clock.overshoot = Overshoot;
+    clock.Attach(pacer);
+
+    // A failing wait function falls back to the deadline timer.
+    int waits = 0;
+    pacer.SetWaitFunction([&waits] { ++waits; return false; });
+
+    uint64_t first = pacer.WaitForNextFrame();
+    CHECK_EQUAL(1000000u, first);
+    for (uint64_t frame = 1; frame <= 10; frame++)
+    {
+        // Frames of uneven length, all shorter than the interval.
+        clock.time += frame % 2 == 0 ? 9000 : 2000;
+
+        // A sleep that overshoots makes at most that one frame late; the sleep margin then
+        // grows to cover it, and lateness is never carried into the next frame.
+        uint64_t start = pacer.WaitForNextFrame();
+        CHECK(start >= first + frame * Interval);
+        CHECK(start - (first + frame * Interval) <= Overshoot);
+        if (frame > 1)
+        {
+            CHECK_EQUAL(first + frame * Interval, start);
+        }
+    }
+    CHECK_EQUAL(11, waits);
+    CHECK_EQUAL(0u, pacer.GetMissedDeadlineCount());
+}
+
+TEST_CASE(FramePacerSkipsMissedSlotsWithoutCatchingUp)
+{
+    const uint64_t Interval = 10000;
+    FramePacer pacer(Interval);
+    SimulatedClock clock;
+    clock.Attach(pacer);
+
+    uint64_t first = pacer.WaitForNextFrame();
+
+    // A frame that runs for three and a half intervals misses the two slots it ran over after
+    // its own, and the frame after it starts straight away.
+    clock.time += 3 * Interval + Interval / 2;
+    uint64_t late = pacer.WaitForNextFrame();
+    CHECK_EQUAL(first + 3 * Interval + Interval / 2, late);
+    CHECK_EQUAL(2u, pacer.GetMissedDeadlineCount());
+
+    // The next one goes back onto the grid instead of following immediately to catch up.
+    uint64_t next = pacer.WaitForNextFrame();
+    CHECK_EQUAL(first + 4 * Interval, next);
+    CHECK_EQUAL(2u, pacer.GetMissedDeadlineCount());
+
+    // And so does the one after that.
+    CHECK_EQUAL(first + 5 * Interval, pacer.WaitForNextFrame());
+}
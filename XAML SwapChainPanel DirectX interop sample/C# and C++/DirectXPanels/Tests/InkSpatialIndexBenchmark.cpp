@@ -0,0 +1,76 @@
+#include "InkSpatialIndex.h"
+
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace DX;
+
+BENCHMARK(InkSpatialIndexEraserHitTest)
+{
+    // 10,000 strokes of 40 segments, each about 6 units long, over a 2000 x 2000 canvas: the
+    // flattened polylines of a full page of handwriting.
+    const size_t StrokeCount = 10000;
+    const size_t PointsPerStroke = 41;
+    std::vector<std::vector<InkPoint>> strokes(StrokeCount);
+    for (size_t i = 0; i < StrokeCount; i++)
+    {
+        float x = static_cast<float>((i * 37) % 1900);
+        float y = static_cast<float>((i * 53) % 1900);
+        for (size_t j = 0; j < PointsPerStroke; j++)
+        {
+            strokes[i].push_back({ x + 2.5f * j, y + ((j % 2 == 0) ? 3.0f : -3.0f) });
+        }
+    }
+
+    InkSpatialIndex index;
+    double add = TestSupport::MeasureNanoseconds(StrokeCount, [&]
+    {
+        index.Clear();
+        for (size_t i = 0; i < StrokeCount; i++)
+        {
+            index.AddStroke(static_cast<uint32_t>(i + 1), strokes[i].data(), strokes[i].size(), 1.5f);
+        }
+    });
+
+    // One eraser move of 8 units with a 10 unit radius, at points spread over the canvas.
+    std::vector<uint32_t> hits;
+    size_t hitCount = 0;
+    const int Queries = 1000;
+    double grid = TestSupport::MeasureNanoseconds(Queries, [&]
+    {
+        hitCount = 0;
+        for (int query = 0; query < Queries; query++)
+        {
+            InkPoint start = { static_cast<float>((query * 97) % 2000), static_cast<float>((query * 61) % 2000) };
+            hits.clear();
+            index.HitTest(start, { start.x + 8.0f, start.y + 4.0f }, 10.0f, hits);
+            hitCount += hits.size();
+        }
+    });
+
+    // What the eraser would cost testing every segment of every stroke.
+    double bruteForce = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        InkPoint start = { 1000.0f, 1000.0f };
+        InkPoint end = { 1008.0f, 1004.0f };
+        size_t found = 0;
+        for (const auto& stroke : strokes)
+        {
+            for (size_t j = 0; j + 1 < stroke.size(); j++)
+            {
+                if (SegmentDistanceSquared(start, end, stroke[j], stroke[j + 1]) <= 11.5f * 11.5f)
+                {
+                    found++;
+                    break;
+                }
+            }
+        }
+        TestSupport::DoNotOptimize(found);
+    });
+
+    TestSupport::Report("AddStroke, 40 segments", add, "ns/stroke");
+    TestSupport::Report("HitTest, grid of 64 unit cells", grid, "ns/query");
+    TestSupport::Report("HitTest, strokes hit per query", static_cast<double>(hitCount) / Queries, "strokes");
+    TestSupport::Report("HitTest, every segment tested", bruteForce, "ns/query");
+}
@@ -0,0 +1,185 @@
+#include "InkSpatialIndex.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    // Deterministic pseudo-random numbers, so a failure reproduces.
+    struct Random
+    {
+        uint32_t state;
+
+        explicit Random(uint32_t seed) : state(seed) {}
+
+        float Next(float low, float high)
+        {
+            state = state * 1664525u + 1013904223u;
+            return low + (high - low) * ((state >> 8) / 16777216.0f);
+        }
+    };
+
+    struct Stroke
+    {
+        uint32_t                id;
+        std::vector<InkPoint>   points;
+        float                   halfWidth;
+    };
+
+    // Random walks of a few points to a few dozen, some of them single dots, spread over
+    // negative and positive coordinates so cells on both sides of zero are used.
+    std::vector<Stroke> MakeStrokes(Random& random, size_t count)
+    {
+        std::vector<Stroke> strokes(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            Stroke& stroke = strokes[i];
+            stroke.id = static_cast<uint32_t>(i + 1);
+            stroke.halfWidth = random.Next(0.5f, 6.0f);
+
+            InkPoint point = { random.Next(-500.0f, 500.0f), random.Next(-500.0f, 500.0f) };
+            size_t pointCount = (i % 10 == 0) ? 1 : static_cast<size_t>(random.Next(2.0f, 40.0f));
+            for (size_t j = 0; j < pointCount; j++)
+            {
+                stroke.points.push_back(point);
+                point.x += random.Next(-25.0f, 25.0f);
+                point.y += random.Next(-25.0f, 25.0f);
+            }
+        }
+        return strokes;
+    }
+
+    // What the index must agree with: every segment of every live stroke tested directly.
+    std::vector<uint32_t> BruteForceHitTest(const std::vector<Stroke>& strokes, const std::vector<bool>& live, InkPoint start, InkPoint end, float radius)
+    {
+        std::vector<uint32_t> hits;
+        for (size_t i = 0; i < strokes.size(); i++)
+        {
+            if (!live[i])
+            {
+                continue;
+            }
+
+            const Stroke& stroke = strokes[i];
+            float reach = radius + stroke.halfWidth;
+            size_t segmentCount = stroke.points.size() > 1 ? stroke.points.size() - 1 : 1;
+            for (size_t j = 0; j < segmentCount; j++)
+            {
+                InkPoint a = stroke.points[j];
+                InkPoint b = stroke.points[std::min(j + 1, stroke.points.size() - 1)];
+                if (SegmentDistanceSquared(start, end, a, b) <= reach * reach)
+                {
+                    hits.push_back(stroke.id);
+                    break;
+                }
+            }
+        }
+        return hits;
+    }
+}
+
+TEST_CASE(InkSpatialIndexSegmentDistances)
+{
+    CHECK_EQUAL(0.0f, PointSegmentDistanceSquared({ 5.0f, 0.0f }, { 0.0f, 0.0f }, { 10.0f, 0.0f }));
+    CHECK_EQUAL(9.0f, PointSegmentDistanceSquared({ 5.0f, 3.0f }, { 0.0f, 0.0f }, { 10.0f, 0.0f }));
+    CHECK_EQUAL(25.0f, PointSegmentDistanceSquared({ 13.0f, 4.0f }, { 0.0f, 0.0f }, { 10.0f, 0.0f }));
+    CHECK_EQUAL(2.0f, PointSegmentDistanceSquared({ 1.0f, 1.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f }));
+
+    // Crossing, parallel, touching at an end, and apart end to end.
+    CHECK_EQUAL(0.0f, SegmentDistanceSquared({ 0.0f, 0.0f }, { 10.0f, 10.0f }, { 0.0f, 10.0f }, { 10.0f, 0.0f }));
+    CHECK_EQUAL(16.0f, SegmentDistanceSquared({ 0.0f, 0.0f }, { 10.0f, 0.0f }, { 2.0f, 4.0f }, { 8.0f, 4.0f }));
+    CHECK_EQUAL(0.0f, SegmentDistanceSquared({ 0.0f, 0.0f }, { 10.0f, 0.0f }, { 10.0f, 0.0f }, { 10.0f, 5.0f }));
+    CHECK_EQUAL(25.0f, SegmentDistanceSquared({ 0.0f, 0.0f }, { 10.0f, 0.0f }, { 13.0f, 4.0f }, { 20.0f, 4.0f }));
+}
+
+TEST_CASE(InkSpatialIndexHitsFromTheStrokeEdge)
+{
+    InkSpatialIndex index(16.0f);
+    const InkPoint line[] = { { 0.0f, 0.0f }, { 100.0f, 0.0f } };
+    const InkPoint dot[] = { { -40.0f, -40.0f } };
+    index.AddStroke(7, line, 2, 2.0f);
+    index.AddStroke(9, dot, 1, 1.0f);
+    CHECK_EQUAL(2u, index.GetSegmentCount());
+
+    // The eraser reaches the line when its radius and the line's half width cover the gap.
+    std::vector<uint32_t> hits;
+    index.HitTest({ 50.0f, 5.0f }, { 60.0f, 5.0f }, 3.0f, hits);
+    CHECK_EQUAL(1u, hits.size());
+    CHECK_EQUAL(7u, hits.empty() ? 0u : hits[0]);
+
+    hits.clear();
+    index.HitTest({ 50.0f, 5.5f }, { 60.0f, 5.5f }, 3.0f, hits);
+    CHECK(hits.empty());
+
+    // Dots can be erased, and results are appended after what is already in the vector.
+    hits = { 100 };
+    index.HitTest({ -45.0f, -40.0f }, { -45.0f, -40.0f }, 4.0f, hits);
+    CHECK_EQUAL(2u, hits.size());
+    CHECK_EQUAL(9u, hits.back());
+
+    // A sweep across both strokes reports each once, in order, however many cells it crosses.
+    hits.clear();
+    index.HitTest({ -40.0f, -40.0f }, { 90.0f, 10.0f }, 1.0f, hits);
+    CHECK_EQUAL(2u, hits.size());
+    CHECK(hits.size() == 2 && hits[0] == 7 && hits[1] == 9);
+
+    index.RemoveStroke(7);
+    index.RemoveStroke(12345);
+    CHECK_EQUAL(1u, index.GetSegmentCount());
+    hits.clear();
+    index.HitTest({ 50.0f, 0.0f }, { 60.0f, 0.0f }, 3.0f, hits);
+    CHECK(hits.empty());
+
+    index.Clear();
+    CHECK_EQUAL(0u, index.GetSegmentCount());
+}
+
+TEST_CASE(InkSpatialIndexMatchesBruteForce)
+{
+    Random random(12345);
+    std::vector<Stroke> strokes = MakeStrokes(random, 300);
+    std::vector<bool> live(strokes.size(), true);
+    size_t totalHits = 0;
+
+    // Cells smaller, near and larger than the segments, which are up to about 35 units long.
+    for (float cellSize : { 8.0f, 64.0f, 300.0f })
+    {
+        InkSpatialIndex index(cellSize);
+        for (const Stroke& stroke : strokes)
+        {
+            index.AddStroke(stroke.id, stroke.points.data(), stroke.points.size(), stroke.halfWidth);
+        }
+        std::fill(live.begin(), live.end(), true);
+
+        for (int round = 0; round < 2; round++)
+        {
+            for (int query = 0; query < 500; query++)
+            {
+                InkPoint start = { random.Next(-550.0f, 550.0f), random.Next(-550.0f, 550.0f) };
+                InkPoint end = { start.x + random.Next(-60.0f, 60.0f), start.y + random.Next(-60.0f, 60.0f) };
+                float radius = random.Next(0.0f, 20.0f);
+
+                std::vector<uint32_t> hits;
+                index.HitTest(start, end, radius, hits);
+                std::vector<uint32_t> expected = BruteForceHitTest(strokes, live, start, end, radius);
+                CHECK(hits == expected);
+                totalHits += expected.size();
+            }
+
+            // Then again with every third stroke removed.
+            for (size_t i = 0; i < strokes.size(); i += 3)
+            {
+                index.RemoveStroke(strokes[i].id);
+                live[i] = false;
+            }
+        }
+    }
+
+    // Enough of the queries hit strokes for the comparison to mean something.
+    CHECK(totalHits > 1000);
+}
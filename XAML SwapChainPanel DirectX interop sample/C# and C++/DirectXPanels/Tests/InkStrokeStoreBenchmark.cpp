@@ -0,0 +1,116 @@
+#include "InkStrokeStore.h"
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    const size_t StrokeCount = 10000;
+    const size_t SegmentsPerStroke = 16;
+
+    // Wavy handwriting-sized strokes spread over a 2000 x 2000 canvas.
+    std::vector<std::vector<InkBezierSegment>> MakeStrokes()
+    {
+        std::vector<std::vector<InkBezierSegment>> strokes(StrokeCount);
+        for (size_t i = 0; i < StrokeCount; i++)
+        {
+            float x = static_cast<float>((i * 37) % 1900);
+            float y = static_cast<float>((i * 53) % 1900);
+            for (size_t j = 0; j < SegmentsPerStroke; j++)
+            {
+                float wave = (j % 2 == 0) ? 6.0f : -6.0f;
+                strokes[i].push_back({ { x + 2.0f, y + wave }, { x + 4.0f, y - wave }, { x + 6.0f, y + 1.0f } });
+                x += 6.0f;
+                y += 1.0f;
+            }
+        }
+        return strokes;
+    }
+
+    void Fill(InkStrokeStore& store, const std::vector<std::vector<InkBezierSegment>>& strokes)
+    {
+        for (const auto& segments : strokes)
+        {
+            InkPoint start = { segments[0].control1.x - 2.0f, segments[0].end.y - 1.0f };
+            store.AddStroke(start, segments.data(), segments.size(), 3.0f, 0xFF000000);
+        }
+    }
+}
+
+BENCHMARK(InkStrokeStore10kStrokes)
+{
+    const auto strokes = MakeStrokes();
+
+    double add = TestSupport::MeasureNanoseconds(StrokeCount, [&]
+    {
+        InkStrokeStore store;
+        Fill(store, strokes);
+        TestSupport::DoNotOptimize(store.GetStrokeCount());
+    });
+
+    InkStrokeStore store;
+    Fill(store, strokes);
+
+    // What SyncStrokeStore does for every stroke it adds to the eraser's spatial index.
+    std::vector<InkPoint> polyline;
+    size_t flattenedPoints = 0;
+    double flatten = TestSupport::MeasureNanoseconds(StrokeCount, [&]
+    {
+        flattenedPoints = 0;
+        for (size_t i = 0; i < store.GetStrokeCount(); i++)
+        {
+            polyline.clear();
+            flattenedPoints += store.FlattenStroke(i, 0.25f, polyline);
+        }
+        TestSupport::DoNotOptimize(polyline.data());
+    });
+
+    double find = TestSupport::MeasureNanoseconds(StrokeCount, [&]
+    {
+        size_t found = 0;
+        for (uint32_t id = 1; id <= StrokeCount; id++)
+        {
+            found += store.FindStroke(id * 7919 % StrokeCount + 1);
+        }
+        TestSupport::DoNotOptimize(found);
+    });
+
+    double bounds = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        TestSupport::DoNotOptimize(store.GetBounds());
+    });
+
+    // Erasing one stroke in a hundred from a full store, in one compaction pass; the refill
+    // is timed on its own and subtracted.
+    std::vector<size_t> removed;
+    for (size_t i = 0; i < StrokeCount; i += 100)
+    {
+        removed.push_back(i);
+    }
+    double refill = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        InkStrokeStore scratch;
+        Fill(scratch, strokes);
+        TestSupport::DoNotOptimize(scratch.GetStrokeCount());
+    });
+    double refillAndRemove = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        InkStrokeStore scratch;
+        Fill(scratch, strokes);
+        scratch.RemoveStrokes(removed);
+        TestSupport::DoNotOptimize(scratch.GetStrokeCount());
+    });
+
+    TestSupport::Report("AddStroke, 16 segments", add, "ns/stroke");
+    TestSupport::Report("FlattenStroke at 0.25, 16 segments", flatten, "ns/stroke");
+    TestSupport::Report("FlattenStroke points per stroke", static_cast<double>(flattenedPoints) / StrokeCount, "points");
+    TestSupport::Report("FindStroke among 10k", find, "ns/lookup");
+    TestSupport::Report("GetBounds over 10k", bounds / 1000, "us");
+    TestSupport::Report("RemoveStrokes, 100 of 10k", (refillAndRemove - refill) / 1000, "us");
+    TestSupport::Report("memory", static_cast<double>(StrokeCount * (sizeof(InkStrokeInfo) +
+        (1 + 3 * SegmentsPerStroke) * sizeof(InkPoint))) / (1024 * 1024), "MB");
+}
@@ -0,0 +1,191 @@
+#include "InkStrokeStore.h"
+
+#include "Check.h"
+
+#include <cmath>
+
+using namespace DX;
+
+namespace
+{
+    // A stroke of segmentCount straight segments, each 9 units long with evenly spaced control
+    // points, along the x axis at height y.
+    size_t AddLine(InkStrokeStore& store, float y, size_t segmentCount, float width = 2.0f)
+    {
+        std::vector<InkBezierSegment> segments;
+        for (size_t i = 0; i < segmentCount; i++)
+        {
+            float x = 9.0f * i;
+            segments.push_back({ { x + 3.0f, y }, { x + 6.0f, y }, { x + 9.0f, y } });
+        }
+        return store.AddStroke({ 0.0f, y }, segments.data(), segments.size(), width, 0xFF000000);
+    }
+
+    float DistanceToCurve(InkPoint point, InkPoint p0, InkPoint p1, InkPoint p2, InkPoint p3)
+    {
+        // Nearest of many samples of the curve, which overstates the distance by under 0.01.
+        float best = 1e30f;
+        for (int i = 0; i <= 20000; i++)
+        {
+            float t = i / 20000.0f;
+            float u = 1.0f - t;
+            float x = u * u * u * p0.x + 3 * u * u * t * p1.x + 3 * u * t * t * p2.x + t * t * t * p3.x;
+            float y = u * u * u * p0.y + 3 * u * u * t * p1.y + 3 * u * t * t * p2.y + t * t * t * p3.y;
+            best = std::fmin(best, std::hypot(point.x - x, point.y - y));
+        }
+        return best;
+    }
+}
+
+TEST_CASE(InkStrokeStoreAddsStrokesWithIncreasingIdsAndHullBounds)
+{
+    InkStrokeStore store;
+    CHECK(store.GetBounds().IsEmpty());
+
+    InkBezierSegment curve = { { 10.0f, -20.0f }, { 30.0f, 40.0f }, { 50.0f, 5.0f } };
+    size_t first = store.AddStroke({ 0.0f, 0.0f }, &curve, 1, 4.0f, 0xFF112233);
+    size_t second = AddLine(store, 100.0f, 3);
+
+    CHECK_EQUAL(0u, first);
+    CHECK_EQUAL(1u, second);
+    CHECK_EQUAL(2u, store.GetStrokeCount());
+    CHECK_EQUAL(2u, store.GetVersion());
+
+    const InkStrokeInfo& stroke = store.GetStroke(first);
+    CHECK_EQUAL(1u, stroke.id);
+    CHECK_EQUAL(2u, store.GetStroke(second).id);
+    CHECK_EQUAL(1u, stroke.segmentCount);
+    CHECK_EQUAL(0xFF112233u, stroke.color);
+
+    // The control point hull, widened by half the stroke width.
+    CHECK_EQUAL(-2.0f, stroke.bounds.left);
+    CHECK_EQUAL(-22.0f, stroke.bounds.top);
+    CHECK_EQUAL(52.0f, stroke.bounds.right);
+    CHECK_EQUAL(42.0f, stroke.bounds.bottom);
+
+    const InkPoint* points = store.GetStrokePoints(first);
+    CHECK_EQUAL(0.0f, points[0].x);
+    CHECK_EQUAL(30.0f, points[2].x);
+    CHECK_EQUAL(5.0f, points[3].y);
+    CHECK_EQUAL(100.0f, store.GetStrokePoints(second)[0].y);
+
+    InkBounds bounds = store.GetBounds();
+    CHECK_EQUAL(-2.0f, bounds.left);
+    CHECK_EQUAL(-22.0f, bounds.top);
+    CHECK_EQUAL(52.0f, bounds.right);
+    CHECK_EQUAL(101.0f, bounds.bottom);
+}
+
+TEST_CASE(InkStrokeStoreRemoveCompactsStrokesAndPoints)
+{
+    InkStrokeStore store;
+    for (int i = 0; i < 6; i++)
+    {
+        AddLine(store, 10.0f * i, i + 1);
+    }
+    uint64_t version = store.GetVersion();
+
+    store.RemoveStrokes({});
+    CHECK_EQUAL(version, store.GetVersion());
+
+    store.RemoveStrokes({ 0, 2, 5 });
+    CHECK_EQUAL(version + 1, store.GetVersion());
+    CHECK_EQUAL(3u, store.GetStrokeCount());
+
+    // The kept strokes keep their ids, order and points, packed one after another.
+    const uint32_t keptIds[] = { 2, 4, 5 };
+    uint32_t nextPoint = 0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        const InkStrokeInfo& stroke = store.GetStroke(i);
+        CHECK_EQUAL(keptIds[i], stroke.id);
+        CHECK_EQUAL(keptIds[i], stroke.segmentCount);
+        CHECK_EQUAL(nextPoint, stroke.firstPoint);
+        nextPoint += 1 + 3 * stroke.segmentCount;
+
+        const InkPoint* points = store.GetStrokePoints(i);
+        float y = 10.0f * (keptIds[i] - 1);
+        CHECK_EQUAL(y, points[0].y);
+        CHECK_EQUAL(9.0f * stroke.segmentCount, points[3 * stroke.segmentCount].x);
+    }
+
+    CHECK_EQUAL(1u, store.FindStroke(4));
+    CHECK(store.FindStroke(3) == InkStrokeStore::InvalidIndex);
+    CHECK(store.FindStroke(99) == InkStrokeStore::InvalidIndex);
+
+    // New strokes never reuse an id.
+    size_t added = AddLine(store, 0.0f, 1);
+    CHECK_EQUAL(7u, store.GetStroke(added).id);
+    CHECK_EQUAL(3u, store.FindStroke(7));
+
+    store.Clear();
+    CHECK_EQUAL(0u, store.GetStrokeCount());
+    CHECK(store.GetBounds().IsEmpty());
+    CHECK(store.FindStroke(2) == InkStrokeStore::InvalidIndex);
+}
+
+TEST_CASE(InkStrokeStoreFlattenStaysWithinTolerance)
+{
+    const InkPoint p0 = { 0.0f, 0.0f };
+    const InkPoint p1 = { 20.0f, 80.0f };
+    const InkPoint p2 = { 80.0f, -60.0f };
+    const InkPoint p3 = { 100.0f, 10.0f };
+
+    size_t previousCount = 0;
+    for (float tolerance : { 2.0f, 0.5f, 0.1f })
+    {
+        std::vector<InkPoint> points;
+        FlattenBezier(p0, p1, p2, p3, tolerance, points);
+
+        // Finer tolerances take more points, and the polyline ends on the curve's end point.
+        CHECK(points.size() > previousCount);
+        previousCount = points.size();
+        CHECK_EQUAL(100.0f, points.back().x);
+        CHECK_EQUAL(10.0f, points.back().y);
+
+        // Every vertex and chord midpoint is within tolerance of the curve.
+        InkPoint previous = p0;
+        for (const InkPoint& point : points)
+        {
+            InkPoint middle = { (previous.x + point.x) * 0.5f, (previous.y + point.y) * 0.5f };
+            CHECK(DistanceToCurve(point, p0, p1, p2, p3) < 0.01f);
+            CHECK(DistanceToCurve(middle, p0, p1, p2, p3) <= tolerance);
+            previous = point;
+        }
+    }
+}
+
+TEST_CASE(InkStrokeStoreFlattenBoundsTheSegmentCount)
+{
+    // A straight line needs one chord, and a degenerate tolerance still gives at most 64.
+    std::vector<InkPoint> points;
+    FlattenBezier({ 0.0f, 0.0f }, { 1.0f, 1.0f }, { 2.0f, 2.0f }, { 3.0f, 3.0f }, 0.25f, points);
+    CHECK_EQUAL(1u, points.size());
+
+    points.clear();
+    FlattenBezier({ 0.0f, 0.0f }, { 0.0f, 1000.0f }, { 1000.0f, -1000.0f }, { 1000.0f, 0.0f }, 0.0001f, points);
+    CHECK_EQUAL(64u, points.size());
+
+    points.clear();
+    FlattenBezier({ 0.0f, 0.0f }, { 0.0f, 1000.0f }, { 1000.0f, -1000.0f }, { 1000.0f, 0.0f }, 0.0f, points);
+    CHECK_EQUAL(1u, points.size());
+}
+
+TEST_CASE(InkStrokeStoreFlattenStrokeAppendsTheWholePolyline)
+{
+    InkStrokeStore store;
+    size_t index = AddLine(store, 5.0f, 4);
+
+    std::vector<InkPoint> points = { { -1.0f, -1.0f } };
+    size_t appended = store.FlattenStroke(index, 0.25f, points);
+
+    // The start point plus one chord per straight segment, after what was already there.
+    CHECK_EQUAL(5u, appended);
+    CHECK_EQUAL(6u, points.size());
+    CHECK_EQUAL(-1.0f, points[0].x);
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        CHECK_EQUAL(9.0f * (i - 1), points[i].x);
+        CHECK_EQUAL(5.0f, points[i].y);
+    }
+}
@@ -0,0 +1,48 @@
+#include "PointerInput.h"
+
+#include "Benchmark.h"
+
+#include <vector>
+
+using namespace DX;
+
+BENCHMARK(PointerInputPerFrame)
+{
+    // A pen at 240 Hz against a 60 Hz render loop: four samples pushed on the input thread and
+    // taken together once a frame.
+    PointerSampleBuffer buffer;
+    std::vector<PointerSample> samples;
+    uint64_t timestamp = 0;
+    double queue = TestSupport::MeasureNanoseconds(4, [&]
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            timestamp += 4167;
+            buffer.Push({ 1.0f, 2.0f, timestamp, PointerSampleKind::Move, 1 });
+        }
+        samples.clear();
+        buffer.PopAll(samples);
+        TestSupport::DoNotOptimize(samples.data());
+    });
+
+    PointerPredictor predictor;
+    float position = 0.0f;
+    double add = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        position += 4.0f;
+        timestamp += 4167;
+        predictor.AddSample(position, position * 0.5f, timestamp);
+    });
+
+    float x = 0.0f;
+    float y = 0.0f;
+    double predict = TestSupport::MeasureNanoseconds(1, [&]
+    {
+        predictor.Predict(16667, x, y);
+        TestSupport::DoNotOptimize(x);
+    });
+
+    TestSupport::Report("PointerSampleBuffer Push and PopAll", queue, "ns/sample");
+    TestSupport::Report("PointerPredictor AddSample", add, "ns/sample");
+    TestSupport::Report("PointerPredictor Predict, six samples", predict, "ns/frame");
+}
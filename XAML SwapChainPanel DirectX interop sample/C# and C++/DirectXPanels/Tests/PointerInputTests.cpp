@@ -0,0 +1,205 @@
+#include "PointerInput.h"
+
+#include "Check.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace DX;
+
+namespace
+{
+    PointerSample MakeSample(uint64_t index)
+    {
+        return { static_cast<float>(index), static_cast<float>(index % 100), index * 1000, PointerSampleKind::Move, 1 };
+    }
+
+    bool Near(float expected, float actual, float tolerance = 0.01f)
+    {
+        return std::fabs(expected - actual) <= tolerance;
+    }
+
+    // Samples every 4 ms of a pointer whose position at t milliseconds is position(t).
+    template<typename TPosition>
+    void AddSamples(PointerPredictor& predictor, int count, TPosition position)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            float t = 4.0f * i;
+            float x, y;
+            position(t, x, y);
+            predictor.AddSample(x, y, static_cast<uint64_t>(t * 1000));
+        }
+    }
+}
+
+TEST_CASE(PointerSampleBufferKeepsOrderAndDropsWhenFull)
+{
+    // Capacity rounds up to 8.
+    PointerSampleBuffer buffer(5);
+    for (uint64_t i = 0; i < 8; i++)
+    {
+        CHECK(buffer.Push(MakeSample(i)));
+    }
+    CHECK(!buffer.Push(MakeSample(8)));
+    CHECK_EQUAL(1u, buffer.GetDroppedCount());
+
+    std::vector<PointerSample> samples(1);
+    CHECK_EQUAL(8u, buffer.PopAll(samples));
+    CHECK_EQUAL(9u, samples.size());
+    for (uint64_t i = 0; i < 8; i++)
+    {
+        CHECK_EQUAL(i * 1000, samples[i + 1].timestamp);
+    }
+
+    samples.clear();
+    CHECK_EQUAL(0u, buffer.PopAll(samples));
+    CHECK(samples.empty());
+
+    // Many laps around the ring, popping at uneven intervals.
+    uint64_t pushed = 100;
+    uint64_t expected = 100;
+    for (int frame = 0; frame < 200; frame++)
+    {
+        for (int i = 0; i < frame % 8; i++)
+        {
+            CHECK(buffer.Push(MakeSample(pushed++)));
+        }
+        samples.clear();
+        buffer.PopAll(samples);
+        for (const PointerSample& sample : samples)
+        {
+            CHECK_EQUAL(expected++, sample.timestamp / 1000);
+        }
+    }
+    CHECK_EQUAL(pushed, expected);
+    CHECK_EQUAL(1u, buffer.GetDroppedCount());
+}
+
+TEST_CASE(PointerSampleBufferPassesSamplesBetweenThreads)
+{
+    const uint64_t Count = 200000;
+    PointerSampleBuffer buffer(64);
+
+    // The producer retries when the consumer has fallen behind, so nothing should go missing.
+    std::thread producer([&]
+    {
+        for (uint64_t i = 0; i < Count; i++)
+        {
+            while (!buffer.Push(MakeSample(i)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<PointerSample> samples;
+    uint64_t received = 0;
+    bool ordered = true;
+    while (received < Count)
+    {
+        samples.clear();
+        if (buffer.PopAll(samples) == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (const PointerSample& sample : samples)
+        {
+            ordered = ordered && sample.timestamp == received * 1000 && sample.x == static_cast<float>(received);
+            received++;
+        }
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK_EQUAL(Count, received);
+}
+
+TEST_CASE(PointerPredictorNeedsMovingHistory)
+{
+    PointerPredictor predictor;
+    float x = -1.0f;
+    float y = -1.0f;
+
+    predictor.AddSample(0.0f, 0.0f, 0);
+    predictor.AddSample(4.0f, 0.0f, 4000);
+    CHECK(!predictor.Predict(16000, x, y));
+
+    // Samples with the same timestamp give no velocity.
+    predictor.Reset();
+    for (int i = 0; i < 4; i++)
+    {
+        predictor.AddSample(4.0f * i, 0.0f, 1000);
+    }
+    CHECK(!predictor.Predict(16000, x, y));
+
+    // Neither does a pointer that is holding still.
+    predictor.Reset();
+    AddSamples(predictor, 6, [](float, float& px, float& py) { px = 50.0f; py = 60.0f; });
+    CHECK(!predictor.Predict(16000, x, y));
+    CHECK_EQUAL(-1.0f, x);
+}
+
+TEST_CASE(PointerPredictorExtrapolatesSteadyMotion)
+{
+    // One unit per millisecond, so 16 units ahead after 16 ms.
+    PointerPredictor predictor;
+    AddSamples(predictor, 6, [](float t, float& x, float& y) { x = t; y = 100.0f; });
+
+    float x, y;
+    CHECK(predictor.Predict(16000, x, y));
+    CHECK(Near(36.0f, x));
+    CHECK(Near(100.0f, y));
+
+    // Only the last six samples count, so an early jump is forgotten.
+    predictor.Reset();
+    predictor.AddSample(500.0f, 500.0f, 0);
+    for (int i = 1; i <= 6; i++)
+    {
+        predictor.AddSample(100.0f - 4.0f * i, 10.0f, 4000u * i);
+    }
+    CHECK(predictor.Predict(8000, x, y));
+    CHECK(Near(68.0f, x));
+    CHECK(Near(10.0f, y));
+}
+
+TEST_CASE(PointerPredictorIsLimitedInTimeAndDistance)
+{
+    // Diagonally at one unit per millisecond: 25 ms of lookahead would be 25 units, but the
+    // default limit is 24, taken along the direction of motion.
+    PointerPredictor predictor;
+    AddSamples(predictor, 6, [](float t, float& x, float& y) { x = 0.6f * t; y = 0.8f * t; });
+
+    float x, y;
+    CHECK(predictor.Predict(100000, x, y));
+    CHECK(Near(12.0f + 14.4f, x));
+    CHECK(Near(16.0f + 19.2f, y));
+
+    predictor.SetLimits(10000, 1000.0f);
+    CHECK(predictor.Predict(100000, x, y));
+    CHECK(Near(12.0f + 6.0f, x));
+    CHECK(Near(16.0f + 8.0f, y));
+}
+
+TEST_CASE(PointerPredictorFollowsAccelerationButNotStops)
+{
+    // x = 0.05 t^2: the fitted velocity lags at 1 unit/ms, and the acceleration of 0.1 unit/ms^2
+    // adds 12.8 units over 16 ms.
+    PointerPredictor predictor;
+    predictor.SetLimits(25000, 100.0f);
+    AddSamples(predictor, 6, [](float t, float& x, float& y) { x = 0.05f * t * t; y = 0.0f; });
+
+    float x, y;
+    CHECK(predictor.Predict(16000, x, y));
+    CHECK(Near(20.0f + 16.0f + 12.8f, x, 0.05f));
+
+    // A pen that nearly stops in its last interval is predicted to crawl on from where it is,
+    // not to carry on at its earlier speed.
+    predictor.Reset();
+    AddSamples(predictor, 5, [](float t, float& px, float& py) { px = t; py = 0.0f; });
+    predictor.AddSample(16.5f, 0.0f, 20000);
+    CHECK(predictor.Predict(16000, x, y));
+    CHECK(Near(16.5f + 2.0f, x));
+    CHECK(Near(0.0f, y));
+}
@@ -98,12 +98,22 @@ void UIAD2DPanel::Render()
         return;
     }
 
+    // The content only changes when the panel framework marks it dirty, e.g. after a resize or device loss.
+    if (m_dirtyRegion.IsEmpty())
+    {
+        return;
+    }
+
     m_d2dContext->BeginDraw();
-    m_d2dContext->Clear(m_backgroundColor);
 
-    // Draw a content rectangle which will be exposed via UIA.
-    m_d2dContext->FillRectangle(m_contentRect, m_fillBrush.Get());
-    m_d2dContext->DrawRectangle(m_contentRect, m_strokeBrush.Get());
+    RenderDirtyRegion([this]()
+    {
+        m_d2dContext->Clear(m_backgroundColor);
+
+        // Draw a content rectangle which will be exposed via UIA.
+        m_d2dContext->FillRectangle(m_contentRect, m_fillBrush.Get());
+        m_d2dContext->DrawRectangle(m_contentRect, m_strokeBrush.Get());
+    });
 
     m_d2dContext->EndDraw();
     
@@ -7,6 +7,7 @@
 #include "MainPage.xaml.h"
 #include "..\Lib1\Lib1.h"
 #include "..\DLL1\DLL1.h"
+#include "LogSinks.h"
 #include <iostream>
 
 using namespace cout;
@@ -30,7 +31,15 @@ using namespace Windows::UI::Xaml::Navigation;
 /// executed, and as such is the logical equivalent of main() or WinMain().
 /// </summary>
 App::App()
+#ifdef _DEBUG
+    : m_charDebugOutput(m_log),
+    m_wcharDebugOutput(m_log)
+#endif
 {
+#ifdef _DEBUG
+    m_log.AddSink(std::make_unique<DebugOutputSink>());
+#endif
+
     InitializeComponent();
 
     std::cout << "***App.xaml.cpp: Hello world!***" << std::endl;
@@ -6,7 +6,7 @@
 #pragma once
 
 #include "App.g.h"
-#include "OutputDebugStringBuf.h"
+#include "AsyncLog.h"
 
 namespace cout
 {
@@ -26,9 +26,10 @@ namespace cout
 		void OnNavigationFailed(Platform::Object ^sender, Windows::UI::Xaml::Navigation::NavigationFailedEventArgs ^e);
 
 #ifdef _DEBUG
-        // overrides std::cout and std::wcout to use DebugOutputString
-        OutputDebugStringBufA m_charDebugOutput;
-        OutputDebugStringBufW m_wcharDebugOutput;
+        // overrides std::cout and std::wcout to go to OutputDebugString from a background thread
+        AsyncLog m_log;
+        AsyncLogStreamBufA m_charDebugOutput;
+        AsyncLogStreamBufW m_wcharDebugOutput;
 #endif
 	};
 }
@@ -0,0 +1,564 @@
+#include "AsyncLog.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const size_t HeaderSize = sizeof(uint32_t);
+    const size_t BatchSize = 64 * 1024;
+
+    std::atomic<uint64_t> s_nextLogId(1);
+
+    size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 256;
+        while (result < value)
+        {
+            result *= 2;
+        }
+        return result;
+    }
+
+    // Records start on a header boundary, so a header is never split by the end of the ring.
+    size_t GetRecordSize(size_t length)
+    {
+        return (HeaderSize + length + HeaderSize - 1) & ~(HeaderSize - 1);
+    }
+
+    size_t GetUtf8Length(uint32_t codePoint)
+    {
+        return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+    }
+
+    // The most of the first length bytes of text, which goes on past them, that doesn't end
+    // inside a UTF-8 character.
+    size_t GetCharacterBoundary(const char* text, size_t length)
+    {
+        for (size_t back = 0; back < 4 && back <= length; ++back)
+        {
+            if ((static_cast<unsigned char>(text[length - back]) & 0xC0) != 0x80)
+            {
+                return length - back;
+            }
+        }
+        return length;
+    }
+
+    void AppendUtf8(std::string& line, uint32_t codePoint)
+    {
+        if (codePoint < 0x80)
+        {
+            line.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            line.push_back(static_cast<char>(0xC0 | codePoint >> 6));
+            line.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            line.push_back(static_cast<char>(0xE0 | codePoint >> 12));
+            line.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            line.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            line.push_back(static_cast<char>(0xF0 | codePoint >> 18));
+            line.push_back(static_cast<char>(0x80 | (codePoint >> 12 & 0x3F)));
+            line.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            line.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+}
+
+// One thread's lines on their way to the drain thread: a length and the text of each, padded
+// to a header boundary. The thread only writes head and the drain thread only writes tail,
+// and each keeps to its own cache lines.
+struct AsyncLog::Ring
+{
+    std::vector<char>       data;
+    size_t                  mask;
+    std::atomic<bool>       owned;
+
+    char                    padding0[64];
+
+    std::atomic<uint64_t>   head;
+    std::atomic<uint64_t>   dropped;        // Lines that didn't fit.
+    std::atomic<uint64_t>   suppressed;     // Lines over the rate limit.
+    uint64_t                cachedTail;     // The tail when last read, so the full ring is the only time it's read.
+    uint32_t                tokens;
+    std::chrono::steady_clock::time_point refilled;
+    std::string             line;           // The line Append is building.
+    bool                    lineTooLong;    // The line Append is building can't fit in the ring, so the rest of it is skipped.
+    uint32_t                highSurrogate;  // Ending the last wide Append, waiting for its low half; 0 for none.
+
+    char                    padding1[64];
+
+    std::atomic<uint64_t>   tail;
+    uint64_t                reportedDropped;
+    uint64_t                reportedSuppressed;
+
+    Ring(size_t size, uint32_t burst) :
+        data(size),
+        mask(size - 1),
+        owned(true),
+        head(0),
+        dropped(0),
+        suppressed(0),
+        cachedTail(0),
+        tokens(burst),
+        refilled(std::chrono::steady_clock::now()),
+        lineTooLong(false),
+        highSurrogate(0),
+        tail(0),
+        reportedDropped(0),
+        reportedSuppressed(0)
+    {
+    }
+};
+
+thread_local AsyncLog::ThreadRing AsyncLog::s_threadRing;
+
+AsyncLog::ThreadRing::~ThreadRing()
+{
+    // The log may already be gone, but the ring is shared: leave it for another thread.
+    if (ring)
+    {
+        ring->line.clear();
+        ring->lineTooLong = false;
+        ring->highSurrogate = 0;
+        ring->owned.store(false, std::memory_order_release);
+    }
+}
+
+AsyncLog::AsyncLog(const Settings& settings) :
+    m_settings(settings),
+    m_id(s_nextLogId++),
+    m_flushRequested(0),
+    m_flushCompleted(0),
+    m_stop(false)
+{
+    m_settings.ringSize = RoundUpToPowerOfTwo(settings.ringSize);
+    m_maximumLine = m_settings.ringSize / 4 - HeaderSize;
+    m_thread = std::thread(&AsyncLog::ThreadWorker, this);
+}
+
+AsyncLog::~AsyncLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+
+    if (s_threadRing.logId == m_id)
+    {
+        Release(s_threadRing);
+    }
+}
+
+void AsyncLog::AddSink(std::unique_ptr<ILogSink> sink)
+{
+    std::lock_guard<std::mutex> lock(m_sinksMutex);
+    m_sinks.push_back(std::move(sink));
+}
+
+void AsyncLog::Write(const char* text, size_t length)
+{
+    Ring& ring = GetRing();
+    EndSurrogate(ring);
+    if (!ring.line.empty() || ring.lineTooLong)
+    {
+        CommitLine(ring);
+    }
+    if (Admit(ring))
+    {
+        Enqueue(ring, text, length, true);
+    }
+}
+
+void AsyncLog::Append(const char* text, size_t length)
+{
+    Ring& ring = GetRing();
+    EndSurrogate(ring);
+    const char* end = text + length;
+    while (text != end)
+    {
+        const char* newline = static_cast<const char*>(memchr(text, '\n', static_cast<size_t>(end - text)));
+        size_t count = static_cast<size_t>((newline != nullptr ? newline + 1 : end) - text);
+        if (HasRoom(ring, count))
+        {
+            ring.line.append(text, count);
+        }
+        text += count;
+        if (newline != nullptr)
+        {
+            CommitLine(ring);
+        }
+    }
+}
+
+void AsyncLog::Append(const wchar_t* text, size_t length)
+{
+    Ring& ring = GetRing();
+    for (size_t i = 0; i < length; ++i)
+    {
+        // UTF-16 surrogate pairs, also where wchar_t is 32 bits, since a surrogate isn't a
+        // character either way. A stream writes a character at a time, so a pair may be split
+        // between calls; the high half waits in the ring for the low one. A lone half becomes
+        // U+FFFD.
+        uint32_t codePoint = static_cast<uint32_t>(text[i]);
+        if (codePoint >= 0xD800 && codePoint < 0xDC00)
+        {
+            EndSurrogate(ring);
+            ring.highSurrogate = codePoint;
+            continue;
+        }
+        if (codePoint >= 0xDC00 && codePoint < 0xE000 && ring.highSurrogate != 0)
+        {
+            codePoint = 0x10000 + ((ring.highSurrogate - 0xD800) << 10) + (codePoint - 0xDC00);
+            ring.highSurrogate = 0;
+        }
+        else
+        {
+            EndSurrogate(ring);
+            if (codePoint > 0x10FFFF || (codePoint >= 0xDC00 && codePoint < 0xE000))
+            {
+                codePoint = 0xFFFD;
+            }
+        }
+        AppendCodePoint(ring, codePoint);
+    }
+}
+
+void AsyncLog::Commit()
+{
+    Ring& ring = GetRing();
+    if (!ring.line.empty() || ring.lineTooLong)
+    {
+        CommitLine(ring);
+    }
+}
+
+void AsyncLog::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t ticket = ++m_flushRequested;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [&] { return m_flushCompleted >= ticket; });
+}
+
+AsyncLog::Ring& AsyncLog::GetRing()
+{
+    ThreadRing& slot = s_threadRing;
+    if (slot.logId == m_id)
+    {
+        return *slot.ring;
+    }
+
+    // The first line from this thread, or the first since it logged elsewhere: one thread
+    // going back and forth between two logs gets here every time.
+    Release(slot);
+
+    std::lock_guard<std::mutex> lock(m_ringsMutex);
+    std::shared_ptr<Ring> ring;
+    for (const std::shared_ptr<Ring>& existing : m_rings)
+    {
+        bool owned = false;
+        if (existing->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+        {
+            ring = existing;
+            break;
+        }
+    }
+    if (!ring)
+    {
+        ring = std::make_shared<Ring>(m_settings.ringSize, m_settings.burst);
+        m_rings.push_back(ring);
+    }
+    slot.logId = m_id;
+    slot.ring = ring;
+    return *ring;
+}
+
+void AsyncLog::Release(ThreadRing& slot)
+{
+    if (slot.ring)
+    {
+        slot.ring->line.clear();
+        slot.ring->lineTooLong = false;
+        slot.ring->highSurrogate = 0;
+        slot.ring->owned.store(false, std::memory_order_release);
+        slot.ring.reset();
+    }
+    slot.logId = 0;
+}
+
+void AsyncLog::AppendCodePoint(Ring& ring, uint32_t codePoint)
+{
+    if (HasRoom(ring, GetUtf8Length(codePoint)))
+    {
+        AppendUtf8(ring.line, codePoint);
+    }
+    if (codePoint == '\n')
+    {
+        CommitLine(ring);
+    }
+}
+
+// A high surrogate with no low half to follow.
+void AsyncLog::EndSurrogate(Ring& ring)
+{
+    if (ring.highSurrogate != 0)
+    {
+        ring.highSurrogate = 0;
+        AppendCodePoint(ring, 0xFFFD);
+    }
+}
+
+// Whether length more bytes can go on the line Append is building. A line longer than the ring
+// could never be logged, so rather than keep growing it, the rest of it is skipped and it is
+// counted as dropped when it ends.
+bool AsyncLog::HasRoom(Ring& ring, size_t length) const
+{
+    if (!ring.lineTooLong && ring.line.size() + length > ring.data.size())
+    {
+        ring.lineTooLong = true;
+        ring.line.clear();
+        ring.line.shrink_to_fit();
+    }
+    return !ring.lineTooLong;
+}
+
+// Logs the line Append built as one line, however many calls it took: one token, and the
+// records of a long line published together or dropped together, as for Write.
+void AsyncLog::CommitLine(Ring& ring)
+{
+    if (Admit(ring))
+    {
+        if (ring.lineTooLong)
+        {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            Enqueue(ring, ring.line.data(), ring.line.size(), false);
+        }
+    }
+    ring.line.clear();
+    ring.lineTooLong = false;
+}
+
+bool AsyncLog::Admit(Ring& ring) const
+{
+    if (m_settings.linesPerSecond != 0)
+    {
+        if (ring.tokens == 0 && !Refill(ring))
+        {
+            ring.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        --ring.tokens;
+    }
+    return true;
+}
+
+// A token bucket, with the clock only read once the burst is spent.
+bool AsyncLog::Refill(Ring& ring) const
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - ring.refilled).count());
+    uint64_t earned = elapsed >= 60000000000ull ? UINT64_MAX : elapsed * m_settings.linesPerSecond / 1000000000;
+    if (earned >= m_settings.burst)
+    {
+        ring.tokens = m_settings.burst;
+        ring.refilled = now;
+    }
+    else if (earned > 0)
+    {
+        ring.tokens = static_cast<uint32_t>(earned);
+        ring.refilled += std::chrono::nanoseconds(earned * 1000000000 / m_settings.linesPerSecond);
+    }
+    return ring.tokens != 0;
+}
+
+// How much of the rest of a line goes in its next record: all of it when it fits, with its
+// newline, otherwise as much as fits with room for one, ending between characters.
+size_t AsyncLog::GetRecordLength(const char* text, size_t remaining, bool newline) const
+{
+    if (remaining + (newline ? 1 : 0) <= m_maximumLine)
+    {
+        return remaining;
+    }
+    return GetCharacterBoundary(text, m_maximumLine - 1);
+}
+
+void AsyncLog::Enqueue(Ring& ring, const char* text, size_t length, bool newline)
+{
+    // A line longer than a record holds goes in several. They are published together, so they
+    // reach the sinks together, or are dropped together when the ring hasn't room for them all.
+    size_t size = 0;
+    for (size_t offset = 0;;)
+    {
+        size_t count = GetRecordLength(text + offset, length - offset, newline);
+        offset += count;
+        if (offset == length)
+        {
+            size += GetRecordSize(count + (newline ? 1 : 0));
+            break;
+        }
+        size += GetRecordSize(count);
+    }
+    size_t capacity = ring.data.size();
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head + size - ring.cachedTail > capacity)
+    {
+        ring.cachedTail = ring.tail.load(std::memory_order_acquire);
+        if (head + size - ring.cachedTail > capacity)
+        {
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    char* data = ring.data.data();
+    uint64_t position = head;
+    for (size_t offset = 0;;)
+    {
+        size_t count = GetRecordLength(text + offset, length - offset, newline);
+        bool last = offset + count == length;
+        size_t start = static_cast<size_t>(position) & ring.mask;
+        uint32_t header = static_cast<uint32_t>(count + (last && newline ? 1 : 0));
+        memcpy(data + start, &header, HeaderSize);
+        start = (start + HeaderSize) & ring.mask;
+        size_t first = std::min(count, capacity - start);
+        memcpy(data + start, text + offset, first);
+        memcpy(data, text + offset + first, count - first);
+        if (last && newline)
+        {
+            data[(start + count) & ring.mask] = '\n';
+        }
+        position += GetRecordSize(header);
+        offset += count;
+        if (last)
+        {
+            break;
+        }
+    }
+    ring.head.store(head + size, std::memory_order_release);
+
+    // Don't wait out the interval once a ring is half full.
+    uint64_t used = head + size - ring.cachedTail;
+    if (used > capacity / 2 && used - size <= capacity / 2)
+    {
+        m_wake.notify_one();
+    }
+}
+
+void AsyncLog::Drain(std::string& batch)
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        rings = m_rings;
+    }
+
+    bool wrote = false;
+    for (const std::shared_ptr<Ring>& ring : rings)
+    {
+        const char* data = ring->data.data();
+        size_t capacity = ring->data.size();
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        while (tail != head)
+        {
+            size_t start = static_cast<size_t>(tail) & ring->mask;
+            uint32_t length;
+            memcpy(&length, data + start, HeaderSize);
+            start = (start + HeaderSize) & ring->mask;
+            size_t first = std::min(static_cast<size_t>(length), capacity - start);
+            batch.append(data + start, first);
+            batch.append(data, length - first);
+            tail += GetRecordSize(length);
+
+            if (batch.size() >= BatchSize)
+            {
+                ring->tail.store(tail, std::memory_order_release);
+                WriteSinks(batch);
+                wrote = true;
+            }
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        uint64_t suppressed = ring->suppressed.load(std::memory_order_relaxed);
+        if (dropped != ring->reportedDropped || suppressed != ring->reportedSuppressed)
+        {
+            batch += "AsyncLog: a thread lost ";
+            batch += std::to_string(dropped - ring->reportedDropped);
+            batch += " lines to a full buffer and ";
+            batch += std::to_string(suppressed - ring->reportedSuppressed);
+            batch += " to the rate limit\n";
+            ring->reportedDropped = dropped;
+            ring->reportedSuppressed = suppressed;
+        }
+    }
+
+    if (!batch.empty())
+    {
+        WriteSinks(batch);
+        wrote = true;
+    }
+    if (wrote)
+    {
+        std::lock_guard<std::mutex> lock(m_sinksMutex);
+        for (const std::unique_ptr<ILogSink>& sink : m_sinks)
+        {
+            sink->Flush();
+        }
+    }
+}
+
+void AsyncLog::WriteSinks(std::string& batch)
+{
+    std::lock_guard<std::mutex> lock(m_sinksMutex);
+    for (const std::unique_ptr<ILogSink>& sink : m_sinks)
+    {
+        sink->Write(batch.data(), batch.size());
+    }
+    batch.clear();
+}
+
+void AsyncLog::ThreadWorker()
+{
+    std::string batch;
+    batch.reserve(BatchSize + m_settings.ringSize / 4);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        uint64_t requested = m_flushRequested;
+        bool stop = m_stop;
+        lock.unlock();
+
+        Drain(batch);
+
+        lock.lock();
+        if (m_flushCompleted != requested)
+        {
+            m_flushCompleted = requested;
+            m_flushed.notify_all();
+        }
+        if (stop)
+        {
+            break;
+        }
+        if (m_flushRequested == requested && !m_stop)
+        {
+            m_wake.wait_for(lock, m_settings.drainInterval);
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Where the log lines end up. Called on the drain thread only, with a batch of whole lines
+// in UTF-8.
+class ILogSink
+{
+public:
+    virtual ~ILogSink() {}
+    virtual void Write(const char* text, size_t length) = 0;
+    virtual void Flush() {}
+};
+
+// Logging that costs the calling thread a copy into its own ring buffer and nothing else:
+// no lock, no allocation and no system call. A background thread drains every thread's ring
+// and hands the lines to the sinks in batches.
+//
+// Lines from one thread stay in order; lines from different threads are only ordered to
+// within a drain interval. When a thread's ring is full, or it goes over its rate limit,
+// its lines are dropped and counted, and the drain thread writes how many.
+class AsyncLog
+{
+public:
+    struct Settings
+    {
+        size_t                      ringSize;       // Bytes per thread, a power of two.
+        uint32_t                    linesPerSecond; // Per thread, 0 for no limit.
+        uint32_t                    burst;          // Lines a thread can log at once, at least 1.
+        std::chrono::milliseconds   drainInterval;
+
+        Settings() :
+            ringSize(64 * 1024),
+            linesPerSecond(1000),
+            burst(500),
+            drainInterval(20)
+        {
+        }
+    };
+
+    explicit AsyncLog(const Settings& settings = Settings());
+
+    // Writes out whatever is left.
+    ~AsyncLog();
+
+    void AddSink(std::unique_ptr<ILogSink> sink);
+
+    // Logs text as a line of its own. A line longer than a quarter of the ring goes in several
+    // records, so one that doesn't fit in the ring is dropped.
+    void Write(const char* text, size_t length);
+    void Write(const std::string& text) { Write(text.data(), text.size()); }
+
+    // Adds to this thread's current line, logging each line as its newline comes. The line is
+    // logged as Write logs one, however many calls built it. A UTF-16 high surrogate at the
+    // end of the wide text waits for its low half in the next call.
+    void Append(const char* text, size_t length);
+    void Append(const wchar_t* text, size_t length);
+
+    // Logs the rest of this thread's current line, newline or not.
+    void Commit();
+
+    // Waits until everything logged before the call has gone to the sinks.
+    void Flush();
+
+private:
+    struct Ring;
+
+    struct ThreadRing
+    {
+        uint64_t                logId;
+        std::shared_ptr<Ring>   ring;
+
+        ThreadRing() : logId(0) {}
+        ~ThreadRing();
+    };
+
+    Ring& GetRing();
+    void Release(ThreadRing& slot);
+    void AppendCodePoint(Ring& ring, uint32_t codePoint);
+    void EndSurrogate(Ring& ring);
+    bool HasRoom(Ring& ring, size_t length) const;
+    void CommitLine(Ring& ring);
+    bool Admit(Ring& ring) const;
+    bool Refill(Ring& ring) const;
+    size_t GetRecordLength(const char* text, size_t remaining, bool newline) const;
+    void Enqueue(Ring& ring, const char* text, size_t length, bool newline);
+    void Drain(std::string& batch);
+    void WriteSinks(std::string& batch);
+    void ThreadWorker();
+
+    static thread_local ThreadRing s_threadRing;
+
+    Settings                    m_settings;
+    const uint64_t              m_id;               // Tells a thread's ring of this log from one it had of an earlier one.
+    size_t                      m_maximumLine;
+
+    std::mutex                  m_ringsMutex;
+    std::vector<std::shared_ptr<Ring>> m_rings;
+
+    std::mutex                  m_sinksMutex;
+    std::vector<std::unique_ptr<ILogSink>> m_sinks;
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_wake;
+    std::condition_variable     m_flushed;
+    uint64_t                    m_flushRequested;
+    uint64_t                    m_flushCompleted;
+    bool                        m_stop;
+    std::thread                 m_thread;
+};
+
+/// \brief A stream buffer that sends everything written to it to an AsyncLog
+///
+/// It has no put area, so the threads that share a stream such as std::cout don't share a
+/// buffer either: each insertion goes straight into the calling thread's current line.
+/// std::flush logs a partial line, but doesn't wait for it to be written.
+template<typename TChar, typename TTraits = std::char_traits<TChar>>
+class AsyncLogStreamBuf : public std::basic_streambuf<TChar, TTraits>
+{
+public:
+    typedef typename TTraits::int_type int_type;
+
+    explicit AsyncLogStreamBuf(AsyncLog& log) : m_log(log)
+    {
+    }
+
+protected:
+    virtual std::streamsize xsputn(const TChar* text, std::streamsize count) override
+    {
+        m_log.Append(text, static_cast<size_t>(count));
+        return count;
+    }
+
+    virtual int_type overflow(int_type c = TTraits::eof()) override
+    {
+        if (!TTraits::eq_int_type(c, TTraits::eof()))
+        {
+            TChar character = TTraits::to_char_type(c);
+            m_log.Append(&character, 1);
+        }
+        return TTraits::not_eof(c);
+    }
+
+    virtual int sync() override
+    {
+        m_log.Commit();
+        return 0;
+    }
+
+private:
+    AsyncLog& m_log;
+};
+
+class AsyncLogStreamBufA : public AsyncLogStreamBuf<char>
+{
+public:
+    explicit AsyncLogStreamBufA(AsyncLog& log) : AsyncLogStreamBuf<char>(log)
+    {
+        // save the previous rdbuf
+        m_rdbuf = std::cout.rdbuf();
+        std::cout.rdbuf(this);
+    }
+
+    virtual ~AsyncLogStreamBufA()
+    {
+        // restore the previous rdbuf
+        std::cout.rdbuf(m_rdbuf);
+    }
+
+private:
+    std::basic_streambuf<char, std::char_traits<char>>* m_rdbuf;
+};
+
+class AsyncLogStreamBufW : public AsyncLogStreamBuf<wchar_t>
+{
+public:
+    explicit AsyncLogStreamBufW(AsyncLog& log) : AsyncLogStreamBuf<wchar_t>(log)
+    {
+        // save the previous rdbuf
+        m_rdbuf = std::wcout.rdbuf();
+        std::wcout.rdbuf(this);
+    }
+
+    virtual ~AsyncLogStreamBufW()
+    {
+        // restore the previous rdbuf
+        std::wcout.rdbuf(m_rdbuf);
+    }
+
+private:
+    std::basic_streambuf<wchar_t, std::char_traits<wchar_t>>* m_rdbuf;
+};
@@ -0,0 +1,72 @@
+#include "LogSinks.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#endif
+
+#if defined(_WIN32)
+void DebugOutputSink::Write(const char* text, size_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+
+    // One call for the whole batch, rather than one per line.
+    int count = MultiByteToWideChar(CP_UTF8, 0, text, static_cast<int>(length), nullptr, 0);
+    m_wide.resize(static_cast<size_t>(count));
+    MultiByteToWideChar(CP_UTF8, 0, text, static_cast<int>(length), &m_wide[0], count);
+    OutputDebugStringW(m_wide.c_str());
+}
+#else
+void DebugOutputSink::Write(const char* text, size_t length)
+{
+    fwrite(text, 1, length, stderr);
+}
+#endif
+
+FileSink::FileSink(const std::string& path)
+{
+#if defined(_WIN32)
+    if (fopen_s(&m_file, path.c_str(), "ab") != 0)
+    {
+        m_file = nullptr;
+    }
+#else
+    m_file = fopen(path.c_str(), "ab");
+#endif
+}
+
+FileSink::~FileSink()
+{
+    if (m_file != nullptr)
+    {
+        fclose(m_file);
+    }
+}
+
+void FileSink::Write(const char* text, size_t length)
+{
+    if (m_file != nullptr)
+    {
+        fwrite(text, 1, length, m_file);
+    }
+}
+
+void FileSink::Flush()
+{
+    if (m_file != nullptr)
+    {
+        fflush(m_file);
+    }
+}
+
+void StderrSink::Write(const char* text, size_t length)
+{
+    fwrite(text, 1, length, stderr);
+}
+
+void StderrSink::Flush()
+{
+    fflush(stderr);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "AsyncLog.h"
+
+#include <cstdio>
+#include <string>
+
+// The Visual Studio Output window, through OutputDebugStringW. There is no debugger channel
+// elsewhere, so other platforms get stderr.
+class DebugOutputSink : public ILogSink
+{
+public:
+    virtual void Write(const char* text, size_t length) override;
+
+private:
+    std::wstring m_wide;    // Kept between batches, so it's only allocated while it grows.
+};
+
+// Appends to a file, flushing after each batch so a crash loses at most one drain interval.
+class FileSink : public ILogSink
+{
+public:
+    explicit FileSink(const std::string& path);
+    virtual ~FileSink();
+
+    bool IsOpen() const { return m_file != nullptr; }
+
+    virtual void Write(const char* text, size_t length) override;
+    virtual void Flush() override;
+
+private:
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    std::FILE* m_file;
+};
+
+class StderrSink : public ILogSink
+{
+public:
+    virtual void Write(const char* text, size_t length) override;
+    virtual void Flush() override;
+};
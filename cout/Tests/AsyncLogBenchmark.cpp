@@ -0,0 +1,82 @@
+#include "AsyncLog.h"
+
+#include "Benchmark.h"
+
+#include <string>
+
+namespace
+{
+    class NullSink : public ILogSink
+    {
+    public:
+        void Write(const char* text, size_t length) override
+        {
+            TestSupport::DoNotOptimize(text);
+            TestSupport::DoNotOptimize(length);
+        }
+    };
+
+    AsyncLog::Settings Unlimited()
+    {
+        AsyncLog::Settings settings;
+        settings.linesPerSecond = 0;
+        return settings;
+    }
+}
+
+BENCHMARK(AsyncLogRing)
+{
+    // What the logging thread pays; lines that find the ring full are dropped, which costs
+    // about the same.
+    AsyncLog log(Unlimited());
+    log.AddSink(std::unique_ptr<ILogSink>(new NullSink()));
+
+    const std::string line = "frame 1234 rendered in 16.6 ms";
+    double write = TestSupport::MeasureNanoseconds(1, [&] { log.Write(line); });
+    TestSupport::Report("Write, 30 characters", write, "ns");
+
+    const std::string longLine(10000, 'x');
+    double writeLong = TestSupport::MeasureNanoseconds(1, [&] { log.Write(longLine); log.Flush(); });
+    double writeShort = TestSupport::MeasureNanoseconds(1, [&] { log.Write(line); log.Flush(); });
+    TestSupport::Report("Write and Flush, 10000 characters", writeLong / 1000.0, "us");
+    TestSupport::Report("Write and Flush, 30 characters", writeShort / 1000.0, "us");
+
+    // Wide text a character at a time, as a stream sends it, half of it surrogate pairs.
+    std::wstring wide;
+    for (int i = 0; i < 15; ++i)
+    {
+        wide += L'w';
+        wide += static_cast<wchar_t>(0xD83D);
+        wide += static_cast<wchar_t>(0xDE00);
+    }
+    double append = TestSupport::MeasureNanoseconds(wide.size(), [&]
+    {
+        for (wchar_t c : wide)
+        {
+            log.Append(&c, 1);
+        }
+        log.Commit();
+    });
+    TestSupport::Report("Append, a wide character at a time", append, "ns/character");
+    log.Flush();
+}
+
+BENCHMARK(AsyncLogTokenBucket)
+{
+    // A line within the rate takes a token without reading the clock; one over it reads the
+    // clock to refill, and is counted instead of copied.
+    AsyncLog::Settings settings;
+    settings.linesPerSecond = 1000000000;
+    settings.burst = 1000000000;
+    AsyncLog admitted(settings);
+    const std::string line = "frame 1234 rendered in 16.6 ms";
+    double within = TestSupport::MeasureNanoseconds(1, [&] { admitted.Write(line); });
+
+    settings.linesPerSecond = 1;
+    settings.burst = 1;
+    AsyncLog limited(settings);
+    double over = TestSupport::MeasureNanoseconds(1, [&] { limited.Write(line); });
+
+    TestSupport::Report("Write within the rate", within, "ns");
+    TestSupport::Report("Write over the rate", over, "ns");
+}
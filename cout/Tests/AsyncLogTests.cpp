@@ -0,0 +1,382 @@
+#include "AsyncLog.h"
+
+#include "Check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Keeps everything the log writes, and the length of each batch.
+    class RecordingSink : public ILogSink
+    {
+    public:
+        void Write(const char* text, size_t length) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_text.append(text, length);
+            m_batches.push_back(std::string(text, length));
+        }
+
+        std::string GetText()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_text;
+        }
+
+        std::vector<std::string> GetBatches()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_batches;
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_text.clear();
+            m_batches.clear();
+        }
+
+    private:
+        std::mutex                  m_mutex;
+        std::string                 m_text;
+        std::vector<std::string>    m_batches;
+    };
+
+    RecordingSink* AddRecordingSink(AsyncLog& log)
+    {
+        RecordingSink* sink = new RecordingSink();
+        log.AddSink(std::unique_ptr<ILogSink>(sink));
+        return sink;
+    }
+
+    AsyncLog::Settings Unlimited(size_t ringSize)
+    {
+        AsyncLog::Settings settings;
+        settings.ringSize = ringSize;
+        settings.linesPerSecond = 0;
+        return settings;
+    }
+
+    std::string LostReport(unsigned dropped, unsigned suppressed)
+    {
+        return "AsyncLog: a thread lost " + std::to_string(dropped) + " lines to a full buffer and " +
+            std::to_string(suppressed) + " to the rate limit\n";
+    }
+
+    size_t CountLines(const std::string& text, const std::string& line)
+    {
+        size_t count = 0;
+        for (size_t position = text.find(line); position != std::string::npos; position = text.find(line, position + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+}
+
+TEST_CASE(AsyncLogKeepsLinesWholeAndInOrderAroundTheRing)
+{
+    // Records of every length wrap at every offset of a 256 byte ring.
+    AsyncLog log(Unlimited(256));
+    RecordingSink* sink = AddRecordingSink(log);
+
+    std::string expected;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string line(static_cast<size_t>(i * 7 % 56), static_cast<char>('a' + i % 26));
+        if (i % 2 == 0)
+        {
+            log.Write(line);
+        }
+        else
+        {
+            log.Append(line.data(), line.size());
+            log.Append("\n", 1);
+        }
+        expected += line + "\n";
+        if (i % 3 == 2)
+        {
+            log.Flush();
+        }
+    }
+    log.Flush();
+    CHECK(sink->GetText() == expected);
+
+    // A partial line waits for Commit, and a Write ends it.
+    sink->Clear();
+    log.Append("partial", 7);
+    log.Flush();
+    CHECK(sink->GetText().empty());
+    log.Commit();
+    log.Append("more", 4);
+    log.Write("line");
+    log.Flush();
+    CHECK_EQUAL(std::string("partialmoreline\n"), sink->GetText());
+}
+
+TEST_CASE(AsyncLogSplitsLongLinesBetweenCharacters)
+{
+    // A quarter of the ring is a record, so these lines take several. Each starts on a ring
+    // the drain thread has emptied, so whether it fits doesn't depend on how quickly it runs.
+    AsyncLog log(Unlimited(2048));
+    RecordingSink* sink = AddRecordingSink(log);
+
+    std::string line;
+    for (int i = 0; i < 300; ++i)
+    {
+        line += i % 2 == 0 ? "\xE2\x82\xAC" : "x";     // A euro sign and an x.
+    }
+    log.Write(line);
+    log.Flush();
+    CHECK(sink->GetText() == line + "\n");
+
+    sink->Clear();
+    log.Append(line.data(), line.size());
+    log.Append(line.data(), line.size());
+    log.Commit();
+    log.Flush();
+    CHECK(sink->GetText() == line + line);
+
+    // A line that can't fit in the ring is dropped whole, and counted once, however many
+    // calls built it.
+    sink->Clear();
+    log.Write(std::string(2100, 'z'));
+    log.Flush();
+    CHECK(sink->GetText() == LostReport(1, 0));
+
+    sink->Clear();
+    for (int i = 0; i < 4; ++i)
+    {
+        log.Append(line.data(), line.size());
+    }
+    log.Append("\n", 1);
+    log.Flush();
+    CHECK(sink->GetText() == LostReport(1, 0));
+
+    // And the next line starts afresh.
+    sink->Clear();
+    log.Append("after", 5);
+    log.Commit();
+    log.Flush();
+    CHECK(sink->GetText() == "after");
+}
+
+TEST_CASE(AsyncLogBatchesEndBetweenCharacters)
+{
+    // A batch is written once it reaches 64 KB, after a record: a line of 3 byte characters
+    // three records long is split at characters, so every batch is valid UTF-8 on its own.
+    AsyncLog log(Unlimited(256 * 1024));
+    RecordingSink* sink = AddRecordingSink(log);
+
+    std::string line;
+    for (int i = 0; i < 60000; ++i)
+    {
+        line += "\xE2\x82\xAC";
+    }
+    log.Write(line);
+    log.Flush();
+    CHECK(sink->GetText() == line + "\n");
+    std::vector<std::string> batches = sink->GetBatches();
+    CHECK(batches.size() >= 2);
+    for (const std::string& batch : batches)
+    {
+        CHECK(batch.size() % 3 == 0 || batch.size() % 3 == 1);
+        CHECK(batch.compare(0, 3, "\xE2\x82\xAC") == 0);
+    }
+}
+
+TEST_CASE(AsyncLogJoinsSurrogatePairsSplitBetweenCalls)
+{
+    AsyncLog log(Unlimited(1024));
+    RecordingSink* sink = AddRecordingSink(log);
+    const wchar_t high = static_cast<wchar_t>(0xD83D);
+    const wchar_t low = static_cast<wchar_t>(0xDE00);
+    const std::string face = "\xF0\x9F\x98\x80";        // U+1F600, which is D83D DE00.
+    const std::string replacement = "\xEF\xBF\xBD";
+
+    // A stream writes a character at a time, and a flush between the halves doesn't split them.
+    AsyncLogStreamBuf<wchar_t> buffer(log);
+    std::wostream stream(&buffer);
+    stream << L'a' << high << low << L'b' << high << std::flush << low << std::endl;
+    log.Flush();
+    CHECK(sink->GetText() == "a" + face + "b" + face + "\n");
+
+    // Lone halves.
+    sink->Clear();
+    const wchar_t loneLow[] = { low, L'c', L'\n' };
+    log.Append(loneLow, 3);
+    const wchar_t twoHighs[] = { high, high };
+    log.Append(twoHighs, 2);
+    const wchar_t lowAndNewline[] = { low, L'\n' };
+    log.Append(lowAndNewline, 2);
+    log.Append(&high, 1);
+    log.Append(L"d\n", 2);
+    log.Append(&high, 1);
+    log.Append("e\n", 2);
+    log.Append(&high, 1);
+    log.Write("f");
+    log.Flush();
+    CHECK(sink->GetText() ==
+        replacement + "c\n" +
+        replacement + face + "\n" +
+        replacement + "d\n" +
+        replacement + "e\n" +
+        replacement + "f\n");
+
+    // Code points past U+10FFFF, where wchar_t can hold them.
+    if (sizeof(wchar_t) == 4)
+    {
+        sink->Clear();
+        const wchar_t large[] = { static_cast<wchar_t>(0x110000), static_cast<wchar_t>(0x10FFFF), L'\n' };
+        log.Append(large, 3);
+        log.Flush();
+        CHECK(sink->GetText() == replacement + "\xF4\x8F\xBF\xBF\n");
+    }
+}
+
+TEST_CASE(AsyncLogLimitsTheRateWithATokenBucket)
+{
+    AsyncLog::Settings settings;
+    settings.linesPerSecond = 20;
+    settings.burst = 5;
+    AsyncLog log(settings);
+    RecordingSink* sink = AddRecordingSink(log);
+
+    // A burst, then nothing until the bucket refills at 20 lines a second.
+    for (int i = 0; i < 10; ++i)
+    {
+        log.Write("burst");
+    }
+    log.Flush();
+    CHECK_EQUAL(5u, CountLines(sink->GetText(), "burst\n"));
+    CHECK(sink->GetText().find(LostReport(0, 5)) != std::string::npos);
+
+    sink->Clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(110));
+    for (int i = 0; i < 5; ++i)
+    {
+        log.Write("refill");
+    }
+    log.Flush();
+    size_t refilled = CountLines(sink->GetText(), "refill\n");
+    CHECK(refilled >= 2 && refilled <= 5);
+
+    // It holds no more than the burst however long it has been.
+    sink->Clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    for (int i = 0; i < 20; ++i)
+    {
+        log.Write("rested");
+    }
+    log.Flush();
+    CHECK_EQUAL(5u, CountLines(sink->GetText(), "rested\n"));
+    CHECK(sink->GetText().find(LostReport(0, 15)) != std::string::npos);
+
+    // Each part of a long line is not a line of its own, nor is each call that appends to one.
+    AsyncLog::Settings small = settings;
+    small.ringSize = 1024;
+    AsyncLog split(small);
+    RecordingSink* splitSink = AddRecordingSink(split);
+    std::string line(900, 'l');
+    std::string expected;
+    for (int i = 0; i < 5; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            split.Write(line);
+        }
+        else
+        {
+            split.Append(line.data(), 300);
+            split.Append(line.data() + 300, 600);
+            split.Append("\n", 1);
+        }
+        split.Flush();
+        expected += line + "\n";
+    }
+    CHECK(splitSink->GetText() == expected);
+}
+
+TEST_CASE(AsyncLogCountsLinesThatDontFit)
+{
+    // Without a flush the drain thread may or may not run in time; every line is either
+    // written or counted.
+    AsyncLog::Settings settings = Unlimited(256);
+    settings.drainInterval = std::chrono::milliseconds(60000);
+    AsyncLog log(settings);
+    RecordingSink* sink = AddRecordingSink(log);
+
+    const int lines = 100;
+    for (int i = 0; i < lines; ++i)
+    {
+        log.Write(std::string(50, 'f'));
+    }
+    log.Flush();
+
+    std::string text = sink->GetText();
+    size_t written = CountLines(text, std::string(50, 'f') + "\n");
+    unsigned dropped = 0;
+    unsigned suppressed = 1;
+    size_t report = text.find("AsyncLog: a thread lost ");
+    if (report != std::string::npos)
+    {
+        CHECK_EQUAL(2, sscanf(text.c_str() + report, "AsyncLog: a thread lost %u lines to a full buffer and %u", &dropped, &suppressed));
+        CHECK_EQUAL(0u, suppressed);
+    }
+    CHECK(written >= 4);
+    CHECK_EQUAL(static_cast<size_t>(lines), written + dropped);
+}
+
+TEST_CASE(AsyncLogKeepsEachThreadsLinesInOrder)
+{
+    AsyncLog log(Unlimited(64 * 1024));
+    RecordingSink* sink = AddRecordingSink(log);
+
+    const int threads = 4;
+    const int lines = 1000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t)
+    {
+        writers.emplace_back([&log, t]
+        {
+            for (int i = 0; i < lines; ++i)
+            {
+                log.Write("thread " + std::to_string(t) + " line " + std::to_string(i));
+                if (i % 100 == 99)
+                {
+                    log.Flush();
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+    log.Flush();
+
+    std::string text = sink->GetText();
+    int next[threads] = {};
+    size_t start = 0;
+    bool ordered = true;
+    for (size_t end = text.find('\n'); end != std::string::npos; start = end + 1, end = text.find('\n', start))
+    {
+        int t;
+        int i;
+        if (sscanf(text.c_str() + start, "thread %d line %d", &t, &i) == 2 && t >= 0 && t < threads)
+        {
+            ordered = ordered && i == next[t];
+            next[t] = i + 1;
+        }
+    }
+    CHECK(ordered);
+    for (int t = 0; t < threads; ++t)
+    {
+        CHECK_EQUAL(lines, next[t]);
+    }
+}